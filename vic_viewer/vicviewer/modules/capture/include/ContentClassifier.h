@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DesktopFrame.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace vic::capture {
+
+/// Perfil de contenido con el que se sintoniza el encoder
+enum class ContentType : uint8_t {
+    Text = 0,     // Documentos, planillas, CAD: bordes nítidos, cambios localizados
+    Video = 1,    // Video web/juegos: cambios en casi todos los pixels, pocos bordes duros
+    Static = 2    // Nada cambia
+};
+
+[[nodiscard]] const char* contentTypeName(ContentType type);
+
+/// Medidas del último frame (sobre una grilla muestreada de la pantalla)
+struct ContentStats {
+    double dirtyFraction{};   // Tiles de 64x64 con algún cambio / total
+    double temporalNoise{};   // Muestras que cambiaron / muestras de los tiles sucios
+    double edgeDensity{};     // Muestras sobre un borde duro / muestras de los tiles sucios
+};
+
+/// Clasificador liviano por frame (texto / video / estático). El perfil
+/// vigente solo cambia cuando la clasificación nueva se sostiene un tiempo,
+/// para no oscilar con un cursor que parpadea o un frame de transición
+class ContentClassifier {
+public:
+    ContentClassifier();
+    ~ContentClassifier();
+
+    ContentClassifier(const ContentClassifier&) = delete;
+    ContentClassifier& operator=(const ContentClassifier&) = delete;
+
+    /// Medir un frame capturado y devolver el perfil vigente
+    ContentType classify(const DesktopFrame& frame);
+
+    /// El capturer no entregó frame nuevo (pantalla quieta): cuenta como un
+    /// frame sin cambios en `timestampMs`
+    ContentType classifyUnchanged(uint64_t timestampMs);
+
+    [[nodiscard]] ContentType current() const;
+    [[nodiscard]] ContentStats lastStats() const;
+
+    void reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vic::capture
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vic::capture {
+
+/// Bloque que se desplazó entre el frame anterior y el actual (scroll o
+/// ventana arrastrada). Host y viewer lo aplican sobre su frame de referencia
+/// antes de codificar/decodificar, así el codec solo envía lo que apareció nuevo
+struct CopyRect {
+    uint32_t srcX{};
+    uint32_t srcY{};
+    uint32_t dstX{};
+    uint32_t dstY{};
+    uint32_t width{};
+    uint32_t height{};
+};
+
+/// Aplicar los copy-rects (en orden) sobre un frame I420. Las coordenadas
+/// son de luma; en croma se usa la mitad. Todo se recorta a width x height
+void applyCopyRectsI420(uint8_t* y, int strideY,
+                        uint8_t* u, int strideU,
+                        uint8_t* v, int strideV,
+                        uint32_t width, uint32_t height,
+                        const std::vector<CopyRect>& rects);
+
+/// Llevar copy-rects detectados en la resolución de captura a la de codificación.
+/// Descarta los que tras escalar quedan sin desplazamiento o vacíos
+std::vector<CopyRect> scaleCopyRects(const std::vector<CopyRect>& rects,
+                                     uint32_t srcWidth, uint32_t srcHeight,
+                                     uint32_t dstWidth, uint32_t dstHeight);
+
+} // namespace vic::capture
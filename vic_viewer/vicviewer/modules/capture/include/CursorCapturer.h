@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CursorShape.h"
+
+#include <memory>
+
+namespace vic::capture {
+
+/// Lectura del cursor del sistema como metadatos (posición + forma)
+/// en lugar de dibujarlo dentro del frame de video
+class CursorCapturer {
+public:
+    CursorCapturer();
+    ~CursorCapturer();
+
+    CursorCapturer(const CursorCapturer&) = delete;
+    CursorCapturer& operator=(const CursorCapturer&) = delete;
+
+    /// Consultar posición y forma actual. La forma solo se lee de nuevo
+    /// cuando cambia el HCURSOR, así que es barato llamarlo cada iteración
+    bool poll(CursorState& state);
+
+    /// Forma asociada a un hash devuelto por poll() (nullptr si no existe)
+    [[nodiscard]] const CursorShape* shape(uint64_t hash) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vic::capture
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vic::capture {
+
+/// Bitmap del cursor del host (BGRA con alpha, top-down)
+/// Se identifica por hash para enviarlo una sola vez por conexión
+struct CursorShape {
+    uint64_t hash{};
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t hotspotX{};
+    uint32_t hotspotY{};
+    std::vector<uint8_t> bgraData{};
+};
+
+/// Posición del cursor en coordenadas de la pantalla ORIGINAL del host
+struct CursorState {
+    int32_t x{};              // Posición del hotspot
+    int32_t y{};
+    bool visible{false};
+    uint64_t shapeHash{};     // 0 si no hay forma conocida
+};
+
+inline bool operator==(const CursorState& a, const CursorState& b) {
+    return a.x == b.x && a.y == b.y && a.visible == b.visible && a.shapeHash == b.shapeHash;
+}
+
+inline bool operator!=(const CursorState& a, const CursorState& b) {
+    return !(a == b);
+}
+
+} // namespace vic::capture
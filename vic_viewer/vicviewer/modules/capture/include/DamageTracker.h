@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DesktopFrame.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vic::capture {
+
+/// Rectángulo en coordenadas del frame
+struct DamageRect {
+    uint32_t x{};
+    uint32_t y{};
+    uint32_t width{};
+    uint32_t height{};
+};
+
+/// Zonas editadas recientemente: tiles de 64x64 cuyo contenido cambió en los
+/// últimos `windowMs`. Los cambios masivos (scroll, cambio de ventana, video)
+/// no cuentan como edición porque no indican dónde está mirando el usuario
+class DamageTracker {
+public:
+    DamageTracker();
+    ~DamageTracker();
+
+    DamageTracker(const DamageTracker&) = delete;
+    DamageTracker& operator=(const DamageTracker&) = delete;
+
+    /// Comparar con el frame anterior y registrar los tiles que cambiaron
+    void update(const DesktopFrame& frame);
+
+    /// Tiles editados en los últimos `windowMs` (respecto al último frame),
+    /// unidos en rects y ordenados de mayor a menor área
+    [[nodiscard]] std::vector<DamageRect> recentEdits(uint64_t windowMs, size_t maxRects) const;
+
+    void reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vic::capture
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CopyRect.h"
+#include "DesktopFrame.h"
+
+#include <memory>
+#include <vector>
+
+namespace vic::capture {
+
+/// Detecta desplazamientos verticales (scroll) y horizontales (ventana arrastrada)
+/// entre frames consecutivos comparando hashes de filas por franjas de 64px
+/// y de columnas por bandas de 64 filas
+class ScrollDetector {
+public:
+    ScrollDetector();
+    ~ScrollDetector();
+
+    ScrollDetector(const ScrollDetector&) = delete;
+    ScrollDetector& operator=(const ScrollDetector&) = delete;
+
+    /// Copy-rects que llevan el frame anterior hacia `frame` (vacío si no hubo
+    /// desplazamiento). El frame pasa a ser la referencia de la próxima llamada
+    std::vector<CopyRect> detect(const DesktopFrame& frame);
+
+    /// Olvidar el frame anterior (p.ej. tras un keyframe o cambio de resolución)
+    void reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vic::capture
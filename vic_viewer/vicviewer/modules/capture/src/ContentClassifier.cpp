@@ -0,0 +1,205 @@
+#include "ContentClassifier.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace vic::capture {
+
+namespace {
+
+constexpr uint32_t kTileSize = 64;
+constexpr uint32_t kSampleStep = 4;               // 1 de cada 16 pixels: ~130K muestras a 1080p
+constexpr int kEdgeThreshold = 64;                // Salto de luma entre pixels vecinos = borde duro
+
+// Umbrales de la clasificación instantánea (estático = ningún tile sucio: a 4K
+// una sola tecla ensucia menos del 0.1% de los tiles)
+constexpr double kVideoMinDirty = 0.03;           // Un video embebido chico ya supera esto
+constexpr double kVideoMinNoise = 0.6;
+constexpr double kVideoMaxEdges = 0.12;
+
+// Cuánto tiene que sostenerse una clasificación para cambiar de perfil. Volver
+// a texto es rápido (es el perfil seguro); estático espera a que todo se calme
+constexpr uint64_t kSwitchToTextMs = 200;
+constexpr uint64_t kSwitchToVideoMs = 500;
+constexpr uint64_t kSwitchToStaticMs = 1000;
+
+uint8_t luma(const uint8_t* bgra) {
+    return static_cast<uint8_t>((bgra[0] * 29 + bgra[1] * 150 + bgra[2] * 77) >> 8);
+}
+
+uint64_t switchDelayMs(ContentType type) {
+    switch (type) {
+    case ContentType::Text:
+        return kSwitchToTextMs;
+    case ContentType::Video:
+        return kSwitchToVideoMs;
+    case ContentType::Static:
+        return kSwitchToStaticMs;
+    }
+    return kSwitchToTextMs;
+}
+
+} // namespace
+
+const char* contentTypeName(ContentType type) {
+    switch (type) {
+    case ContentType::Text:
+        return "texto";
+    case ContentType::Video:
+        return "video";
+    case ContentType::Static:
+        return "estático";
+    }
+    return "desconocido";
+}
+
+struct ContentClassifier::Impl {
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t tilesX{0};
+    uint32_t tilesY{0};
+    uint32_t samplesX{0};
+    uint32_t samplesY{0};
+    bool hasPrevious{false};
+    std::vector<uint8_t> previousLuma;
+    // Contadores por tile, reutilizados entre frames
+    std::vector<uint32_t> changed;
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> samples;
+
+    ContentStats stats{};
+    ContentType current{ContentType::Text};
+    ContentType candidate{ContentType::Text};
+    uint64_t candidateSinceMs{0};
+
+    void resize(uint32_t w, uint32_t h) {
+        width = w;
+        height = h;
+        tilesX = (w + kTileSize - 1) / kTileSize;
+        tilesY = (h + kTileSize - 1) / kTileSize;
+        samplesX = (w + kSampleStep - 1) / kSampleStep;
+        samplesY = (h + kSampleStep - 1) / kSampleStep;
+        previousLuma.assign(static_cast<size_t>(samplesX) * samplesY, 0);
+        hasPrevious = false;
+    }
+
+    void measure(const DesktopFrame& frame) {
+        const size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+        changed.assign(tileCount, 0);
+        edges.assign(tileCount, 0);
+        samples.assign(tileCount, 0);
+
+        const size_t stride = static_cast<size_t>(width) * 4;
+        for (uint32_t sy = 0; sy < samplesY; ++sy) {
+            const uint32_t y = sy * kSampleStep;
+            const uint8_t* row = frame.bgraData.data() + y * stride;
+            const size_t tileRow = static_cast<size_t>(y / kTileSize) * tilesX;
+            uint8_t* previous = previousLuma.data() + static_cast<size_t>(sy) * samplesX;
+            for (uint32_t sx = 0; sx < samplesX; ++sx) {
+                const uint32_t x = sx * kSampleStep;
+                const uint8_t value = luma(row + static_cast<size_t>(x) * 4);
+                const size_t tile = tileRow + x / kTileSize;
+                ++samples[tile];
+                if (hasPrevious && value != previous[sx]) {
+                    ++changed[tile];
+                }
+                if (x + 1 < width && std::abs(value - luma(row + static_cast<size_t>(x + 1) * 4)) > kEdgeThreshold) {
+                    ++edges[tile];
+                }
+                previous[sx] = value;
+            }
+        }
+
+        // Ruido temporal y bordes solo sobre lo que cambió: el fondo quieto
+        // de una planilla no dice nada del video que se reproduce encima
+        size_t dirtyTiles = 0;
+        uint64_t dirtySamples = 0;
+        uint64_t dirtyChanged = 0;
+        uint64_t dirtyEdges = 0;
+        for (size_t i = 0; i < tileCount; ++i) {
+            if (changed[i] == 0) {
+                continue;
+            }
+            ++dirtyTiles;
+            dirtySamples += samples[i];
+            dirtyChanged += changed[i];
+            dirtyEdges += edges[i];
+        }
+        stats.dirtyFraction = tileCount > 0 ? static_cast<double>(dirtyTiles) / static_cast<double>(tileCount) : 0.0;
+        stats.temporalNoise = dirtySamples > 0 ? static_cast<double>(dirtyChanged) / static_cast<double>(dirtySamples) : 0.0;
+        stats.edgeDensity = dirtySamples > 0 ? static_cast<double>(dirtyEdges) / static_cast<double>(dirtySamples) : 0.0;
+        hasPrevious = true;
+    }
+
+    [[nodiscard]] ContentType instantType() const {
+        if (stats.dirtyFraction <= 0.0) {
+            return ContentType::Static;
+        }
+        if (stats.dirtyFraction >= kVideoMinDirty && stats.temporalNoise >= kVideoMinNoise &&
+            stats.edgeDensity <= kVideoMaxEdges) {
+            return ContentType::Video;
+        }
+        return ContentType::Text;
+    }
+
+    ContentType settle(ContentType type, uint64_t timestampMs) {
+        if (type == current) {
+            candidate = current;
+            return current;
+        }
+        if (type != candidate) {
+            candidate = type;
+            candidateSinceMs = timestampMs;
+        }
+        if (timestampMs >= candidateSinceMs + switchDelayMs(type)) {
+            current = type;
+        }
+        return current;
+    }
+};
+
+ContentClassifier::ContentClassifier()
+    : impl_(std::make_unique<Impl>()) {}
+
+ContentClassifier::~ContentClassifier() = default;
+
+ContentType ContentClassifier::classify(const DesktopFrame& frame) {
+    auto& impl = *impl_;
+    if (frame.width == 0 || frame.height == 0 ||
+        frame.bgraData.size() < static_cast<size_t>(frame.width) * frame.height * 4) {
+        return impl.current;
+    }
+    if (frame.width != impl.width || frame.height != impl.height) {
+        impl.resize(frame.width, frame.height);
+    }
+    const bool hadPrevious = impl.hasPrevious;
+    impl.measure(frame);
+    if (!hadPrevious) {
+        return impl.current;
+    }
+    return impl.settle(impl.instantType(), frame.timestamp);
+}
+
+ContentType ContentClassifier::classifyUnchanged(uint64_t timestampMs) {
+    auto& impl = *impl_;
+    impl.stats = {};
+    return impl.settle(ContentType::Static, timestampMs);
+}
+
+ContentType ContentClassifier::current() const {
+    return impl_->current;
+}
+
+ContentStats ContentClassifier::lastStats() const {
+    return impl_->stats;
+}
+
+void ContentClassifier::reset() {
+    impl_->resize(0, 0);
+    impl_->stats = {};
+    impl_->current = ContentType::Text;
+    impl_->candidate = ContentType::Text;
+    impl_->candidateSinceMs = 0;
+}
+
+} // namespace vic::capture
@@ -0,0 +1,87 @@
+#include "CopyRect.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vic::capture {
+
+namespace {
+
+void copyPlaneRect(uint8_t* plane, int stride, uint32_t planeWidth, uint32_t planeHeight,
+                   uint32_t srcX, uint32_t srcY, uint32_t dstX, uint32_t dstY,
+                   uint32_t width, uint32_t height) {
+    if (srcX >= planeWidth || dstX >= planeWidth || srcY >= planeHeight || dstY >= planeHeight) {
+        return;
+    }
+    width = std::min({width, planeWidth - srcX, planeWidth - dstX});
+    height = std::min({height, planeHeight - srcY, planeHeight - dstY});
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    // Origen y destino se solapan: si el bloque baja hay que copiar de abajo hacia arriba
+    const bool bottomUp = dstY > srcY;
+    for (uint32_t i = 0; i < height; ++i) {
+        const uint32_t row = bottomUp ? height - 1 - i : i;
+        std::memmove(plane + static_cast<size_t>(dstY + row) * stride + dstX,
+                     plane + static_cast<size_t>(srcY + row) * stride + srcX,
+                     width);
+    }
+}
+
+uint32_t scaleCoord(uint32_t value, uint32_t from, uint32_t to) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(value) * to + from / 2) / from);
+}
+
+} // namespace
+
+void applyCopyRectsI420(uint8_t* y, int strideY,
+                        uint8_t* u, int strideU,
+                        uint8_t* v, int strideV,
+                        uint32_t width, uint32_t height,
+                        const std::vector<CopyRect>& rects) {
+    const uint32_t uvWidth = (width + 1) / 2;
+    const uint32_t uvHeight = (height + 1) / 2;
+
+    for (const auto& rect : rects) {
+        copyPlaneRect(y, strideY, width, height,
+                      rect.srcX, rect.srcY, rect.dstX, rect.dstY, rect.width, rect.height);
+
+        const uint32_t uvW = (rect.dstX + rect.width + 1) / 2 - rect.dstX / 2;
+        const uint32_t uvH = (rect.dstY + rect.height + 1) / 2 - rect.dstY / 2;
+        copyPlaneRect(u, strideU, uvWidth, uvHeight,
+                      rect.srcX / 2, rect.srcY / 2, rect.dstX / 2, rect.dstY / 2, uvW, uvH);
+        copyPlaneRect(v, strideV, uvWidth, uvHeight,
+                      rect.srcX / 2, rect.srcY / 2, rect.dstX / 2, rect.dstY / 2, uvW, uvH);
+    }
+}
+
+std::vector<CopyRect> scaleCopyRects(const std::vector<CopyRect>& rects,
+                                     uint32_t srcWidth, uint32_t srcHeight,
+                                     uint32_t dstWidth, uint32_t dstHeight) {
+    if (srcWidth == dstWidth && srcHeight == dstHeight) {
+        return rects;
+    }
+    std::vector<CopyRect> scaled;
+    if (srcWidth == 0 || srcHeight == 0) {
+        return scaled;
+    }
+
+    scaled.reserve(rects.size());
+    for (const auto& rect : rects) {
+        CopyRect out{};
+        out.srcX = scaleCoord(rect.srcX, srcWidth, dstWidth);
+        out.srcY = scaleCoord(rect.srcY, srcHeight, dstHeight);
+        out.dstX = scaleCoord(rect.dstX, srcWidth, dstWidth);
+        out.dstY = scaleCoord(rect.dstY, srcHeight, dstHeight);
+        out.width = scaleCoord(rect.width, srcWidth, dstWidth);
+        out.height = scaleCoord(rect.height, srcHeight, dstHeight);
+        if (out.width == 0 || out.height == 0 || (out.srcX == out.dstX && out.srcY == out.dstY)) {
+            continue;
+        }
+        scaled.push_back(out);
+    }
+    return scaled;
+}
+
+} // namespace vic::capture
@@ -0,0 +1,194 @@
+#include "CursorCapturer.h"
+
+#include "Logger.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+
+namespace vic::capture {
+
+namespace {
+
+// Cursores más grandes se recortan: el mensaje de forma debe caber
+// holgadamente en un solo mensaje del DataChannel
+constexpr uint32_t kMaxCursorSize = 128;
+
+uint64_t hashShape(const CursorShape& shape) {
+    // FNV-1a 64 bits sobre dimensiones, hotspot y pixels
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFFu;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(shape.width);
+    mix(shape.height);
+    mix(shape.hotspotX);
+    mix(shape.hotspotY);
+    for (uint8_t byte : shape.bgraData) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+    // 0 está reservado para "sin forma"
+    return hash != 0 ? hash : 1;
+}
+
+bool readBitmapBgra(HDC dc, HBITMAP bitmap, uint32_t width, uint32_t height, std::vector<uint8_t>& out) {
+    BITMAPINFO bmi{};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = static_cast<LONG>(width);
+    bmi.bmiHeader.biHeight = -static_cast<LONG>(height); // top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    out.resize(static_cast<size_t>(width) * height * 4);
+    return GetDIBits(dc, bitmap, 0, height, out.data(), &bmi, DIB_RGB_COLORS) != 0;
+}
+
+std::optional<CursorShape> readCursorShape(HCURSOR cursor) {
+    ICONINFO ii{};
+    if (!GetIconInfo(cursor, &ii)) {
+        return std::nullopt;
+    }
+
+    CursorShape shape;
+    shape.hotspotX = ii.xHotspot;
+    shape.hotspotY = ii.yHotspot;
+
+    HDC dc = GetDC(nullptr);
+    bool ok = false;
+
+    BITMAP maskInfo{};
+    if (ii.hbmMask && GetObject(ii.hbmMask, sizeof(BITMAP), &maskInfo)) {
+        const uint32_t width = static_cast<uint32_t>(maskInfo.bmWidth);
+        std::vector<uint8_t> mask;
+
+        if (ii.hbmColor) {
+            // Cursor a color: hbmColor trae los pixels, la máscara AND solo
+            // se usa si el bitmap no tiene canal alpha
+            const uint32_t height = static_cast<uint32_t>(maskInfo.bmHeight);
+            if (readBitmapBgra(dc, ii.hbmColor, width, height, shape.bgraData) &&
+                readBitmapBgra(dc, ii.hbmMask, width, height, mask)) {
+                shape.width = width;
+                shape.height = height;
+                bool hasAlpha = false;
+                for (size_t i = 3; i < shape.bgraData.size(); i += 4) {
+                    if (shape.bgraData[i] != 0) {
+                        hasAlpha = true;
+                        break;
+                    }
+                }
+                if (!hasAlpha) {
+                    for (size_t i = 0; i < shape.bgraData.size(); i += 4) {
+                        shape.bgraData[i + 3] = mask[i] ? 0 : 255;
+                    }
+                }
+                ok = true;
+            }
+        } else {
+            // Cursor monocromo: la máscara tiene el doble de alto (AND arriba, XOR abajo)
+            const uint32_t height = static_cast<uint32_t>(maskInfo.bmHeight) / 2;
+            if (readBitmapBgra(dc, ii.hbmMask, width, height * 2, mask)) {
+                shape.width = width;
+                shape.height = height;
+                shape.bgraData.assign(static_cast<size_t>(width) * height * 4, 0);
+                const size_t xorOffset = static_cast<size_t>(width) * height * 4;
+                for (size_t i = 0; i < xorOffset; i += 4) {
+                    const bool andBit = mask[i] != 0;
+                    const bool xorBit = mask[xorOffset + i] != 0;
+                    if (andBit && !xorBit) {
+                        continue; // transparente
+                    }
+                    // XOR sobre fondo (p.ej. I-beam) no se puede reproducir con alpha:
+                    // se dibuja en negro, que es lo legible sobre texto
+                    const uint8_t value = (!andBit && xorBit) ? 255 : 0;
+                    shape.bgraData[i + 0] = value;
+                    shape.bgraData[i + 1] = value;
+                    shape.bgraData[i + 2] = value;
+                    shape.bgraData[i + 3] = 255;
+                }
+                ok = true;
+            }
+        }
+    }
+
+    ReleaseDC(nullptr, dc);
+    if (ii.hbmMask) DeleteObject(ii.hbmMask);
+    if (ii.hbmColor) DeleteObject(ii.hbmColor);
+
+    if (!ok || shape.width == 0 || shape.height == 0) {
+        return std::nullopt;
+    }
+
+    if (shape.width > kMaxCursorSize || shape.height > kMaxCursorSize) {
+        const uint32_t croppedWidth = std::min(shape.width, kMaxCursorSize);
+        const uint32_t croppedHeight = std::min(shape.height, kMaxCursorSize);
+        std::vector<uint8_t> cropped(static_cast<size_t>(croppedWidth) * croppedHeight * 4);
+        for (uint32_t y = 0; y < croppedHeight; ++y) {
+            std::copy_n(shape.bgraData.begin() + static_cast<size_t>(y) * shape.width * 4,
+                        static_cast<size_t>(croppedWidth) * 4,
+                        cropped.begin() + static_cast<size_t>(y) * croppedWidth * 4);
+        }
+        shape.width = croppedWidth;
+        shape.height = croppedHeight;
+        shape.hotspotX = std::min(shape.hotspotX, croppedWidth - 1);
+        shape.hotspotY = std::min(shape.hotspotY, croppedHeight - 1);
+        shape.bgraData = std::move(cropped);
+    }
+
+    shape.hash = hashShape(shape);
+    return shape;
+}
+
+} // namespace
+
+struct CursorCapturer::Impl {
+    HCURSOR lastHandle{nullptr};
+    uint64_t lastHash{0};
+    std::unordered_map<uint64_t, CursorShape> shapes;
+};
+
+CursorCapturer::CursorCapturer()
+    : impl_(std::make_unique<Impl>()) {}
+
+CursorCapturer::~CursorCapturer() = default;
+
+bool CursorCapturer::poll(CursorState& state) {
+    CURSORINFO ci{};
+    ci.cbSize = sizeof(CURSORINFO);
+    if (!GetCursorInfo(&ci)) {
+        return false;
+    }
+
+    state.x = ci.ptScreenPos.x;
+    state.y = ci.ptScreenPos.y;
+    state.visible = (ci.flags & CURSOR_SHOWING) != 0 && ci.hCursor != nullptr;
+    if (!state.visible) {
+        state.shapeHash = 0;
+        return true;
+    }
+
+    if (ci.hCursor != impl_->lastHandle) {
+        impl_->lastHandle = ci.hCursor;
+        if (auto shape = readCursorShape(ci.hCursor)) {
+            impl_->lastHash = shape->hash;
+            impl_->shapes.try_emplace(shape->hash, std::move(*shape));
+        } else {
+            impl_->lastHash = 0;
+            logging::global().log(logging::Logger::Level::Debug, "Cursor: no se pudo leer la forma del cursor");
+        }
+    }
+    state.shapeHash = impl_->lastHash;
+    return true;
+}
+
+const CursorShape* CursorCapturer::shape(uint64_t hash) const {
+    auto it = impl_->shapes.find(hash);
+    return it != impl_->shapes.end() ? &it->second : nullptr;
+}
+
+} // namespace vic::capture
@@ -0,0 +1,170 @@
+#include "DamageTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vic::capture {
+
+namespace {
+
+constexpr uint32_t kTileSize = 64;
+// Si cambia más de 1/4 de la pantalla no es una edición localizada
+constexpr uint32_t kMaxEditFractionDivisor = 4;
+
+constexpr uint64_t kHashSeed = 1469598103934665603ull;
+constexpr uint64_t kHashPrime = 1099511628211ull;
+
+} // namespace
+
+struct DamageTracker::Impl {
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t tilesX{0};
+    uint32_t tilesY{0};
+    bool hasPrevious{false};
+    uint64_t lastTimestamp{0};
+
+    std::vector<uint64_t> hashes;
+    std::vector<uint64_t> scratch;
+    // Timestamp + 1 del último cambio de cada tile (0 = nunca)
+    std::vector<uint64_t> lastChange;
+
+    void resize(uint32_t w, uint32_t h) {
+        width = w;
+        height = h;
+        tilesX = (w + kTileSize - 1) / kTileSize;
+        tilesY = (h + kTileSize - 1) / kTileSize;
+        hashes.assign(static_cast<size_t>(tilesX) * tilesY, kHashSeed);
+        lastChange.assign(hashes.size(), 0);
+        hasPrevious = false;
+    }
+
+    void computeHashes(const DesktopFrame& frame, std::vector<uint64_t>& out) const {
+        out.assign(static_cast<size_t>(tilesX) * tilesY, kHashSeed);
+        const uint8_t* data = frame.bgraData.data();
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t* row = data + static_cast<size_t>(y) * width * 4;
+            uint64_t* tileRow = out.data() + static_cast<size_t>(y / kTileSize) * tilesX;
+            for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                const uint32_t x0 = tx * kTileSize;
+                const uint32_t x1 = std::min(width, x0 + kTileSize);
+                uint64_t hash = tileRow[tx];
+                for (uint32_t x = x0; x < x1; ++x) {
+                    uint32_t pixel;
+                    std::memcpy(&pixel, row + static_cast<size_t>(x) * 4, sizeof(pixel));
+                    hash = (hash ^ pixel) * kHashPrime;
+                }
+                tileRow[tx] = hash;
+            }
+        }
+    }
+};
+
+DamageTracker::DamageTracker()
+    : impl_(std::make_unique<Impl>()) {}
+
+DamageTracker::~DamageTracker() = default;
+
+void DamageTracker::update(const DesktopFrame& frame) {
+    auto& impl = *impl_;
+    if (frame.width == 0 || frame.height == 0 ||
+        frame.bgraData.size() < static_cast<size_t>(frame.width) * frame.height * 4) {
+        return;
+    }
+    if (frame.width != impl.width || frame.height != impl.height) {
+        impl.resize(frame.width, frame.height);
+    }
+
+    impl.computeHashes(frame, impl.scratch);
+    impl.lastTimestamp = frame.timestamp;
+
+    if (impl.hasPrevious) {
+        size_t changed = 0;
+        for (size_t i = 0; i < impl.scratch.size(); ++i) {
+            changed += impl.scratch[i] != impl.hashes[i] ? 1 : 0;
+        }
+
+        if (changed * kMaxEditFractionDivisor > impl.scratch.size()) {
+            // Cambio global: las ediciones anteriores ya no están donde estaban
+            std::fill(impl.lastChange.begin(), impl.lastChange.end(), 0);
+        } else if (changed > 0) {
+            for (size_t i = 0; i < impl.scratch.size(); ++i) {
+                if (impl.scratch[i] != impl.hashes[i]) {
+                    impl.lastChange[i] = frame.timestamp + 1;
+                }
+            }
+        }
+    }
+
+    impl.hashes.swap(impl.scratch);
+    impl.hasPrevious = true;
+}
+
+std::vector<DamageRect> DamageTracker::recentEdits(uint64_t windowMs, size_t maxRects) const {
+    const auto& impl = *impl_;
+    std::vector<DamageRect> rects;
+    if (!impl.hasPrevious) {
+        return rects;
+    }
+
+    auto isRecent = [&](uint32_t tx, uint32_t ty) {
+        const uint64_t changed = impl.lastChange[static_cast<size_t>(ty) * impl.tilesX + tx];
+        return changed != 0 && impl.lastTimestamp + 1 - changed <= windowMs;
+    };
+
+    // Tramos horizontales de tiles por fila; un tramo con el mismo rango que
+    // uno de la fila anterior lo extiende hacia abajo
+    std::vector<DamageRect> open;
+    for (uint32_t ty = 0; ty < impl.tilesY; ++ty) {
+        std::vector<DamageRect> next;
+        uint32_t tx = 0;
+        while (tx < impl.tilesX) {
+            if (!isRecent(tx, ty)) {
+                ++tx;
+                continue;
+            }
+            const uint32_t start = tx;
+            while (tx < impl.tilesX && isRecent(tx, ty)) {
+                ++tx;
+            }
+            DamageRect run{start * kTileSize, ty * kTileSize, (tx - start) * kTileSize, kTileSize};
+            auto it = std::find_if(open.begin(), open.end(), [&](const DamageRect& rect) {
+                return rect.x == run.x && rect.width == run.width;
+            });
+            if (it != open.end()) {
+                it->height += kTileSize;
+                next.push_back(*it);
+                open.erase(it);
+            } else {
+                next.push_back(run);
+            }
+        }
+        rects.insert(rects.end(), open.begin(), open.end());
+        open.swap(next);
+    }
+    rects.insert(rects.end(), open.begin(), open.end());
+
+    for (auto& rect : rects) {
+        rect.width = std::min(rect.width, impl.width - rect.x);
+        rect.height = std::min(rect.height, impl.height - rect.y);
+    }
+    std::sort(rects.begin(), rects.end(), [](const DamageRect& a, const DamageRect& b) {
+        return static_cast<uint64_t>(a.width) * a.height > static_cast<uint64_t>(b.width) * b.height;
+    });
+    if (rects.size() > maxRects) {
+        rects.resize(maxRects);
+    }
+    return rects;
+}
+
+void DamageTracker::reset() {
+    impl_->width = 0;
+    impl_->height = 0;
+    impl_->tilesX = 0;
+    impl_->tilesY = 0;
+    impl_->hasPrevious = false;
+    impl_->hashes.clear();
+    impl_->lastChange.clear();
+}
+
+} // namespace vic::capture
@@ -190,6 +190,13 @@ struct DesktopCapturer::DxgiCapturer {
             return nullptr;
         }
 
+        // Actualización solo de puntero (el escritorio no cambió): el cursor viaja
+        // por su propio canal de metadatos, no hay nada que codificar
+        if (frameInfo.LastPresentTime.QuadPart == 0) {
+            duplication->ReleaseFrame();
+            return nullptr;
+        }
+
         Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
         hr = resource.As(&texture);
         if (FAILED(hr)) {
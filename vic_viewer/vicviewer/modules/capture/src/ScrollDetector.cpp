@@ -0,0 +1,264 @@
+#include "ScrollDetector.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace vic::capture {
+
+namespace {
+
+constexpr uint32_t kLaneSize = 64;       // Ancho de franja (vertical) / alto de banda (horizontal)
+constexpr uint32_t kMinVotes = 8;        // Filas únicas que deben coincidir con el mismo desplazamiento
+constexpr uint32_t kMinRunLength = 24;   // Tramo mínimo desplazado para emitir un copy-rect
+constexpr size_t kMaxRects = 16;
+
+constexpr uint64_t kHashSeed = 1469598103934665603ull;
+constexpr uint64_t kHashPrime = 1099511628211ull;
+
+inline uint64_t mix(uint64_t hash, uint32_t pixel) {
+    return (hash ^ pixel) * kHashPrime;
+}
+
+/// Tramo [start, end) de una franja que se movió `shift` posiciones
+struct ShiftRun {
+    int32_t shift{};
+    uint32_t start{};
+    uint32_t end{};
+};
+
+/// Tramos desplazados dentro de una franja. `cur`/`prev` son los hashes de sus
+/// filas (o columnas) en el frame actual y el anterior
+std::vector<ShiftRun> findShiftRuns(const uint64_t* cur, const uint64_t* prev, uint32_t length,
+                                    std::unordered_map<uint64_t, int32_t>& index,
+                                    std::vector<uint32_t>& votes) {
+    std::vector<ShiftRun> runs;
+
+    // Franja sin cambios (lo habitual): no hace falta indexar nada
+    uint32_t changed = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+        changed += cur[i] != prev[i] ? 1u : 0u;
+    }
+    if (changed < kMinVotes) {
+        return runs;
+    }
+
+    // Posición de cada hash en el frame anterior; -1 si se repite (líneas vacías,
+    // fondos lisos) porque no dice nada sobre el desplazamiento
+    index.clear();
+    for (uint32_t i = 0; i < length; ++i) {
+        auto [it, inserted] = index.try_emplace(prev[i], static_cast<int32_t>(i));
+        if (!inserted) {
+            it->second = -1;
+        }
+    }
+
+    votes.assign(static_cast<size_t>(length) * 2, 0);
+    uint32_t bestVotes = 0;
+    int32_t bestShift = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+        if (cur[i] == prev[i]) {
+            continue;
+        }
+        auto it = index.find(cur[i]);
+        if (it == index.end() || it->second < 0) {
+            continue;
+        }
+        const int32_t shift = static_cast<int32_t>(i) - it->second;
+        const uint32_t count = ++votes[static_cast<size_t>(shift + static_cast<int32_t>(length))];
+        if (count > bestVotes) {
+            bestVotes = count;
+            bestShift = shift;
+        }
+    }
+    if (bestVotes < kMinVotes || bestShift == 0) {
+        return runs;
+    }
+
+    // Tramos contiguos donde el frame actual coincide con el anterior desplazado
+    const uint32_t first = static_cast<uint32_t>(std::max(0, bestShift));
+    const uint32_t last = static_cast<uint32_t>(std::min<int32_t>(static_cast<int32_t>(length),
+                                                                  static_cast<int32_t>(length) + bestShift));
+    uint32_t runStart = first;
+    uint32_t moved = 0;
+    for (uint32_t i = first; i <= last; ++i) {
+        const bool match = i < last && cur[i] == prev[i - bestShift];
+        if (match) {
+            if (cur[i] != prev[i]) {
+                ++moved;
+            }
+            continue;
+        }
+        // Exigir contenido que realmente cambió: un fondo liso coincide con cualquier desplazamiento
+        if (i - runStart >= kMinRunLength && moved >= kMinVotes) {
+            runs.push_back({bestShift, runStart, i});
+        }
+        runStart = i + 1;
+        moved = 0;
+    }
+    return runs;
+}
+
+/// Rect abierto mientras se recorren franjas contiguas con el mismo desplazamiento
+struct LaneRect {
+    int32_t shift{};
+    uint32_t laneStart{};
+    uint32_t laneEnd{};
+    uint32_t start{};
+    uint32_t end{};
+    uint32_t lastLane{};
+};
+
+} // namespace
+
+struct ScrollDetector::Impl {
+    uint32_t width{0};
+    uint32_t height{0};
+    bool hasPrevious{false};
+
+    // rowHashes[strip * height + y], colHashes[band * width + x]
+    std::vector<uint64_t> rowHashes;
+    std::vector<uint64_t> colHashes;
+    std::vector<uint64_t> prevRowHashes;
+    std::vector<uint64_t> prevColHashes;
+
+    std::unordered_map<uint64_t, int32_t> index;
+    std::vector<uint32_t> votes;
+
+    uint32_t strips() const { return (width + kLaneSize - 1) / kLaneSize; }
+    uint32_t bands() const { return (height + kLaneSize - 1) / kLaneSize; }
+
+    void computeHashes(const DesktopFrame& frame) {
+        rowHashes.assign(static_cast<size_t>(strips()) * height, kHashSeed);
+        colHashes.assign(static_cast<size_t>(bands()) * width, kHashSeed);
+
+        // Una sola pasada: cada pixel alimenta el hash de su fila (dentro de su
+        // franja) y el de su columna (dentro de su banda)
+        const uint8_t* data = frame.bgraData.data();
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t* row = data + static_cast<size_t>(y) * width * 4;
+            uint64_t* col = colHashes.data() + static_cast<size_t>(y / kLaneSize) * width;
+            for (uint32_t strip = 0; strip < strips(); ++strip) {
+                const uint32_t x0 = strip * kLaneSize;
+                const uint32_t x1 = std::min(width, x0 + kLaneSize);
+                uint64_t hash = kHashSeed;
+                for (uint32_t x = x0; x < x1; ++x) {
+                    uint32_t pixel;
+                    std::memcpy(&pixel, row + static_cast<size_t>(x) * 4, sizeof(pixel));
+                    hash = mix(hash, pixel);
+                    col[x] = mix(col[x], pixel);
+                }
+                rowHashes[static_cast<size_t>(strip) * height + y] = hash;
+            }
+        }
+    }
+
+    /// Recorre las franjas (`vertical`) o bandas y une las contiguas con el mismo
+    /// desplazamiento y rango solapado en un único rect
+    std::vector<CopyRect> detectDirection(bool vertical) {
+        const uint32_t lanes = vertical ? strips() : bands();
+        const uint32_t length = vertical ? height : width;
+        const uint32_t extent = vertical ? width : height;
+        const auto& cur = vertical ? rowHashes : colHashes;
+        const auto& prev = vertical ? prevRowHashes : prevColHashes;
+
+        std::vector<LaneRect> open;
+        std::vector<LaneRect> closed;
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            const size_t offset = static_cast<size_t>(lane) * length;
+            auto runs = findShiftRuns(cur.data() + offset, prev.data() + offset, length, index, votes);
+            const uint32_t laneEnd = std::min(extent, (lane + 1) * kLaneSize);
+
+            for (const auto& run : runs) {
+                auto it = std::find_if(open.begin(), open.end(), [&](const LaneRect& rect) {
+                    const uint32_t start = std::max(rect.start, run.start);
+                    const uint32_t end = std::min(rect.end, run.end);
+                    return rect.lastLane + 1 == lane && rect.shift == run.shift &&
+                        end > start && end - start >= kMinRunLength;
+                });
+                if (it != open.end()) {
+                    it->start = std::max(it->start, run.start);
+                    it->end = std::min(it->end, run.end);
+                    it->laneEnd = laneEnd;
+                    it->lastLane = lane;
+                } else {
+                    open.push_back({run.shift, lane * kLaneSize, laneEnd, run.start, run.end, lane});
+                }
+            }
+
+            // Los rects que no continuaron en esta franja quedan cerrados
+            auto stale = std::stable_partition(open.begin(), open.end(),
+                [lane](const LaneRect& rect) { return rect.lastLane == lane; });
+            closed.insert(closed.end(), stale, open.end());
+            open.erase(stale, open.end());
+        }
+        closed.insert(closed.end(), open.begin(), open.end());
+
+        std::vector<CopyRect> rects;
+        rects.reserve(closed.size());
+        for (const auto& rect : closed) {
+            CopyRect out{};
+            const uint32_t along = rect.end - rect.start;
+            const uint32_t across = rect.laneEnd - rect.laneStart;
+            const uint32_t src = static_cast<uint32_t>(static_cast<int32_t>(rect.start) - rect.shift);
+            if (vertical) {
+                out = {rect.laneStart, src, rect.laneStart, rect.start, across, along};
+            } else {
+                out = {src, rect.laneStart, rect.start, rect.laneStart, along, across};
+            }
+            rects.push_back(out);
+        }
+        return rects;
+    }
+};
+
+ScrollDetector::ScrollDetector()
+    : impl_(std::make_unique<Impl>()) {}
+
+ScrollDetector::~ScrollDetector() = default;
+
+std::vector<CopyRect> ScrollDetector::detect(const DesktopFrame& frame) {
+    auto& impl = *impl_;
+    if (frame.width == 0 || frame.height == 0 ||
+        frame.bgraData.size() < static_cast<size_t>(frame.width) * frame.height * 4) {
+        reset();
+        return {};
+    }
+    if (frame.width != impl.width || frame.height != impl.height) {
+        reset();
+        impl.width = frame.width;
+        impl.height = frame.height;
+    }
+
+    impl.computeHashes(frame);
+
+    std::vector<CopyRect> rects;
+    if (impl.hasPrevious) {
+        // El scroll es el caso común; el horizontal solo se busca si no hubo vertical
+        rects = impl.detectDirection(true);
+        if (rects.empty()) {
+            rects = impl.detectDirection(false);
+        }
+        if (rects.size() > kMaxRects) {
+            std::sort(rects.begin(), rects.end(), [](const CopyRect& a, const CopyRect& b) {
+                return static_cast<uint64_t>(a.width) * a.height > static_cast<uint64_t>(b.width) * b.height;
+            });
+            rects.resize(kMaxRects);
+        }
+    }
+
+    impl.prevRowHashes.swap(impl.rowHashes);
+    impl.prevColHashes.swap(impl.colHashes);
+    impl.hasPrevious = true;
+    return rects;
+}
+
+void ScrollDetector::reset() {
+    impl_->hasPrevious = false;
+    impl_->width = 0;
+    impl_->height = 0;
+    impl_->prevRowHashes.clear();
+    impl_->prevColHashes.clear();
+}
+
+} // namespace vic::capture
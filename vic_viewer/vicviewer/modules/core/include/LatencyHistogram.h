@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vic::metrics {
+
+/// Histograma log-lineal al estilo HDR para latencias en nanosegundos: por
+/// cada potencia de dos, kSubBuckets buckets lineales, así el error relativo
+/// es el mismo (< 1/kSubBuckets) de 1 ns a 2^kMaxExponent ns (~137 s) con
+/// tamaño fijo; lo que pase de ahí cae en el último bucket.
+/// Esta es la versión simple (no atómica) que usa el lector para fusionar y
+/// restar; los contadores de cada hilo viven en MetricsCollector
+namespace histogram {
+
+constexpr uint32_t kSubBucketBits = 5;
+constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;        // 32: error <= 3.1 %
+constexpr uint32_t kMaxExponent = 37;                         // 2^37 ns ~ 137 s
+constexpr size_t kBuckets = kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+/// Bucket de un valor: los menores a kSubBuckets van uno por bucket; el
+/// resto según su bit más alto y los kSubBucketBits siguientes
+[[nodiscard]] constexpr size_t bucketIndex(uint64_t ns) {
+    if (ns < kSubBuckets) {
+        return static_cast<size_t>(ns);
+    }
+    const uint32_t exponent = static_cast<uint32_t>(std::bit_width(ns)) - 1;
+    if (exponent >= kMaxExponent) {
+        return kBuckets - 1;
+    }
+    const uint32_t shift = exponent - kSubBucketBits;
+    const auto sub = static_cast<size_t>((ns >> shift) & (kSubBuckets - 1));
+    return kSubBuckets + static_cast<size_t>(shift) * kSubBuckets + sub;
+}
+
+/// Límite inferior y ancho del bucket (en ns)
+[[nodiscard]] constexpr uint64_t bucketLower(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const size_t shift = (index - kSubBuckets) / kSubBuckets;
+    const uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + sub) << shift;
+}
+
+[[nodiscard]] constexpr uint64_t bucketWidth(size_t index) {
+    return index < kSubBuckets ? 1 : uint64_t{1} << ((index - kSubBuckets) / kSubBuckets);
+}
+
+} // namespace histogram
+
+class LatencyHistogram {
+public:
+    void record(uint64_t ns) {
+        ++counts_[histogram::bucketIndex(ns)];
+        ++count_;
+        sumNs_ += ns;
+    }
+
+    /// Sumar un bucket leído de otro histograma (fusión de los hilos)
+    void addBucket(size_t index, uint64_t count) {
+        counts_[index] += count;
+        count_ += count;
+    }
+    void addSum(uint64_t ns) { sumNs_ += ns; }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < histogram::kBuckets; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sumNs_ += other.sumNs_;
+    }
+
+    /// Restar un estado anterior del mismo contador acumulado (ventanas)
+    void subtract(const LatencyHistogram& earlier) {
+        for (size_t i = 0; i < histogram::kBuckets; ++i) {
+            counts_[i] -= std::min(counts_[i], earlier.counts_[i]);
+        }
+        count_ -= std::min(count_, earlier.count_);
+        sumNs_ -= std::min(sumNs_, earlier.sumNs_);
+    }
+
+    void clear() { *this = LatencyHistogram{}; }
+
+    [[nodiscard]] uint64_t count() const { return count_; }
+    [[nodiscard]] uint64_t sumNs() const { return sumNs_; }
+    [[nodiscard]] double meanNs() const { return count_ > 0 ? static_cast<double>(sumNs_) / count_ : 0.0; }
+
+    /// Percentil (0..1) como el punto medio del bucket que lo contiene
+    [[nodiscard]] double percentileNs(double quantile) const {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count_)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < histogram::kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= std::max<uint64_t>(rank, 1)) {
+                return static_cast<double>(histogram::bucketLower(i)) +
+                       static_cast<double>(histogram::bucketWidth(i) - 1) / 2.0;
+            }
+        }
+        return maxNs();
+    }
+
+    /// Límite superior del bucket más alto con muestras
+    [[nodiscard]] double maxNs() const {
+        for (size_t i = histogram::kBuckets; i-- > 0;) {
+            if (counts_[i] > 0) {
+                return static_cast<double>(histogram::bucketLower(i) + histogram::bucketWidth(i) - 1);
+            }
+        }
+        return 0.0;
+    }
+
+private:
+    std::array<uint64_t, histogram::kBuckets> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sumNs_ = 0;
+};
+
+} // namespace vic::metrics
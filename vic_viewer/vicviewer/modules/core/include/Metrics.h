@@ -1,13 +1,39 @@
 #pragma once
 
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <deque>
+#include <vector>
 
 namespace vic::metrics {
 
+/// Etapas del pipeline con histograma de latencia propio
+enum class Stage : uint8_t {
+    Capture,
+    ColorConvert,
+    Encode,
+    Network,
+    Decode,
+    Render,
+};
+
+/// Latencia de una etapa en una ventana, en microsegundos
+struct LatencyPercentiles {
+    uint64_t count = 0;
+    double meanUs = 0;
+    double p50Us = 0;
+    double p90Us = 0;
+    double p99Us = 0;
+    double p999Us = 0;
+    double maxUs = 0;
+};
+
 /// Métricas de rendimiento del pipeline de video
 struct PipelineMetrics {
     // Tiempos promedio en microsegundos
@@ -34,31 +60,121 @@ struct PipelineMetrics {
     uint64_t totalFramesEncoded = 0;
     uint64_t totalFramesDropped = 0;
     uint64_t totalBytesTransferred = 0;
+    uint64_t totalBytesSent = 0;        // Aceptados por el transporte, sumando todos los viewers
+    
+    // Governor de velocidad del encoder (cpuUsed 0 = sin governor)
+    int encoderCpuUsed = 0;
+    uint32_t encoderThreads = 0;
+    uint32_t encoderTokenPartitions = 0;   // log2
+    double encoderUtilisation = 0;         // Tiempo de encode / presupuesto por frame
+    
+    // Perfil de contenido (vic::capture::ContentType: 0 texto, 1 video, 2 estático)
+    static constexpr size_t kContentProfiles = 3;
+    uint8_t contentProfile = 0;
+    std::array<double, kContentProfiles> contentProfileSeconds{};   // Tiempo activo de cada perfil
+    std::array<uint64_t, kContentProfiles> contentProfileBytes{};   // Bytes enviados con cada perfil
+    
+    // Cola del hilo de decode del viewer
+    uint32_t decodeQueueDepth = 0;          // Frames que tomó el último ciclo de decode
+    uint32_t maxDecodeQueueDepth = 0;
+    uint64_t framesDecodedNotPresented = 0; // Decodificados solo por referencia (había uno más nuevo)
+    uint64_t decodeQueueOverflows = 0;      // Veces que la cola se vació por llena (pide recuperación)
+    
+    // Viewers que se unen al host: DataChannel abierto -> enviado el frame que
+    // completa la primera imagen (ráfaga desde la caché GOP o keyframe forzado)
+    uint64_t gopCacheJoins = 0;
+    uint64_t keyframeJoins = 0;
+    double avgGopCacheJoinMs = 0;
+    double avgKeyframeJoinMs = 0;
+    
+    // Simulcast: costo de cada capa (0 = completa, 1 = reducida) en el último segundo
+    static constexpr size_t kSimulcastLayers = 2;
+    std::array<uint32_t, kSimulcastLayers> simulcastWidth{};
+    std::array<uint32_t, kSimulcastLayers> simulcastHeight{};
+    std::array<double, kSimulcastLayers> simulcastEncodeUs{};   // Promedio por frame
+    std::array<double, kSimulcastLayers> simulcastKbps{};
+    std::array<uint32_t, kSimulcastLayers> simulcastViewers{};
+    uint64_t simulcastSwitches = 0;                             // Cambios de capa de algún viewer
+    
+    // Percentiles por etapa (índice = Stage) en cada ventana de
+    // MetricsCollector::setWindows(), de la más corta a la más larga.
+    // Los avg*TimeUs de arriba son los de la ventana más corta
+    static constexpr size_t kStages = 6;
+    /// Los checkpoints solo avanzan cuando alguien lee las métricas: tras un
+    /// rato sin lecturas, la ventana abarca todo ese rato y no solo `window`
+    /// (lo mismo avgFps y avgBitrateKbps, que salen de la más corta).
+    /// `covered` es lo que abarca en realidad; leer al menos una vez por
+    /// ventana la mantiene cerca de `window`
+    struct LatencyWindow {
+        std::chrono::milliseconds window{};
+        std::chrono::milliseconds covered{};   // Tiempo realmente cubierto (menos al arrancar, más tras un hueco)
+        std::array<LatencyPercentiles, kStages> stages{};
+    };
+    std::vector<LatencyWindow> latencyWindows;
 };
 
-/// Singleton para recopilar métricas del pipeline
+/// Singleton para recopilar métricas del pipeline.
+/// Los tiempos por etapa van a histogramas HDR por hilo: cada hilo escribe
+/// solo los suyos (load + store relajados, sin locks ni RMW, wait-free) y el
+/// lector los fusiona al pedir las métricas. Los histogramas son acumulados;
+/// cada ventana es la diferencia contra un checkpoint de hace al menos esa
+/// ventana. El resto de las métricas (estado, una vez por segundo o menos)
+/// sigue bajo mutex_
 class MetricsCollector {
 public:
     static MetricsCollector& instance();
+    ~MetricsCollector();
 
-    // Marcar inicio de cada fase
+    // Marcar inicio de cada fase (el inicio es por hilo: inicio y fin en el mismo)
     void markCaptureStart();
     void markCaptureEnd();
     void markColorConvertStart();
     void markColorConvertEnd();
     void markEncodeStart();
     void markEncodeEnd();
-    void markNetworkSendStart();
+    void markNetworkSendStart();     // Compartido entre hilos (envío -> recepción)
     void markNetworkReceiveEnd();
     void markDecodeStart();
     void markDecodeEnd();
     void markRenderStart();
     void markRenderEnd();
     
+    /// Tiempo de una etapa medido por quien llama (StageTimer, o su propio reloj)
+    void recordStageTime(Stage stage, uint64_t ns);
+    
     // Registrar tamaño de frame
     void recordFrameSize(size_t bytes);
     void recordFrameDropped();
     
+    // Bytes de un frame que el transporte aceptó para un viewer (host)
+    void recordBytesSent(size_t bytes);
+    
+    // Estado del governor de velocidad del encoder
+    void recordEncoderSpeed(int cpuUsed, uint32_t threads, uint32_t tokenPartitions, double utilisation);
+    
+    // Perfil de contenido vigente y tiempo/bytes acumulados con cada perfil
+    void recordContentProfile(uint8_t profile);
+    void addContentProfileUsage(uint8_t profile, double seconds, uint64_t bytes);
+    
+    // Cola de decode del viewer: profundidad de cada ciclo, frames no presentados y desbordes
+    void recordDecodeQueueDepth(uint32_t depth);
+    void recordFramesNotPresented(uint32_t count);
+    void recordDecodeQueueOverflow();
+    
+    // Tiempo hasta la primera imagen de un viewer que se une (host)
+    void recordViewerJoin(double timeToFirstFrameMs, bool fromGopCache);
+    
+    // Simulcast: costo por capa (una vez por segundo) y cambios de capa
+    void recordSimulcastLayer(uint8_t layer, uint32_t width, uint32_t height,
+                              double avgEncodeUs, double kbps, uint32_t viewers);
+    void recordSimulcastSwitch();
+    
+    /// Ventanas de los percentiles (default 1 s, 10 s y 60 s). Empiezan vacías
+    void setWindows(std::vector<std::chrono::milliseconds> windows);
+    
+    /// Percentiles de una etapa en la ventana `window` (índice de setWindows)
+    LatencyPercentiles stageLatency(Stage stage, size_t window = 0) const;
+    
     // Obtener métricas actuales
     PipelineMetrics getMetrics() const;
     
@@ -69,34 +185,55 @@ public:
     void reset();
 
 private:
-    MetricsCollector() = default;
+    struct ThreadCounters;
+    struct Snapshot;
+    struct Window;
+
+    MetricsCollector();
     
-    void updateAverages();
+    ThreadCounters& local();
+    void markStart(Stage stage);
+    void markEnd(Stage stage);
+    void snapshot(Snapshot& out) const;
+    void updateWindows(const Snapshot& current) const;
+    void fillWindowMetrics(PipelineMetrics& metrics, const Snapshot& current) const;
     
-    mutable std::mutex mutex_;
+    // Contadores de cada hilo que registró algo. Un hilo que termina deja el
+    // suyo libre y lo adopta el próximo: los acumulados siguen siendo válidos
+    mutable std::mutex registryMutex_;
+    std::vector<std::unique_ptr<ThreadCounters>> threads_;
     
-    // Timestamps de la fase actual
-    std::chrono::steady_clock::time_point captureStart_;
-    std::chrono::steady_clock::time_point colorConvertStart_;
-    std::chrono::steady_clock::time_point encodeStart_;
-    std::chrono::steady_clock::time_point networkSendStart_;
-    std::chrono::steady_clock::time_point decodeStart_;
-    std::chrono::steady_clock::time_point renderStart_;
-    
-    // Últimas N mediciones para promedios
-    static constexpr size_t kWindowSize = 60;  // ~1 segundo a 60fps
-    std::deque<double> captureTimesUs_;
-    std::deque<double> colorConvertTimesUs_;
-    std::deque<double> encodeTimesUs_;
-    std::deque<double> networkTimesUs_;
-    std::deque<double> decodeTimesUs_;
-    std::deque<double> renderTimesUs_;
-    std::deque<size_t> frameSizes_;
-    std::deque<std::chrono::steady_clock::time_point> frameTimestamps_;
+    // Inicio de la etapa de red (la recepción termina en otro hilo)
+    std::atomic<int64_t> networkSendStartNs_{0};
     
+    // Lado del lector (bajo mutex_)
+    mutable std::mutex mutex_;
+    std::unique_ptr<Snapshot> baseline_;          // Estado en el último reset()
+    mutable std::vector<Window> windows_;
     PipelineMetrics currentMetrics_{};
 };
 
+/// Helper RAII para medir una etapa: el inicio queda en el objeto, al salir
+/// registra la duración (un par de lecturas del reloj y un incremento)
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage)
+        : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    
+    ~StageTimer() {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        MetricsCollector::instance().recordStageTime(stage_, static_cast<uint64_t>(ns));
+    }
+    
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    
+private:
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
 /// Helper RAII para medir tiempo de una sección
 class ScopedTimer {
 public:
@@ -117,28 +254,18 @@ private:
 
 // Macros de conveniencia
 #define VIC_METRICS_CAPTURE() \
-    vic::metrics::ScopedTimer _capture_timer_( \
-        &vic::metrics::MetricsCollector::markCaptureStart, \
-        &vic::metrics::MetricsCollector::markCaptureEnd)
+    vic::metrics::StageTimer _capture_timer_(vic::metrics::Stage::Capture)
 
 #define VIC_METRICS_COLOR_CONVERT() \
-    vic::metrics::ScopedTimer _color_timer_( \
-        &vic::metrics::MetricsCollector::markColorConvertStart, \
-        &vic::metrics::MetricsCollector::markColorConvertEnd)
+    vic::metrics::StageTimer _color_timer_(vic::metrics::Stage::ColorConvert)
 
 #define VIC_METRICS_ENCODE() \
-    vic::metrics::ScopedTimer _encode_timer_( \
-        &vic::metrics::MetricsCollector::markEncodeStart, \
-        &vic::metrics::MetricsCollector::markEncodeEnd)
+    vic::metrics::StageTimer _encode_timer_(vic::metrics::Stage::Encode)
 
 #define VIC_METRICS_DECODE() \
-    vic::metrics::ScopedTimer _decode_timer_( \
-        &vic::metrics::MetricsCollector::markDecodeStart, \
-        &vic::metrics::MetricsCollector::markDecodeEnd)
+    vic::metrics::StageTimer _decode_timer_(vic::metrics::Stage::Decode)
 
 #define VIC_METRICS_RENDER() \
-    vic::metrics::ScopedTimer _render_timer_( \
-        &vic::metrics::MetricsCollector::markRenderStart, \
-        &vic::metrics::MetricsCollector::markRenderEnd)
+    vic::metrics::StageTimer _render_timer_(vic::metrics::Stage::Render)
 
 } // namespace vic::metrics
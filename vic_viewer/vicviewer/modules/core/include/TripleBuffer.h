@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace vic {
+
+/// Buzón de tres buffers entre un único productor (decoder) y un único
+/// consumidor (render), sin locks ni copias:
+///   - El productor escribe en writeBuffer() y lo publica con publish()
+///   - El consumidor toma el más nuevo publicado con acquireLatest() y lo lee
+///     en readBuffer() hasta el próximo acquireLatest()
+/// Ninguno espera al otro: si el productor publica más rápido de lo que el
+/// consumidor lee, los buffers intermedios se pisan (gana el más nuevo).
+/// Los buffers se reciclan, así que T conserva su capacidad entre frames
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ========== Productor ==========
+    /// Buffer propio del productor: nadie más lo toca hasta publish()
+    T& writeBuffer() { return buffers_[write_]; }
+
+    /// Publicar writeBuffer() y quedarse con el buffer intermedio (que puede
+    /// tener un frame viejo que nunca se leyó) para escribir el siguiente
+    void publish() {
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(write_ | kFresh), std::memory_order_acq_rel);
+        write_ = previous & kIndexMask;
+    }
+
+    // ========== Consumidor ==========
+    /// Tomar el último buffer publicado. false si no hubo publicaciones desde
+    /// la última llamada (readBuffer() sigue siendo el mismo)
+    bool acquireLatest() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        const uint8_t previous = middle_.exchange(read_, std::memory_order_acq_rel);
+        read_ = previous & kIndexMask;
+        hasRead_ = true;
+        return true;
+    }
+
+    /// Buffer propio del consumidor (el último tomado con acquireLatest())
+    const T& readBuffer() const { return buffers_[read_]; }
+    T& readBuffer() { return buffers_[read_]; }
+
+    /// Si ya se tomó algún buffer publicado (readBuffer() tiene datos)
+    [[nodiscard]] bool hasFrame() const { return hasRead_; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;   // El intermedio tiene un buffer aún no leído
+
+    T buffers_[3]{};
+    // Cada índice tiene un único dueño: write_ el productor, read_ el
+    // consumidor y middle_ se intercambia atómicamente entre ambos. Línea de
+    // cache propia para que el productor no invalide la del consumidor
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t write_ = 0;
+    alignas(64) uint8_t read_ = 2;
+    bool hasRead_ = false;
+};
+
+} // namespace vic
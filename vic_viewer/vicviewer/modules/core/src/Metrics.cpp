@@ -1,232 +1,478 @@
 #include "Metrics.h"
 
 #include <algorithm>
-#include <numeric>
+#include <deque>
 #include <sstream>
 #include <iomanip>
+#include <utility>
 
 namespace vic::metrics {
 
+namespace {
+
+constexpr size_t kStageCount = PipelineMetrics::kStages;
+constexpr const char* kStageNames[kStageCount] = {"Capture", "Color Conv", "Encode", "Network", "Decode", "Render"};
+
+// Checkpoints por ventana: la ventana efectiva cubre entre W y W + W/4
+constexpr int kCheckpointsPerWindow = 4;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Cada contador tiene un solo escritor (su hilo): load + store relajados, sin
+// RMW ni lock. El lector puede ver un bucket un incremento atrasado, nada más
+void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+LatencyPercentiles toPercentiles(const LatencyHistogram& histogram) {
+    LatencyPercentiles result;
+    result.count = histogram.count();
+    result.meanUs = histogram.meanNs() / 1000.0;
+    result.p50Us = histogram.percentileNs(0.50) / 1000.0;
+    result.p90Us = histogram.percentileNs(0.90) / 1000.0;
+    result.p99Us = histogram.percentileNs(0.99) / 1000.0;
+    result.p999Us = histogram.percentileNs(0.999) / 1000.0;
+    result.maxUs = histogram.maxNs() / 1000.0;
+    return result;
+}
+
+} // namespace
+
+// ========== CONTADORES POR HILO ==========
+
+struct MetricsCollector::ThreadCounters {
+    std::array<std::array<std::atomic<uint64_t>, histogram::kBuckets>, kStageCount> buckets{};
+    std::array<std::atomic<uint64_t>, kStageCount> sumNs{};
+    std::atomic<uint64_t> frameBytes{0};
+    std::atomic<uint64_t> frameSizes{0};
+    std::atomic<uint64_t> framesDropped{0};
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic_bool inUse{false};
+    std::array<int64_t, kStageCount> startNs{};   // Solo el hilo dueño
+};
+
+/// Estado acumulado de todos los hilos en un instante
+struct MetricsCollector::Snapshot {
+    std::chrono::steady_clock::time_point time{};
+    std::array<LatencyHistogram, kStageCount> stages{};
+    uint64_t frameBytes = 0;
+    uint64_t frameSizes = 0;
+    uint64_t framesDropped = 0;
+    uint64_t bytesSent = 0;
+};
+
+struct MetricsCollector::Window {
+    std::chrono::milliseconds length{};
+    std::deque<Snapshot> checkpoints;   // El primero es la base: el más nuevo con al menos `length`
+};
+
 MetricsCollector& MetricsCollector::instance() {
     static MetricsCollector instance;
     return instance;
 }
 
-void MetricsCollector::markCaptureStart() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    captureStart_ = std::chrono::steady_clock::now();
+MetricsCollector::MetricsCollector()
+        : baseline_(std::make_unique<Snapshot>()) {
+    baseline_->time = std::chrono::steady_clock::now();
+    setWindows({std::chrono::seconds(1), std::chrono::seconds(10), std::chrono::seconds(60)});
 }
 
-void MetricsCollector::markCaptureEnd() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - captureStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    captureTimesUs_.push_back(static_cast<double>(us));
-    if (captureTimesUs_.size() > kWindowSize) {
-        captureTimesUs_.pop_front();
+MetricsCollector::~MetricsCollector() = default;
+
+MetricsCollector::ThreadCounters& MetricsCollector::local() {
+    // Al terminar el hilo sus contadores quedan libres para el próximo
+    struct Slot {
+        ThreadCounters* counters = nullptr;
+        ~Slot() {
+            if (counters) {
+                counters->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Slot slot;
+    if (!slot.counters) {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        for (const auto& counters : threads_) {
+            if (!counters->inUse.exchange(true, std::memory_order_acquire)) {
+                slot.counters = counters.get();
+                break;
+            }
+        }
+        if (!slot.counters) {
+            threads_.push_back(std::make_unique<ThreadCounters>());
+            slot.counters = threads_.back().get();
+            slot.counters->inUse.store(true, std::memory_order_relaxed);
+        }
     }
-    
-    currentMetrics_.totalFramesCaptured++;
-    frameTimestamps_.push_back(std::chrono::steady_clock::now());
-    if (frameTimestamps_.size() > kWindowSize) {
-        frameTimestamps_.pop_front();
+    return *slot.counters;
+}
+
+// ========== TIEMPOS POR ETAPA (hot path, sin locks) ==========
+
+void MetricsCollector::recordStageTime(Stage stage, uint64_t ns) {
+    auto& counters = local();
+    const auto index = static_cast<size_t>(stage);
+    bump(counters.buckets[index][histogram::bucketIndex(ns)], 1);
+    bump(counters.sumNs[index], ns);
+}
+
+void MetricsCollector::markStart(Stage stage) {
+    local().startNs[static_cast<size_t>(stage)] = nowNs();
+}
+
+void MetricsCollector::markEnd(Stage stage) {
+    auto& counters = local();
+    const int64_t start = std::exchange(counters.startNs[static_cast<size_t>(stage)], 0);
+    if (start != 0) {
+        recordStageTime(stage, static_cast<uint64_t>(std::max<int64_t>(0, nowNs() - start)));
     }
-    
-    updateAverages();
 }
 
-void MetricsCollector::markColorConvertStart() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    colorConvertStart_ = std::chrono::steady_clock::now();
+void MetricsCollector::markCaptureStart() { markStart(Stage::Capture); }
+void MetricsCollector::markCaptureEnd() { markEnd(Stage::Capture); }
+void MetricsCollector::markColorConvertStart() { markStart(Stage::ColorConvert); }
+void MetricsCollector::markColorConvertEnd() { markEnd(Stage::ColorConvert); }
+void MetricsCollector::markEncodeStart() { markStart(Stage::Encode); }
+void MetricsCollector::markEncodeEnd() { markEnd(Stage::Encode); }
+void MetricsCollector::markDecodeStart() { markStart(Stage::Decode); }
+void MetricsCollector::markDecodeEnd() { markEnd(Stage::Decode); }
+void MetricsCollector::markRenderStart() { markStart(Stage::Render); }
+void MetricsCollector::markRenderEnd() { markEnd(Stage::Render); }
+
+void MetricsCollector::markNetworkSendStart() {
+    networkSendStartNs_.store(nowNs(), std::memory_order_relaxed);
 }
 
-void MetricsCollector::markColorConvertEnd() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - colorConvertStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    colorConvertTimesUs_.push_back(static_cast<double>(us));
-    if (colorConvertTimesUs_.size() > kWindowSize) {
-        colorConvertTimesUs_.pop_front();
+void MetricsCollector::markNetworkReceiveEnd() {
+    const int64_t start = networkSendStartNs_.load(std::memory_order_relaxed);
+    if (start != 0) {
+        recordStageTime(Stage::Network, static_cast<uint64_t>(std::max<int64_t>(0, nowNs() - start)));
     }
 }
 
-void MetricsCollector::markEncodeStart() {
+void MetricsCollector::recordFrameSize(size_t bytes) {
+    auto& counters = local();
+    bump(counters.frameBytes, bytes);
+    bump(counters.frameSizes, 1);
+}
+
+void MetricsCollector::recordFrameDropped() {
+    bump(local().framesDropped, 1);
+}
+
+void MetricsCollector::recordBytesSent(size_t bytes) {
+    bump(local().bytesSent, bytes);
+}
+
+// ========== ESTADO (bajo mutex, fuera del hot path) ==========
+
+void MetricsCollector::recordEncoderSpeed(int cpuUsed, uint32_t threads, uint32_t tokenPartitions, double utilisation) {
     std::lock_guard<std::mutex> lock(mutex_);
-    encodeStart_ = std::chrono::steady_clock::now();
+    currentMetrics_.encoderCpuUsed = cpuUsed;
+    currentMetrics_.encoderThreads = threads;
+    currentMetrics_.encoderTokenPartitions = tokenPartitions;
+    currentMetrics_.encoderUtilisation = utilisation;
 }
 
-void MetricsCollector::markEncodeEnd() {
+void MetricsCollector::recordContentProfile(uint8_t profile) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - encodeStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    encodeTimesUs_.push_back(static_cast<double>(us));
-    if (encodeTimesUs_.size() > kWindowSize) {
-        encodeTimesUs_.pop_front();
+    currentMetrics_.contentProfile = profile;
+}
+
+void MetricsCollector::addContentProfileUsage(uint8_t profile, double seconds, uint64_t bytes) {
+    if (profile >= PipelineMetrics::kContentProfiles) {
+        return;
     }
-    
-    currentMetrics_.totalFramesEncoded++;
+    std::lock_guard<std::mutex> lock(mutex_);
+    currentMetrics_.contentProfileSeconds[profile] += seconds;
+    currentMetrics_.contentProfileBytes[profile] += bytes;
 }
 
-void MetricsCollector::markNetworkSendStart() {
+void MetricsCollector::recordDecodeQueueDepth(uint32_t depth) {
     std::lock_guard<std::mutex> lock(mutex_);
-    networkSendStart_ = std::chrono::steady_clock::now();
+    currentMetrics_.decodeQueueDepth = depth;
+    currentMetrics_.maxDecodeQueueDepth = std::max(currentMetrics_.maxDecodeQueueDepth, depth);
 }
 
-void MetricsCollector::markNetworkReceiveEnd() {
+void MetricsCollector::recordFramesNotPresented(uint32_t count) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - networkSendStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    networkTimesUs_.push_back(static_cast<double>(us));
-    if (networkTimesUs_.size() > kWindowSize) {
-        networkTimesUs_.pop_front();
-    }
+    currentMetrics_.framesDecodedNotPresented += count;
 }
 
-void MetricsCollector::markDecodeStart() {
+void MetricsCollector::recordDecodeQueueOverflow() {
     std::lock_guard<std::mutex> lock(mutex_);
-    decodeStart_ = std::chrono::steady_clock::now();
+    currentMetrics_.decodeQueueOverflows++;
 }
 
-void MetricsCollector::markDecodeEnd() {
+void MetricsCollector::recordViewerJoin(double timeToFirstFrameMs, bool fromGopCache) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - decodeStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    decodeTimesUs_.push_back(static_cast<double>(us));
-    if (decodeTimesUs_.size() > kWindowSize) {
-        decodeTimesUs_.pop_front();
-    }
+    auto& joins = fromGopCache ? currentMetrics_.gopCacheJoins : currentMetrics_.keyframeJoins;
+    auto& avgMs = fromGopCache ? currentMetrics_.avgGopCacheJoinMs : currentMetrics_.avgKeyframeJoinMs;
+    ++joins;
+    avgMs += (timeToFirstFrameMs - avgMs) / static_cast<double>(joins);
 }
 
-void MetricsCollector::markRenderStart() {
+void MetricsCollector::recordSimulcastLayer(uint8_t layer, uint32_t width, uint32_t height,
+                                            double avgEncodeUs, double kbps, uint32_t viewers) {
+    if (layer >= PipelineMetrics::kSimulcastLayers) {
+        return;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
-    renderStart_ = std::chrono::steady_clock::now();
+    currentMetrics_.simulcastWidth[layer] = width;
+    currentMetrics_.simulcastHeight[layer] = height;
+    currentMetrics_.simulcastEncodeUs[layer] = avgEncodeUs;
+    currentMetrics_.simulcastKbps[layer] = kbps;
+    currentMetrics_.simulcastViewers[layer] = viewers;
 }
 
-void MetricsCollector::markRenderEnd() {
+void MetricsCollector::recordSimulcastSwitch() {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto duration = std::chrono::steady_clock::now() - renderStart_;
-    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    
-    renderTimesUs_.push_back(static_cast<double>(us));
-    if (renderTimesUs_.size() > kWindowSize) {
-        renderTimesUs_.pop_front();
+    currentMetrics_.simulcastSwitches++;
+}
+
+// ========== LECTURA: FUSIÓN Y VENTANAS ==========
+
+void MetricsCollector::snapshot(Snapshot& out) const {
+    out = Snapshot{};
+    out.time = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    for (const auto& counters : threads_) {
+        for (size_t stage = 0; stage < kStageCount; ++stage) {
+            auto& histogram = out.stages[stage];
+            for (size_t bucket = 0; bucket < histogram::kBuckets; ++bucket) {
+                if (const uint64_t count = counters->buckets[stage][bucket].load(std::memory_order_relaxed)) {
+                    histogram.addBucket(bucket, count);
+                }
+            }
+            histogram.addSum(counters->sumNs[stage].load(std::memory_order_relaxed));
+        }
+        out.frameBytes += counters->frameBytes.load(std::memory_order_relaxed);
+        out.frameSizes += counters->frameSizes.load(std::memory_order_relaxed);
+        out.framesDropped += counters->framesDropped.load(std::memory_order_relaxed);
+        out.bytesSent += counters->bytesSent.load(std::memory_order_relaxed);
     }
 }
 
-void MetricsCollector::recordFrameSize(size_t bytes) {
+void MetricsCollector::setWindows(std::vector<std::chrono::milliseconds> windows) {
+    windows.erase(std::remove_if(windows.begin(), windows.end(),
+        [](std::chrono::milliseconds window) { return window.count() <= 0; }), windows.end());
+    std::sort(windows.begin(), windows.end());
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+    if (windows.empty()) {
+        windows.push_back(std::chrono::seconds(1));
+    }
+
+    Snapshot current;
+    snapshot(current);
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    frameSizes_.push_back(bytes);
-    if (frameSizes_.size() > kWindowSize) {
-        frameSizes_.pop_front();
+    windows_.clear();
+    for (const auto length : windows) {
+        Window window;
+        window.length = length;
+        window.checkpoints.push_back(current);
+        windows_.push_back(std::move(window));
     }
-    
-    currentMetrics_.totalBytesTransferred += bytes;
-    updateAverages();
 }
 
-void MetricsCollector::recordFrameDropped() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    currentMetrics_.totalFramesDropped++;
+// Sin hilo propio: los checkpoints se toman al leer (el overlay y los logs
+// leen al menos una vez por segundo)
+void MetricsCollector::updateWindows(const Snapshot& current) const {
+    for (auto& window : windows_) {
+        const auto spacing = std::max<std::chrono::steady_clock::duration>(
+            window.length / kCheckpointsPerWindow, std::chrono::milliseconds(1));
+        if (window.checkpoints.empty() || current.time - window.checkpoints.back().time >= spacing) {
+            window.checkpoints.push_back(current);
+        }
+        while (window.checkpoints.size() >= 2 && window.checkpoints[1].time <= current.time - window.length) {
+            window.checkpoints.pop_front();
+        }
+    }
 }
 
-void MetricsCollector::updateAverages() {
-    // Calculate averages
-    auto calcAvg = [](const std::deque<double>& data) -> double {
-        if (data.empty()) return 0;
-        return std::accumulate(data.begin(), data.end(), 0.0) / data.size();
+void MetricsCollector::fillWindowMetrics(PipelineMetrics& metrics, const Snapshot& current) const {
+    const auto since = [](uint64_t now, uint64_t before) { return now - std::min(now, before); };
+    const auto stageCount = [](const Snapshot& snapshot, Stage stage) {
+        return snapshot.stages[static_cast<size_t>(stage)].count();
     };
-    
-    currentMetrics_.avgCaptureTimeUs = calcAvg(captureTimesUs_);
-    currentMetrics_.avgColorConvertTimeUs = calcAvg(colorConvertTimesUs_);
-    currentMetrics_.avgEncodeTimeUs = calcAvg(encodeTimesUs_);
-    currentMetrics_.avgNetworkTimeUs = calcAvg(networkTimesUs_);
-    currentMetrics_.avgDecodeTimeUs = calcAvg(decodeTimesUs_);
-    currentMetrics_.avgRenderTimeUs = calcAvg(renderTimesUs_);
-    
-    // Total latency
-    currentMetrics_.avgTotalLatencyMs = (
-        currentMetrics_.avgCaptureTimeUs +
-        currentMetrics_.avgColorConvertTimeUs +
-        currentMetrics_.avgEncodeTimeUs +
-        currentMetrics_.avgNetworkTimeUs +
-        currentMetrics_.avgDecodeTimeUs +
-        currentMetrics_.avgRenderTimeUs
-    ) / 1000.0;
-    
-    // Frame size average
-    if (!frameSizes_.empty()) {
-        double sum = 0;
-        for (auto s : frameSizes_) sum += static_cast<double>(s);
-        currentMetrics_.avgFrameSizeBytes = sum / frameSizes_.size();
-    }
-    
-    // FPS calculation
-    if (frameTimestamps_.size() >= 2) {
-        auto duration = frameTimestamps_.back() - frameTimestamps_.front();
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-        if (ms > 0) {
-            currentMetrics_.avgFps = (frameTimestamps_.size() - 1) * 1000.0 / ms;
+    metrics.totalFramesCaptured = since(stageCount(current, Stage::Capture), stageCount(*baseline_, Stage::Capture));
+    metrics.totalFramesEncoded = since(stageCount(current, Stage::Encode), stageCount(*baseline_, Stage::Encode));
+    metrics.totalFramesDropped = since(current.framesDropped, baseline_->framesDropped);
+    metrics.totalBytesTransferred = since(current.frameBytes, baseline_->frameBytes);
+    metrics.totalBytesSent = since(current.bytesSent, baseline_->bytesSent);
+
+    metrics.latencyWindows.clear();
+    for (const auto& window : windows_) {
+        const Snapshot& base = window.checkpoints.front();
+        PipelineMetrics::LatencyWindow latency;
+        latency.window = window.length;
+        latency.covered = std::chrono::duration_cast<std::chrono::milliseconds>(current.time - base.time);
+        for (size_t stage = 0; stage < kStageCount; ++stage) {
+            LatencyHistogram histogram = current.stages[stage];
+            histogram.subtract(base.stages[stage]);
+            latency.stages[stage] = toPercentiles(histogram);
+        }
+        metrics.latencyWindows.push_back(latency);
+
+        // Promedios, FPS y bitrate: sobre la ventana más corta
+        if (metrics.latencyWindows.size() > 1) {
+            continue;
+        }
+        const auto& stages = latency.stages;
+        metrics.avgCaptureTimeUs = stages[static_cast<size_t>(Stage::Capture)].meanUs;
+        metrics.avgColorConvertTimeUs = stages[static_cast<size_t>(Stage::ColorConvert)].meanUs;
+        metrics.avgEncodeTimeUs = stages[static_cast<size_t>(Stage::Encode)].meanUs;
+        metrics.avgNetworkTimeUs = stages[static_cast<size_t>(Stage::Network)].meanUs;
+        metrics.avgDecodeTimeUs = stages[static_cast<size_t>(Stage::Decode)].meanUs;
+        metrics.avgRenderTimeUs = stages[static_cast<size_t>(Stage::Render)].meanUs;
+        metrics.avgTotalLatencyMs = (metrics.avgCaptureTimeUs + metrics.avgColorConvertTimeUs +
+                                     metrics.avgEncodeTimeUs + metrics.avgNetworkTimeUs +
+                                     metrics.avgDecodeTimeUs + metrics.avgRenderTimeUs) / 1000.0;
+
+        const uint64_t frames = since(current.frameSizes, base.frameSizes);
+        const uint64_t bytes = since(current.frameBytes, base.frameBytes);
+        if (frames > 0) {
+            metrics.avgFrameSizeBytes = static_cast<double>(bytes) / static_cast<double>(frames);
+        }
+        const double seconds = std::chrono::duration<double>(current.time - base.time).count();
+        if (seconds > 0) {
+            metrics.avgFps = static_cast<double>(stages[static_cast<size_t>(Stage::Capture)].count) / seconds;
+            metrics.avgBitrateKbps = static_cast<double>(bytes) * 8.0 / seconds / 1000.0;
         }
     }
-    
-    // Bitrate
-    if (currentMetrics_.avgFps > 0 && currentMetrics_.avgFrameSizeBytes > 0) {
-        currentMetrics_.avgBitrateKbps = 
-            (currentMetrics_.avgFrameSizeBytes * 8 * currentMetrics_.avgFps) / 1000.0;
+}
+
+LatencyPercentiles MetricsCollector::stageLatency(Stage stage, size_t window) const {
+    const PipelineMetrics metrics = getMetrics();
+    if (window >= metrics.latencyWindows.size()) {
+        return {};
     }
+    return metrics.latencyWindows[window].stages[static_cast<size_t>(stage)];
 }
 
 PipelineMetrics MetricsCollector::getMetrics() const {
+    Snapshot current;
+    snapshot(current);
     std::lock_guard<std::mutex> lock(mutex_);
-    return currentMetrics_;
+    updateWindows(current);
+    PipelineMetrics metrics = currentMetrics_;
+    fillWindowMetrics(metrics, current);
+    return metrics;
 }
 
 std::string MetricsCollector::formatMetrics() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const PipelineMetrics metrics = getMetrics();
     
     std::ostringstream ss;
     ss << std::fixed << std::setprecision(1);
     
     ss << "=== VicViewer Performance Metrics ===\n";
-    ss << "FPS: " << currentMetrics_.avgFps << "\n";
-    ss << "Total Latency: " << currentMetrics_.avgTotalLatencyMs << " ms\n";
+    ss << "FPS: " << metrics.avgFps << "\n";
+    ss << "Total Latency: " << metrics.avgTotalLatencyMs << " ms\n";
     ss << "\n--- Pipeline Breakdown ---\n";
-    ss << "  Capture:      " << (currentMetrics_.avgCaptureTimeUs / 1000.0) << " ms\n";
-    ss << "  Color Conv:   " << (currentMetrics_.avgColorConvertTimeUs / 1000.0) << " ms\n";
-    ss << "  Encode:       " << (currentMetrics_.avgEncodeTimeUs / 1000.0) << " ms\n";
-    ss << "  Network:      " << (currentMetrics_.avgNetworkTimeUs / 1000.0) << " ms\n";
-    ss << "  Decode:       " << (currentMetrics_.avgDecodeTimeUs / 1000.0) << " ms\n";
-    ss << "  Render:       " << (currentMetrics_.avgRenderTimeUs / 1000.0) << " ms\n";
+    ss << "  Capture:      " << (metrics.avgCaptureTimeUs / 1000.0) << " ms\n";
+    ss << "  Color Conv:   " << (metrics.avgColorConvertTimeUs / 1000.0) << " ms\n";
+    ss << "  Encode:       " << (metrics.avgEncodeTimeUs / 1000.0) << " ms\n";
+    ss << "  Network:      " << (metrics.avgNetworkTimeUs / 1000.0) << " ms\n";
+    ss << "  Decode:       " << (metrics.avgDecodeTimeUs / 1000.0) << " ms\n";
+    ss << "  Render:       " << (metrics.avgRenderTimeUs / 1000.0) << " ms\n";
+    // Percentiles por etapa en cada ventana (la cola que el promedio esconde)
+    for (const auto& window : metrics.latencyWindows) {
+        bool header = false;
+        for (size_t stage = 0; stage < PipelineMetrics::kStages; ++stage) {
+            const auto& latency = window.stages[stage];
+            if (latency.count == 0) {
+                continue;
+            }
+            if (!header) {
+                ss << "\n--- Latency " << (window.window.count() / 1000.0) << " s";
+                // Sin lecturas en un rato la ventana abarca todo el hueco
+                if (window.covered > window.window * 2) {
+                    ss << ", covering " << (window.covered.count() / 1000.0) << " s";
+                }
+                ss << " (ms: p50 / p90 / p99 / p99.9 / max) ---\n";
+                header = true;
+            }
+            ss << "  " << std::left << std::setw(14) << (std::string(kStageNames[stage]) + ":") << std::right
+               << std::setprecision(2)
+               << latency.p50Us / 1000.0 << " / " << latency.p90Us / 1000.0 << " / "
+               << latency.p99Us / 1000.0 << " / " << latency.p999Us / 1000.0 << " / "
+               << latency.maxUs / 1000.0 << " (" << latency.count << ")\n"
+               << std::setprecision(1);
+        }
+    }
     ss << "\n--- Bandwidth ---\n";
-    ss << "  Avg Frame:    " << (currentMetrics_.avgFrameSizeBytes / 1024.0) << " KB\n";
-    ss << "  Bitrate:      " << currentMetrics_.avgBitrateKbps << " kbps\n";
+    ss << "  Avg Frame:    " << (metrics.avgFrameSizeBytes / 1024.0) << " KB\n";
+    ss << "  Bitrate:      " << metrics.avgBitrateKbps << " kbps\n";
+    if (metrics.encoderThreads > 0) {
+        ss << "\n--- Encoder Governor ---\n";
+        ss << "  CPU Used:     " << metrics.encoderCpuUsed << "\n";
+        ss << "  Threads:      " << metrics.encoderThreads << "\n";
+        ss << "  Partitions:   " << (1u << metrics.encoderTokenPartitions) << "\n";
+        ss << "  Budget Use:   " << (metrics.encoderUtilisation * 100.0) << " %\n";
+    }
+    
+    // Bitrate de cada perfil. No se comparan entre sí: cada uno mide otro
+    // contenido, no el mismo contenido con otro tuning
+    double totalSeconds = 0;
+    for (double seconds : metrics.contentProfileSeconds) totalSeconds += seconds;
+    if (totalSeconds > 0) {
+        static constexpr const char* kProfileNames[PipelineMetrics::kContentProfiles] = {"Text", "Video", "Static"};
+        auto profileKbps = [&](size_t profile) {
+            const double seconds = metrics.contentProfileSeconds[profile];
+            return seconds > 0 ? metrics.contentProfileBytes[profile] * 8 / seconds / 1000.0 : 0.0;
+        };
+        ss << "\n--- Content Profile: " << kProfileNames[metrics.contentProfile % PipelineMetrics::kContentProfiles] << " ---\n";
+        for (size_t profile = 0; profile < PipelineMetrics::kContentProfiles; ++profile) {
+            const double seconds = metrics.contentProfileSeconds[profile];
+            ss << "  " << std::left << std::setw(14) << (std::string(kProfileNames[profile]) + ":") << std::right
+               << (seconds * 100.0 / totalSeconds) << " %, " << profileKbps(profile) << " kbps\n";
+        }
+    }
+    if (metrics.maxDecodeQueueDepth > 0) {
+        ss << "\n--- Decode Queue ---\n";
+        ss << "  Depth:        " << metrics.decodeQueueDepth << " (max " << metrics.maxDecodeQueueDepth << ")\n";
+        ss << "  Not Shown:    " << metrics.framesDecodedNotPresented << "\n";
+        ss << "  Overflows:    " << metrics.decodeQueueOverflows << "\n";
+    }
+    if (metrics.gopCacheJoins + metrics.keyframeJoins > 0) {
+        ss << "\n--- Viewer Joins ---\n";
+        ss << "  GOP Cache:    " << metrics.gopCacheJoins << " (avg " << metrics.avgGopCacheJoinMs << " ms)\n";
+        ss << "  Keyframe:     " << metrics.keyframeJoins << " (avg " << metrics.avgKeyframeJoinMs << " ms)\n";
+    }
+    if (metrics.simulcastWidth[1] > 0) {
+        ss << "\n--- Simulcast ---\n";
+        for (size_t layer = 0; layer < PipelineMetrics::kSimulcastLayers; ++layer) {
+            ss << "  Layer " << layer << ":      " << metrics.simulcastWidth[layer] << "x"
+               << metrics.simulcastHeight[layer] << ", encode "
+               << (metrics.simulcastEncodeUs[layer] / 1000.0) << " ms, "
+               << metrics.simulcastKbps[layer] << " kbps, "
+               << metrics.simulcastViewers[layer] << " viewers\n";
+        }
+        ss << "  Switches:     " << metrics.simulcastSwitches << "\n";
+    }
     ss << "\n--- Counters ---\n";
-    ss << "  Captured:     " << currentMetrics_.totalFramesCaptured << "\n";
-    ss << "  Encoded:      " << currentMetrics_.totalFramesEncoded << "\n";
-    ss << "  Dropped:      " << currentMetrics_.totalFramesDropped << "\n";
-    ss << "  Total Data:   " << (currentMetrics_.totalBytesTransferred / (1024.0 * 1024.0)) << " MB\n";
+    ss << "  Captured:     " << metrics.totalFramesCaptured << "\n";
+    ss << "  Encoded:      " << metrics.totalFramesEncoded << "\n";
+    ss << "  Dropped:      " << metrics.totalFramesDropped << "\n";
+    ss << "  Total Data:   " << (metrics.totalBytesTransferred / (1024.0 * 1024.0)) << " MB\n";
+    ss << "  Sent:         " << (metrics.totalBytesSent / (1024.0 * 1024.0)) << " MB\n";
     
     return ss.str();
 }
 
 void MetricsCollector::reset() {
+    // Los contadores de los hilos no se tocan (solo los escribe su dueño):
+    // el reset toma el estado actual como nueva base
+    Snapshot current;
+    snapshot(current);
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    captureTimesUs_.clear();
-    colorConvertTimesUs_.clear();
-    encodeTimesUs_.clear();
-    networkTimesUs_.clear();
-    decodeTimesUs_.clear();
-    renderTimesUs_.clear();
-    frameSizes_.clear();
-    frameTimestamps_.clear();
-    
+    *baseline_ = current;
+    for (auto& window : windows_) {
+        window.checkpoints.assign(1, current);
+    }
     currentMetrics_ = PipelineMetrics{};
 }
 
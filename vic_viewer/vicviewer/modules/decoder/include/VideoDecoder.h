@@ -3,19 +3,99 @@
 #include "EncodedFrame.h"
 #include "DesktopFrame.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <memory>
+#include <vector>
 
 namespace vic::decoder {
 
+/// Referencias que el decoder conserva intactas tras descartar frames
+struct RecoveryState {
+    uint32_t lastFrameId{};       // Último frame decodificado correctamente
+    uint32_t goldenFrameId{};     // 0 = no hay golden utilizable
+    uint32_t altRefFrameId{};
+};
+
+/// Lo que el renderer necesita de un frame decodificado, sin los pixels
+struct DecodedFrameInfo {
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t originalWidth{};     // Resolución del host (coordenadas de mouse)
+    uint32_t originalHeight{};
+    uint64_t timestamp{};
+};
+
+/// Buffer BGRA prestado por el renderer (stride en bytes, >= width * 4)
+struct FrameBuffer {
+    uint8_t* data{};
+    size_t stride{};
+};
+
+/// Destino de decodeInto(): el renderer presta su propio buffer (DIB section,
+/// textura de staging mapeada o un frame de un pool) y el decoder convierte
+/// directo ahí, sin el DesktopFrame intermedio ni la copia al presentarlo
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    /// Buffer para un frame de info.width x info.height. data = nullptr descarta el frame
+    virtual FrameBuffer acquire(const DecodedFrameInfo& info) = 0;
+
+    /// El buffer de acquire() quedó escrito completo: presentarlo
+    virtual void commit(const DecodedFrameInfo& info) = 0;
+
+    /// El buffer de acquire() quedó a medias (falló la conversión): no presentarlo
+    virtual void abort() {}
+};
+
 class VideoDecoder {
 public:
     virtual ~VideoDecoder() = default;
 
     virtual bool configure(uint32_t width, uint32_t height) = 0;
     virtual std::optional<vic::capture::DesktopFrame> decode(const vic::encoder::EncodedFrame& frame) = 0;
+
+    /// Como decode() pero escribiendo los pixels en el buffer de `sink`.
+    /// true si se presentó un frame (commit). La implementación base pasa por
+    /// decode() y copia; los decoders libvpx convierten directo al sink
+    virtual bool decodeInto(const vic::encoder::EncodedFrame& frame, FrameSink& sink);
+
+    /// Decodificar sin convertir a BGRA: avanza las referencias y deja la imagen
+    /// para convertLatest(). Para frames que no se van a mostrar porque ya hay
+    /// uno más nuevo (ráfagas): true si quedó una imagen decodificada. Un frame
+    /// descartado sin llegar a decodificarse (referencias perdidas) deja la
+    /// imagen pendiente anterior, si el decoder la puede conservar
+    virtual bool decodeOnly(const vic::encoder::EncodedFrame& frame) = 0;
+
+    /// Convertir al sink la imagen del último decodeOnly() (una sola vez).
+    /// false si no hay imagen pendiente o el último frame no decodificó
+    virtual bool convertLatest(FrameSink& sink) = 0;
+
+    /// Tope de hilos de decode (0 = según cores y resolución). Se aplica en el
+    /// próximo configure(); el decoder por tiles lo usa para repartir los cores
+    virtual void setMaxThreads(uint32_t threads) { (void)threads; }
+
+    /// Si se descartaron frames por referencias perdidas (decode() no los
+    /// decodifica para no mostrar basura), lo que hay que reportar al host para
+    /// que envíe un frame de recuperación. std::nullopt = referencias al día
+    [[nodiscard]] virtual std::optional<RecoveryState> recoveryState() const { return std::nullopt; }
 };
 
 std::unique_ptr<VideoDecoder> createVp8Decoder();
 
+/// Decoder VP9 (para streams de createVp9Encoder)
+std::unique_ptr<VideoDecoder> createVp9Decoder();
+
+/// Codecs que este viewer puede decodificar, en orden de preferencia
+std::vector<vic::encoder::CodecCapability> decoderCapabilities();
+
+/// Decoder para el codec de un stream (EncodedFrame::codec). nullptr si no hay
+std::unique_ptr<VideoDecoder> createDecoder(vic::encoder::VideoCodec codec);
+
+/// Decoder para frames de createTiledEncoder (EncodedFrame::tiles no vacío):
+/// decodifica los tiles en paralelo y los une en un solo frame
+std::unique_ptr<VideoDecoder> createTiledDecoder(vic::encoder::VideoCodec codec);
+
 } // namespace vic::decoder
@@ -1,4 +1,5 @@
 #include "VideoDecoder.h"
+#include "VpxReferenceFrame.h"
 
 #include "Logger.h"
 
@@ -10,23 +11,40 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace vic::decoder {
 
 namespace {
 
+// Hilos de decode: uno por cada 640x360 de frame, hasta los cores disponibles.
+// VP8 reparte filas de macrobloques (y las particiones de tokens del encoder);
+// VP9 reparte columnas de tiles y filas
+constexpr uint32_t kPixelsPerThreadHint = 640u * 360u;
+constexpr uint32_t kMaxDecoderThreads = 8;
+
+enum class VpxCodec {
+    Vp8,
+    Vp9
+};
+
 // ============================================================================
-// LibvpxDecoder - VP8 decoder optimizado con libyuv SIMD y buffer reuse
+// LibvpxDecoder - VP8/VP9 decoder optimizado con libyuv SIMD y buffer reuse
 // Optimizaciones:
 //   1. libyuv::I420ToARGB para conversión I420→BGRA (60-70% más rápido)
 //   2. Buffer BGRA reutilizable (evita allocations por frame)
 //   3. Evita resize() si el tamaño no cambia
+//   4. Multi-hilo según cores y resolución (clientes livianos a 1080p)
 // ============================================================================
 class LibvpxDecoder final : public VideoDecoder {
 public:
-    LibvpxDecoder() = default;
+    explicit LibvpxDecoder(VpxCodec codec)
+        : codecKind_(codec), name_(codec == VpxCodec::Vp9 ? "VP9" : "VP8") {}
     ~LibvpxDecoder() override {
         shutdown();
     }
@@ -51,35 +69,138 @@ public:
         const size_t bufferSize = static_cast<size_t>(width) * height * 4;
         bgraBuffer_.resize(bufferSize);
         
-        const vpx_codec_iface_t* iface = vpx_codec_vp8_dx();
-        if (vpx_codec_dec_init(&codec_, iface, nullptr, 0) != VPX_CODEC_OK) {
-            logging::global().log(logging::Logger::Level::Error, "Failed to initialize VP8 decoder context");
+        const vpx_codec_iface_t* iface = codecKind_ == VpxCodec::Vp9 ? vpx_codec_vp9_dx() : vpx_codec_vp8_dx();
+        vpx_codec_dec_cfg_t config{};
+        config.threads = decodeThreads();
+        config.w = width;
+        config.h = height;
+        if (vpx_codec_dec_init(&codec_, iface, &config, 0) != VPX_CODEC_OK) {
+            logging::global().log(logging::Logger::Level::Error, "Failed to initialize " + name_ + " decoder context");
             return false;
         }
         initialized_ = true;
+        if (codecKind_ == VpxCodec::Vp9 && config.threads > 1) {
+            vpx_codec_control(&codec_, VP9D_SET_ROW_MT, 1);
+        }
         
         logging::global().log(logging::Logger::Level::Info, 
-            "VP8 decoder configurado: " + std::to_string(width) + "x" + std::to_string(height) + 
-            " con libyuv SIMD y buffer reutilizable");
+            name_ + " decoder configurado: " + std::to_string(width) + "x" + std::to_string(height) + 
+            ", " + std::to_string(config.threads) + " hilos, con libyuv SIMD y buffer reutilizable");
         return true;
     }
 
     std::optional<vic::capture::DesktopFrame> decode(const vic::encoder::EncodedFrame& frame) override {
+        if (!decodeOnly(frame)) {
+            return std::nullopt;
+        }
+
+        // ========== OPTIMIZACIÓN: Reutilizar buffer ==========
+        // Conversión al buffer reutilizable y copia al frame de salida
+        // (decodeInto() evita esta copia escribiendo en el buffer del renderer)
+        const vpx_image_t* image = std::exchange(latestImage_, nullptr);
+        if (!convertImage(image, bgraBuffer_.data(), static_cast<size_t>(frame.width) * 4, frame.width, frame.height)) {
+            return std::nullopt;
+        }
+
+        vic::capture::DesktopFrame desktop{};
+        desktop.width = latestInfo_.width;
+        desktop.height = latestInfo_.height;
+        // Copiar dimensiones originales para cálculo correcto de coordenadas de mouse
+        desktop.originalWidth = latestInfo_.originalWidth;
+        desktop.originalHeight = latestInfo_.originalHeight;
+        desktop.timestamp = latestInfo_.timestamp;
+        desktop.bgraData.assign(bgraBuffer_.begin(), bgraBuffer_.end());
+
+        return desktop;
+    }
+
+    bool decodeInto(const vic::encoder::EncodedFrame& frame, FrameSink& sink) override {
+        return decodeOnly(frame) && convertLatest(sink);
+    }
+
+    bool decodeOnly(const vic::encoder::EncodedFrame& frame) override {
+        const vpx_image_t* image = decodeImage(frame);
+        if (!image) {
+            return false;
+        }
+        latestImage_ = image;
+        latestInfo_ = frameInfo(frame);
+        return true;
+    }
+
+    // ========== I420→BGRA directo al buffer del renderer ==========
+    bool convertLatest(FrameSink& sink) override {
+        const vpx_image_t* image = std::exchange(latestImage_, nullptr);
+        if (!image) {
+            return false;
+        }
+        const FrameBuffer target = sink.acquire(latestInfo_);
+        if (!target.data) {
+            return false;
+        }
+        if (target.stride < static_cast<size_t>(latestInfo_.width) * 4 ||
+            !convertImage(image, target.data, target.stride, latestInfo_.width, latestInfo_.height)) {
+            sink.abort();
+            return false;
+        }
+        sink.commit(latestInfo_);
+        return true;
+    }
+
+    std::optional<RecoveryState> recoveryState() const override {
+        if (!needsRecovery_) {
+            return std::nullopt;
+        }
+        return RecoveryState{lastFrameId_, goldenFrameId_, altRefFrameId_};
+    }
+
+    void setMaxThreads(uint32_t threads) override {
+        maxThreads_ = threads;
+    }
+
+private:
+    // Decodifica a I420 y avanza las referencias. nullptr si no hay imagen
+    // (referencias perdidas, error o el decoder no entregó frame)
+    const vpx_image_t* decodeImage(const vic::encoder::EncodedFrame& frame) {
         if (!initialized_ || frame.width != width_ || frame.height != height_) {
             if (!configure(frame.width, frame.height)) {
-                return std::nullopt;
+                return nullptr;
             }
         }
 
         if (frame.payload.empty()) {
-            return std::nullopt;
+            return nullptr;
+        }
+
+        // ========== Referencias: no decodificar sobre referencias perdidas ==========
+        if (!hasValidReferences(frame)) {
+            if (!needsRecovery_) {
+                logging::global().log(logging::Logger::Level::Warning,
+                    name_ + ": frame " + std::to_string(frame.frameId) + " referencia " +
+                    std::to_string(frame.referenceFrameId) + " y el último decodificado es " +
+                    std::to_string(lastFrameId_) + " - esperando recuperación");
+            }
+            needsRecovery_ = true;
+            return nullptr;
+        }
+
+        // La imagen anterior deja de ser válida en cuanto libvpx toca sus
+        // buffers (copy-rects sobre LAST o decodificar otro frame)
+        latestImage_ = nullptr;
+
+        // Mismos copy-rects que aplicó el encoder sobre su referencia LAST
+        // Copy-rects solo existen en VP8 (el encoder VP9 no los emite)
+        if (codecKind_ == VpxCodec::Vp8 && !frame.keyFrame && !frame.copyRects.empty() &&
+            !reference_.applyCopyRects(&codec_, width_, height_, frame.copyRects)) {
+            logging::global().log(logging::Logger::Level::Warning,
+                name_ + ": no se pudo aplicar copy-rects a la referencia del decoder");
         }
 
-        // Decodificar VP8 a I420
+        // Decodificar a I420
         if (vpx_codec_decode(&codec_, frame.payload.data(), static_cast<unsigned int>(frame.payload.size()), nullptr, 0) != VPX_CODEC_OK) {
             const char* err = vpx_codec_error(&codec_);
             const char* detail = vpx_codec_error_detail(&codec_);
-            std::string msg = std::string("VP8 decode failed: ") + (err ? err : "<none>");
+            std::string msg = name_ + " decode failed: " + (err ? err : "<none>");
             if (detail && *detail) {
                 msg += " detail=";
                 msg += detail;
@@ -93,24 +214,28 @@ public:
                 msg.push_back(hex[b & 0xF]);
             }
             logging::global().log(logging::Logger::Level::Error, msg);
-            return std::nullopt;
+            // Las referencias pudieron quedar a medio escribir: solo sirve un keyframe
+            invalidateReferences();
+            return nullptr;
         }
+        trackReferences(frame);
 
         vpx_codec_iter_t iter = nullptr;
         vpx_image_t* image = vpx_codec_get_frame(&codec_, &iter);
         if (!image) {
-            return std::nullopt;
+            return nullptr;
         }
 
         if (image->fmt != VPX_IMG_FMT_I420) {
-            logging::global().log(logging::Logger::Level::Error, "Unexpected VP8 image format");
-            return std::nullopt;
+            logging::global().log(logging::Logger::Level::Error, "Unexpected " + name_ + " image format");
+            return nullptr;
         }
+        return image;
+    }
 
-        // ========== OPTIMIZACIÓN: libyuv I420→BGRA (SIMD) ==========
-        // libyuv usa SIMD (SSE2/AVX2/NEON) para conversión ~60-70% más rápida
-        const int dstStride = static_cast<int>(frame.width * 4);
-        
+    // ========== OPTIMIZACIÓN: libyuv I420→BGRA (SIMD) ==========
+    // libyuv usa SIMD (SSE2/AVX2/NEON) para conversión ~60-70% más rápida
+    bool convertImage(const vpx_image_t* image, uint8_t* dst, size_t dstStride, uint32_t width, uint32_t height) const {
         // NOTA: En libyuv, "ARGB" significa bytes en orden [B,G,R,A] en memoria
         // Esto es exactamente lo que Windows llama "BGRA"
         // Por eso I420ToARGB es la función correcta para Windows
@@ -118,57 +243,170 @@ public:
             image->planes[0], image->stride[0],  // Y plane
             image->planes[1], image->stride[1],  // U plane
             image->planes[2], image->stride[2],  // V plane
-            bgraBuffer_.data(), dstStride,       // Destination (Windows BGRA = libyuv ARGB)
-            static_cast<int>(frame.width),
-            static_cast<int>(frame.height)
+            dst, static_cast<int>(dstStride),    // Destination (Windows BGRA = libyuv ARGB)
+            static_cast<int>(width),
+            static_cast<int>(height)
         );
         
         if (result != 0) {
             logging::global().log(logging::Logger::Level::Error, "libyuv::I420ToARGB failed");
-            return std::nullopt;
+            return false;
         }
+        return true;
+    }
 
-        // ========== OPTIMIZACIÓN: Reutilizar buffer ==========
-        // En lugar de crear nuevo vector, movemos el contenido del buffer reutilizable
-        vic::capture::DesktopFrame desktop{};
-        desktop.width = frame.width;
-        desktop.height = frame.height;
-        // Copiar dimensiones originales para cálculo correcto de coordenadas de mouse
-        desktop.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
-        desktop.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
-        desktop.timestamp = frame.timestamp;
-        
-        // Copiar del buffer reutilizable al frame de salida
-        // (el frame de salida será consumido y destruido por el caller)
-        desktop.bgraData.assign(bgraBuffer_.begin(), bgraBuffer_.end());
+    static DecodedFrameInfo frameInfo(const vic::encoder::EncodedFrame& frame) {
+        DecodedFrameInfo info{};
+        info.width = frame.width;
+        info.height = frame.height;
+        info.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
+        info.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
+        info.timestamp = frame.timestamp;
+        return info;
+    }
 
-        return desktop;
+    unsigned int decodeThreads() const {
+        const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        uint32_t threads = std::clamp<uint32_t>((width_ * height_) / kPixelsPerThreadHint, 1,
+                                                std::min(cores, kMaxDecoderThreads));
+        if (maxThreads_ > 0) {
+            threads = std::min(threads, maxThreads_);
+        }
+        return threads;
+    }
+
+    // Un frame es decodificable si todo lo que referencia está en los buffers:
+    // el anterior (con la cadena sin huecos) o, si es de recuperación, el long-term
+    bool hasValidReferences(const vic::encoder::EncodedFrame& frame) const {
+        if (frame.keyFrame || frame.frameId == 0) {
+            return true;
+        }
+        if (frame.referenceFlags & vic::encoder::EncodedFrame::kRecovery) {
+            return frame.referenceFrameId != 0 &&
+                (frame.referenceFrameId == goldenFrameId_ || frame.referenceFrameId == altRefFrameId_);
+        }
+        return !needsRecovery_ && lastFrameId_ != 0 && frame.referenceFrameId == lastFrameId_;
+    }
+
+    void trackReferences(const vic::encoder::EncodedFrame& frame) {
+        if (frame.frameId == 0) {
+            return;
+        }
+        if (needsRecovery_) {
+            logging::global().log(logging::Logger::Level::Info,
+                name_ + ": recuperado en frame " + std::to_string(frame.frameId) +
+                (frame.keyFrame ? " (key)" : " desde long-term " + std::to_string(frame.referenceFrameId)));
+        }
+        needsRecovery_ = false;
+        // Las capas temporales de mejora no actualizan LAST
+        if (frame.keyFrame || frame.temporalLayer == 0) {
+            lastFrameId_ = frame.frameId;
+        }
+        if (frame.keyFrame || (frame.referenceFlags & vic::encoder::EncodedFrame::kRefreshGolden)) {
+            goldenFrameId_ = frame.frameId;
+        }
+        if (frame.keyFrame || (frame.referenceFlags & vic::encoder::EncodedFrame::kRefreshAltRef)) {
+            altRefFrameId_ = frame.frameId;
+        }
+    }
+
+    void invalidateReferences() {
+        lastFrameId_ = goldenFrameId_ = altRefFrameId_ = 0;
+        needsRecovery_ = true;
     }
 
-private:
     void shutdown() {
         if (initialized_) {
             vpx_codec_destroy(&codec_);
             initialized_ = false;
         }
+        latestImage_ = nullptr;
         width_ = height_ = 0;
         bgraBuffer_.clear();
         bgraBuffer_.shrink_to_fit();
+        // Contexto nuevo: hasta el próximo keyframe no hay referencias
+        lastFrameId_ = goldenFrameId_ = altRefFrameId_ = 0;
+        needsRecovery_ = false;
     }
 
+    const VpxCodec codecKind_;
+    const std::string name_;
     vpx_codec_ctx_t codec_{};
     bool initialized_ = false;
     uint32_t width_ = 0;
     uint32_t height_ = 0;
+    uint32_t maxThreads_ = 0;       // 0 = según cores y resolución
+    
+    // Imagen I420 del último decodeOnly() que todavía no se convirtió (es de
+    // libvpx y vale hasta el próximo vpx_codec_decode)
+    const vpx_image_t* latestImage_ = nullptr;
+    DecodedFrameInfo latestInfo_{};
     
     // Buffer BGRA reutilizable - evita allocation por frame
     std::vector<uint8_t> bgraBuffer_;
+    vic::encoder::VpxReferenceFrame reference_;
+
+    // Recuperación de pérdidas: frames que contiene cada buffer de referencia
+    uint32_t lastFrameId_ = 0;
+    uint32_t goldenFrameId_ = 0;
+    uint32_t altRefFrameId_ = 0;
+    bool needsRecovery_ = false;
 };
 
 } // namespace
 
+bool VideoDecoder::decodeInto(const vic::encoder::EncodedFrame& frame, FrameSink& sink) {
+    auto decoded = decode(frame);
+    if (!decoded) {
+        return false;
+    }
+    DecodedFrameInfo info{};
+    info.width = decoded->width;
+    info.height = decoded->height;
+    info.originalWidth = decoded->originalWidth;
+    info.originalHeight = decoded->originalHeight;
+    info.timestamp = decoded->timestamp;
+    const FrameBuffer target = sink.acquire(info);
+    if (!target.data) {
+        return false;
+    }
+    const size_t rowBytes = static_cast<size_t>(decoded->width) * 4;
+    if (target.stride < rowBytes || decoded->bgraData.size() < rowBytes * decoded->height) {
+        sink.abort();
+        return false;
+    }
+    for (uint32_t row = 0; row < decoded->height; ++row) {
+        std::memcpy(target.data + row * target.stride, decoded->bgraData.data() + row * rowBytes, rowBytes);
+    }
+    sink.commit(info);
+    return true;
+}
+
 std::unique_ptr<VideoDecoder> createVp8Decoder() {
-    return std::make_unique<LibvpxDecoder>();
+    return std::make_unique<LibvpxDecoder>(VpxCodec::Vp8);
+}
+
+std::unique_ptr<VideoDecoder> createVp9Decoder() {
+    return std::make_unique<LibvpxDecoder>(VpxCodec::Vp9);
+}
+
+std::vector<vic::encoder::CodecCapability> decoderCapabilities() {
+    return {
+        {vic::encoder::VideoCodec::Vp8, vic::encoder::kProfile0},
+        {vic::encoder::VideoCodec::Vp9, vic::encoder::kProfile0},
+    };
+}
+
+std::unique_ptr<VideoDecoder> createDecoder(vic::encoder::VideoCodec codec) {
+    switch (codec) {
+    case vic::encoder::VideoCodec::Vp8:
+        return createVp8Decoder();
+    case vic::encoder::VideoCodec::Vp9:
+        return createVp9Decoder();
+    case vic::encoder::VideoCodec::H264:
+        break;
+    }
+    return nullptr;
 }
 
 } // namespace vic::decoder
@@ -0,0 +1,253 @@
+#include "VideoDecoder.h"
+#include "Tiling.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vic::decoder {
+
+namespace {
+
+// ============================================================================
+// TiledDecoder - un decoder por tile, decodificados en paralelo y unidos en un
+// buffer BGRA del frame completo. Si un tile no decodifica (referencias
+// perdidas) el frame entero se descarta: mostrar tiles de distintos instantes
+// partiría texto y ventanas en los bordes
+// ============================================================================
+class TiledDecoder final : public VideoDecoder {
+public:
+    explicit TiledDecoder(vic::encoder::VideoCodec codec) : codec_(codec) {}
+
+    bool configure(uint32_t width, uint32_t height) override {
+        if (width == 0 || height == 0) {
+            logging::global().log(logging::Logger::Level::Error, "Decoder configure received invalid dimensions");
+            return false;
+        }
+        width_ = width;
+        height_ = height;
+        bgraBuffer_.assign(static_cast<size_t>(width) * height * 4, 0);
+        return true;
+    }
+
+    std::optional<vic::capture::DesktopFrame> decode(const vic::encoder::EncodedFrame& frame) override {
+        if (!decodeOnly(frame)) {
+            return std::nullopt;
+        }
+        TileSink sink(bgraBuffer_.data(), static_cast<size_t>(width_) * 4, width_, height_);
+        if (!convertLatest(sink)) {
+            return std::nullopt;
+        }
+
+        vic::capture::DesktopFrame desktop{};
+        desktop.width = latestInfo_.width;
+        desktop.height = latestInfo_.height;
+        desktop.originalWidth = latestInfo_.originalWidth;
+        desktop.originalHeight = latestInfo_.originalHeight;
+        desktop.timestamp = latestInfo_.timestamp;
+        desktop.bgraData.assign(bgraBuffer_.begin(), bgraBuffer_.end());
+        return desktop;
+    }
+
+    bool decodeInto(const vic::encoder::EncodedFrame& frame, FrameSink& sink) override {
+        return decodeOnly(frame) && convertLatest(sink);
+    }
+
+    // ========== Decode en paralelo, sin convertir ==========
+    bool decodeOnly(const vic::encoder::EncodedFrame& frame) override {
+        hasLatest_ = false;
+        if (!prepare(frame)) {
+            return false;
+        }
+        std::atomic<bool> failed{false};
+        workers_->run(decoders_.size(), [&](size_t index) {
+            const auto& tile = frame.tiles[index];
+            auto& tileFrame = tileFrames_[index];
+            tileFrame.width = tileFrame.originalWidth = tile.width;
+            tileFrame.height = tileFrame.originalHeight = tile.height;
+            tileFrame.timestamp = frame.timestamp;
+            tileFrame.codec = frame.codec;
+            tileFrame.keyFrame = tile.keyFrame;
+            tileFrame.frameId = tile.frameId;
+            tileFrame.referenceFrameId = tile.referenceFrameId;
+            tileFrame.referenceFlags = tile.referenceFlags;
+            const auto begin = frame.payload.begin() + static_cast<std::ptrdiff_t>(payloadOffsets_[index]);
+            tileFrame.payload.assign(begin, begin + tile.payloadSize);
+
+            if (!decoders_[index]->decodeOnly(tileFrame)) {
+                failed = true;
+            }
+        });
+        if (failed) {
+            return false;
+        }
+        latestInfo_.width = frame.width;
+        latestInfo_.height = frame.height;
+        latestInfo_.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
+        latestInfo_.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
+        latestInfo_.timestamp = frame.timestamp;
+        hasLatest_ = true;
+        return true;
+    }
+
+    // ========== Conversión en paralelo, cada tile a su rectángulo del sink ==========
+    bool convertLatest(FrameSink& sink) override {
+        if (!std::exchange(hasLatest_, false)) {
+            return false;
+        }
+        const FrameBuffer target = sink.acquire(latestInfo_);
+        if (!target.data) {
+            return false;
+        }
+        if (target.stride < static_cast<size_t>(width_) * 4) {
+            sink.abort();
+            return false;
+        }
+        std::atomic<bool> failed{false};
+        workers_->run(decoders_.size(), [&](size_t index) {
+            const auto& tile = layout_[index];
+            TileSink tileSink(target.data + tile.y * target.stride + static_cast<size_t>(tile.x) * 4,
+                              target.stride, tile.width, tile.height);
+            if (!decoders_[index]->convertLatest(tileSink)) {
+                failed = true;
+            }
+        });
+        if (failed) {
+            sink.abort();
+            return false;
+        }
+        sink.commit(latestInfo_);
+        return true;
+    }
+
+    std::optional<RecoveryState> recoveryState() const override {
+        // Los tiles no comparten long-terms: sin ids intactos el host manda keyframe
+        for (const auto& decoder : decoders_) {
+            if (decoder->recoveryState()) {
+                return RecoveryState{};
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    // Sink de un tile: su rectángulo dentro del buffer del frame completo
+    class TileSink final : public FrameSink {
+    public:
+        TileSink(uint8_t* origin, size_t stride, uint32_t width, uint32_t height)
+            : origin_(origin), stride_(stride), width_(width), height_(height) {}
+
+        FrameBuffer acquire(const DecodedFrameInfo& info) override {
+            if (info.width != width_ || info.height != height_) {
+                return {};
+            }
+            return {origin_, stride_};
+        }
+
+        void commit(const DecodedFrameInfo&) override {}
+
+    private:
+        uint8_t* origin_;
+        size_t stride_;
+        uint32_t width_;
+        uint32_t height_;
+    };
+
+    bool prepare(const vic::encoder::EncodedFrame& frame) {
+        if (frame.tiles.empty()) {
+            logging::global().log(logging::Logger::Level::Error, "Tiled decoder recibió un frame sin tiles");
+            return false;
+        }
+        if (frame.width != width_ || frame.height != height_) {
+            if (!configure(frame.width, frame.height)) {
+                return false;
+            }
+        }
+        return matchLayout(frame);
+    }
+
+    // Un decoder por tile; si cambia el layout (resolución o cantidad de tiles)
+    // se recrean todos y hasta el próximo keyframe no hay referencias
+    bool matchLayout(const vic::encoder::EncodedFrame& frame) {
+        std::vector<vic::encoder::TileRect> layout;
+        layout.reserve(frame.tiles.size());
+        size_t offset = 0;
+        payloadOffsets_.resize(frame.tiles.size());
+        for (size_t i = 0; i < frame.tiles.size(); ++i) {
+            const auto& tile = frame.tiles[i];
+            if (tile.width == 0 || tile.height == 0 ||
+                tile.x + tile.width > frame.width || tile.y + tile.height > frame.height) {
+                logging::global().log(logging::Logger::Level::Error, "Tiled decoder: tile fuera del frame");
+                return false;
+            }
+            payloadOffsets_[i] = offset;
+            offset += tile.payloadSize;
+            layout.push_back({tile.x, tile.y, tile.width, tile.height});
+        }
+        if (offset != frame.payload.size()) {
+            logging::global().log(logging::Logger::Level::Error, "Tiled decoder: los tiles no suman el payload");
+            return false;
+        }
+        if (layout == layout_) {
+            return true;
+        }
+
+        // Los tiles ya decodifican en paralelo: los cores se reparten entre ellos
+        const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        const uint32_t threadsPerTile = std::max<uint32_t>(1, cores / static_cast<uint32_t>(layout.size()));
+        decoders_.clear();
+        for (size_t i = 0; i < layout.size(); ++i) {
+            auto decoder = createDecoder(codec_);
+            if (!decoder) {
+                logging::global().log(logging::Logger::Level::Error,
+                    std::string("Tiled decoder: ") + vic::encoder::codecName(codec_) + " no disponible");
+                decoders_.clear();
+                layout_.clear();
+                return false;
+            }
+            decoder->setMaxThreads(threadsPerTile);
+            decoders_.push_back(std::move(decoder));
+        }
+        layout_ = std::move(layout);
+        tileFrames_.assign(layout_.size(), {});
+        if (!workers_ || workers_->size() != layout_.size()) {
+            workers_ = std::make_unique<vic::encoder::TileWorkers>(layout_.size());
+        }
+        logging::global().log(logging::Logger::Level::Info,
+            "Tiled decoder: " + std::to_string(width_) + "x" + std::to_string(height_) + " en " +
+            std::to_string(layout_.size()) + " tiles, " + std::to_string(threadsPerTile) + " hilos por tile");
+        return true;
+    }
+
+    const vic::encoder::VideoCodec codec_;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint8_t> bgraBuffer_;
+    DecodedFrameInfo latestInfo_{};
+    bool hasLatest_ = false;                 // Todos los tiles tienen imagen sin convertir
+
+    std::vector<vic::encoder::TileRect> layout_;
+    std::vector<size_t> payloadOffsets_;
+    std::vector<std::unique_ptr<VideoDecoder>> decoders_;
+    std::vector<vic::encoder::EncodedFrame> tileFrames_;   // Reutilizados entre frames
+    std::unique_ptr<vic::encoder::TileWorkers> workers_;
+};
+
+} // namespace
+
+std::unique_ptr<VideoDecoder> createTiledDecoder(vic::encoder::VideoCodec codec) {
+    if (!createDecoder(codec)) {
+        return nullptr;
+    }
+    return std::make_unique<TiledDecoder>(codec);
+}
+
+} // namespace vic::decoder
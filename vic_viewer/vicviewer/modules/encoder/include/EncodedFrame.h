@@ -1,11 +1,33 @@
 #pragma once
 
+#include "CopyRect.h"
+#include "VideoCodec.h"
+
 #include <cstdint>
 #include <vector>
 
 namespace vic::encoder {
 
+/// Tile de un frame codificado por tiles (createTiledEncoder): bitstream
+/// independiente con su propio encoder y sus propias referencias
+struct EncodedTile {
+    uint32_t x{};
+    uint32_t y{};
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t payloadSize{};       // Bytes de EncodedFrame::payload que le tocan (en orden)
+    bool keyFrame{false};
+    uint32_t frameId{};
+    uint32_t referenceFrameId{};
+    uint8_t referenceFlags{};
+};
+
 struct EncodedFrame {
+    /// Bits de referenceFlags
+    static constexpr uint8_t kRefreshGolden = 0x01;
+    static constexpr uint8_t kRefreshAltRef = 0x02;
+    static constexpr uint8_t kRecovery = 0x04;     // Solo referencia un long-term (golden/altref)
+
     uint64_t timestamp{};
     std::vector<uint8_t> payload{};
     uint32_t width{};           // Ancho del frame codificado (puede estar escalado)
@@ -13,6 +35,19 @@ struct EncodedFrame {
     uint32_t originalWidth{};   // Ancho ORIGINAL de la pantalla (para coordenadas de mouse)
     uint32_t originalHeight{};  // Alto ORIGINAL de la pantalla
     bool keyFrame{false};
+    VideoCodec codec{VideoCodec::Vp8};
+    // Desplazamientos a aplicar sobre la referencia LAST antes de decodificar
+    std::vector<vic::capture::CopyRect> copyRects{};
+
+    // ========== Referencias (recuperación de pérdidas) ==========
+    uint32_t frameId{};           // Consecutivo del encoder (0 = sin numerar, no se verifica)
+    uint32_t referenceFrameId{};  // Frame del que depende: el anterior, el long-term en recuperación, o sí mismo si es key
+    uint8_t referenceFlags{};
+    uint8_t temporalLayer{};      // 0 = base; >0 = descartable (nadie lo referencia)
+
+    // ========== Tiles ==========
+    // Vacío = un solo bitstream. Si no, payload es la concatenación de los tiles
+    std::vector<EncodedTile> tiles{};
 };
 
 } // namespace vic::encoder
@@ -17,6 +17,7 @@ struct NvencConfig {
     uint32_t targetBitrateKbps = 5000;
     uint32_t maxBitrateKbps = 8000;
     uint32_t gopLength = 60;           // Keyframe cada N frames
+    uint32_t intraRefreshPeriod = 0;   // >0: intra refresh en N frames, sin IDR periódicos
     bool useBFrames = false;           // Sin B-frames para menor latencia
     bool useHEVC = false;              // false = H.264, true = HEVC
     bool lowLatencyMode = true;        // Optimizado para streaming
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vic::encoder {
+
+/// Zona del frame codificado asignada a un segmento de calidad
+struct RoiRegion {
+    uint32_t x{};
+    uint32_t y{};
+    uint32_t width{};
+    uint32_t height{};
+    uint8_t segment{};        // 1..3 (0 es el fondo). Si se solapan, gana la última
+};
+
+/// Mapa de región de interés. Cada segmento lleva un delta de cuantizador
+/// (negativo = más calidad) y de loop filter (negativo = bordes de texto más
+/// nítidos), en la escala externa 0..63 de libvpx
+struct RoiMap {
+    static constexpr size_t kSegments = 4;
+
+    std::vector<RoiRegion> regions{};
+    std::array<int8_t, kSegments> deltaQ{};
+    std::array<int8_t, kSegments> deltaLoopFilter{};
+
+    [[nodiscard]] bool empty() const { return regions.empty(); }
+};
+
+} // namespace vic::encoder
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vic::encoder {
+
+/// Parámetros de velocidad que el governor ajusta en caliente
+struct EncoderSpeedState {
+    int cpuUsed{};                  // VP8E_SET_CPUUSED: más alto = más rápido y peor calidad
+    uint32_t threads{1};
+    uint32_t tokenPartitions{};     // log2 (VP8E_SET_TOKEN_PARTITIONS, 0..3)
+    double utilisation{};           // Tiempo de encode / presupuesto por frame (promedio móvil)
+};
+
+struct SpeedGovernorLimits {
+    int minCpuUsed{};               // Mejor calidad que se permite
+    int maxCpuUsed{};               // Lo más rápido que da el codec
+    uint32_t maxThreads{1};
+    bool tokenPartitions{false};    // Solo VP8 particiona tokens
+    uint32_t minTokenPartitions{};  // log2 mínimo por resolución (hilos del decoder del viewer)
+};
+
+/// Mide el tiempo de encode de cada frame contra el presupuesto (1000/fps) y
+/// mueve cpu-used, hilos y particiones de tokens para quedar cerca de un uso
+/// objetivo: con margen sube la calidad, pasado de presupuesto gana velocidad
+class SpeedGovernor {
+public:
+    /// budgetUs = 0 desactiva el governor (los parámetros quedan fijos)
+    void configure(uint32_t budgetUs, const SpeedGovernorLimits& limits, const EncoderSpeedState& initial);
+
+    [[nodiscard]] bool enabled() const { return budgetUs_ > 0; }
+    [[nodiscard]] const EncoderSpeedState& state() const { return state_; }
+
+    /// Registrar el tiempo de encode de un frame. true si cambió cpu-used,
+    /// hilos o particiones y hay que aplicarlos al encoder
+    bool observe(uint32_t encodeUs);
+
+    /// El encoder no pudo cambiar los hilos en caliente: dejarlos fijos
+    void pinThreads(uint32_t threads);
+
+private:
+    [[nodiscard]] uint32_t partitionsFor(uint32_t threads) const;
+
+    uint32_t budgetUs_ = 0;
+    SpeedGovernorLimits limits_{};
+    EncoderSpeedState state_{};
+    bool threadsPinned_ = false;
+    uint32_t framesSinceChange_ = 0;
+    bool hasSample_ = false;
+};
+
+} // namespace vic::encoder
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vic::encoder {
+
+/// Cómo partir el frame en tiles independientes
+enum class TileSplit : uint8_t {
+    Auto,         // Columnas si el frame es muy ancho (multi-monitor), si no franjas
+    Horizontal,   // Franjas de ancho completo, una debajo de otra
+    Vertical      // Columnas de alto completo
+};
+
+struct TileRect {
+    uint32_t x{};
+    uint32_t y{};
+    uint32_t width{};
+    uint32_t height{};
+
+    bool operator==(const TileRect&) const = default;
+};
+
+/// Partir width x height en hasta `tiles` tiles con bordes alineados a
+/// macrobloques (16 px). Puede devolver menos si el frame es chico
+[[nodiscard]] std::vector<TileRect> computeTileLayout(uint32_t width, uint32_t height,
+                                                      uint32_t tiles, TileSplit split);
+
+/// Hilos persistentes, uno por tile: run() ejecuta job(i) para cada i < count
+/// en paralelo y espera a que terminen todos
+class TileWorkers {
+public:
+    explicit TileWorkers(size_t threads);
+    ~TileWorkers();
+
+    TileWorkers(const TileWorkers&) = delete;
+    TileWorkers& operator=(const TileWorkers&) = delete;
+
+    [[nodiscard]] size_t size() const { return threads_.size(); }
+    void run(size_t count, const std::function<void(size_t)>& job);
+
+private:
+    void workerLoop(size_t index);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t jobCount_ = 0;
+    size_t pending_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace vic::encoder
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace vic::encoder {
+
+/// Codec de un stream de video (viaja en cada VideoFrameHeader)
+enum class VideoCodec : uint8_t {
+    Vp8 = 0,    // 0: default de frames sin negociar
+    Vp9 = 1,
+    H264 = 2
+};
+
+/// Bits de CodecCapability::profileMask
+/// VP8/VP9: bit N = perfil N. H.264: baseline, main, high
+constexpr uint8_t kProfile0 = 0x01;
+constexpr uint8_t kH264Baseline = 0x01;
+constexpr uint8_t kH264Main = 0x02;
+constexpr uint8_t kH264High = 0x04;
+
+struct CodecCapability {
+    VideoCodec codec{VideoCodec::Vp8};
+    uint8_t profileMask{kProfile0};
+};
+
+[[nodiscard]] const char* codecName(VideoCodec codec);
+
+/// Primer codec de `hostPreference` (ordenado del más barato al más caro para
+/// el host) que el viewer también soporta con algún perfil en común
+[[nodiscard]] std::optional<CodecCapability> negotiateCodec(
+    std::span<const CodecCapability> hostPreference,
+    std::span<const CodecCapability> viewerCapabilities);
+
+} // namespace vic::encoder
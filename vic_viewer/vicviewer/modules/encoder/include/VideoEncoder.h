@@ -1,11 +1,18 @@
 #pragma once
 
 #include "EncodedFrame.h"
+#include "RoiMap.h"
+#include "SpeedGovernor.h"
+#include "Tiling.h"
+#include "VideoCodec.h"
 
+#include "ContentClassifier.h"
+#include "CopyRect.h"
 #include "DesktopFrame.h"
 
 #include <optional>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace vic::encoder {
@@ -21,6 +28,63 @@ public:
     /// Forzar que el próximo frame sea un keyframe
     virtual void forceNextKeyframe() { forceKeyframe_ = true; }
 
+    /// Copy-rects (scroll / ventana arrastrada) para el próximo frame. El encoder
+    /// los aplica sobre su referencia y los devuelve en EncodedFrame::copyRects
+    /// para que el decoder haga lo mismo. Sin soporte se ignoran
+    virtual void setCopyRects(std::vector<vic::capture::CopyRect> rects) { (void)rects; }
+
+    /// Mapa de región de interés para los próximos frames (persiste hasta el
+    /// siguiente llamado; un mapa vacío lo desactiva). Sin soporte se ignora
+    virtual void setRoiMap(const RoiMap& map) { (void)map; }
+
+    /// Acotar el cuantizador (escala 0..63) de los próximos frames, p.ej. para
+    /// refinar una pantalla quieta. resetQuantizerRange() vuelve al rango normal
+    virtual bool setQuantizerRange(uint32_t minQuantizer, uint32_t maxQuantizer) {
+        (void)minQuantizer;
+        (void)maxQuantizer;
+        return false;
+    }
+    virtual void resetQuantizerRange() {}
+
+    /// El próximo frame es un refinamiento (el mismo contenido a mejor
+    /// calidad): con capas temporales va en la base para quedar como
+    /// referencia de los que siguen. Sin soporte se ignora
+    virtual void refineNextFrame() {}
+
+    /// Modo intra refresh (desde el próximo Configure): sin keyframes periódicos
+    /// y un viewer nuevo converge en `periodFrames` frames a bitrate parejo en
+    /// lugar de recibir un keyframe enorme. 0 = desactivado
+    virtual void setIntraRefresh(uint32_t periodFrames) { (void)periodFrames; }
+
+    /// Capas temporales (desde el próximo Configure, 1-3): los frames de capa
+    /// > 0 no son referencia de nadie y se pueden descartar bajo congestión
+    /// para bajar el frame rate al instante sin keyframe. Sin soporte, 1 capa
+    virtual void setTemporalLayers(uint32_t layers) { (void)layers; }
+
+    /// Tope de hilos internos del encoder (desde el próximo Configure). El
+    /// encoder por tiles lo usa para repartir los cores entre tiles. 0 = auto
+    virtual void setMaxThreads(uint32_t threads) { (void)threads; }
+
+    /// Presupuesto de tiempo por frame en µs (1000/fps, desde el próximo
+    /// Configure): el encoder mide cada encode y ajusta su velocidad para usar
+    /// ~70% del presupuesto. 0 = velocidad fija
+    virtual void setFrameBudgetUs(uint32_t budgetUs) { (void)budgetUs; }
+
+    /// Perfil de contenido (ContentClassifier), aplicado en caliente: modo de
+    /// pantalla, denoiser y rango del cuantizador. Sin soporte se ignora
+    virtual void setContentType(vic::capture::ContentType type) { (void)type; }
+
+    /// Estado actual del governor de velocidad (métricas). nullopt = sin governor
+    [[nodiscard]] virtual std::optional<EncoderSpeedState> speedState() const { return std::nullopt; }
+
+    /// El viewer perdió frames y conserva intactos los frames long-term
+    /// `intactFrameIds`. El próximo frame referencia solo uno de ellos (mucho
+    /// más chico que un keyframe); si ninguno sirve, o sin soporte, keyframe
+    virtual void requestRecovery(std::span<const uint32_t> intactFrameIds) {
+        (void)intactFrameIds;
+        forceNextKeyframe();
+    }
+
 protected:
     bool forceKeyframe_ = false;
 };
@@ -28,7 +92,21 @@ protected:
 /// Crear encoder VP8 (software, siempre disponible)
 std::unique_ptr<VideoEncoder> createVp8Encoder();
 
+/// Crear encoder VP9 (software, tuning realtime para contenido de pantalla)
+std::unique_ptr<VideoEncoder> createVp9Encoder();
+
 /// Crear el mejor encoder disponible (NVENC hardware si disponible, sino VP8)
 std::unique_ptr<VideoEncoder> createBestEncoder();
 
+/// Codecs que este host puede codificar, del más barato al más caro
+std::vector<CodecCapability> encoderCapabilities();
+
+/// Crear encoder para un codec negociado. nullptr si no está disponible
+std::unique_ptr<VideoEncoder> createEncoder(VideoCodec codec);
+
+/// Encoder que parte el frame en `tiles` tiles y codifica cada uno con su
+/// propia instancia de `codec` en su propio hilo (4K / multi-monitor).
+/// Los tiles viajan en EncodedFrame::tiles; decodificar con createTiledDecoder
+std::unique_ptr<VideoEncoder> createTiledEncoder(VideoCodec codec, uint32_t tiles, TileSplit split = TileSplit::Auto);
+
 } // namespace vic::encoder
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CopyRect.h"
+
+#include <vpx/vp8.h>
+#include <vpx/vpx_codec.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vic::encoder {
+
+/// Copia de trabajo de la referencia LAST de un contexto VP8 (encoder o decoder).
+/// Encoder y decoder aplican los mismos copy-rects sobre la misma referencia,
+/// así ambos lados siguen siendo idénticos bit a bit
+class VpxReferenceFrame {
+public:
+    /// Leer la referencia LAST, aplicar los copy-rects y volver a escribirla
+    bool applyCopyRects(vpx_codec_ctx_t* codec, uint32_t width, uint32_t height,
+                        const std::vector<vic::capture::CopyRect>& rects) {
+        if (rects.empty()) {
+            return true;
+        }
+        allocate(width, height);
+
+        ref_.frame_type = VP8_LAST_FRAME;
+        if (vpx_codec_control(codec, VP8_COPY_REFERENCE, &ref_) != VPX_CODEC_OK) {
+            return false;
+        }
+        vic::capture::applyCopyRectsI420(
+            ref_.img.planes[VPX_PLANE_Y], ref_.img.stride[VPX_PLANE_Y],
+            ref_.img.planes[VPX_PLANE_U], ref_.img.stride[VPX_PLANE_U],
+            ref_.img.planes[VPX_PLANE_V], ref_.img.stride[VPX_PLANE_V],
+            width, height, rects);
+        return vpx_codec_control(codec, VP8_SET_REFERENCE, &ref_) == VPX_CODEC_OK;
+    }
+
+private:
+    // VP8 copia la referencia con bordes extendidos: la imagen debe tener las
+    // dimensiones internas (múltiplo de 16) y 32px de borde en luma (16 en croma)
+    static constexpr uint32_t kBorder = 32;
+
+    void allocate(uint32_t width, uint32_t height) {
+        if (width == width_ && height == height_) {
+            return;
+        }
+        width_ = width;
+        height_ = height;
+
+        const uint32_t alignedWidth = (width + 15) & ~15u;
+        const uint32_t alignedHeight = (height + 15) & ~15u;
+        const uint32_t yStride = alignedWidth + 2 * kBorder;
+        const uint32_t uvStride = yStride / 2;
+        const size_t ySize = static_cast<size_t>(yStride) * (alignedHeight + 2 * kBorder);
+        const size_t uvSize = static_cast<size_t>(uvStride) * (alignedHeight / 2 + kBorder);
+        buffer_.assign(ySize + 2 * uvSize, 0);
+
+        vpx_image_t& img = ref_.img;
+        img = {};
+        img.fmt = VPX_IMG_FMT_I420;
+        img.w = img.d_w = alignedWidth;
+        img.h = img.d_h = alignedHeight;
+        img.x_chroma_shift = 1;
+        img.y_chroma_shift = 1;
+        img.bps = 12;
+        img.stride[VPX_PLANE_Y] = static_cast<int>(yStride);
+        img.stride[VPX_PLANE_U] = img.stride[VPX_PLANE_V] = static_cast<int>(uvStride);
+        img.planes[VPX_PLANE_Y] = buffer_.data() + static_cast<size_t>(kBorder) * yStride + kBorder;
+        img.planes[VPX_PLANE_U] = buffer_.data() + ySize + static_cast<size_t>(kBorder / 2) * uvStride + kBorder / 2;
+        img.planes[VPX_PLANE_V] = img.planes[VPX_PLANE_U] + uvSize;
+    }
+
+    vpx_ref_frame_t ref_{};
+    std::vector<uint8_t> buffer_;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+};
+
+} // namespace vic::encoder
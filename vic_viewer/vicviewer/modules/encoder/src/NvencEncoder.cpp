@@ -39,6 +39,8 @@ struct NvencLibrary {
 
 static NvencLibrary g_nvenc = {};
 
+constexpr uint32_t kNvencInfiniteGopLength = 0xFFFFFFFF;  // NVENC_INFINITE_GOPLENGTH
+
 bool initNvencLibrary() {
     if (g_nvenc.initialized) {
         return g_nvenc.available;
@@ -182,7 +184,8 @@ public:
         encodeConfig.rcParams.zeroReorderDelay = 1;
         encodeConfig.rcParams.enableAQ = 1;
         
-        // H.264 specific
+        // H.264 specific (perfil fijo: es el que se anuncia en la negociación)
+        encodeConfig.profileGUID = NV_ENC_H264_PROFILE_HIGH_GUID;
         encodeConfig.encodeCodecConfig.h264Config.idrPeriod = config_.gopLength;
         encodeConfig.encodeCodecConfig.h264Config.repeatSPSPPS = 1;
         encodeConfig.encodeCodecConfig.h264Config.sliceMode = 0;
@@ -190,6 +193,16 @@ public:
         
         // GOP structure
         encodeConfig.gopLength = config_.gopLength;
+
+        // Intra refresh: GOP infinito y una franja intra por frame que recorre
+        // la imagen en intraRefreshPeriod frames (sin picos de IDR)
+        if (config_.intraRefreshPeriod > 0) {
+            encodeConfig.gopLength = kNvencInfiniteGopLength;
+            encodeConfig.encodeCodecConfig.h264Config.idrPeriod = kNvencInfiniteGopLength;
+            encodeConfig.encodeCodecConfig.h264Config.enableIntraRefresh = 1;
+            encodeConfig.encodeCodecConfig.h264Config.intraRefreshPeriod = config_.intraRefreshPeriod;
+            encodeConfig.encodeCodecConfig.h264Config.intraRefreshCnt = config_.intraRefreshPeriod;
+        }
         encodeConfig.frameIntervalP = 1; // No B-frames for low latency
 
         // Initialize encoder
@@ -348,9 +361,11 @@ public:
         picParams.inputTimeStamp = frameIndex_;
         picParams.frameIdx = static_cast<uint32_t>(frameIndex_);
 
-        // Request IDR frame periodically or on first frame
-        if (frameIndex_ == 0 || (frameIndex_ % config_.gopLength == 0)) {
+        // Request IDR frame periodically (salvo con intra refresh), on first frame or on demand
+        const bool periodicIdr = config_.intraRefreshPeriod == 0 && frameIndex_ % config_.gopLength == 0;
+        if (frameIndex_ == 0 || periodicIdr || forceKeyframe_) {
             picParams.encodePicFlags = 0x04;  // NV_ENC_PIC_FLAG_FORCEIDR
+            forceKeyframe_ = false;
         }
 
         status = g_nvenc.api.nvEncEncodePicture(encoder_, &picParams);
@@ -382,6 +397,7 @@ public:
         result.timestamp = frame.timestamp;
         result.width = width_;
         result.height = height_;
+        result.codec = VideoCodec::H264;
 
         g_nvenc.api.nvEncUnlockBitstream(encoder_, outputBuffer_);
 
@@ -398,6 +414,10 @@ public:
         return result;
     }
 
+    void setIntraRefresh(uint32_t periodFrames) override {
+        config_.intraRefreshPeriod = periodFrames;
+    }
+
     std::vector<uint8_t> Flush() override {
         if (!initialized_ || !encoder_) {
             return {};
@@ -534,18 +554,10 @@ std::unique_ptr<VideoEncoder> createNvencEncoder(const NvencConfig& config, ID3D
 
 std::unique_ptr<VideoEncoder> createBestEncoder() {
     // Try NVENC first
-    if (isNvencAvailable()) {
-        NvencConfig config;
-        config.lowLatencyMode = true;
-        config.targetBitrateKbps = 8000;  // Higher default for H.264
-        config.gopLength = 60;
-
-        auto nvenc = createNvencEncoder(config, nullptr);
-        if (nvenc) {
-            logging::global().log(logging::Logger::Level::Info, 
-                "Using NVENC H.264 hardware encoder");
-            return nvenc;
-        }
+    if (auto nvenc = createEncoder(VideoCodec::H264)) {
+        logging::global().log(logging::Logger::Level::Info, 
+            "Using NVENC H.264 hardware encoder");
+        return nvenc;
     }
 
     // Fallback to VP8
@@ -554,4 +566,35 @@ std::unique_ptr<VideoEncoder> createBestEncoder() {
     return createVp8Encoder();
 }
 
+std::vector<CodecCapability> encoderCapabilities() {
+    // Del más barato al más caro para el host: hardware, VP8, VP9 (mejor
+    // compresión pero bastante más CPU por frame)
+    std::vector<CodecCapability> capabilities;
+    if (isNvencAvailable()) {
+        capabilities.push_back({VideoCodec::H264, kH264High});
+    }
+    capabilities.push_back({VideoCodec::Vp8, kProfile0});
+    capabilities.push_back({VideoCodec::Vp9, kProfile0});
+    return capabilities;
+}
+
+std::unique_ptr<VideoEncoder> createEncoder(VideoCodec codec) {
+    switch (codec) {
+    case VideoCodec::Vp8:
+        return createVp8Encoder();
+    case VideoCodec::Vp9:
+        return createVp9Encoder();
+    case VideoCodec::H264:
+        if (isNvencAvailable()) {
+            NvencConfig config;
+            config.lowLatencyMode = true;
+            config.targetBitrateKbps = 8000;  // Higher default for H.264
+            config.gopLength = 60;
+            return createNvencEncoder(config, nullptr);
+        }
+        return nullptr;
+    }
+    return nullptr;
+}
+
 } // namespace vic::encoder
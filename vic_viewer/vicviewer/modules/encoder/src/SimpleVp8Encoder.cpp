@@ -1,5 +1,6 @@
 #include "VideoEncoder.h"
 #include "ColorConvert.h"
+#include "VpxReferenceFrame.h"
 
 #include "Logger.h"
 
@@ -7,9 +8,14 @@
 #include <vpx/vp8cx.h>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace vic::encoder {
@@ -21,14 +27,84 @@ namespace {
 constexpr uint32_t kDefaultBitrateKbps = 2500;
 constexpr uint32_t kPixelsPerThreadHint = 640u * 360u;
 constexpr int kDefaultCpuUsed = 10; // Máximo speed para mínima latencia
+constexpr int kVp9CpuUsed = 8;      // Speed realtime de VP9 al arrancar (el máximo, 9, queda para el governor)
+// Rango en el que el governor mueve cpu-used (realtime): por debajo del mínimo
+// el costo por frame se dispara sin mejora visible en contenido de pantalla
+constexpr int kVp8MinCpuUsed = 4;
+constexpr int kVp8MaxCpuUsed = 16;
+constexpr int kVp9MinCpuUsed = 5;
+constexpr int kVp9MaxCpuUsed = 9;
+constexpr uint32_t kMaxEncoderThreads = 8;
+// Particiones de tokens VP8 (log2): una por cada 640x360 de frame, hasta 8.
+// Cuestan ~3 bytes por partición y dejan al decoder del viewer repartir el
+// entropy decoding entre hilos (1080p = 8 particiones)
+constexpr uint32_t kMaxTokenPartitionsLog2 = 3;
+constexpr uint32_t kVp9MinTileWidth = 256;
+constexpr unsigned int kVp9AqCyclicRefresh = 3;
+
+// Capas temporales: las de mejora solo referencian LAST (que actualiza solo la
+// base) y no actualizan nada, así cualquiera se descarta sin corromper
+constexpr uint32_t kMaxTemporalLayers = 3;
+constexpr uint32_t kTemporalPattern2[] = {0, 1};
+constexpr uint32_t kTemporalPattern3[] = {0, 2, 1, 2};
+// Bitrate acumulado hasta cada capa (% del total): la base se lleva más bits
+// porque es la única que persiste en la referencia
+constexpr uint32_t kTemporalBitratePct2[] = {60, 100};
+constexpr uint32_t kTemporalBitratePct3[] = {50, 70, 100};
+constexpr uint32_t kDefaultMinQuantizer = 2;   // Permite mejor calidad en escenas estáticas
+constexpr uint32_t kDefaultMaxQuantizer = 48;  // Permite más compresión cuando sea necesario
+constexpr uint32_t kMaxQuantizer = 63;
+
+// ========== Perfiles de contenido (ContentClassifier) ==========
+struct ContentTuning {
+    unsigned int screenContent;     // VP8E_SET_SCREEN_CONTENT_MODE / VP9 tune screen
+    unsigned int noiseSensitivity;  // Denoiser temporal: solo ayuda con video
+    uint32_t minQuantizer;
+    uint32_t maxQuantizer;
+};
+// Texto: modos de pantalla y sin denoiser que borronee glifos
+constexpr ContentTuning kTextTuning{1, 0, kDefaultMinQuantizer, kDefaultMaxQuantizer};
+// Video: tuning natural; el cuantizador puede subir más porque el movimiento
+// oculta los artefactos y así el rate control no desborda el bitrate
+constexpr ContentTuning kVideoTuning{0, 1, 4, 56};
+// Estático: lo poco que cambia (reloj, caret) a calidad alta
+constexpr ContentTuning kStaticTuning{1, 0, kDefaultMinQuantizer, 40};
+
+const ContentTuning& contentTuning(vic::capture::ContentType type) {
+    switch (type) {
+    case vic::capture::ContentType::Video:
+        return kVideoTuning;
+    case vic::capture::ContentType::Static:
+        return kStaticTuning;
+    case vic::capture::ContentType::Text:
+        break;
+    }
+    return kTextTuning;
+}
+// Cada cuántos frames se refresca un long-term (alternando golden y altref):
+// a 30 fps ninguno tiene más de ~2 s
+constexpr uint32_t kLongTermRefreshInterval = 30;
+// Intra refresh: keyframe limitado a ~3 frames promedio y banda de MBs
+// recodificados con más calidad (segmento libre del ROI) hasta converger
+constexpr unsigned int kIntraRefreshMaxKeyframePct = 300;
+constexpr uint8_t kIntraRefreshSegment = RoiMap::kSegments - 1;
+constexpr int8_t kIntraRefreshDeltaQ = -24;
 
 uint8_t clampToByte(int value) {
     return static_cast<uint8_t>(std::clamp(value, 0, 255));
 }
 
+enum class VpxCodec {
+    Vp8,
+    Vp9
+};
+
+// Mismo encoder libvpx para VP8 y VP9: cambian la interfaz, el tuning y lo
+// que depende de cómo cada uno maneja sus buffers de referencia
 class LibvpxEncoder final : public VideoEncoder {
 public:
-    LibvpxEncoder() = default;
+    explicit LibvpxEncoder(VpxCodec codec)
+        : codecKind_(codec), name_(codec == VpxCodec::Vp9 ? "VP9" : "VP8") {}
     ~LibvpxEncoder() override {
         Shutdown();
     }
@@ -47,9 +123,9 @@ public:
         height_ = height;
         targetBitrateKbps_ = targetBitrateKbps == 0 ? kDefaultBitrateKbps : targetBitrateKbps;
 
-        const vpx_codec_iface_t* iface = vpx_codec_vp8_cx();
+        const vpx_codec_iface_t* iface = codecKind_ == VpxCodec::Vp9 ? vpx_codec_vp9_cx() : vpx_codec_vp8_cx();
         if (vpx_codec_enc_config_default(iface, &config_, 0) != VPX_CODEC_OK) {
-            logging::global().log(logging::Logger::Level::Error, "Failed to get default VP8 encoder config");
+            logging::global().log(logging::Logger::Level::Error, "Failed to get default " + name_ + " encoder config");
             return false;
         }
 
@@ -59,28 +135,72 @@ public:
         config_.g_timebase.den = 1000; // millisecond timestamps
         config_.rc_target_bitrate = std::max<uint32_t>(1, targetBitrateKbps_);
         config_.g_threads = std::clamp<uint32_t>((width_ * height_) / kPixelsPerThreadHint, 1, 8);
+        if (maxThreads_ > 0) {
+            config_.g_threads = std::min(config_.g_threads, maxThreads_);
+        }
         config_.rc_end_usage = VPX_CBR;
-        config_.kf_mode = VPX_KF_AUTO;
+        // Con intra refresh no hay keyframes periódicos: solo los forzados
+        // (viewer nuevo sin referencias), y esos con tamaño acotado
+        config_.kf_mode = intraRefreshFrames_ > 0 ? VPX_KF_DISABLED : VPX_KF_AUTO;
         config_.g_error_resilient = VPX_ERROR_RESILIENT_DEFAULT;
-        config_.rc_min_quantizer = 2;   // Permite mejor calidad en escenas estáticas
-        config_.rc_max_quantizer = 48;  // Permite más compresión cuando sea necesario
+        config_.rc_min_quantizer = contentTuning(contentType_).minQuantizer;
+        config_.rc_max_quantizer = contentTuning(contentType_).maxQuantizer;
         config_.g_lag_in_frames = 0;    // Zero latency - no buffering
         config_.rc_buf_sz = 100;        // Buffer más pequeño para menor latencia
         config_.rc_buf_initial_sz = 50;
         config_.rc_buf_optimal_sz = 75;
 
+        // Capas temporales (solo VP8: VP9 las maneja vía SVC)
+        temporalLayers_ = codecKind_ == VpxCodec::Vp8 ? std::clamp<uint32_t>(requestedTemporalLayers_, 1, kMaxTemporalLayers) : 1;
+        temporalIndex_ = 0;
+        if (temporalLayers_ > 1) {
+            const auto pattern = temporalPattern();
+            const auto* bitratePct = temporalLayers_ == 2 ? kTemporalBitratePct2 : kTemporalBitratePct3;
+            config_.ts_number_layers = temporalLayers_;
+            config_.ts_periodicity = static_cast<unsigned int>(pattern.size());
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                config_.ts_layer_id[i] = pattern[i];
+            }
+            for (uint32_t layer = 0; layer < temporalLayers_; ++layer) {
+                config_.ts_rate_decimator[layer] = 1u << (temporalLayers_ - 1 - layer);
+                config_.ts_target_bitrate[layer] = std::max<uint32_t>(1, config_.rc_target_bitrate * bitratePct[layer] / 100);
+            }
+        }
+
         if (vpx_codec_enc_init(&codec_, iface, &config_, 0) != VPX_CODEC_OK) {
-            logging::global().log(logging::Logger::Level::Error, "Failed to initialize VP8 encoder context");
+            logging::global().log(logging::Logger::Level::Error, "Failed to initialize " + name_ + " encoder context");
             return false;
         }
 
-        // Baseline realtime tuning: modest CPUUSED for low latency desktop capture.
-        vpx_codec_control(&codec_, VP8E_SET_CPUUSED, kDefaultCpuUsed);
-        vpx_codec_control(&codec_, VP8E_SET_STATIC_THRESHOLD, 0);
-        vpx_codec_control(&codec_, VP8E_SET_NOISE_SENSITIVITY, 0);
-        vpx_codec_control(&codec_, VP8E_SET_ARNR_MAXFRAMES, 0);
-        vpx_codec_control(&codec_, VP8E_SET_ARNR_STRENGTH, 0);
-        vpx_codec_control(&codec_, VP8E_SET_ARNR_TYPE, 0);
+        if (codecKind_ == VpxCodec::Vp9) {
+            configureVp9();
+        } else {
+            // Baseline realtime tuning: modest CPUUSED for low latency desktop capture.
+            vpx_codec_control(&codec_, VP8E_SET_CPUUSED, kDefaultCpuUsed);
+            vpx_codec_control(&codec_, VP8E_SET_TOKEN_PARTITIONS, static_cast<int>(tokenPartitionsLog2()));
+            vpx_codec_control(&codec_, VP8E_SET_STATIC_THRESHOLD, 0);
+            vpx_codec_control(&codec_, VP8E_SET_ARNR_MAXFRAMES, 0);
+            vpx_codec_control(&codec_, VP8E_SET_ARNR_STRENGTH, 0);
+            vpx_codec_control(&codec_, VP8E_SET_ARNR_TYPE, 0);
+        }
+        if (intraRefreshFrames_ > 0) {
+            vpx_codec_control(&codec_, VP8E_SET_MAX_INTRA_BITRATE_PCT, kIntraRefreshMaxKeyframePct);
+        }
+        applyContentControls();
+
+        // Governor de velocidad: arranca del preset fijo y se ajusta midiendo
+        const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        const SpeedGovernorLimits limits{
+            codecKind_ == VpxCodec::Vp9 ? kVp9MinCpuUsed : kVp8MinCpuUsed,
+            codecKind_ == VpxCodec::Vp9 ? kVp9MaxCpuUsed : kVp8MaxCpuUsed,
+            maxThreads_ > 0 ? maxThreads_ : std::min(cores, kMaxEncoderThreads),
+            codecKind_ == VpxCodec::Vp8,
+            codecKind_ == VpxCodec::Vp8 ? tokenPartitionsLog2() : 0u};
+        governor_.configure(frameBudgetUs_, limits,
+            {codecKind_ == VpxCodec::Vp9 ? kVp9CpuUsed : kDefaultCpuUsed, config_.g_threads, 0, 0.0});
+        if (governor_.enabled()) {
+            applySpeed();
+        }
 
         const size_t ySize = static_cast<size_t>(width_) * height_;
         const size_t uvWidth = (width_ + 1) / 2;
@@ -88,6 +208,17 @@ public:
         const size_t uvSize = uvWidth * uvHeight;
 
         yuvBuffer_.resize(ySize + 2 * uvSize);
+
+        // El contexto nuevo no tiene segmentación: volver a aplicar el ROI vigente
+        roiActive_ = false;
+        roiDirty_ = !roi_.empty();
+
+        // Empieza con keyframe: no hay referencias long-term que ofrecer
+        // (los frameId siguen creciendo para que el viewer no los confunda)
+        longTerm_ = {};
+        recoverySlot_.reset();
+        framesSinceLongTermRefresh_ = 0;
+        refreshFramesLeft_ = 0;
         
         // Inicializar el convertidor de color si no existe
         if (!colorConverter_) {
@@ -161,11 +292,91 @@ public:
             flags = VPX_EFLAG_FORCE_KF;
             forceKeyframe_ = false;  // Reset el flag
         }
-        
+
+        // ========== Recuperación: solo desde un long-term intacto ==========
+        std::optional<size_t> recoverySlot;
+        if ((flags & VPX_EFLAG_FORCE_KF) == 0 && recoverySlot_) {
+            recoverySlot = recoverySlot_;
+        }
+        recoverySlot_.reset();
+
+        // ========== Copy-rects: desplazar la referencia LAST ==========
+        // El encoder comparte buffers entre LAST/GOLDEN/ALTREF y SET_REFERENCE
+        // escribe sobre el compartido; el decoder en cambio copia. Para que no
+        // diverjan, este frame no usa GOLDEN/ALTREF y los reemplaza al terminar.
+        // Un frame de recuperación no los lleva: necesita el long-term intacto
+        std::vector<vic::capture::CopyRect> copyRects = std::move(pendingCopyRects_);
+        pendingCopyRects_.clear();
+
+        // ========== Capa temporal ==========
+        // Lo que modifica referencias (keyframe, recuperación, copy-rects sobre
+        // LAST) va siempre en la base y reinicia el patrón. También el
+        // refinamiento (refineNextFrame): tiene que quedar en LAST
+        const bool refine = refinePending_;
+        refinePending_ = false;
+        uint32_t temporalLayer = 0;
+        if (temporalLayers_ > 1) {
+            if ((flags & VPX_EFLAG_FORCE_KF) || recoverySlot || !copyRects.empty() || refine) {
+                temporalIndex_ = 0;
+            }
+            temporalLayer = temporalPattern()[temporalIndex_];
+        }
+        if (!copyRects.empty() && (flags & VPX_EFLAG_FORCE_KF) == 0 && !recoverySlot) {
+            if (reference_.applyCopyRects(&codec_, width_, height_, copyRects)) {
+                flags |= VP8_EFLAG_NO_REF_GF | VP8_EFLAG_NO_REF_ARF | VP8_EFLAG_FORCE_GF | VP8_EFLAG_FORCE_ARF;
+            } else {
+                logging::global().log(logging::Logger::Level::Warning, name_ + ": no se pudo aplicar copy-rects a la referencia");
+                copyRects.clear();
+            }
+        } else {
+            copyRects.clear();
+        }
+
+        // ========== Long-term (golden / altref) ==========
+        // Nunca los actualiza libvpx por su cuenta: el viewer tiene que saber
+        // exactamente qué frame contiene cada uno
+        uint8_t refreshFlags = 0;
+        if (flags & VPX_EFLAG_FORCE_KF) {
+            refreshFlags = EncodedFrame::kRefreshGolden | EncodedFrame::kRefreshAltRef;
+        } else if (!copyRects.empty()) {
+            refreshFlags = EncodedFrame::kRefreshGolden | EncodedFrame::kRefreshAltRef;
+        } else if (recoverySlot) {
+            // Sin LAST ni el otro long-term (puede no tenerlo el viewer), que se
+            // reemplaza con este frame para dejar todas las referencias en regla
+            const bool fromGolden = *recoverySlot == kGoldenSlot;
+            flags |= VP8_EFLAG_NO_REF_LAST;
+            flags |= fromGolden ? (VP8_EFLAG_NO_REF_ARF | VP8_EFLAG_FORCE_ARF | VP8_EFLAG_NO_UPD_GF)
+                                : (VP8_EFLAG_NO_REF_GF | VP8_EFLAG_FORCE_GF | VP8_EFLAG_NO_UPD_ARF);
+            refreshFlags = fromGolden ? EncodedFrame::kRefreshAltRef : EncodedFrame::kRefreshGolden;
+        } else if (temporalLayer > 0) {
+            // Capa de mejora: descartable, no deja rastro en ninguna referencia
+            flags |= VP8_EFLAG_NO_UPD_LAST | VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF | VP8_EFLAG_NO_UPD_ENTROPY;
+        } else if (framesSinceLongTermRefresh_ + 1 >= kLongTermRefreshInterval) {
+            // Refresco periódico, alternando para conservar siempre el anterior
+            const bool refreshGolden = longTerm_[kGoldenSlot].frameId <= longTerm_[kAltRefSlot].frameId;
+            flags |= refreshGolden ? (VP8_EFLAG_FORCE_GF | VP8_EFLAG_NO_UPD_ARF)
+                                   : (VP8_EFLAG_FORCE_ARF | VP8_EFLAG_NO_UPD_GF);
+            refreshFlags = refreshGolden ? EncodedFrame::kRefreshGolden : EncodedFrame::kRefreshAltRef;
+        } else {
+            flags |= VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF;
+        }
+
+        if (roiDirty_ || refreshFramesLeft_ > 0) {
+            applyRoiMap();
+        }
+        if (temporalLayers_ > 1) {
+            vpx_codec_control(&codec_, VP8E_SET_TEMPORAL_LAYER_ID, static_cast<int>(temporalLayer));
+        }
+
         const vpx_codec_err_t encodeResult = vpx_codec_encode(&codec_, &raw, frame.timestamp, 1, flags, VPX_DL_REALTIME);
         vpx_img_free(&raw);
         if (encodeResult != VPX_CODEC_OK) {
-            logging::global().log(logging::Logger::Level::Error, "VP8 encode failed");
+            logging::global().log(logging::Logger::Level::Error, name_ + " encode failed");
+            // La referencia ya fue modificada y el decoder no lo sabrá
+            forceKeyframe_ = forceKeyframe_ || !copyRects.empty();
+            if (!recoverySlot_) {
+                recoverySlot_ = recoverySlot;
+            }
             return std::nullopt;
         }
 
@@ -178,18 +389,129 @@ public:
                 encoded.width = width_;
                 encoded.height = height_;
                 encoded.keyFrame = (packet->data.frame.flags & VPX_FRAME_IS_KEY) != 0;
+                encoded.codec = codecKind_ == VpxCodec::Vp9 ? VideoCodec::Vp9 : VideoCodec::Vp8;
                 encoded.payload.assign(static_cast<const uint8_t*>(packet->data.frame.buf),
                     static_cast<const uint8_t*>(packet->data.frame.buf) + packet->data.frame.sz);
+                if (!encoded.keyFrame) {
+                    encoded.copyRects = std::move(copyRects);
+                }
+                encoded.temporalLayer = encoded.keyFrame ? 0 : static_cast<uint8_t>(temporalLayer);
+                trackReferences(encoded, refreshFlags, recoverySlot);
+                const auto encodeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - encodeStart).count();
+                if (governor_.observe(static_cast<uint32_t>(encodeUs))) {
+                    applySpeed();
+                }
                 logging::global().log(logging::Logger::Level::Debug,
-                    std::string("VP8 encoded frame size=") + std::to_string(packet->data.frame.sz) +
+                    name_ + " encoded frame size=" + std::to_string(packet->data.frame.sz) +
                     (encoded.keyFrame ? " (key)" : ""));
                 return encoded;
             }
         }
 
+        forceKeyframe_ = forceKeyframe_ || !copyRects.empty();
+        if (!recoverySlot_) {
+            recoverySlot_ = recoverySlot;
+        }
         return std::nullopt;
     }
 
+    void setCopyRects(std::vector<vic::capture::CopyRect> rects) override {
+        // VP9 guarda las referencias en un pool con conteo de referencias:
+        // SET_REFERENCE escribiría sobre un buffer que puede compartir con
+        // golden/altref sin forma de volver a sincronizarlos. Solo VP8
+        if (codecKind_ == VpxCodec::Vp8) {
+            pendingCopyRects_ = std::move(rects);
+        }
+    }
+
+    void setRoiMap(const RoiMap& map) override {
+        roi_ = map;
+        roiDirty_ = true;
+    }
+
+    bool setQuantizerRange(uint32_t minQuantizer, uint32_t maxQuantizer) override {
+        if (!initialized_) {
+            return false;
+        }
+        const uint32_t minQ = std::min(minQuantizer, kMaxQuantizer);
+        const uint32_t maxQ = std::clamp(maxQuantizer, minQ, kMaxQuantizer);
+        if (config_.rc_min_quantizer == minQ && config_.rc_max_quantizer == maxQ) {
+            return true;
+        }
+        config_.rc_min_quantizer = minQ;
+        config_.rc_max_quantizer = maxQ;
+        if (vpx_codec_enc_config_set(&codec_, &config_) != VPX_CODEC_OK) {
+            logging::global().log(logging::Logger::Level::Warning, name_ + ": no se pudo cambiar el rango del cuantizador");
+            return false;
+        }
+        return true;
+    }
+
+    void resetQuantizerRange() override {
+        const auto& tuning = contentTuning(contentType_);
+        setQuantizerRange(tuning.minQuantizer, tuning.maxQuantizer);
+    }
+
+    void refineNextFrame() override {
+        refinePending_ = true;
+    }
+
+    void setIntraRefresh(uint32_t periodFrames) override {
+        intraRefreshFrames_ = periodFrames;
+    }
+
+    void setTemporalLayers(uint32_t layers) override {
+        requestedTemporalLayers_ = layers;
+    }
+
+    void setMaxThreads(uint32_t threads) override {
+        maxThreads_ = threads;
+    }
+
+    void setContentType(vic::capture::ContentType type) override {
+        if (type == contentType_) {
+            return;
+        }
+        contentType_ = type;
+        if (initialized_) {
+            applyContentControls();
+            resetQuantizerRange();
+        }
+    }
+
+    void setFrameBudgetUs(uint32_t budgetUs) override {
+        frameBudgetUs_ = budgetUs;
+    }
+
+    std::optional<EncoderSpeedState> speedState() const override {
+        if (!governor_.enabled()) {
+            return std::nullopt;
+        }
+        return governor_.state();
+    }
+
+    void requestRecovery(std::span<const uint32_t> intactFrameIds) override {
+        // El long-term más reciente que el viewer todavía tiene
+        std::optional<size_t> best;
+        for (size_t slot = 0; slot < longTerm_.size(); ++slot) {
+            const auto& entry = longTerm_[slot];
+            if (entry.frameId == 0 ||
+                std::find(intactFrameIds.begin(), intactFrameIds.end(), entry.frameId) == intactFrameIds.end()) {
+                continue;
+            }
+            if (!best || entry.frameId > longTerm_[*best].frameId) {
+                best = slot;
+            }
+        }
+        if (!best) {
+            logging::global().log(logging::Logger::Level::Info, name_ + ": recuperación sin long-term intacto, keyframe");
+            forceNextKeyframe();
+            return;
+        }
+        recoverySlot_ = best;
+    }
+
     std::vector<uint8_t> Flush() override {
         if (!initialized_) {
             return {};
@@ -210,6 +532,210 @@ public:
     }
 
 private:
+    // ========== Governor: aplicar cpu-used, hilos y particiones en caliente ==========
+    void applySpeed() {
+        const auto& speed = governor_.state();
+        if (speed.threads != config_.g_threads) {
+            const unsigned int previous = config_.g_threads;
+            config_.g_threads = speed.threads;
+            if (vpx_codec_enc_config_set(&codec_, &config_) != VPX_CODEC_OK) {
+                logging::global().log(logging::Logger::Level::Warning,
+                    name_ + ": no se pueden cambiar los hilos en caliente, quedan en " + std::to_string(previous));
+                config_.g_threads = previous;
+                governor_.pinThreads(previous);
+            }
+        }
+        vpx_codec_control(&codec_, VP8E_SET_CPUUSED, speed.cpuUsed);
+        if (codecKind_ == VpxCodec::Vp8) {
+            vpx_codec_control(&codec_, VP8E_SET_TOKEN_PARTITIONS, static_cast<int>(speed.tokenPartitions));
+        }
+        logging::global().log(logging::Logger::Level::Debug,
+            name_ + " governor: cpu-used=" + std::to_string(speed.cpuUsed) +
+            " hilos=" + std::to_string(config_.g_threads) +
+            " particiones=" + std::to_string(1u << speed.tokenPartitions) +
+            " uso=" + std::to_string(static_cast<int>(speed.utilisation * 100)) + "%");
+    }
+
+    uint32_t tokenPartitionsLog2() const {
+        const uint32_t blocks = (width_ * height_) / kPixelsPerThreadHint;
+        uint32_t log2 = 0;
+        while ((2u << log2) <= blocks && log2 < kMaxTokenPartitionsLog2) {
+            ++log2;
+        }
+        return log2;
+    }
+
+    // ========== Perfil de contenido: modos de pantalla y denoiser ==========
+    void applyContentControls() {
+        const auto& tuning = contentTuning(contentType_);
+        if (codecKind_ == VpxCodec::Vp9) {
+            // Texto y bordes nítidos: intra block copy de paleta, modos para pantalla
+            vpx_codec_control(&codec_, VP9E_SET_TUNE_CONTENT,
+                static_cast<int>(tuning.screenContent ? VP9E_CONTENT_SCREEN : VP9E_CONTENT_DEFAULT));
+            vpx_codec_control(&codec_, VP9E_SET_NOISE_SENSITIVITY, tuning.noiseSensitivity);
+        } else {
+            vpx_codec_control(&codec_, VP8E_SET_SCREEN_CONTENT_MODE, tuning.screenContent);
+            vpx_codec_control(&codec_, VP8E_SET_NOISE_SENSITIVITY, tuning.noiseSensitivity);
+        }
+    }
+
+    // ========== VP9: tuning realtime para escritorio ==========
+    void configureVp9() {
+        vpx_codec_control(&codec_, VP8E_SET_CPUUSED, kVp9CpuUsed);
+        vpx_codec_control(&codec_, VP8E_SET_STATIC_THRESHOLD, 0);
+        // Multithreading por filas + columnas de tiles (cada una de al menos 256 px)
+        vpx_codec_control(&codec_, VP9E_SET_ROW_MT, 1u);
+        int tileColumnsLog2 = 0;
+        while ((1u << (tileColumnsLog2 + 1)) <= config_.g_threads &&
+               (width_ >> (tileColumnsLog2 + 1)) >= kVp9MinTileWidth) {
+            ++tileColumnsLog2;
+        }
+        vpx_codec_control(&codec_, VP9E_SET_TILE_COLUMNS, tileColumnsLog2);
+        vpx_codec_control(&codec_, VP9E_SET_FRAME_PARALLEL_DECODING, 0u);
+        // Intra refresh: VP9 tiene refresco cíclico propio (AQ 3) en lugar de la banda ROI
+        vpx_codec_control(&codec_, VP9E_SET_AQ_MODE, intraRefreshFrames_ > 0 ? kVp9AqCyclicRefresh : 0u);
+    }
+
+    bool setRoiControl(vpx_roi_map_t* roi) {
+        if (codecKind_ == VpxCodec::Vp9) {
+            return vpx_codec_control(&codec_, VP9E_SET_ROI_MAP, roi) == VPX_CODEC_OK;
+        }
+        return vpx_codec_control(&codec_, VP8E_SET_ROI_MAP, roi) == VPX_CODEC_OK;
+    }
+
+    std::span<const uint32_t> temporalPattern() const {
+        if (temporalLayers_ == 2) {
+            return kTemporalPattern2;
+        }
+        return kTemporalPattern3;
+    }
+
+    static constexpr size_t kGoldenSlot = 0;
+    static constexpr size_t kAltRefSlot = 1;
+
+    struct LongTermReference {
+        uint32_t frameId = 0;   // Frame que lo refrescó por última vez (0 = ninguno)
+    };
+
+    // Numerar el frame y registrar qué referencias quedaron en cada buffer
+    void trackReferences(EncodedFrame& encoded, uint8_t refreshFlags, std::optional<size_t> recoverySlot) {
+        encoded.frameId = nextFrameId_++;
+        if (encoded.keyFrame) {
+            // También los keyframes que decide libvpx por su cuenta
+            refreshFlags = EncodedFrame::kRefreshGolden | EncodedFrame::kRefreshAltRef;
+            encoded.referenceFrameId = encoded.frameId;
+        } else if (recoverySlot) {
+            encoded.referenceFrameId = longTerm_[*recoverySlot].frameId;
+            refreshFlags |= EncodedFrame::kRecovery;
+            logging::global().log(logging::Logger::Level::Info,
+                name_ + ": frame de recuperación " + std::to_string(encoded.frameId) + " desde long-term " +
+                std::to_string(encoded.referenceFrameId) + " size=" + std::to_string(encoded.payload.size()));
+        } else {
+            encoded.referenceFrameId = lastFrameId_;
+        }
+        encoded.referenceFlags = refreshFlags;
+
+        if (refreshFlags & EncodedFrame::kRefreshGolden) {
+            longTerm_[kGoldenSlot].frameId = encoded.frameId;
+        }
+        if (refreshFlags & EncodedFrame::kRefreshAltRef) {
+            longTerm_[kAltRefSlot].frameId = encoded.frameId;
+        }
+        framesSinceLongTermRefresh_ = (refreshFlags & (EncodedFrame::kRefreshGolden | EncodedFrame::kRefreshAltRef))
+            ? 0 : framesSinceLongTermRefresh_ + 1;
+        // LAST solo lo actualiza la capa base
+        if (encoded.temporalLayer == 0) {
+            lastFrameId_ = encoded.frameId;
+        }
+        if (temporalLayers_ > 1) {
+            temporalIndex_ = encoded.keyFrame ? 1 : temporalIndex_ + 1;
+            temporalIndex_ %= static_cast<uint32_t>(temporalPattern().size());
+        }
+
+        // Tras un keyframe (acotado) la banda de intra refresh recorre el frame
+        // (avanza con la base: lo refrescado en una capa de mejora no persiste)
+        if (encoded.keyFrame) {
+            refreshFramesLeft_ = codecKind_ == VpxCodec::Vp8 ? intraRefreshFrames_ : 0;
+        } else if (encoded.temporalLayer == 0 && refreshFramesLeft_ > 0 && --refreshFramesLeft_ == 0) {
+            roiDirty_ = true;   // Quitar la banda del mapa de segmentos
+        }
+    }
+
+    // ========== ROI: segmentación VP8 por macrobloque ==========
+    // Incluye la banda de intra refresh, que usa el último segmento
+    void applyRoiMap() {
+        roiDirty_ = false;
+        const uint32_t mbCols = (width_ + 15) / 16;
+        const uint32_t mbRows = (height_ + 15) / 16;
+
+        vpx_roi_map_t roi{};
+        roi.rows = mbRows;
+        roi.cols = mbCols;
+
+        const bool refreshBand = refreshFramesLeft_ > 0;
+        if (roi_.empty() && !refreshBand) {
+            if (roiActive_) {
+                // roi_map nulo desactiva la segmentación
+                setRoiControl(&roi);
+                roiActive_ = false;
+                roiSegments_.clear();
+            }
+            return;
+        }
+
+        std::vector<uint8_t> segments(static_cast<size_t>(mbRows) * mbCols, 0);
+        for (const auto& region : roi_.regions) {
+            if (region.x >= width_ || region.y >= height_ || region.width == 0 || region.height == 0) {
+                continue;
+            }
+            const uint8_t segment = std::min<uint8_t>(region.segment, RoiMap::kSegments - 1);
+            const uint32_t col0 = region.x / 16;
+            const uint32_t row0 = region.y / 16;
+            const uint32_t col1 = std::min(mbCols, (std::min(width_, region.x + region.width) + 15) / 16);
+            const uint32_t row1 = std::min(mbRows, (std::min(height_, region.y + region.height) + 15) / 16);
+            for (uint32_t row = row0; row < row1; ++row) {
+                std::fill_n(segments.begin() + static_cast<size_t>(row) * mbCols + col0, col1 - col0, segment);
+            }
+        }
+
+        auto deltaQ = roi_.deltaQ;
+        auto deltaLoopFilter = roi_.deltaLoopFilter;
+        if (refreshBand) {
+            // Banda de filas de MBs: en intraRefreshFrames_ frames cubre todo el frame
+            const uint32_t bandRows = (mbRows + intraRefreshFrames_ - 1) / intraRefreshFrames_;
+            const uint32_t row0 = std::min(mbRows, (intraRefreshFrames_ - refreshFramesLeft_) * bandRows);
+            const uint32_t row1 = std::min(mbRows, row0 + bandRows);
+            std::fill(segments.begin() + static_cast<size_t>(row0) * mbCols,
+                      segments.begin() + static_cast<size_t>(row1) * mbCols, kIntraRefreshSegment);
+            deltaQ[kIntraRefreshSegment] = kIntraRefreshDeltaQ;
+            deltaLoopFilter[kIntraRefreshSegment] = 0;
+        }
+
+        if (roiActive_ && segments == roiSegments_ &&
+            deltaQ == appliedDeltaQ_ && deltaLoopFilter == appliedDeltaLoopFilter_) {
+            return;
+        }
+
+        roi.roi_map = segments.data();
+        for (size_t i = 0; i < RoiMap::kSegments; ++i) {
+            roi.delta_q[i] = std::clamp<int>(deltaQ[i], -63, 63);
+            roi.delta_lf[i] = std::clamp<int>(deltaLoopFilter[i], -63, 63);
+            roi.static_threshold[i] = 0;
+        }
+        // VP9: sin forzar frame de referencia por segmento (0 sería intra)
+        for (auto& refFrame : roi.ref_frame) {
+            refFrame = -1;
+        }
+        if (!setRoiControl(&roi)) {
+            logging::global().log(logging::Logger::Level::Warning, name_ + ": ROI map rechazado");
+            return;
+        }
+        roiSegments_ = std::move(segments);
+        appliedDeltaQ_ = deltaQ;
+        appliedDeltaLoopFilter_ = deltaLoopFilter;
+        roiActive_ = true;
+    }
+
     void Shutdown() {
         if (initialized_) {
             vpx_codec_destroy(&codec_);
@@ -219,8 +745,11 @@ private:
         targetBitrateKbps_ = 0;
         yuvBuffer_.clear();
         colorConverter_.reset();
+        pendingCopyRects_.clear();
     }
 
+    const VpxCodec codecKind_;
+    const std::string name_;
     vpx_codec_ctx_t codec_{};
     vpx_codec_enc_cfg_t config_{};
     bool initialized_ = false;
@@ -229,12 +758,52 @@ private:
     uint32_t targetBitrateKbps_ = 0;
     std::vector<uint8_t> yuvBuffer_;
     std::unique_ptr<ColorConverter> colorConverter_;
+    std::vector<vic::capture::CopyRect> pendingCopyRects_;
+    VpxReferenceFrame reference_;
+
+    RoiMap roi_;
+    bool roiDirty_ = false;
+    bool roiActive_ = false;
+    std::vector<uint8_t> roiSegments_;
+    std::array<int8_t, RoiMap::kSegments> appliedDeltaQ_{};
+    std::array<int8_t, RoiMap::kSegments> appliedDeltaLoopFilter_{};
+
+    // Recuperación de pérdidas
+    uint32_t nextFrameId_ = 1;
+    uint32_t lastFrameId_ = 0;
+    std::array<LongTermReference, 2> longTerm_{};
+    std::optional<size_t> recoverySlot_;
+    uint32_t framesSinceLongTermRefresh_ = 0;
+
+    // Próximo frame de refinamiento en reposo (refineNextFrame)
+    bool refinePending_ = false;
+
+    // Intra refresh (0 = desactivado)
+    uint32_t intraRefreshFrames_ = 0;
+    uint32_t refreshFramesLeft_ = 0;
+
+    // Capas temporales (1 = sin capas)
+    uint32_t requestedTemporalLayers_ = 1;
+    uint32_t temporalLayers_ = 1;
+    uint32_t temporalIndex_ = 0;    // Posición en el patrón del próximo frame
+
+    uint32_t maxThreads_ = 0;       // 0 = según resolución
+
+    vic::capture::ContentType contentType_ = vic::capture::ContentType::Text;
+
+    // Governor de velocidad (presupuesto 0 = preset fijo)
+    uint32_t frameBudgetUs_ = 0;
+    SpeedGovernor governor_;
 };
 
 } // namespace
 
 std::unique_ptr<VideoEncoder> createVp8Encoder() {
-    return std::make_unique<LibvpxEncoder>();
+    return std::make_unique<LibvpxEncoder>(VpxCodec::Vp8);
+}
+
+std::unique_ptr<VideoEncoder> createVp9Encoder() {
+    return std::make_unique<LibvpxEncoder>(VpxCodec::Vp9);
 }
 
 } // namespace vic::encoder
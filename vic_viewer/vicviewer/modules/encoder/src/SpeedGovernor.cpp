@@ -0,0 +1,92 @@
+#include "SpeedGovernor.h"
+
+#include <algorithm>
+
+namespace vic::encoder {
+
+namespace {
+
+// Uso objetivo del presupuesto: el resto queda para captura, escalado y envío
+constexpr double kHighUtilisation = 0.85;
+constexpr double kLowUtilisation = 0.5;
+constexpr double kTargetUtilisation = 0.7;
+// Pasado de presupuesto (se pierden frames): saltos más grandes de cpu-used
+constexpr double kOverBudget = 1.0;
+constexpr double kSmoothing = 0.1;            // Peso del último frame en el promedio
+constexpr uint32_t kSettleFrames = 30;        // Frames entre ajustes (~1 s a 30 fps)
+constexpr uint32_t kMaxTokenPartitionsLog2 = 3;
+
+} // namespace
+
+void SpeedGovernor::configure(uint32_t budgetUs, const SpeedGovernorLimits& limits, const EncoderSpeedState& initial) {
+    budgetUs_ = budgetUs;
+    limits_ = limits;
+    limits_.maxThreads = std::max<uint32_t>(1, limits_.maxThreads);
+    state_ = initial;
+    state_.cpuUsed = std::clamp(state_.cpuUsed, limits_.minCpuUsed, limits_.maxCpuUsed);
+    state_.threads = std::clamp<uint32_t>(state_.threads, 1, limits_.maxThreads);
+    state_.tokenPartitions = partitionsFor(state_.threads);
+    state_.utilisation = 0.0;
+    threadsPinned_ = false;
+    framesSinceChange_ = 0;
+    hasSample_ = false;
+}
+
+bool SpeedGovernor::observe(uint32_t encodeUs) {
+    if (!enabled()) {
+        return false;
+    }
+    const double utilisation = static_cast<double>(encodeUs) / budgetUs_;
+    state_.utilisation = hasSample_ ? state_.utilisation + kSmoothing * (utilisation - state_.utilisation) : utilisation;
+    hasSample_ = true;
+    if (++framesSinceChange_ < kSettleFrames) {
+        return false;
+    }
+
+    const EncoderSpeedState previous = state_;
+    if (state_.utilisation > kHighUtilisation) {
+        // Primero más hilos (no cuesta calidad), después un preset más rápido
+        if (!threadsPinned_ && state_.threads < limits_.maxThreads) {
+            ++state_.threads;
+        } else {
+            const int step = state_.utilisation > kOverBudget ? 2 : 1;
+            state_.cpuUsed = std::min(state_.cpuUsed + step, limits_.maxCpuUsed);
+        }
+    } else if (state_.utilisation < kLowUtilisation) {
+        // Con margen: primero calidad; ya al tope, devolver cores al resto del host
+        if (state_.cpuUsed > limits_.minCpuUsed) {
+            --state_.cpuUsed;
+        } else if (!threadsPinned_ && state_.threads > 1 &&
+                   state_.utilisation * state_.threads / (state_.threads - 1) < kTargetUtilisation) {
+            --state_.threads;
+        }
+    }
+    state_.tokenPartitions = partitionsFor(state_.threads);
+
+    if (state_.cpuUsed == previous.cpuUsed && state_.threads == previous.threads) {
+        return false;
+    }
+    framesSinceChange_ = 0;
+    return true;
+}
+
+void SpeedGovernor::pinThreads(uint32_t threads) {
+    threadsPinned_ = true;
+    state_.threads = threads;
+    state_.tokenPartitions = partitionsFor(threads);
+}
+
+uint32_t SpeedGovernor::partitionsFor(uint32_t threads) const {
+    // Una partición por hilo, sin bajar del mínimo por resolución: el decoder
+    // del viewer también las reparte entre sus hilos
+    if (!limits_.tokenPartitions) {
+        return 0;
+    }
+    uint32_t log2 = 0;
+    while ((2u << log2) <= threads && log2 < kMaxTokenPartitionsLog2) {
+        ++log2;
+    }
+    return std::max(log2, std::min(limits_.minTokenPartitions, kMaxTokenPartitionsLog2));
+}
+
+} // namespace vic::encoder
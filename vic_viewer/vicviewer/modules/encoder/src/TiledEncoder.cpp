@@ -0,0 +1,267 @@
+#include "VideoEncoder.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vic::encoder {
+
+namespace {
+
+constexpr uint32_t kDefaultBitrateKbps = 2500;
+
+// ============================================================================
+// TiledEncoder - un encoder independiente por tile, cada uno en su hilo
+// Para 4K / multi-monitor donde un solo contexto libvpx no llega a 30 fps:
+//   1. Tiles alineados a macrobloque (columnas en multi-monitor, franjas si no)
+//   2. Bitrate repartido por área, hilos internos repartidos entre tiles
+//   3. Cada tile numera sus propias referencias (EncodedTile::frameId)
+// Sin copy-rects ni capas temporales: son por frame completo y los tiles no
+// comparten referencias. La recuperación de pérdidas es por keyframe
+// ============================================================================
+class TiledEncoder final : public VideoEncoder {
+public:
+    TiledEncoder(VideoCodec codec, uint32_t tiles, TileSplit split)
+        : codec_(codec), requestedTiles_(std::max<uint32_t>(1, tiles)), split_(split) {}
+
+    bool Configure(uint32_t width, uint32_t height, uint32_t targetBitrateKbps) override {
+        if (width == 0 || height == 0) {
+            logging::global().log(logging::Logger::Level::Error, "Tiled encoder configure received invalid dimensions");
+            return false;
+        }
+
+        width_ = width;
+        height_ = height;
+        targetBitrateKbps_ = targetBitrateKbps == 0 ? kDefaultBitrateKbps : targetBitrateKbps;
+        layout_ = computeTileLayout(width_, height_, requestedTiles_, split_);
+
+        const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        const uint32_t threadsPerTile = std::max<uint32_t>(1, cores / static_cast<uint32_t>(layout_.size()));
+        const uint64_t totalArea = static_cast<uint64_t>(width_) * height_;
+
+        encoders_.clear();
+        tileFrames_.assign(layout_.size(), {});
+        for (const auto& tile : layout_) {
+            auto encoder = createEncoder(codec_);
+            if (!encoder) {
+                logging::global().log(logging::Logger::Level::Error,
+                    std::string("Tiled encoder: ") + codecName(codec_) + " no disponible");
+                encoders_.clear();
+                return false;
+            }
+            const uint64_t area = static_cast<uint64_t>(tile.width) * tile.height;
+            const auto bitrate = static_cast<uint32_t>(std::max<uint64_t>(1, targetBitrateKbps_ * area / totalArea));
+            encoder->setMaxThreads(threadsPerTile);
+            encoder->setFrameBudgetUs(frameBudgetUs_);
+            encoder->setIntraRefresh(intraRefreshFrames_);
+            encoder->setContentType(contentType_);
+            if (!encoder->Configure(tile.width, tile.height, bitrate)) {
+                encoders_.clear();
+                return false;
+            }
+            encoders_.push_back(std::move(encoder));
+        }
+        applyRoiMap();
+
+        if (!workers_ || workers_->size() != layout_.size()) {
+            workers_ = std::make_unique<TileWorkers>(layout_.size());
+        }
+
+        logging::global().log(logging::Logger::Level::Info,
+            std::string("Tiled encoder ") + codecName(codec_) + ": " + std::to_string(width_) + "x" +
+            std::to_string(height_) + " en " + std::to_string(layout_.size()) + " tiles, " +
+            std::to_string(threadsPerTile) + " hilos por tile");
+        return true;
+    }
+
+    std::optional<EncodedFrame> EncodeFrame(const vic::capture::DesktopFrame& frame) override {
+        if (frame.bgraData.empty()) {
+            logging::global().log(logging::Logger::Level::Warning, "Encoder received empty frame data");
+            return std::nullopt;
+        }
+        if (encoders_.empty() || frame.width != width_ || frame.height != height_) {
+            if (!Configure(frame.width, frame.height, targetBitrateKbps_ == 0 ? kDefaultBitrateKbps : targetBitrateKbps_)) {
+                return std::nullopt;
+            }
+        }
+
+        if (forceKeyframe_) {
+            forceKeyframe_ = false;
+            for (auto& encoder : encoders_) {
+                encoder->forceNextKeyframe();
+            }
+        }
+
+        // ========== Recorte + encode en paralelo, un tile por hilo ==========
+        std::vector<std::optional<EncodedFrame>> results(layout_.size());
+        std::atomic<bool> failed{false};
+        workers_->run(layout_.size(), [&](size_t index) {
+            const auto& tile = layout_[index];
+            auto& tileFrame = tileFrames_[index];
+            tileFrame.width = tileFrame.originalWidth = tile.width;
+            tileFrame.height = tileFrame.originalHeight = tile.height;
+            tileFrame.timestamp = frame.timestamp;
+            const size_t rowBytes = static_cast<size_t>(tile.width) * 4;
+            tileFrame.bgraData.resize(rowBytes * tile.height);
+            const size_t srcStride = static_cast<size_t>(frame.width) * 4;
+            const uint8_t* src = frame.bgraData.data() + tile.y * srcStride + static_cast<size_t>(tile.x) * 4;
+            for (uint32_t row = 0; row < tile.height; ++row) {
+                std::memcpy(tileFrame.bgraData.data() + row * rowBytes, src + row * srcStride, rowBytes);
+            }
+
+            results[index] = encoders_[index]->EncodeFrame(tileFrame);
+            if (!results[index]) {
+                failed = true;
+            }
+        });
+
+        if (failed) {
+            // Los tiles que sí codificaron avanzaron sus referencias y el viewer
+            // no las va a recibir: solo un keyframe de todos los tiles las alinea
+            logging::global().log(logging::Logger::Level::Warning, "Tiled encoder: falló un tile, keyframe en todos");
+            for (auto& encoder : encoders_) {
+                encoder->forceNextKeyframe();
+            }
+            return std::nullopt;
+        }
+
+        EncodedFrame result{};
+        result.timestamp = frame.timestamp;
+        result.width = width_;
+        result.height = height_;
+        result.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
+        result.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
+        result.codec = codec_;
+        result.keyFrame = true;
+
+        size_t payloadSize = 0;
+        for (const auto& encoded : results) {
+            payloadSize += encoded->payload.size();
+        }
+        result.payload.reserve(payloadSize);
+        result.tiles.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& tile = layout_[i];
+            const auto& encoded = *results[i];
+            result.payload.insert(result.payload.end(), encoded.payload.begin(), encoded.payload.end());
+            result.tiles.push_back({tile.x, tile.y, tile.width, tile.height,
+                static_cast<uint32_t>(encoded.payload.size()), encoded.keyFrame,
+                encoded.frameId, encoded.referenceFrameId, encoded.referenceFlags});
+            result.keyFrame = result.keyFrame && encoded.keyFrame;
+        }
+        // frameId 0: las referencias se verifican por tile
+        return result;
+    }
+
+    std::vector<uint8_t> Flush() override {
+        return {};
+    }
+
+    void setRoiMap(const RoiMap& map) override {
+        roiMap_ = map;
+        applyRoiMap();
+    }
+
+    bool setQuantizerRange(uint32_t minQuantizer, uint32_t maxQuantizer) override {
+        bool ok = !encoders_.empty();
+        for (auto& encoder : encoders_) {
+            ok = encoder->setQuantizerRange(minQuantizer, maxQuantizer) && ok;
+        }
+        return ok;
+    }
+
+    void resetQuantizerRange() override {
+        for (auto& encoder : encoders_) {
+            encoder->resetQuantizerRange();
+        }
+    }
+
+    void refineNextFrame() override {
+        for (auto& encoder : encoders_) {
+            encoder->refineNextFrame();
+        }
+    }
+
+    void setIntraRefresh(uint32_t periodFrames) override {
+        intraRefreshFrames_ = periodFrames;
+    }
+
+    void setContentType(vic::capture::ContentType type) override {
+        contentType_ = type;
+        for (auto& encoder : encoders_) {
+            encoder->setContentType(type);
+        }
+    }
+
+    // Los tiles corren en paralelo: cada uno tiene el presupuesto completo
+    void setFrameBudgetUs(uint32_t budgetUs) override {
+        frameBudgetUs_ = budgetUs;
+    }
+
+    // El tile más cargado es el que marca el tiempo del frame
+    std::optional<EncoderSpeedState> speedState() const override {
+        std::optional<EncoderSpeedState> slowest;
+        for (const auto& encoder : encoders_) {
+            const auto state = encoder->speedState();
+            if (state && (!slowest || state->utilisation > slowest->utilisation)) {
+                slowest = state;
+            }
+        }
+        return slowest;
+    }
+
+private:
+    // Cada tile recibe las regiones que lo tocan, recortadas y en sus coordenadas
+    void applyRoiMap() {
+        for (size_t i = 0; i < encoders_.size(); ++i) {
+            const auto& tile = layout_[i];
+            RoiMap tileMap{};
+            tileMap.deltaQ = roiMap_.deltaQ;
+            tileMap.deltaLoopFilter = roiMap_.deltaLoopFilter;
+            for (const auto& region : roiMap_.regions) {
+                const uint32_t left = std::max(region.x, tile.x);
+                const uint32_t top = std::max(region.y, tile.y);
+                const uint32_t right = std::min(region.x + region.width, tile.x + tile.width);
+                const uint32_t bottom = std::min(region.y + region.height, tile.y + tile.height);
+                if (left >= right || top >= bottom) {
+                    continue;
+                }
+                tileMap.regions.push_back({left - tile.x, top - tile.y, right - left, bottom - top, region.segment});
+            }
+            encoders_[i]->setRoiMap(tileMap);
+        }
+    }
+
+    const VideoCodec codec_;
+    const uint32_t requestedTiles_;
+    const TileSplit split_;
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t targetBitrateKbps_ = 0;
+    uint32_t intraRefreshFrames_ = 0;
+    uint32_t frameBudgetUs_ = 0;
+    vic::capture::ContentType contentType_ = vic::capture::ContentType::Text;
+    RoiMap roiMap_{};
+
+    std::vector<TileRect> layout_;
+    std::vector<std::unique_ptr<VideoEncoder>> encoders_;
+    std::vector<vic::capture::DesktopFrame> tileFrames_;   // Buffers de recorte reutilizables
+    std::unique_ptr<TileWorkers> workers_;
+};
+
+} // namespace
+
+std::unique_ptr<VideoEncoder> createTiledEncoder(VideoCodec codec, uint32_t tiles, TileSplit split) {
+    return std::make_unique<TiledEncoder>(codec, tiles, split);
+}
+
+} // namespace vic::encoder
@@ -0,0 +1,104 @@
+#include "Tiling.h"
+
+#include <algorithm>
+
+namespace vic::encoder {
+
+namespace {
+
+constexpr uint32_t kTileAlignment = 16;       // Macrobloque VP8
+constexpr uint32_t kMinTileExtent = 64;       // No partir más fino que esto
+constexpr uint32_t kWideAspectRatio = 2;      // ancho >= 2x alto: multi-monitor
+
+} // namespace
+
+std::vector<TileRect> computeTileLayout(uint32_t width, uint32_t height, uint32_t tiles, TileSplit split) {
+    if (width == 0 || height == 0) {
+        return {};
+    }
+    if (split == TileSplit::Auto) {
+        split = width >= height * kWideAspectRatio ? TileSplit::Vertical : TileSplit::Horizontal;
+    }
+    const bool vertical = split == TileSplit::Vertical;
+    const uint32_t extent = vertical ? width : height;
+
+    const uint32_t maxTiles = std::max<uint32_t>(1, extent / kMinTileExtent);
+    const uint32_t count = std::clamp<uint32_t>(tiles, 1, maxTiles);
+    uint32_t step = (extent + count - 1) / count;
+    step = (step + kTileAlignment - 1) / kTileAlignment * kTileAlignment;
+
+    std::vector<TileRect> layout;
+    for (uint32_t offset = 0; offset < extent; offset += step) {
+        const uint32_t size = std::min(step, extent - offset);
+        if (vertical) {
+            layout.push_back({offset, 0, size, height});
+        } else {
+            layout.push_back({0, offset, width, size});
+        }
+    }
+    return layout;
+}
+
+TileWorkers::TileWorkers(size_t threads) {
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&TileWorkers::workerLoop, this, i);
+    }
+}
+
+TileWorkers::~TileWorkers() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void TileWorkers::run(size_t count, const std::function<void(size_t)>& job) {
+    count = std::min(count, threads_.size());
+    if (count == 0) {
+        return;
+    }
+    std::unique_lock lock(mutex_);
+    job_ = &job;
+    jobCount_ = count;
+    pending_ = threads_.size();
+    ++generation_;
+    startCv_.notify_all();
+    doneCv_.wait(lock, [this]() { return pending_ == 0; });
+    job_ = nullptr;
+}
+
+void TileWorkers::workerLoop(size_t index) {
+    uint64_t seen = 0;
+    while (true) {
+        const std::function<void(size_t)>* job = nullptr;
+        size_t count = 0;
+        {
+            std::unique_lock lock(mutex_);
+            startCv_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            job = job_;
+            count = jobCount_;
+        }
+        if (index < count) {
+            (*job)(index);
+        }
+        {
+            std::lock_guard lock(mutex_);
+            if (--pending_ == 0) {
+                doneCv_.notify_one();
+            }
+        }
+    }
+}
+
+} // namespace vic::encoder
@@ -0,0 +1,34 @@
+#include "VideoCodec.h"
+
+namespace vic::encoder {
+
+const char* codecName(VideoCodec codec) {
+    switch (codec) {
+    case VideoCodec::Vp8:
+        return "VP8";
+    case VideoCodec::Vp9:
+        return "VP9";
+    case VideoCodec::H264:
+        return "H.264";
+    }
+    return "desconocido";
+}
+
+std::optional<CodecCapability> negotiateCodec(
+    std::span<const CodecCapability> hostPreference,
+    std::span<const CodecCapability> viewerCapabilities) {
+    for (const auto& host : hostPreference) {
+        for (const auto& viewer : viewerCapabilities) {
+            if (viewer.codec != host.codec) {
+                continue;
+            }
+            const uint8_t profiles = host.profileMask & viewer.profileMask;
+            if (profiles != 0) {
+                return CodecCapability{host.codec, profiles};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace vic::encoder
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "VideoEncoder.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vic::pipeline {
+
+/// Último keyframe y todos los deltas desde él, compartidos (sin copia) con
+/// las colas de los viewers. Un viewer que se une recibe la caché en ráfaga y
+/// sigue con el stream en vivo, sin forzar un keyframe que pagarían todos los
+/// que ya están mirando. Solo la usa el hilo de captura (no es thread-safe)
+class GopCache {
+public:
+    explicit GopCache(size_t maxBytes = 4 * 1024 * 1024);
+
+    /// Frame recién codificado, en orden. Un keyframe reinicia la caché; un
+    /// delta sin keyframe antes (o que excede el presupuesto) la invalida
+    /// hasta el próximo keyframe
+    void push(std::shared_ptr<const vic::encoder::EncodedFrame> frame);
+    void clear();
+
+    /// Hay un keyframe y la cadena completa de deltas desde él
+    [[nodiscard]] bool valid() const { return !frames_.empty(); }
+    /// Se invalidó por presupuesto: un keyframe programado la vuelve a llenar
+    [[nodiscard]] bool overflowed() const { return overflowed_; }
+
+    [[nodiscard]] const std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>>& frames() const {
+        return frames_;
+    }
+    [[nodiscard]] size_t bytes() const { return bytes_; }
+
+private:
+    size_t maxBytes_;
+    std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>> frames_;
+    size_t bytes_ = 0;
+    bool overflowed_ = false;
+};
+
+} // namespace vic::pipeline
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "ContentClassifier.h"
+#include "CursorCapturer.h"
+#include "DamageTracker.h"
 #include "DesktopCapturer.h"
 #include "FrameScaler.h"
+#include "ScrollDetector.h"
 #include "InputInjector.h"
 #include "Transport.h"
 #include "VideoEncoder.h"
@@ -10,13 +14,17 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 namespace vic::pipeline {
 
+class ViewerPeer;
+
 class HostSession {
 public:
     HostSession();
@@ -47,6 +55,7 @@ public:
     [[nodiscard]] bool isRunning() const { return running_.load(); }
     [[nodiscard]] bool hasCapturedFrame() const { return lastFrameTimestampMs_.load() != 0; }
     [[nodiscard]] bool isViewerConnected() const { return answerApplied_.load(); }
+    [[nodiscard]] size_t viewerCount() const;
     
     // Métricas
     [[nodiscard]] uint32_t currentFps() const { return currentFps_.load(); }
@@ -56,11 +65,34 @@ private:
     void captureLoop();
     void signalingLoop();
 
+    // ========== VIEWERS ==========
+    std::shared_ptr<ViewerPeer> createViewerPeer(bool withTunnel);
+    bool preparePendingViewer();
+    bool acceptViewerAnswer(const vic::transport::SessionDescription& answer,
+                            const std::vector<vic::transport::IceCandidate>& candidates);
+    void reapClosedViewers();
+    void renegotiateCodec();
+    std::vector<std::shared_ptr<ViewerPeer>> viewersSnapshot() const;
+    std::optional<vic::transport::ConnectionInfo> currentConnectionInfo();
+
     std::unique_ptr<vic::capture::DesktopCapturer> capturer_;
+    std::unique_ptr<vic::capture::CursorCapturer> cursorCapturer_;
+    std::unique_ptr<vic::capture::ScrollDetector> scrollDetector_;
+    std::unique_ptr<vic::capture::DamageTracker> damageTracker_;
+    std::unique_ptr<vic::capture::ContentClassifier> contentClassifier_;
     std::unique_ptr<vic::capture::FrameScaler> scaler_;
     std::unique_ptr<vic::encoder::VideoEncoder> encoder_;
     std::unique_ptr<vic::input::InputInjector> inputInjector_;
-    std::unique_ptr<vic::transport::TransportServer> transportServer_;
+
+    // Una sola captura + encode para todos los viewers: cada uno conectado
+    // tiene su TransportServer, su cola de envío y su capa temporal.
+    // pendingViewer_ es la oferta publicada (matchmaker / LAN) para el próximo
+    mutable std::mutex viewersMutex_;
+    std::vector<std::shared_ptr<ViewerPeer>> viewers_;
+    std::mutex signalingMutex_;  // pendingViewer_ y connectionInfo_ (signaling y LAN)
+    std::shared_ptr<ViewerPeer> pendingViewer_;
+    uint32_t nextViewerId_ = 1;
+    uint32_t tunnelViewerId_ = 0;  // Viewer con el túnel de fallback (puerto fijo: uno solo)
 
     std::atomic_bool running_{false};
     std::thread captureThread_;
@@ -74,6 +106,21 @@ private:
     std::atomic<uint64_t> lastFrameTimestampMs_{0};
     std::atomic_bool answerApplied_{false};
     vic::transport::TransportConfig transportConfig_{};
+
+    // Pedidos de recuperación de los viewers (hilo de red -> hilo de captura);
+    // los de una misma vuelta y capa se combinan en un solo frame de recuperación
+    struct PendingRecovery {
+        uint8_t layer{};   // Capa de simulcast del viewer que la pidió
+        vic::transport::RecoveryRequest request;
+    };
+    std::mutex recoveryMutex_;
+    std::vector<PendingRecovery> pendingRecoveries_;
+
+    // Codec que decodifican todos los viewers (hilo de red -> hilo de captura).
+    // Hasta recibir sus capacidades se usa VP8, que decodifica cualquier viewer
+    std::mutex codecMutex_;
+    std::optional<vic::encoder::VideoCodec> pendingCodec_;
+    vic::encoder::VideoCodec codec_{vic::encoder::VideoCodec::Vp8};
     std::string fixedCode_;  // Código fijo opcional
     
     // Configuración de stream
@@ -83,7 +130,6 @@ private:
     std::atomic<uint32_t> currentFps_{0};
     std::atomic<uint32_t> currentBitrateKbps_{0};
     std::atomic<uint64_t> frameCount_{0};
-    std::atomic<uint64_t> bytesSent_{0};
     
     // Servidor TCP para conexiones LAN directas
     std::thread lanServerThread_;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "VideoEncoder.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace vic::pipeline {
+
+/// Refinamiento en reposo: tras `afterFrames` frames sin cambios se reenvía
+/// el último frame a cuantizador fijo decreciente, uno por intervalo de frame,
+/// y después nada más. Cualquier cambio vuelve a empezar. Solo la usa el hilo
+/// de captura
+class IdleRefinement {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // El último ya es prácticamente sin pérdidas para texto
+    static constexpr std::array<uint32_t, 3> kQuantizers = {24, 12, 4};
+
+    IdleRefinement(bool enabled, uint32_t afterFrames, Clock::duration frameInterval, Clock::time_point now)
+        : enabled_(enabled), afterFrames_(afterFrames), frameInterval_(frameInterval), lastChange_(now) {}
+
+    /// La pantalla cambió (o se recodificó el último frame por un keyframe o
+    /// una recuperación): el refinamiento vuelve a esperar desde `now`
+    void restart(Clock::time_point now);
+
+    /// Cuantizador del refinamiento que corresponde en `now`, si corresponde
+    [[nodiscard]] std::optional<uint32_t> due(Clock::time_point now) const;
+
+    /// Se codificó el refinamiento de due(): el próximo espera un frame más
+    void advance() { ++step_; }
+
+    [[nodiscard]] size_t step() const { return step_; }
+
+private:
+    bool enabled_;
+    uint32_t afterFrames_;
+    Clock::duration frameInterval_;
+    Clock::time_point lastChange_;
+    size_t step_ = 0;
+};
+
+/// Rango del cuantizador de un encoder alrededor del refinamiento: fijo en los
+/// frames de refinamiento y de vuelta al normal (resetQuantizerRange) en el
+/// primero que no lo es
+class QuantizerOverride {
+public:
+    /// Antes de codificar cada frame; `refineQuantizer` = IdleRefinement::due()
+    void apply(vic::encoder::VideoEncoder& encoder, std::optional<uint32_t> refineQuantizer);
+
+    /// Encoder nuevo (cambio de codec): ya arranca en el rango normal
+    void forget() { overridden_ = false; }
+
+    [[nodiscard]] bool overridden() const { return overridden_; }
+
+private:
+    bool overridden_ = false;
+};
+
+} // namespace vic::pipeline
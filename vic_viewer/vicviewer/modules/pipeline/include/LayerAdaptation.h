@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Transport.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace vic::pipeline {
+
+/// Capa temporal más alta que se le envía a un viewer. Bajo congestión (cola
+/// acumulada o DataChannel con mucho pendiente) baja una capa cada medio
+/// segundo; sube de a una tras 3 s sin congestión. Es la única política de
+/// descarte por capa temporal: el transporte envía todo lo que recibe.
+/// Solo la usa el hilo de envío del viewer
+class TemporalLayerAdapter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kCongestedQueueDepth = 3;
+    static constexpr size_t kCongestedBufferedBytes = 512 * 1024;
+    static constexpr auto kDownInterval = std::chrono::milliseconds(500);
+    static constexpr auto kUpAfter = std::chrono::seconds(3);
+
+    /// Capas 0..temporalLayers-1, empezando por la más alta
+    void reset(uint32_t temporalLayers, Clock::time_point now);
+
+    /// Con la cola en vivo y lo pendiente en el DataChannel tras un envío.
+    /// Devuelve la capa nueva si cambió
+    std::optional<uint8_t> update(size_t queueDepth, size_t bufferedBytes, Clock::time_point now);
+
+    [[nodiscard]] uint8_t maxLayer() const { return layer_; }
+
+private:
+    uint8_t layer_ = 0;
+    uint8_t topLayer_ = 0;
+    Clock::time_point lastChange_{};
+    Clock::time_point lastCongestion_{};
+};
+
+/// Capa de simulcast de un viewer (0 = completa, 1 = reducida) según el
+/// ancho de banda que mide su hilo de envío. Baja si el enlace no da 1.2x el
+/// bitrate de la capa completa. Para subir no hay medición que sirva: en la
+/// capa reducida el enlace solo limita si ni siquiera da esa capa, así que se
+/// prueba la completa tras un rato sin cuello de botella. Una prueba que
+/// falla enseguida duplica la espera de la siguiente (hasta 80 s). Solo la
+/// usa el hilo de captura
+class SimulcastLayerPolicy {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint8_t kFullLayer = 0;
+    static constexpr uint8_t kLowLayer = 1;
+    static constexpr double kDownMargin = 1.2;
+    static constexpr auto kProbeAfter = std::chrono::seconds(10);
+    static constexpr auto kMaxProbeAfter = std::chrono::seconds(80);
+    static constexpr auto kFailedProbe = std::chrono::seconds(10);
+
+    explicit SimulcastLayerPolicy(Clock::time_point now) : lastSwitch_(now) {}
+
+    /// bottleneckKbps: ViewerPeer::bottleneckKbps() (0 = el enlace no limita).
+    /// Devuelve la capa a la que hay que cambiar, si corresponde
+    std::optional<uint8_t> evaluate(uint8_t layer, uint32_t bottleneckKbps, double fullKbps, Clock::time_point now);
+
+    [[nodiscard]] Clock::duration probeAfter() const { return probeAfter_; }
+
+private:
+    Clock::time_point lastSwitch_;
+    Clock::duration probeAfter_ = kProbeAfter;
+    bool probing_ = false;      // Subió de prueba y todavía no se confirmó
+};
+
+/// Long-term que conservan todos los viewers que pidieron recuperación en la
+/// misma vuelta: un solo frame de recuperación les sirve a todos. Vacío = el
+/// encoder cae a keyframe
+std::vector<uint32_t> commonIntactFrames(const std::vector<vic::transport::RecoveryRequest>& requests);
+
+} // namespace vic::pipeline
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CursorShape.h"
+#include "DamageTracker.h"
+#include "RoiMap.h"
+#include "StreamConfig.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vic::pipeline {
+
+// Segmento 1: alrededor del cursor (lo que el usuario está leyendo)
+// Segmento 2: zonas editadas recientemente (donde está escribiendo)
+// El fondo (segmento 0) cede un poco de calidad para que el bitrate total no cambie
+constexpr uint8_t kRoiCursorSegment = 1;
+constexpr uint8_t kRoiEditSegment = 2;
+
+/// Construir el mapa ROI en coordenadas del frame codificado a partir de
+/// cursor y ediciones (ambos en coordenadas de la pantalla original). Las
+/// zonas se recortan al frame; vacío si no queda ninguna
+vic::encoder::RoiMap buildRoiMap(const StreamConfig& config,
+                                 const vic::capture::CursorState& cursor,
+                                 const std::vector<vic::capture::DamageRect>& edits,
+                                 uint32_t srcWidth, uint32_t srcHeight,
+                                 uint32_t dstWidth, uint32_t dstHeight);
+
+} // namespace vic::pipeline
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "VideoEncoder.h"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace vic::pipeline {
+
+/// Cola de envío de un viewer: los frames compartidos que le toca mandar, la
+/// ráfaga GOP al frente y el conteo hasta su primera imagen. No es
+/// thread-safe: ViewerPeer la usa bajo su mutex
+class SendQueue {
+public:
+    using FramePtr = std::shared_ptr<const vic::encoder::EncodedFrame>;
+
+    enum class PushResult {
+        Queued,
+        AwaitingKeyframe,   // Delta sin su keyframe: descartado
+        Overflowed          // Cola llena: se vació y quedó solo este frame
+    };
+
+    struct Entry {
+        FramePtr frame;
+        bool burst{false};        // Era de la ráfaga GOP
+        bool joined{false};       // Completó la primera imagen del viewer
+        size_t liveDepth{};       // Frames en vivo que quedan detrás
+    };
+
+    /// Frames en vivo antes de vaciar la cola: ni en la capa base el viewer
+    /// alcanza al encoder. Sin los descartados detecta la referencia faltante
+    /// y pide recuperación
+    static constexpr size_t kMaxLive = 8;
+    /// Mientras sale la ráfaga GOP el stream en vivo se acumula detrás
+    static constexpr size_t kMaxLiveDuringBurst = 64;
+
+    PushResult push(FramePtr frame);
+    std::optional<Entry> pop();
+
+    /// Vaciar y esperar un keyframe. join = contar hasta la primera imagen
+    /// (el keyframe que llegue)
+    void awaitKeyframe(bool join);
+    /// Arrancar con la ráfaga GOP (keyframe + deltas); el vivo sigue detrás
+    /// false = la caché no empieza en un keyframe (no se usó)
+    bool prime(const std::vector<FramePtr>& gop);
+    void clear();
+
+    [[nodiscard]] bool empty() const { return queue_.empty(); }
+    [[nodiscard]] size_t size() const { return queue_.size(); }
+    [[nodiscard]] size_t liveDepth() const { return queue_.size() - burstRemaining_; }
+
+private:
+    std::deque<FramePtr> queue_;
+    bool awaitingKeyframe_ = true;
+    size_t burstRemaining_ = 0;     // Frames de la ráfaga GOP todavía al frente
+    size_t joinFramesLeft_ = 0;     // Hasta la primera imagen (0 = no se mide)
+};
+
+} // namespace vic::pipeline
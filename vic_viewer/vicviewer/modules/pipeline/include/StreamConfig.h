@@ -24,7 +24,67 @@ struct StreamConfig {
     
     // Captura
     uint32_t captureTimeoutMs = 16;  // ~60 FPS máximo de captura
-    bool enableCursorOverlay = true;
+    bool enableCursorOverlay = true;  // Enviar cursor como metadatos (el viewer lo compone)
+    bool enableScrollDetection = true;  // Scroll/ventanas movidas como copy-rects sobre la referencia
+    
+    // Región de interés: más calidad alrededor del cursor y de lo editado recientemente
+    bool enableRoi = true;
+    uint32_t roiCursorRadius = 128;     // Píxeles (pantalla original) alrededor del cursor
+    uint32_t roiRecentEditMs = 2000;    // Ventana para considerar una zona "recién editada"
+    
+    // Refinamiento en reposo: con la pantalla quieta se envían unos pocos frames
+    // a cuantizador decreciente hasta casi sin pérdidas, y luego nada más
+    bool enableIdleRefinement = true;
+    uint32_t idleRefineAfterFrames = 6; // Frames sin cambios antes del primer refinamiento
+    
+    // Intra refresh: sin keyframes periódicos; un viewer nuevo converge en
+    // intraRefreshFrames frames con bitrate parejo en lugar de un pico enorme
+    bool enableIntraRefresh = false;
+    uint32_t intraRefreshFrames = 30;
+    
+    // Capas temporales (1-3): bajo congestión se descartan los frames de las
+    // capas de mejora y el frame rate baja a la mitad sin keyframe. 1 = sin capas
+    uint32_t temporalLayers = 1;
+    
+    // Viewers simultáneos (técnicos mirando el mismo host) sobre una sola
+    // captura y un solo encode. Con temporalLayers >= 2 un viewer lento baja de
+    // capa (menos fps) sin frenar a los demás
+    uint32_t maxViewers = 3;
+    
+    // Caché GOP: el último keyframe y los deltas desde él. Un viewer que se une
+    // (o reconecta) la recibe en ráfaga en lugar de forzar un keyframe para
+    // todos. Si supera el presupuesto se renueva con un keyframe recién cuando
+    // hay un viewer por unirse (con intra refresh no llegan keyframes solos)
+    bool enableGopCache = true;
+    uint32_t gopCacheMaxKB = 4096;
+    
+    // Simulcast: un segundo encoder, en otro hilo, sobre la misma entrada
+    // escalada a 1/simulcastLowDivisor por lado (1/4 del área con 2). Cada
+    // viewer recibe la capa que su ancho de banda soporta y cambia de capa en
+    // un keyframe (o desde la caché GOP de la capa nueva). Cuesta un encode más
+    bool enableSimulcast = false;
+    uint32_t simulcastLowDivisor = 2;
+    uint32_t simulcastLowBitrateKbps = 500;
+    
+    // Grabación de la sesión (auditoría): el stream ya codificado de la capa
+    // completa se copia a IVF + índice de keyframes, sin re-encodear, desde un
+    // hilo propio que escribe por lotes. Un segmento nuevo por cambio de codec
+    bool enableRecording = false;
+    std::string recordingDirectory = "recordings";
+    
+    // Encoder por tiles: cada tile con su propio encoder en su propio core,
+    // para 4K / multi-monitor. Sin copy-rects ni capas temporales. 1 = un solo encoder
+    uint32_t encoderTiles = 1;
+    
+    // Governor de velocidad: mide el encode contra 1000/maxFramerate y ajusta
+    // cpu-used, hilos y particiones. false = preset fijo (cpu-used 10)
+    bool enableSpeedGovernor = true;
+    
+    // Clasificador de contenido: texto / video / estático por frame, y el
+    // encoder cambia modo de pantalla, denoiser y cuantizador en caliente.
+    // En estático la captura se sondea a staticFramerate en lugar de maxFramerate
+    bool enableContentClassifier = true;
+    uint32_t staticFramerate = 15;
     
     // Input
     bool enableInputCoalescing = true;  // Agrupar eventos de mouse move
@@ -5,14 +5,37 @@
 #include "MatchmakerClient.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 namespace vic::pipeline {
 
+/// Cursor remoto para componer sobre el frame al momento de pintar
+struct RemoteCursor {
+    vic::capture::CursorState state{};
+    std::shared_ptr<const vic::capture::CursorShape> shape;  // nullptr si aún no llegó
+};
+
+/// Un frame recibido, para load tests y el viewer headless
+struct ViewerFrameStats {
+    uint32_t frameId{};
+    size_t bytes{};
+    bool keyFrame{};
+    bool decoded{};      // false en modo solo conteo o si el decoder lo descartó
+    bool presented{};    // Imagen entregada al sink/callback (si este no decodificó, la del anterior de la ráfaga)
+    std::chrono::steady_clock::time_point arrival{};  // Llegada desde la red
+    double queueUs{};    // Espera en la cola de decode
+    double decodeUs{};   // Decode (+ conversión si se presentó), sin presentar
+};
+
 class ViewerSession {
 public:
     ViewerSession();
@@ -27,6 +50,20 @@ public:
 
     void setFrameCallback(std::function<void(const vic::capture::DesktopFrame&)> callback);
 
+    /// El decoder escribe los pixels directo en el buffer del renderer
+    /// (reemplaza al frame callback, sin copias por frame)
+    void setFrameSink(std::shared_ptr<vic::decoder::FrameSink> sink);
+
+    /// Estadísticas de cada frame, llamado en el hilo de decode (configurar antes de conectar)
+    void setFrameStatsCallback(std::function<void(const ViewerFrameStats&)> callback);
+
+    /// false = solo contar frames, sin decodificar (carga de red pura sobre host/relay)
+    void setDecodeEnabled(bool enabled) { decodeEnabled_.store(enabled); }
+
+    /// Notificación de cambio de cursor (posición o forma); leer con remoteCursor()
+    void setCursorCallback(std::function<void(const RemoteCursor&)> callback);
+    [[nodiscard]] RemoteCursor remoteCursor() const;
+
     bool sendMouseEvent(const vic::input::MouseEvent& ev);
     bool sendKeyboardEvent(const vic::input::KeyboardEvent& ev);
 
@@ -35,10 +72,45 @@ public:
     void disableAutoReconnect();
 
 private:
+    struct QueuedFrame {
+        vic::encoder::EncodedFrame frame;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void attachClientHandlers();
+    void enqueueEncodedFrame(const vic::encoder::EncodedFrame& frame);
+    void startDecodeThread();
+    void stopDecodeThread();
+    void decodeLoop();
+    void handleEncodedFrame(const QueuedFrame& queued, bool present);
+    void requestRecoveryIfNeeded();
+    void handleCursorPosition(const vic::capture::CursorState& state);
+    void handleCursorShape(const vic::capture::CursorShape& shape);
+
     std::unique_ptr<vic::transport::TransportClient> client_;
     std::unique_ptr<vic::decoder::VideoDecoder> decoder_;
+    vic::encoder::VideoCodec decoderCodec_{vic::encoder::VideoCodec::Vp8};
+    bool decoderTiled_ = false;
+
+    // Hilo de decode: el callback de red solo encola; el hilo decodifica todo
+    // lo encolado (VP8 necesita cada referencia) y presenta solo el más nuevo
+    std::thread decodeThread_;
+    std::mutex decodeMutex_;
+    std::condition_variable decodeCv_;
+    std::deque<QueuedFrame> decodeQueue_;
+    bool decodeRunning_ = false;
+    std::atomic_bool decodeEnabled_{true};
 
     std::function<void(const vic::capture::DesktopFrame&)> frameCallback_;
+    std::shared_ptr<vic::decoder::FrameSink> frameSink_;
+    std::function<void(const ViewerFrameStats&)> frameStatsCallback_;
+    std::chrono::steady_clock::time_point lastRecoveryRequest_{};
+
+    // Cursor remoto: formas cacheadas por hash (el host envía cada una una sola vez)
+    mutable std::mutex cursorMutex_;
+    vic::capture::CursorState cursorState_{};
+    std::unordered_map<uint64_t, std::shared_ptr<const vic::capture::CursorShape>> cursorShapes_;
+    std::function<void(const RemoteCursor&)> cursorCallback_;
     std::atomic_bool connected_{false};
     std::atomic_bool reconnectRunning_{false};
     std::thread reconnectThread_;
@@ -0,0 +1,36 @@
+#include "GopCache.h"
+
+#include <utility>
+
+namespace vic::pipeline {
+
+GopCache::GopCache(size_t maxBytes)
+        : maxBytes_(maxBytes) {
+}
+
+void GopCache::push(std::shared_ptr<const vic::encoder::EncodedFrame> frame) {
+    if (frame->keyFrame) {
+        clear();
+    } else if (frames_.empty()) {
+        // Delta sin su keyframe (caché invalidada o recién creada): inservible
+        return;
+    }
+
+    if (!frame->keyFrame && bytes_ + frame->payload.size() > maxBytes_) {
+        // Un viewer nuevo tardaría más en recibir la ráfaga que en esperar un
+        // keyframe: mejor descartarla y que el host programe uno
+        clear();
+        overflowed_ = true;
+        return;
+    }
+    bytes_ += frame->payload.size();
+    frames_.push_back(std::move(frame));
+}
+
+void GopCache::clear() {
+    frames_.clear();
+    bytes_ = 0;
+    overflowed_ = false;
+}
+
+} // namespace vic::pipeline
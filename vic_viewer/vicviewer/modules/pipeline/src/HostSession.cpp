@@ -1,15 +1,28 @@
 #include "HostSession.h"
 
 #include "FrameScaler.h"
+#include "GopCache.h"
+#include "IdleRefinement.h"
+#include "LayerAdaptation.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include "NvencEncoder.h"
+#include "RegionOfInterest.h"
+#include "SessionRecorder.h"
 #include "StreamConfig.h"
+#include "ViewerPeer.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <optional>
 #include <random>
+#include <span>
 #include <sstream>
+#include <unordered_map>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
@@ -35,6 +48,26 @@ std::vector<std::string> splitList(const char* value) {
     return entries;
 }
 
+// ========== ROI ==========
+// Zonas editadas que entran en el mapa (ver buildRoiMap)
+constexpr size_t kRoiMaxEditRects = 8;
+
+// ========== CACHÉ GOP ==========
+// Con la caché llena se programa un keyframe solo si hay un viewer por unirse,
+// y como mucho uno cada tanto: si el keyframe solo ya no entra, no encadenar
+// uno tras otro
+constexpr auto kGopRefreshMinInterval = std::chrono::seconds(5);
+
+// ========== SIMULCAST ==========
+// Cada cuánto se revisa la capa de cada viewer (ver SimulcastLayerPolicy)
+constexpr auto kSimulcastEvaluateInterval = std::chrono::seconds(1);
+constexpr uint8_t kFullLayer = SimulcastLayerPolicy::kFullLayer;
+constexpr uint8_t kLowLayer = SimulcastLayerPolicy::kLowLayer;
+
+bool sameContent(const vic::capture::DesktopFrame& a, const vic::capture::DesktopFrame& b) {
+    return a.width == b.width && a.height == b.height && a.bgraData == b.bgraData;
+}
+
 vic::transport::TransportConfig buildTransportConfigFromEnv() {
     vic::transport::TransportConfig config{};
 
@@ -117,6 +150,52 @@ vic::transport::TransportConfig buildTransportConfigFromEnv() {
     return config;
 }
 
+/// Encoder para el stream: por tiles si la config lo pide (4K / multi-monitor),
+/// con intra refresh, capas temporales y presupuesto por frame ya aplicados
+std::unique_ptr<vic::encoder::VideoEncoder> createStreamEncoder(vic::encoder::VideoCodec codec,
+                                                                const StreamConfig& config) {
+    auto encoder = config.encoderTiles > 1
+        ? vic::encoder::createTiledEncoder(codec, config.encoderTiles)
+        : vic::encoder::createEncoder(codec);
+    if (encoder) {
+        encoder->setIntraRefresh(config.enableIntraRefresh ? config.intraRefreshFrames : 0);
+        encoder->setTemporalLayers(config.temporalLayers);
+        if (config.enableSpeedGovernor && config.maxFramerate > 0) {
+            encoder->setFrameBudgetUs(1'000'000 / config.maxFramerate);
+        }
+    }
+    return encoder;
+}
+
+/// Capa reducida del simulcast: su propio encoder sobre la misma entrada
+/// escalada otra vez, su caché GOP y sus pedidos de keyframe y recuperación.
+/// La usa el hilo de captura (y un worker durante el encode)
+struct SimulcastLowLayer {
+    std::unique_ptr<vic::encoder::VideoEncoder> encoder;
+    vic::capture::FrameScaler scaler;
+    GopCache cache;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool keyframePending = false;
+    QuantizerOverride quantizer;
+    std::optional<std::vector<uint32_t>> recovery;
+};
+
+/// Costo acumulado de una capa para las métricas (se vuelca una vez por segundo)
+struct LayerCost {
+    double encodeUs = 0;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+};
+
+std::unique_ptr<vic::encoder::VideoEncoder> createLowLayerEncoder(vic::encoder::VideoCodec codec,
+                                                                  const StreamConfig& config) {
+    // La capa reducida es chica: un solo encoder aunque la completa vaya por tiles
+    auto lowConfig = config;
+    lowConfig.encoderTiles = 1;
+    return createStreamEncoder(codec, lowConfig);
+}
+
 std::string generateCode() {
     static constexpr char alphabet[] = "ABCDEFGHJKLMNPQRSTUVWXYZ23456789";
     static thread_local std::mt19937 rng{std::random_device{}()};
@@ -132,10 +211,13 @@ std::string generateCode() {
 
 HostSession::HostSession()
         : capturer_(std::make_unique<vic::capture::DesktopCapturer>()),
+          cursorCapturer_(std::make_unique<vic::capture::CursorCapturer>()),
+          scrollDetector_(std::make_unique<vic::capture::ScrollDetector>()),
+          damageTracker_(std::make_unique<vic::capture::DamageTracker>()),
+          contentClassifier_(std::make_unique<vic::capture::ContentClassifier>()),
           scaler_(std::make_unique<vic::capture::FrameScaler>()),
-          encoder_(vic::encoder::createBestEncoder()),
-          inputInjector_(std::make_unique<vic::input::InputInjector>()),
-          transportServer_(std::make_unique<vic::transport::TransportServer>()) {
+          encoder_(vic::encoder::createVp8Encoder()),
+          inputInjector_(std::make_unique<vic::input::InputInjector>()) {
     // NO crear matchmakerClient_ aquí - se crea en signalingLoop con la URL correcta
     // Aplicar preset por defecto (Medium = 720p)
     streamConfig_.applyPreset(QualityPreset::Medium);
@@ -169,15 +251,18 @@ bool HostSession::start(uint16_t /*port*/) {
 
     transportConfig_ = buildTransportConfigFromEnv();
 
-    transportServer_->setInputHandlers(
-        [this](const vic::input::MouseEvent& ev) {
-            inputInjector_->inject(ev);
-        },
-        [this](const vic::input::KeyboardEvent& ev) {
-            inputInjector_->inject(ev);
-        });
+    {
+        std::lock_guard lock(viewersMutex_);
+        viewers_.clear();
+    }
+    {
+        std::lock_guard lock(recoveryMutex_);
+        pendingRecoveries_.clear();
+    }
+    tunnelViewerId_ = 0;
 
-    if (!transportServer_->start(transportConfig_)) {
+    auto firstViewer = createViewerPeer(transportConfig_.tunnel.has_value());
+    if (!firstViewer) {
         logging::global().log(logging::Logger::Level::Error, "Failed to start WebRTC transport server");
         return false;
     }
@@ -187,11 +272,11 @@ bool HostSession::start(uint16_t /*port*/) {
     vic::transport::OfferBundle offerBundle;
     try {
         logging::global().log(logging::Logger::Level::Info, "HostSession: creating WebRTC offer bundle");
-        offerBundle = transportServer_->createOfferBundle();
+        offerBundle = firstViewer->server().createOfferBundle();
     } catch (const std::exception& ex) {
         logging::global().log(logging::Logger::Level::Error,
             std::string("Failed to create WebRTC offer: ") + ex.what());
-        transportServer_->stop();
+        firstViewer->stop();
         return false;
     }
 
@@ -209,7 +294,11 @@ bool HostSession::start(uint16_t /*port*/) {
     connectionInfo_->offer = std::move(offerBundle.description);
     connectionInfo_->iceCandidates = std::move(offerBundle.iceCandidates);
     connectionInfo_->iceServers = transportConfig_.iceServers;
-    transportServer_->setConnectionInfo(*connectionInfo_);
+    firstViewer->server().setConnectionInfo(*connectionInfo_);
+    {
+        std::lock_guard lock(signalingMutex_);
+        pendingViewer_ = std::move(firstViewer);
+    }
 
     logging::global().log(logging::Logger::Level::Info,
         std::string("HostSession: provisional session code ") + connectionInfo_->code);
@@ -240,14 +329,224 @@ void HostSession::stop() {
     if (lanServerThread_.joinable()) {
         lanServerThread_.join();
     }
-    if (transportServer_) {
-        transportServer_->stop();
+    std::vector<std::shared_ptr<ViewerPeer>> viewers;
+    {
+        std::lock_guard lock(viewersMutex_);
+        viewers.swap(viewers_);
+    }
+    for (const auto& viewer : viewers) {
+        viewer->stop();
+    }
+    {
+        std::lock_guard lock(signalingMutex_);
+        if (pendingViewer_) {
+            pendingViewer_->stop();
+            pendingViewer_.reset();
+        }
+        connectionInfo_.reset();
     }
-    connectionInfo_.reset();
 
     logging::global().log(logging::Logger::Level::Info, "HostSession: stopped");
 }
 
+size_t HostSession::viewerCount() const {
+    std::lock_guard lock(viewersMutex_);
+    return viewers_.size();
+}
+
+std::vector<std::shared_ptr<ViewerPeer>> HostSession::viewersSnapshot() const {
+    std::lock_guard lock(viewersMutex_);
+    return viewers_;
+}
+
+std::optional<vic::transport::ConnectionInfo> HostSession::currentConnectionInfo() {
+    std::lock_guard lock(signalingMutex_);
+    return connectionInfo_;
+}
+
+// ========== VIEWERS ==========
+
+std::shared_ptr<ViewerPeer> HostSession::createViewerPeer(bool withTunnel) {
+    // El túnel de fallback escucha en un puerto local fijo: solo un viewer a la vez
+    auto config = transportConfig_;
+    if (!withTunnel) {
+        config.tunnel.reset();
+    }
+
+    const uint32_t id = nextViewerId_++;
+    auto peer = std::make_shared<ViewerPeer>(id, std::make_unique<vic::transport::TransportServer>());
+    auto& server = peer->server();
+    server.setInputHandlers(
+        [this](const vic::input::MouseEvent& ev) {
+            inputInjector_->inject(ev);
+        },
+        [this](const vic::input::KeyboardEvent& ev) {
+            inputInjector_->inject(ev);
+        });
+    server.setRecoveryHandler([this, viewer = peer.get()](const vic::transport::RecoveryRequest& request) {
+        std::lock_guard lock(recoveryMutex_);
+        pendingRecoveries_.push_back({viewer->simulcastLayer(), request});
+    });
+    server.setCapabilitiesHandler([this, viewer = peer.get()](const std::vector<vic::encoder::CodecCapability>& capabilities) {
+        viewer->setCapabilities(capabilities);
+        renegotiateCodec();
+    });
+
+    if (!server.start(config)) {
+        return nullptr;
+    }
+    if (config.tunnel) {
+        tunnelViewerId_ = id;
+    }
+    return peer;
+}
+
+bool HostSession::preparePendingViewer() {
+    std::optional<vic::transport::ConnectionInfo> info = currentConnectionInfo();
+    if (!info) {
+        return false;
+    }
+
+    // El túnel vuelve a estar libre si el viewer que lo tenía ya se fue
+    bool tunnelFree = transportConfig_.tunnel.has_value();
+    for (const auto& viewer : viewersSnapshot()) {
+        if (viewer->id() == tunnelViewerId_) {
+            tunnelFree = false;
+        }
+    }
+
+    auto peer = createViewerPeer(tunnelFree);
+    if (!peer) {
+        logging::global().log(logging::Logger::Level::Warning, "[Host] No se pudo crear transport para otro viewer");
+        return false;
+    }
+
+    vic::transport::OfferBundle offerBundle;
+    try {
+        offerBundle = peer->server().createOfferBundle();
+    } catch (const std::exception& ex) {
+        logging::global().log(logging::Logger::Level::Warning,
+            std::string("[Host] No se pudo crear oferta para otro viewer: ") + ex.what());
+        peer->stop();
+        return false;
+    }
+
+    {
+        std::lock_guard lock(signalingMutex_);
+        if (!connectionInfo_) {
+            peer->stop();
+            return false;
+        }
+        connectionInfo_->offer = std::move(offerBundle.description);
+        connectionInfo_->iceCandidates = std::move(offerBundle.iceCandidates);
+        peer->server().setConnectionInfo(*connectionInfo_);
+        pendingViewer_ = std::move(peer);
+    }
+
+    // Publicar la oferta nueva bajo el mismo código
+    if (!externalRegistration_) {
+        registered_.store(false);
+    }
+    logging::global().log(logging::Logger::Level::Info,
+        "[Host] Oferta lista para otro viewer (" + std::to_string(viewerCount()) + "/" +
+        std::to_string(streamConfig_.maxViewers) + " conectados)");
+    return true;
+}
+
+bool HostSession::acceptViewerAnswer(const vic::transport::SessionDescription& answer,
+                                     const std::vector<vic::transport::IceCandidate>& candidates) {
+    std::shared_ptr<ViewerPeer> peer;
+    {
+        std::lock_guard lock(signalingMutex_);
+        if (!pendingViewer_ || !pendingViewer_->server().applyAnswer(answer)) {
+            return false;
+        }
+        for (const auto& candidate : candidates) {
+            logging::global().log(logging::Logger::Level::Debug, "[Host] Candidato: " + candidate.candidate);
+            pendingViewer_->server().addRemoteCandidate(candidate);
+        }
+        peer = std::move(pendingViewer_);
+    }
+
+    peer->start(streamConfig_.temporalLayers);
+    size_t count = 0;
+    {
+        std::lock_guard lock(viewersMutex_);
+        viewers_.push_back(peer);
+        count = viewers_.size();
+    }
+    answerApplied_.store(true);
+    // Las capacidades pueden haber llegado antes de estar en la lista
+    renegotiateCodec();
+
+    logging::global().log(logging::Logger::Level::Info,
+        "[Host] Viewer " + std::to_string(peer->id()) + " conectado (" + std::to_string(count) + "/" +
+        std::to_string(streamConfig_.maxViewers) + ")");
+    return true;
+}
+
+void HostSession::reapClosedViewers() {
+    std::vector<std::shared_ptr<ViewerPeer>> closed;
+    size_t remaining = 0;
+    {
+        std::lock_guard lock(viewersMutex_);
+        auto it = std::stable_partition(viewers_.begin(), viewers_.end(),
+            [](const std::shared_ptr<ViewerPeer>& viewer) { return !viewer->isClosed(); });
+        closed.assign(std::make_move_iterator(it), std::make_move_iterator(viewers_.end()));
+        viewers_.erase(it, viewers_.end());
+        remaining = viewers_.size();
+    }
+    if (closed.empty()) {
+        return;
+    }
+
+    for (const auto& viewer : closed) {
+        viewer->stop();
+        logging::global().log(logging::Logger::Level::Info,
+            "[Host] Viewer " + std::to_string(viewer->id()) + " desconectado (" +
+            std::to_string(remaining) + " restantes)");
+    }
+    // Sin viewers no se captura ni codifica
+    if (remaining == 0) {
+        answerApplied_.store(false);
+    }
+    renegotiateCodec();
+}
+
+void HostSession::renegotiateCodec() {
+    // El codec más barato para el host que decodifican TODOS los viewers que ya
+    // anunciaron sus decoders; si no hay ninguno en común, VP8
+    std::vector<std::vector<vic::encoder::CodecCapability>> viewerCodecs;
+    for (const auto& viewer : viewersSnapshot()) {
+        if (auto capabilities = viewer->capabilities()) {
+            viewerCodecs.push_back(std::move(*capabilities));
+        }
+    }
+    if (viewerCodecs.empty()) {
+        return;
+    }
+
+    const auto hostCodecs = vic::encoder::encoderCapabilities();
+    std::optional<vic::encoder::VideoCodec> chosen;
+    for (const auto& candidate : hostCodecs) {
+        const bool everyone = std::all_of(viewerCodecs.begin(), viewerCodecs.end(),
+            [&](const std::vector<vic::encoder::CodecCapability>& codecs) {
+                return vic::encoder::negotiateCodec(std::span(&candidate, 1), codecs).has_value();
+            });
+        if (everyone) {
+            chosen = candidate.codec;
+            break;
+        }
+    }
+    if (!chosen) {
+        logging::global().log(logging::Logger::Level::Warning,
+            "[Host] Sin codec en común con los viewers, se usa VP8");
+        chosen = vic::encoder::VideoCodec::Vp8;
+    }
+    std::lock_guard lock(codecMutex_);
+    pendingCodec_ = *chosen;
+}
+
 void HostSession::captureLoop() {
     logging::global().log(logging::Logger::Level::Info, 
         "Host capture loop started - Quality: " + 
@@ -263,61 +562,328 @@ void HostSession::captureLoop() {
     uint64_t framesThisSecond = 0;
     uint64_t bytesThisSecond = 0;
 
+    bool keyframePending = false;
+    std::unique_ptr<vic::capture::DesktopFrame> lastEncodedFrame;
+    uint32_t lastOriginalWidth = 0;
+    uint32_t lastOriginalHeight = 0;
+    vic::capture::CursorState cursor{};
+
+    if (auto encoder = createStreamEncoder(codec_, streamConfig_)) {
+        encoder_ = std::move(encoder);
+    }
+
+    // Perfil de contenido y cuánto tiempo/bytes lleva cada uno (métricas)
+    auto contentType = vic::capture::ContentType::Text;
+    std::array<double, vic::metrics::PipelineMetrics::kContentProfiles> contentSeconds{};
+    std::array<uint64_t, vic::metrics::PipelineMetrics::kContentProfiles> contentBytes{};
+    auto lastContentSample = std::chrono::steady_clock::now();
+    auto lastContentReport = lastContentSample;
+    contentClassifier_->reset();
+
+    // Refinamiento en reposo
+    IdleRefinement refinement(streamConfig_.enableIdleRefinement, streamConfig_.idleRefineAfterFrames,
+        std::chrono::milliseconds(1000 / std::max<uint32_t>(1, streamConfig_.maxFramerate)),
+        std::chrono::steady_clock::now());
+    QuantizerOverride quantizer;
+
+    // Caché GOP para los viewers que se unen con el stream ya en marcha
+    GopCache gopCache(static_cast<size_t>(streamConfig_.gopCacheMaxKB) * 1024);
+    auto lastKeyframeTime = std::chrono::steady_clock::now();
+
+    // Grabación: recibe los mismos frames compartidos que los viewers
+    std::unique_ptr<vic::recording::SessionRecorder> recorder;
+    if (streamConfig_.enableRecording) {
+        vic::recording::RecorderConfig recorderConfig;
+        recorderConfig.directory = streamConfig_.recordingDirectory;
+        recorder = std::make_unique<vic::recording::SessionRecorder>(std::move(recorderConfig));
+        if (!recorder->start()) {
+            logging::global().log(logging::Logger::Level::Warning, "[Host] Grabación desactivada");
+            recorder.reset();
+        }
+    }
+
+    // Simulcast: capa reducida con su encoder y dos workers (uno por capa)
+    std::unique_ptr<SimulcastLowLayer> low;
+    std::unique_ptr<vic::encoder::TileWorkers> simulcastWorkers;
+    std::unordered_map<uint32_t, SimulcastLayerPolicy> simulcastViewers;
+    std::array<LayerCost, vic::metrics::PipelineMetrics::kSimulcastLayers> layerCost{};
+    auto lastSimulcastEvaluation = std::chrono::steady_clock::now();
+    if (streamConfig_.enableSimulcast) {
+        low = std::make_unique<SimulcastLowLayer>();
+        low->encoder = createLowLayerEncoder(codec_, streamConfig_);
+        const uint32_t divisor = std::max<uint32_t>(1, streamConfig_.simulcastLowDivisor);
+        low->cache = GopCache(static_cast<size_t>(streamConfig_.gopCacheMaxKB) * 1024 / (divisor * divisor));
+        if (low->encoder) {
+            simulcastWorkers = std::make_unique<vic::encoder::TileWorkers>(2);
+        } else {
+            logging::global().log(logging::Logger::Level::Warning, "[Host] Simulcast: no se pudo crear el encoder reducido");
+            low.reset();
+        }
+    }
+
+    // Arrancar un viewer en una capa: desde su caché GOP si es válida (ráfaga,
+    // nadie más lo nota) o con un keyframe de esa capa
+    auto startViewerOnLayer = [&](const std::shared_ptr<ViewerPeer>& viewer, uint8_t layer, const char* reason) {
+        const bool lowLayer = low && layer == kLowLayer;
+        const GopCache& cache = lowLayer ? low->cache : gopCache;
+        const std::string who = "[Host] " + std::string(reason) + " (viewer " + std::to_string(viewer->id()) +
+                                (low ? ", capa " + std::to_string(layer) : std::string()) + ")";
+        if (streamConfig_.enableGopCache && cache.valid()) {
+            viewer->primeFromCache(cache.frames());
+            logging::global().log(logging::Logger::Level::Info,
+                who + " - ráfaga de " + std::to_string(cache.frames().size()) + " frames (" +
+                std::to_string(cache.bytes() / 1024) + " KB) desde la caché GOP");
+        } else {
+            logging::global().log(logging::Logger::Level::Info, who + " - forzando keyframe");
+            (lowLayer ? low->keyframePending : keyframePending) = true;
+        }
+    };
+
     while (running_.load()) {
         if (!answerApplied_.load()) {
             std::this_thread::sleep_for(10ms);
             continue;
         }
 
-        auto frame = capturer_->captureFrame();
-        if (!frame) {
-            std::this_thread::sleep_for(1ms);
-            continue;
+        // Viewers a los que va este frame (los que se conectan o caen durante
+        // la vuelta entran o salen en la siguiente)
+        const auto viewers = viewersSnapshot();
+
+        // ========== CURSOR (canal de metadatos) ==========
+        // Posición en cada movimiento y forma una sola vez por hash; el viewer
+        // lo compone localmente, así mover el mouse no genera frames de video
+        // (el ROI también usa la posición aunque no se envíe)
+        if (streamConfig_.enableCursorOverlay || streamConfig_.enableRoi) {
+            if (cursorCapturer_->poll(cursor) && streamConfig_.enableCursorOverlay) {
+                const auto* shape = cursorCapturer_->shape(cursor.shapeHash);
+                for (const auto& viewer : viewers) {
+                    viewer->server().sendCursorUpdate(cursor, shape);
+                }
+            }
         }
 
-        // ========== ESCALADO OPCIONAL ==========
-        // Si streamConfig indica resolución menor, escalar
-        vic::capture::DesktopFrame* frameToEncode = frame.get();
-        std::unique_ptr<vic::capture::DesktopFrame> scaledFrame;
-        
-        if (frame->width > streamConfig_.maxWidth || frame->height > streamConfig_.maxHeight) {
-            scaledFrame = scaler_->scale(*frame, streamConfig_.maxWidth, streamConfig_.maxHeight);
-            if (scaledFrame) {
-                frameToEncode = scaledFrame.get();
-            }
-        }
-
-        // Overlay de cursor (en el frame escalado)
-        CURSORINFO ci{ sizeof(CURSORINFO) };
-        if (streamConfig_.enableCursorOverlay && GetCursorInfo(&ci) && (ci.flags & CURSOR_SHOWING) && ci.hCursor) {
-            ICONINFO ii{};
-            if (GetIconInfo(ci.hCursor, &ii)) {
-                const int hotspotX = static_cast<int>(ii.xHotspot);
-                const int hotspotY = static_cast<int>(ii.yHotspot);
-                if (ii.hbmMask) DeleteObject(ii.hbmMask);
-                if (ii.hbmColor) DeleteObject(ii.hbmColor);
-                
-                // Calcular posición del cursor escalada
-                float scaleX = static_cast<float>(frameToEncode->width) / frame->width;
-                float scaleY = static_cast<float>(frameToEncode->height) / frame->height;
-                const int cx = static_cast<int>((ci.ptScreenPos.x - hotspotX) * scaleX);
-                const int cy = static_cast<int>((ci.ptScreenPos.y - hotspotY) * scaleY);
-                
-                // Dibujar cursor invertido (5x5 pixels)
-                for (int oy = 0; oy < 5; ++oy) {
-                    const int py = cy + oy;
-                    if (py < 0 || py >= static_cast<int>(frameToEncode->height)) continue;
-                    for (int ox = 0; ox < 5; ++ox) {
-                        const int px = cx + ox;
-                        if (px < 0 || px >= static_cast<int>(frameToEncode->width)) continue;
-                        const size_t idx = (static_cast<size_t>(py) * frameToEncode->width + px) * 4;
-                        frameToEncode->bgraData[idx + 0] = 255 - frameToEncode->bgraData[idx + 0];
-                        frameToEncode->bgraData[idx + 1] = 255 - frameToEncode->bgraData[idx + 1];
-                        frameToEncode->bgraData[idx + 2] = 255 - frameToEncode->bgraData[idx + 2];
+        // Verificar si algún DataChannel acaba de abrirse: con la caché GOP
+        // válida arranca desde ella (ráfaga) y los demás no notan nada; si no,
+        // un solo keyframe para todos los que llegaron en esta vuelta
+        for (const auto& viewer : viewers) {
+            if (viewer->takeJoinRequest()) {
+                startViewerOnLayer(viewer, viewer->simulcastLayer(), "DataChannel abierto");
+            }
+        }
+        // El grabador arranca (o retoma tras descartar por disco lento) en un
+        // keyframe; la caché GOP no sirve porque parte de ella ya puede estar escrita
+        if (recorder && recorder->takeKeyframeRequest()) {
+            keyframePending = true;
+        }
+
+        // ========== SIMULCAST: CAPA DE CADA VIEWER ==========
+        // Según el ancho de banda que mide su hilo de envío; el cambio entra en
+        // un keyframe de la capa nueva (o su caché GOP)
+        const auto evaluationNow = std::chrono::steady_clock::now();
+        if (low && evaluationNow - lastSimulcastEvaluation >= kSimulcastEvaluateInterval) {
+            lastSimulcastEvaluation = evaluationNow;
+            const double fullKbps = streamConfig_.targetBitrateKbps;
+            for (const auto& viewer : viewers) {
+                auto& policy = simulcastViewers.try_emplace(viewer->id(), evaluationNow).first->second;
+                const uint32_t bandwidth = viewer->bottleneckKbps();
+                const auto target = policy.evaluate(viewer->simulcastLayer(), bandwidth, fullKbps, evaluationNow);
+                if (!target) {
+                    continue;
+                }
+                logging::global().log(logging::Logger::Level::Info,
+                    "[Host] Simulcast: viewer " + std::to_string(viewer->id()) + " a capa " + std::to_string(*target) +
+                    " (enlace " + (bandwidth > 0 ? std::to_string(bandwidth) + " kbps" : std::string("sin límite")) + ")");
+                viewer->switchLayer(*target);
+                vic::metrics::MetricsCollector::instance().recordSimulcastSwitch();
+                startViewerOnLayer(viewer, *target, "Cambio de capa");
+            }
+            std::erase_if(simulcastViewers, [&](const auto& entry) {
+                return std::none_of(viewers.begin(), viewers.end(),
+                    [&](const std::shared_ptr<ViewerPeer>& viewer) { return viewer->id() == entry.first; });
+            });
+        }
+
+        // ========== NEGOCIACIÓN DE CODEC ==========
+        // Los viewers anunciaron sus decoders: cambiar al codec más barato que
+        // todos soportan. Encoder nuevo = reconfigurar y arrancar con keyframe
+        std::optional<vic::encoder::VideoCodec> negotiatedCodec;
+        {
+            std::lock_guard lock(codecMutex_);
+            negotiatedCodec.swap(pendingCodec_);
+        }
+        if (negotiatedCodec && *negotiatedCodec != codec_) {
+            if (auto encoder = createStreamEncoder(*negotiatedCodec, streamConfig_)) {
+                logging::global().log(logging::Logger::Level::Info,
+                    std::string("[Host] Codec negociado: ") + vic::encoder::codecName(*negotiatedCodec));
+                encoder_ = std::move(encoder);
+                encoder_->setContentType(contentType);
+                codec_ = *negotiatedCodec;
+                encoderWidth = 0;
+                encoderHeight = 0;
+                quantizer.forget();
+                keyframePending = true;
+                if (low) {
+                    if (auto lowEncoder = createLowLayerEncoder(codec_, streamConfig_)) {
+                        low->encoder = std::move(lowEncoder);
+                        low->encoder->setContentType(contentType);
                     }
+                    low->width = 0;
+                    low->height = 0;
+                    low->quantizer.forget();
+                    low->keyframePending = true;
+                }
+            }
+        }
+
+        // ========== RECUPERACIÓN DE PÉRDIDAS ==========
+        // En lugar de un keyframe (cientos de KB a 1080p, que a su vez provocan
+        // más pérdidas) el encoder codifica desde un long-term que el viewer tiene.
+        // Varios pedidos en la misma vuelta: un solo frame desde un long-term
+        // común (por capa: cada encoder tiene sus propias referencias)
+        std::optional<std::vector<uint32_t>> recovery;
+        {
+            std::vector<PendingRecovery> pending;
+            {
+                std::lock_guard lock(recoveryMutex_);
+                pending.swap(pendingRecoveries_);
+            }
+            std::array<std::vector<vic::transport::RecoveryRequest>, 2> requests;
+            for (const auto& entry : pending) {
+                requests[low && entry.layer == kLowLayer ? kLowLayer : kFullLayer].push_back(entry.request);
+            }
+            for (uint8_t layer = 0; layer < requests.size(); ++layer) {
+                if (requests[layer].empty()) {
+                    continue;
+                }
+                auto& target = layer == kLowLayer ? low->recovery : recovery;
+                target = commonIntactFrames(requests[layer]);
+                if (requests[layer].size() > 1) {
+                    logging::global().log(logging::Logger::Level::Info,
+                        "[Host] " + std::to_string(requests[layer].size()) + " pedidos de recuperación combinados (" +
+                        std::to_string(target->size()) + " long-term en común)");
+                }
+            }
+        }
+
+        auto frame = capturer_->captureFrame();
+        std::unique_ptr<vic::capture::DesktopFrame> scaledFrame;
+        uint32_t originalWidth = 0;
+        uint32_t originalHeight = 0;
+        std::vector<vic::capture::CopyRect> copyRects;
+        bool contentClassified = false;
+
+        if (frame) {
+            originalWidth = frame->width;
+            originalHeight = frame->height;
+
+            // ========== SCROLL / VENTANA ARRASTRADA ==========
+            // Se detecta sobre la captura original (siempre, para mantener el
+            // frame anterior al día) y se traduce luego a la resolución del encoder
+            if (streamConfig_.enableScrollDetection) {
+                copyRects = scrollDetector_->detect(*frame);
+            }
+            if (streamConfig_.enableRoi) {
+                damageTracker_->update(*frame);
+            }
+            if (streamConfig_.enableContentClassifier) {
+                contentClassifier_->classify(*frame);
+                contentClassified = true;
+            }
+
+            // ========== ESCALADO OPCIONAL ==========
+            // Si streamConfig indica resolución menor, escalar
+            if (frame->width > streamConfig_.maxWidth || frame->height > streamConfig_.maxHeight) {
+                scaledFrame = scaler_->scale(*frame, streamConfig_.maxWidth, streamConfig_.maxHeight);
+            }
+
+            // Mismo contenido que el último frame codificado (GDI entrega frames
+            // aunque nada cambie): tratarlo como pantalla estática
+            const auto* candidate = scaledFrame ? scaledFrame.get() : frame.get();
+            if (!keyframePending && lastEncodedFrame && sameContent(*candidate, *lastEncodedFrame)) {
+                frame.reset();
+                scaledFrame.reset();
+                copyRects.clear();
+            }
+        }
+
+        const auto loopNow = std::chrono::steady_clock::now();
+
+        // ========== PERFIL DE CONTENIDO ==========
+        // Texto / video / estático con histéresis: el encoder cambia su tuning
+        // en caliente (sin keyframe) y en estático se sondea más despacio
+        if (streamConfig_.enableContentClassifier) {
+            if (!contentClassified) {
+                contentClassifier_->classifyUnchanged(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count()));
+            }
+            const auto type = contentClassifier_->current();
+            if (type != contentType) {
+                const auto stats = contentClassifier_->lastStats();
+                logging::global().log(logging::Logger::Level::Info,
+                    std::string("[Host] Contenido: ") + vic::capture::contentTypeName(type) +
+                    " (sucio=" + std::to_string(static_cast<int>(stats.dirtyFraction * 100)) +
+                    "% ruido=" + std::to_string(static_cast<int>(stats.temporalNoise * 100)) +
+                    "% bordes=" + std::to_string(static_cast<int>(stats.edgeDensity * 100)) + "%)");
+                contentType = type;
+                encoder_->setContentType(type);
+                if (low) {
+                    low->encoder->setContentType(type);
+                }
+                vic::metrics::MetricsCollector::instance().recordContentProfile(static_cast<uint8_t>(type));
+            }
+            contentSeconds[static_cast<size_t>(contentType)] +=
+                std::chrono::duration<double>(loopNow - lastContentSample).count();
+            lastContentSample = loopNow;
+            if (loopNow - lastContentReport >= 1s) {
+                for (size_t profile = 0; profile < contentSeconds.size(); ++profile) {
+                    vic::metrics::MetricsCollector::instance().addContentProfileUsage(
+                        static_cast<uint8_t>(profile), contentSeconds[profile], contentBytes[profile]);
                 }
+                contentSeconds = {};
+                contentBytes = {};
+                lastContentReport = loopNow;
             }
         }
+        const uint32_t targetFramerate = contentType == vic::capture::ContentType::Static
+            ? std::min(streamConfig_.staticFramerate, streamConfig_.maxFramerate)
+            : streamConfig_.maxFramerate;
+
+        std::optional<uint32_t> refineQuantizer;
+        if (frame) {
+            refinement.restart(loopNow);
+        } else if ((keyframePending || recovery || (low && (low->keyframePending || low->recovery))) &&
+                   lastEncodedFrame) {
+            // Pantalla estática: DXGI no entrega frames nuevos. Recodificar el
+            // último para que el viewer recién conectado reciba su keyframe (o
+            // el que perdió frames, su recuperación) y después su refinamiento
+            frame = std::move(lastEncodedFrame);
+            refinement.restart(loopNow);
+            originalWidth = lastOriginalWidth;
+            originalHeight = lastOriginalHeight;
+            frame->timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        } else if (lastEncodedFrame && refinement.due(loopNow)) {
+            // ========== REFINAMIENTO EN REPOSO ==========
+            // Tras N frames sin cambios, reenviar el último frame a cuantizador
+            // decreciente: el texto queda nítido y después no se envía nada más
+            frame = std::move(lastEncodedFrame);
+            originalWidth = lastOriginalWidth;
+            originalHeight = lastOriginalHeight;
+            frame->timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            refineQuantizer = refinement.due(loopNow);
+        } else {
+            // Sin cambios: en estático sondear la captura a staticFramerate
+            if (contentType == vic::capture::ContentType::Static && targetFramerate > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1000 / targetFramerate) / 2);
+            } else {
+                std::this_thread::sleep_for(1ms);
+            }
+            continue;
+        }
+
+        vic::capture::DesktopFrame* frameToEncode = scaledFrame ? scaledFrame.get() : frame.get();
 
         // Configurar encoder si cambió la resolución
         if (frameToEncode->width != encoderWidth || frameToEncode->height != encoderHeight) {
@@ -332,33 +898,172 @@ void HostSession::captureLoop() {
                 std::to_string(encoderHeight) + " @ " + std::to_string(streamConfig_.targetBitrateKbps) + " kbps");
         }
 
-        // Verificar si el DataChannel acaba de abrirse y necesita keyframe
-        if (transportServer_->needsInitialKeyframe()) {
-            logging::global().log(logging::Logger::Level::Info, 
-                "[Host] DataChannel abierto - forzando keyframe inicial");
+        if (keyframePending) {
             encoder_->forceNextKeyframe();
+            keyframePending = false;
+        } else if (recovery) {
+            encoder_->requestRecovery(*recovery);
+        } else if (!copyRects.empty()) {
+            encoder_->setCopyRects(vic::capture::scaleCopyRects(copyRects,
+                originalWidth, originalHeight, frameToEncode->width, frameToEncode->height));
+        }
+
+        quantizer.apply(*encoder_, refineQuantizer);
+
+        // El refinamiento ya es uniforme: sin ROI para no degradar el fondo
+        if (refineQuantizer) {
+            encoder_->setRoiMap({});
+        } else if (streamConfig_.enableRoi) {
+            encoder_->setRoiMap(buildRoiMap(streamConfig_, cursor,
+                damageTracker_->recentEdits(streamConfig_.roiRecentEditMs, kRoiMaxEditRects),
+                originalWidth, originalHeight, frameToEncode->width, frameToEncode->height));
+        }
+
+        // ========== CAPA REDUCIDA (SIMULCAST) ==========
+        // Misma entrada escalada a 1/divisor; sin copy-rects ni ROI (se
+        // calculan para la completa), sí keyframes, recuperación y refinamiento
+        bool encodeLow = false;
+        if (low) {
+            const uint32_t divisor = std::max<uint32_t>(1, streamConfig_.simulcastLowDivisor);
+            uint32_t lowWidth = 0;
+            uint32_t lowHeight = 0;
+            vic::capture::FrameScaler::calculateScaledDimensions(frameToEncode->width, frameToEncode->height,
+                frameToEncode->width / divisor, frameToEncode->height / divisor, lowWidth, lowHeight);
+            encodeLow = true;
+            if (lowWidth != low->width || lowHeight != low->height) {
+                low->width = lowWidth;
+                low->height = lowHeight;
+                encodeLow = low->encoder->Configure(lowWidth, lowHeight, streamConfig_.simulcastLowBitrateKbps);
+                logging::global().log(encodeLow ? logging::Logger::Level::Info : logging::Logger::Level::Warning,
+                    "[Host] Encoder reducido " + std::string(encodeLow ? "configurado: " : "falló: ") +
+                    std::to_string(lowWidth) + "x" + std::to_string(lowHeight) + " @ " +
+                    std::to_string(streamConfig_.simulcastLowBitrateKbps) + " kbps");
+                if (!encodeLow) {
+                    low->width = 0;
+                }
+            }
+            if (encodeLow) {
+                if (low->keyframePending) {
+                    low->encoder->forceNextKeyframe();
+                    low->keyframePending = false;
+                } else if (low->recovery) {
+                    low->encoder->requestRecovery(*low->recovery);
+                }
+                low->recovery.reset();
+                low->quantizer.apply(*low->encoder, refineQuantizer);
+            }
+        }
+
+        std::optional<vic::encoder::EncodedFrame> encodedOpt;
+        std::optional<vic::encoder::EncodedFrame> lowEncoded;
+        std::array<double, 2> encodeUs{};
+        if (encodeLow) {
+            // Las dos capas en paralelo: el frame tarda lo que la más lenta
+            simulcastWorkers->run(2, [&](size_t index) {
+                const auto start = std::chrono::steady_clock::now();
+                if (index == kFullLayer) {
+                    encodedOpt = encoder_->EncodeFrame(*frameToEncode);
+                } else if (auto lowFrame = low->scaler.scale(*frameToEncode, low->width, low->height)) {
+                    lowEncoded = low->encoder->EncodeFrame(*lowFrame);
+                }
+                encodeUs[index] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            });
+        } else {
+            encodedOpt = encoder_->EncodeFrame(*frameToEncode);
+        }
+
+        // La capa reducida sale aunque la completa haya fallado: su encoder ya
+        // avanzó sus referencias
+        size_t lowAccepted = 0;
+        size_t lowBytes = 0;
+        if (lowEncoded) {
+            lowEncoded->originalWidth = originalWidth;
+            lowEncoded->originalHeight = originalHeight;
+            const auto lowShared = std::make_shared<const vic::encoder::EncodedFrame>(std::move(*lowEncoded));
+            // Llena no se renueva: quien baja de capa fuerza un keyframe de
+            // esta capa, que es chico
+            if (streamConfig_.enableGopCache) {
+                low->cache.push(lowShared);
+            }
+            for (const auto& viewer : viewers) {
+                if (viewer->simulcastLayer() == kLowLayer && viewer->enqueue(lowShared)) {
+                    ++lowAccepted;
+                }
+            }
+            layerCost[kLowLayer].encodeUs += encodeUs[kLowLayer];
+            layerCost[kLowLayer].frames++;
+            lowBytes = lowShared->payload.size();
+            layerCost[kLowLayer].bytes += lowBytes;
         }
 
-        auto encodedOpt = encoder_->EncodeFrame(*frameToEncode);
         if (!encodedOpt) {
             std::this_thread::sleep_for(1ms);
             continue;
         }
+        if (encodeLow) {
+            layerCost[kFullLayer].encodeUs += encodeUs[kFullLayer];
+            layerCost[kFullLayer].frames++;
+            layerCost[kFullLayer].bytes += encodedOpt->payload.size();
+        }
 
         // *** IMPORTANTE: Guardar resolución ORIGINAL para que el viewer calcule coordenadas correctas ***
-        encodedOpt->originalWidth = frame->width;
-        encodedOpt->originalHeight = frame->height;
+        encodedOpt->originalWidth = originalWidth;
+        encodedOpt->originalHeight = originalHeight;
 
-        if (!transportServer_->sendFrame(*encodedOpt)) {
+        if (refineQuantizer) {
+            refinement.advance();
+        }
+
+        // Conservar el frame codificado (sin copia) por si hay que reenviarlo
+        lastEncodedFrame = scaledFrame ? std::move(scaledFrame) : std::move(frame);
+        lastOriginalWidth = originalWidth;
+        lastOriginalHeight = originalHeight;
+
+        // ========== FAN-OUT ==========
+        // Codificado una vez, compartido por todas las colas: encolar nunca
+        // bloquea, cada viewer lo envía (o lo descarta) a su ritmo
+        const size_t frameBytes = encodedOpt->payload.size();
+        const auto shared = std::make_shared<const vic::encoder::EncodedFrame>(std::move(*encodedOpt));
+
+        // La caché sigue al encoder aunque ningún viewer acepte el frame: el
+        // próximo delta lo referencia igual
+        if (shared->keyFrame) {
+            lastKeyframeTime = loopNow;
+        }
+        if (streamConfig_.enableGopCache) {
+            gopCache.push(shared);
+            // Renovarla solo con un viewer conectándose (respuesta aplicada,
+            // DataChannel por abrir). Con intra refresh no hay keyframes
+            // periódicos: renovarla por las dudas traería de vuelta un pico
+            // cada vez que se llena (~16 s a 2 Mbps con 4 MB)
+            const bool joinPending = std::any_of(viewers.begin(), viewers.end(),
+                [](const std::shared_ptr<ViewerPeer>& viewer) { return viewer->awaitingJoin(); });
+            if (gopCache.overflowed() && joinPending && loopNow - lastKeyframeTime >= kGopRefreshMinInterval) {
+                logging::global().log(logging::Logger::Level::Debug,
+                    "[Host] Caché GOP llena - keyframe programado");
+                keyframePending = true;
+                lastKeyframeTime = loopNow;
+            }
+        }
+        if (recorder) {
+            recorder->enqueue(shared);
+        }
+        size_t accepted = 0;
+        for (const auto& viewer : viewers) {
+            if ((!low || viewer->simulcastLayer() == kFullLayer) && viewer->enqueue(shared)) {
+                ++accepted;
+            }
+        }
+        if (accepted == 0 && lowAccepted == 0) {
             std::this_thread::sleep_for(5ms);
             continue;
         }
 
         // ========== MÉTRICAS ==========
         framesThisSecond++;
-        bytesThisSecond += encodedOpt->payload.size();
+        bytesThisSecond += frameBytes;
+        contentBytes[static_cast<size_t>(contentType)] += frameBytes;
         frameCount_.fetch_add(1, std::memory_order_relaxed);
-        bytesSent_.fetch_add(encodedOpt->payload.size(), std::memory_order_relaxed);
 
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastFpsUpdate).count();
@@ -372,6 +1077,28 @@ void HostSession::captureLoop() {
                 " Bitrate=" + std::to_string((bytesThisSecond * 8) / 1000) + "kbps" +
                 " Resolution=" + std::to_string(encoderWidth) + "x" + std::to_string(encoderHeight));
             
+            if (const auto speed = encoder_->speedState()) {
+                vic::metrics::MetricsCollector::instance().recordEncoderSpeed(
+                    speed->cpuUsed, speed->threads, speed->tokenPartitions, speed->utilisation);
+            }
+
+            // Costo de cada capa de simulcast y cuántos viewers la reciben
+            if (low) {
+                const double seconds = static_cast<double>(elapsed) / 1000.0;
+                for (uint8_t layer = 0; layer < layerCost.size(); ++layer) {
+                    const auto& cost = layerCost[layer];
+                    const auto layerViewers = static_cast<uint32_t>(std::count_if(viewers.begin(), viewers.end(),
+                        [&](const std::shared_ptr<ViewerPeer>& viewer) { return viewer->simulcastLayer() == layer; }));
+                    vic::metrics::MetricsCollector::instance().recordSimulcastLayer(layer,
+                        layer == kLowLayer ? low->width : encoderWidth,
+                        layer == kLowLayer ? low->height : encoderHeight,
+                        cost.frames > 0 ? cost.encodeUs / static_cast<double>(cost.frames) : 0.0,
+                        static_cast<double>(cost.bytes) * 8.0 / 1000.0 / seconds,
+                        layerViewers);
+                }
+                layerCost = {};
+            }
+            
             framesThisSecond = 0;
             bytesThisSecond = 0;
             lastFpsUpdate = now;
@@ -382,8 +1109,8 @@ void HostSession::captureLoop() {
         lastFrameTimestampMs_.store(static_cast<uint64_t>(nowMs));
 
         // Control de framerate: Limitar a maxFramerate si está configurado
-        if (streamConfig_.maxFramerate > 0 && streamConfig_.maxFramerate < 60) {
-            auto targetFrameTime = std::chrono::milliseconds(1000 / streamConfig_.maxFramerate);
+        if (targetFramerate > 0 && targetFramerate < 60) {
+            auto targetFrameTime = std::chrono::milliseconds(1000 / targetFramerate);
             std::this_thread::sleep_for(targetFrameTime / 2);  // Sleep parcial, DXGI hace el resto
         }
     }
@@ -396,7 +1123,8 @@ void HostSession::signalingLoop() {
     logging::global().log(logging::Logger::Level::Info, "[Host] signalingLoop iniciado");
     
     while (running_.load()) {
-        if (!connectionInfo_) {
+        auto info = currentConnectionInfo();
+        if (!info) {
             logging::global().log(logging::Logger::Level::Debug, "[Host] signalingLoop: esperando connectionInfo...");
             std::this_thread::sleep_for(500ms);
             continue;
@@ -411,17 +1139,37 @@ void HostSession::signalingLoop() {
         // Log del estado actual
         logging::global().log(logging::Logger::Level::Debug, 
             "[Host] Estado: registered=" + std::string(registered_.load() ? "true" : "false") + 
-            ", answerApplied=" + std::string(answerApplied_.load() ? "true" : "false"));
+            ", answerApplied=" + std::string(answerApplied_.load() ? "true" : "false") +
+            ", viewers=" + std::to_string(viewerCount()));
+
+        // Viewers que se fueron liberan su lugar; si hay lugar y ninguna oferta
+        // publicada, preparar la del próximo
+        reapClosedViewers();
+        bool hasPending = false;
+        {
+            std::lock_guard lock(signalingMutex_);
+            hasPending = pendingViewer_ != nullptr;
+        }
+        if (!hasPending && viewerCount() < std::max<uint32_t>(1, streamConfig_.maxViewers)) {
+            hasPending = preparePendingViewer();
+            info = currentConnectionInfo();
+            if (!info) {
+                continue;
+            }
+        }
 
         if (!registered_.load()) {
-            auto result = matchmakerClient_->registerHost(*connectionInfo_);
+            auto result = matchmakerClient_->registerHost(*info);
             if (result) {
-                if (*result != connectionInfo_->code) {
+                std::lock_guard lock(signalingMutex_);
+                if (connectionInfo_) {
                     connectionInfo_->code = *result;
+                    if (pendingViewer_) {
+                        pendingViewer_->server().setConnectionInfo(*connectionInfo_);
+                    }
                 }
-                transportServer_->setConnectionInfo(*connectionInfo_);
                 registered_.store(true);
-                logging::global().log(logging::Logger::Level::Info, "Host registrado en matchmaker con código " + connectionInfo_->code);
+                logging::global().log(logging::Logger::Level::Info, "Host registrado en matchmaker con código " + *result);
             } else {
                 logging::global().log(logging::Logger::Level::Warning, "Registro matchmaker falló, reintento...");
                 std::this_thread::sleep_for(retryInterval_);
@@ -429,29 +1177,23 @@ void HostSession::signalingLoop() {
             continue;
         }
 
-        if (!answerApplied_.load()) {
-            logging::global().log(logging::Logger::Level::Info, "[Host] Buscando answer para código: " + connectionInfo_->code);
-            auto answerBundle = matchmakerClient_->fetchViewerAnswer(connectionInfo_->code);
+        if (hasPending) {
+            logging::global().log(logging::Logger::Level::Info, "[Host] Buscando answer para código: " + info->code);
+            auto answerBundle = matchmakerClient_->fetchViewerAnswer(info->code);
             if (!answerBundle) {
                 logging::global().log(logging::Logger::Level::Debug, "[Host] No hay answer aun, reintentando en 3s...");
                 std::this_thread::sleep_for(retryInterval_);
                 continue;
             }
 
-            logging::global().log(logging::Logger::Level::Info, "[Host] Answer recibido! Aplicando...");
-            if (!transportServer_->applyAnswer(answerBundle->description)) {
+            logging::global().log(logging::Logger::Level::Info, "[Host] Answer recibido! Aplicando " +
+                std::to_string(answerBundle->iceCandidates.size()) + " candidatos remotos...");
+            if (!acceptViewerAnswer(answerBundle->description, answerBundle->iceCandidates)) {
                 logging::global().log(logging::Logger::Level::Warning, "Aplicar respuesta WebRTC falló, reintento...");
                 std::this_thread::sleep_for(retryInterval_);
                 continue;
             }
 
-            logging::global().log(logging::Logger::Level::Info, "[Host] Agregando " + std::to_string(answerBundle->iceCandidates.size()) + " candidatos remotos");
-            for (const auto& candidate : answerBundle->iceCandidates) {
-                logging::global().log(logging::Logger::Level::Debug, "[Host] Candidato: " + candidate.candidate);
-                transportServer_->addRemoteCandidate(candidate);
-            }
-
-            answerApplied_.store(true);
             logging::global().log(logging::Logger::Level::Info, "Respuesta del viewer aplicada, streaming habilitado");
             continue;
         }
@@ -536,8 +1278,9 @@ void HostSession::lanServerLoop() {
         logging::global().log(logging::Logger::Level::Info, 
             "[LAN] Nueva conexión desde " + std::string(clientIP));
         
-        // Verificar que tenemos connectionInfo_ disponible
-        if (!connectionInfo_.has_value()) {
+        // Verificar que tenemos connectionInfo_ disponible (la oferta del próximo viewer)
+        const auto info = currentConnectionInfo();
+        if (!info) {
             logging::global().log(logging::Logger::Level::Warning, "[LAN] No hay connectionInfo disponible");
             closesocket(clientSocket);
             continue;
@@ -553,7 +1296,7 @@ void HostSession::lanServerLoop() {
             
             // Construir JSON con oferta SDP e ICE candidates
             std::string offer = "{\"sdp\":\"";
-            for (char c : connectionInfo_->offer.sdp) {
+            for (char c : info->offer.sdp) {
                 if (c == '\n') offer += "\\n";
                 else if (c == '\r') offer += "\\r";
                 else if (c == '\\') offer += "\\\\";
@@ -563,7 +1306,7 @@ void HostSession::lanServerLoop() {
             offer += "\",\"type\":\"offer\",\"ice\":[";
             
             bool firstCandidate = true;
-            for (const auto& cand : connectionInfo_->iceCandidates) {
+            for (const auto& cand : info->iceCandidates) {
                 if (!firstCandidate) offer += ",";
                 firstCandidate = false;
                 offer += "{\"candidate\":\"" + cand.candidate + "\",\"sdpMid\":\"" + cand.sdpMid + 
@@ -662,15 +1405,10 @@ void HostSession::lanServerLoop() {
                 "[LAN] Respuesta parseada, aplicando al transport...");
             
             // Aplicar respuesta al transport
-            if (!transportServer_->applyAnswer(answerBundle.description)) {
+            if (!acceptViewerAnswer(answerBundle.description, answerBundle.iceCandidates)) {
                 throw std::runtime_error("No se pudo aplicar respuesta WebRTC");
             }
             
-            for (const auto& candidate : answerBundle.iceCandidates) {
-                transportServer_->addRemoteCandidate(candidate);
-            }
-            
-            answerApplied_.store(true);
             logging::global().log(logging::Logger::Level::Info, 
                 "[LAN] Conexión LAN establecida con " + std::string(clientIP));
             
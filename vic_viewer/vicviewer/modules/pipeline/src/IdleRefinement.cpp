@@ -0,0 +1,28 @@
+#include "IdleRefinement.h"
+
+namespace vic::pipeline {
+
+void IdleRefinement::restart(Clock::time_point now) {
+    lastChange_ = now;
+    step_ = 0;
+}
+
+std::optional<uint32_t> IdleRefinement::due(Clock::time_point now) const {
+    if (!enabled_ || step_ >= kQuantizers.size() ||
+        now - lastChange_ < frameInterval_ * static_cast<int64_t>(afterFrames_ + step_)) {
+        return std::nullopt;
+    }
+    return kQuantizers[step_];
+}
+
+void QuantizerOverride::apply(vic::encoder::VideoEncoder& encoder, std::optional<uint32_t> refineQuantizer) {
+    if (refineQuantizer) {
+        overridden_ = encoder.setQuantizerRange(*refineQuantizer, *refineQuantizer);
+        encoder.refineNextFrame();
+    } else if (overridden_) {
+        encoder.resetQuantizerRange();
+        overridden_ = false;
+    }
+}
+
+} // namespace vic::pipeline
@@ -0,0 +1,79 @@
+#include "LayerAdaptation.h"
+
+#include <algorithm>
+
+namespace vic::pipeline {
+
+void TemporalLayerAdapter::reset(uint32_t temporalLayers, Clock::time_point now) {
+    topLayer_ = static_cast<uint8_t>(std::clamp<uint32_t>(temporalLayers, 1, 3) - 1);
+    layer_ = topLayer_;
+    lastChange_ = now;
+    lastCongestion_ = now;
+}
+
+std::optional<uint8_t> TemporalLayerAdapter::update(size_t queueDepth, size_t bufferedBytes, Clock::time_point now) {
+    const bool congested = queueDepth >= kCongestedQueueDepth || bufferedBytes > kCongestedBufferedBytes;
+    if (congested) {
+        lastCongestion_ = now;
+        if (layer_ > 0 && now - lastChange_ >= kDownInterval) {
+            --layer_;
+            lastChange_ = now;
+            return layer_;
+        }
+    } else if (layer_ < topLayer_ && now - lastCongestion_ >= kUpAfter && now - lastChange_ >= kUpAfter) {
+        ++layer_;
+        lastChange_ = now;
+        return layer_;
+    }
+    return std::nullopt;
+}
+
+std::optional<uint8_t> SimulcastLayerPolicy::evaluate(uint8_t layer, uint32_t bottleneckKbps, double fullKbps,
+                                                      Clock::time_point now) {
+    const auto sinceSwitch = now - lastSwitch_;
+    if (layer == kFullLayer) {
+        if (bottleneckKbps == 0 || bottleneckKbps >= fullKbps * kDownMargin) {
+            // La prueba aguantó: la próxima caída vuelve a la espera corta
+            if (probing_ && sinceSwitch >= kFailedProbe) {
+                probing_ = false;
+                probeAfter_ = kProbeAfter;
+            }
+            return std::nullopt;
+        }
+        if (probing_ && sinceSwitch < kFailedProbe) {
+            probeAfter_ = std::min<Clock::duration>(probeAfter_ * 2, kMaxProbeAfter);
+        } else {
+            probeAfter_ = kProbeAfter;
+        }
+        probing_ = false;
+        lastSwitch_ = now;
+        return kLowLayer;
+    }
+    if (bottleneckKbps == 0 && sinceSwitch >= probeAfter_) {
+        probing_ = true;
+        lastSwitch_ = now;
+        return kFullLayer;
+    }
+    return std::nullopt;
+}
+
+std::vector<uint32_t> commonIntactFrames(const std::vector<vic::transport::RecoveryRequest>& requests) {
+    std::vector<uint32_t> common;
+    if (requests.empty()) {
+        return common;
+    }
+    for (const uint32_t id : {requests.front().goldenFrameId, requests.front().altRefFrameId}) {
+        if (id != 0) {
+            common.push_back(id);
+        }
+    }
+    for (size_t i = 1; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        std::erase_if(common, [&](uint32_t id) {
+            return id != request.goldenFrameId && id != request.altRefFrameId;
+        });
+    }
+    return common;
+}
+
+} // namespace vic::pipeline
@@ -0,0 +1,62 @@
+#include "RegionOfInterest.h"
+
+#include <algorithm>
+
+namespace vic::pipeline {
+
+namespace {
+
+// Deltas de cuantizador y loop filter por segmento (escala 0..63 de libvpx)
+constexpr int8_t kRoiCursorDeltaQ = -16;
+constexpr int8_t kRoiCursorDeltaLf = -10;
+constexpr int8_t kRoiEditDeltaQ = -10;
+constexpr int8_t kRoiEditDeltaLf = -6;
+constexpr int8_t kRoiBackgroundDeltaQ = 4;
+
+} // namespace
+
+vic::encoder::RoiMap buildRoiMap(const StreamConfig& config,
+                                 const vic::capture::CursorState& cursor,
+                                 const std::vector<vic::capture::DamageRect>& edits,
+                                 uint32_t srcWidth, uint32_t srcHeight,
+                                 uint32_t dstWidth, uint32_t dstHeight) {
+    vic::encoder::RoiMap map;
+    if (srcWidth == 0 || srcHeight == 0) {
+        return map;
+    }
+
+    auto addRegion = [&](int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint8_t segment) {
+        x0 = std::clamp<int64_t>(x0, 0, srcWidth);
+        y0 = std::clamp<int64_t>(y0, 0, srcHeight);
+        x1 = std::clamp<int64_t>(x1, 0, srcWidth);
+        y1 = std::clamp<int64_t>(y1, 0, srcHeight);
+        if (x1 <= x0 || y1 <= y0) {
+            return;
+        }
+        vic::encoder::RoiRegion region{};
+        region.x = static_cast<uint32_t>(x0 * dstWidth / srcWidth);
+        region.y = static_cast<uint32_t>(y0 * dstHeight / srcHeight);
+        region.width = static_cast<uint32_t>((x1 * dstWidth + srcWidth - 1) / srcWidth) - region.x;
+        region.height = static_cast<uint32_t>((y1 * dstHeight + srcHeight - 1) / srcHeight) - region.y;
+        region.segment = segment;
+        map.regions.push_back(region);
+    };
+
+    for (const auto& edit : edits) {
+        addRegion(edit.x, edit.y, static_cast<int64_t>(edit.x) + edit.width,
+                  static_cast<int64_t>(edit.y) + edit.height, kRoiEditSegment);
+    }
+    // El cursor va último: donde se solapa con una edición, gana su calidad
+    if (cursor.visible) {
+        const int64_t radius = config.roiCursorRadius;
+        addRegion(cursor.x - radius, cursor.y - radius, cursor.x + radius, cursor.y + radius, kRoiCursorSegment);
+    }
+
+    if (!map.regions.empty()) {
+        map.deltaQ = {kRoiBackgroundDeltaQ, kRoiCursorDeltaQ, kRoiEditDeltaQ, 0};
+        map.deltaLoopFilter = {0, kRoiCursorDeltaLf, kRoiEditDeltaLf, 0};
+    }
+    return map;
+}
+
+} // namespace vic::pipeline
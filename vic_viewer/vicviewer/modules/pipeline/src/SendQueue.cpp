@@ -0,0 +1,66 @@
+#include "SendQueue.h"
+
+#include <utility>
+
+namespace vic::pipeline {
+
+SendQueue::PushResult SendQueue::push(FramePtr frame) {
+    if (awaitingKeyframe_) {
+        if (!frame->keyFrame) {
+            return PushResult::AwaitingKeyframe;
+        }
+        awaitingKeyframe_ = false;
+    }
+    auto result = PushResult::Queued;
+    if (liveDepth() >= (burstRemaining_ > 0 ? kMaxLiveDuringBurst : kMaxLive)) {
+        queue_.clear();
+        burstRemaining_ = 0;
+        joinFramesLeft_ = 0;
+        result = PushResult::Overflowed;
+    }
+    queue_.push_back(std::move(frame));
+    return result;
+}
+
+std::optional<SendQueue::Entry> SendQueue::pop() {
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+    Entry entry;
+    entry.frame = std::move(queue_.front());
+    queue_.pop_front();
+    if (burstRemaining_ > 0) {
+        --burstRemaining_;
+        entry.burst = true;
+    }
+    entry.liveDepth = liveDepth();
+    entry.joined = joinFramesLeft_ > 0 && --joinFramesLeft_ == 0;
+    return entry;
+}
+
+void SendQueue::awaitKeyframe(bool join) {
+    queue_.clear();
+    burstRemaining_ = 0;
+    awaitingKeyframe_ = true;
+    if (join) {
+        joinFramesLeft_ = 1;
+    }
+}
+
+bool SendQueue::prime(const std::vector<FramePtr>& gop) {
+    if (gop.empty() || !gop.front()->keyFrame) {
+        return false;
+    }
+    queue_.assign(gop.begin(), gop.end());
+    awaitingKeyframe_ = false;
+    burstRemaining_ = gop.size();
+    joinFramesLeft_ = gop.size();
+    return true;
+}
+
+void SendQueue::clear() {
+    queue_.clear();
+    burstRemaining_ = 0;
+}
+
+} // namespace vic::pipeline
@@ -0,0 +1,207 @@
+#include "ViewerPeer.h"
+
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace vic::pipeline {
+
+namespace {
+
+// Ancho de banda: muestra cada medio segundo; el canal tiene backlog si sigue
+// con al menos esto sin salir (el enlace, no el encoder, marca el ritmo)
+constexpr auto kBandwidthSampleInterval = std::chrono::milliseconds(500);
+constexpr size_t kBackloggedBytes = 64 * 1024;
+
+} // namespace
+
+ViewerPeer::ViewerPeer(uint32_t id, std::unique_ptr<vic::transport::TransportServer> server)
+        : id_(id), server_(std::move(server)) {
+    server_->setConnectionStateCallback([this](vic::transport::ConnectionState state) {
+        if (state == vic::transport::ConnectionState::Failed || state == vic::transport::ConnectionState::Closed) {
+            closed_.store(true);
+        }
+    });
+}
+
+ViewerPeer::~ViewerPeer() {
+    stop();
+}
+
+void ViewerPeer::start(uint32_t temporalLayers) {
+    std::lock_guard lock(queueMutex_);
+    if (running_) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    layerAdapter_.reset(temporalLayers, now);
+    maxLayer_.store(layerAdapter_.maxLayer());
+    lastSample_ = now;
+    queue_.awaitKeyframe(false);
+    joined_.store(false);
+    running_ = true;
+    sendThread_ = std::thread([this] { sendLoop(); });
+}
+
+void ViewerPeer::stop() {
+    {
+        std::lock_guard lock(queueMutex_);
+        running_ = false;
+        queue_.clear();
+    }
+    queueCv_.notify_one();
+    if (sendThread_.joinable()) {
+        sendThread_.join();
+    }
+    if (server_) {
+        server_->stop();
+        server_->setConnectionStateCallback(nullptr);
+    }
+    closed_.store(true);
+}
+
+bool ViewerPeer::enqueue(std::shared_ptr<const vic::encoder::EncodedFrame> frame) {
+    // Capa de mejora que este viewer no alcanza a recibir: nadie la referencia
+    if (frame->temporalLayer > maxLayer_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    {
+        std::lock_guard lock(queueMutex_);
+        if (!running_) {
+            return false;
+        }
+        const size_t queued = queue_.size();
+        const auto result = queue_.push(std::move(frame));
+        if (result == SendQueue::PushResult::AwaitingKeyframe) {
+            return false;
+        }
+        if (result == SendQueue::PushResult::Overflowed) {
+            logging::global().log(logging::Logger::Level::Warning,
+                "[Host] Viewer " + std::to_string(id_) + ": cola de envío llena (" +
+                std::to_string(queued) + " frames), descartando");
+        }
+    }
+    queueCv_.notify_one();
+    return true;
+}
+
+bool ViewerPeer::takeJoinRequest() {
+    if (!server_->needsInitialKeyframe()) {
+        return false;
+    }
+    joined_.store(true);
+    std::lock_guard lock(queueMutex_);
+    queue_.awaitKeyframe(true);
+    joinStart_ = std::chrono::steady_clock::now();
+    joinFromCache_ = false;
+    return true;
+}
+
+void ViewerPeer::primeFromCache(const std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>>& gop) {
+    {
+        std::lock_guard lock(queueMutex_);
+        if (!queue_.prime(gop)) {
+            return;
+        }
+        joinFromCache_ = true;
+    }
+    queueCv_.notify_one();
+}
+
+void ViewerPeer::switchLayer(uint8_t layer) {
+    std::lock_guard lock(queueMutex_);
+    simulcastLayer_.store(layer);
+    bottleneckKbps_.store(0);   // La medición era del bitrate de la otra capa
+    queue_.awaitKeyframe(false);
+}
+
+void ViewerPeer::setCapabilities(std::vector<vic::encoder::CodecCapability> capabilities) {
+    std::lock_guard lock(capabilitiesMutex_);
+    capabilities_ = std::move(capabilities);
+}
+
+std::optional<std::vector<vic::encoder::CodecCapability>> ViewerPeer::capabilities() const {
+    std::lock_guard lock(capabilitiesMutex_);
+    return capabilities_;
+}
+
+void ViewerPeer::sendLoop() {
+    while (true) {
+        std::optional<SendQueue::Entry> entry;
+        {
+            std::unique_lock lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (!running_) {
+                return;
+            }
+            entry = queue_.pop();
+        }
+        // Solo lo que el transporte aceptó: lo descartado por congestión no
+        // sale por el enlace y no puede contar para la estimación
+        if (server_->sendFrame(*entry->frame)) {
+            bytesSubmitted_ += entry->frame->payload.size();
+            vic::metrics::MetricsCollector::instance().recordBytesSent(entry->frame->payload.size());
+        }
+        const auto now = std::chrono::steady_clock::now();
+        sampleBandwidth(now);
+        if (entry->joined) {
+            reportJoin(now);
+        }
+        // La ráfaga llena el DataChannel a propósito: no es congestión
+        if (!entry->burst) {
+            if (const auto layer = layerAdapter_.update(entry->liveDepth, server_->bufferedAmount(), now)) {
+                const bool down = *layer < maxLayer_.load();
+                maxLayer_.store(*layer);
+                logging::global().log(logging::Logger::Level::Info,
+                    "[Host] Viewer " + std::to_string(id_) + (down ? " congestionado" : " sin congestión") +
+                    ": capa temporal máx " + std::to_string(*layer));
+            }
+        }
+    }
+}
+
+void ViewerPeer::sampleBandwidth(std::chrono::steady_clock::time_point now) {
+    const size_t buffered = server_->bufferedAmount();
+    if (buffered < kBackloggedBytes) {
+        backloggedSinceSample_ = false;
+    }
+    const auto elapsed = now - lastSample_;
+    if (elapsed < kBandwidthSampleInterval) {
+        return;
+    }
+
+    // Lo que ya salió del DataChannel: enviado menos lo que sigue en su buffer
+    const uint64_t delivered = bytesSubmitted_ - std::min<uint64_t>(buffered, bytesSubmitted_);
+    const double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    const auto kbps = static_cast<uint32_t>((delivered - std::min(delivered, lastSampleDelivered_)) * 8 / ms);
+    if (backloggedSinceSample_) {
+        const uint32_t previous = bottleneckKbps_.load();
+        bottleneckKbps_.store(previous == 0 ? kbps : (previous + kbps) / 2);
+    } else {
+        // Sin backlog el ritmo lo marca el encoder: el enlace da al menos eso
+        bottleneckKbps_.store(0);
+    }
+    lastSampleDelivered_ = delivered;
+    lastSample_ = now;
+    backloggedSinceSample_ = buffered >= kBackloggedBytes;
+}
+
+void ViewerPeer::reportJoin(std::chrono::steady_clock::time_point now) {
+    std::chrono::steady_clock::time_point start;
+    bool fromCache = false;
+    {
+        std::lock_guard lock(queueMutex_);
+        start = joinStart_;
+        fromCache = joinFromCache_;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+    vic::metrics::MetricsCollector::instance().recordViewerJoin(ms, fromCache);
+    logging::global().log(logging::Logger::Level::Info,
+        "[Host] Viewer " + std::to_string(id_) + ": primera imagen enviada en " +
+        std::to_string(static_cast<int>(ms)) + " ms (" + (fromCache ? "caché GOP" : "keyframe forzado") + ")");
+}
+
+} // namespace vic::pipeline
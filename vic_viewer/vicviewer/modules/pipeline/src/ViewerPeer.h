@@ -0,0 +1,115 @@
+#pragma once
+
+#include "LayerAdaptation.h"
+#include "SendQueue.h"
+#include "Transport.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace vic::pipeline {
+
+/// Un viewer conectado al host: su TransportServer, su cola de envío y su
+/// control de congestión. El hilo de captura codifica una sola vez y encola el
+/// mismo frame (compartido) en cada viewer sin bloquear; el hilo de envío de
+/// cada uno lo manda a su ritmo, así un viewer lento no frena a los demás.
+/// Bajo congestión el viewer baja de capa temporal (menos fps, sin keyframe)
+class ViewerPeer {
+public:
+    ViewerPeer(uint32_t id, std::unique_ptr<vic::transport::TransportServer> server);
+    ~ViewerPeer();
+
+    ViewerPeer(const ViewerPeer&) = delete;
+    ViewerPeer& operator=(const ViewerPeer&) = delete;
+
+    [[nodiscard]] uint32_t id() const { return id_; }
+    vic::transport::TransportServer& server() { return *server_; }
+
+    /// Arrancar el hilo de envío con capas temporales 0..temporalLayers-1
+    void start(uint32_t temporalLayers);
+    /// Detener el hilo de envío y cerrar la conexión
+    void stop();
+
+    /// Desde el hilo de captura; nunca bloquea. Descarta los frames de capas
+    /// por encima de la permitida y, hasta el primer keyframe, los deltas
+    /// (un viewer recién llegado no tiene sus referencias). false = descartado
+    bool enqueue(std::shared_ptr<const vic::encoder::EncodedFrame> frame);
+
+    /// DataChannel recién abierto (viewer nuevo o reconectado): vacía la cola,
+    /// espera un keyframe y devuelve true una sola vez. El host le pasa la
+    /// caché GOP con primeFromCache() o le pide un keyframe al encoder
+    bool takeJoinRequest();
+    /// Arrancado (respuesta aplicada) pero con el DataChannel todavía
+    /// cerrado: se va a unir en breve
+    [[nodiscard]] bool awaitingJoin() const { return !joined_.load() && !closed_.load(); }
+
+    /// Arrancar desde la caché GOP: la ráfaga (keyframe + deltas) va primero y
+    /// el stream en vivo sigue detrás, sin esperar un keyframe nuevo
+    void primeFromCache(const std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>>& gop);
+
+    /// Conexión caída o cerrada: el host lo quita
+    [[nodiscard]] bool isClosed() const { return closed_.load(); }
+
+    /// Decoders anunciados por el viewer (vacío hasta que los envía)
+    void setCapabilities(std::vector<vic::encoder::CodecCapability> capabilities);
+    [[nodiscard]] std::optional<std::vector<vic::encoder::CodecCapability>> capabilities() const;
+
+    [[nodiscard]] uint8_t maxTemporalLayer() const { return maxLayer_.load(); }
+
+    /// Capa de simulcast que recibe (0 = completa, 1 = reducida)
+    [[nodiscard]] uint8_t simulcastLayer() const { return simulcastLayer_.load(); }
+    /// Cambiar de capa: vacía la cola y espera un keyframe de la capa nueva
+    /// (el host le pasa su caché GOP o le pide un keyframe a ese encoder)
+    void switchLayer(uint8_t layer);
+
+    /// Ancho de banda medido mientras el DataChannel tenía backlog (el enlace
+    /// era el cuello de botella), en kbps. 0 = el enlace no está limitando
+    [[nodiscard]] uint32_t bottleneckKbps() const { return bottleneckKbps_.load(); }
+
+private:
+    void sendLoop();
+    void reportJoin(std::chrono::steady_clock::time_point now);
+    void sampleBandwidth(std::chrono::steady_clock::time_point now);
+
+    const uint32_t id_;
+    std::unique_ptr<vic::transport::TransportServer> server_;
+
+    std::thread sendThread_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    SendQueue queue_;
+    bool running_ = false;
+
+    // Tiempo hasta la primera imagen: DataChannel abierto -> enviado el frame
+    // que la completa (el keyframe, o el último de la ráfaga)
+    std::chrono::steady_clock::time_point joinStart_{};
+    bool joinFromCache_ = false;
+    std::atomic_bool joined_{false};
+
+    // Capa temporal más alta que se le envía: la decide el hilo de envío y la
+    // lee el de captura
+    TemporalLayerAdapter layerAdapter_;
+    std::atomic<uint8_t> maxLayer_{0};
+
+    std::atomic_bool closed_{false};
+    std::atomic<uint8_t> simulcastLayer_{0};
+
+    // Estimación de ancho de banda (solo el hilo de envío)
+    uint64_t bytesSubmitted_ = 0;
+    uint64_t lastSampleDelivered_ = 0;
+    std::chrono::steady_clock::time_point lastSample_{};
+    bool backloggedSinceSample_ = true;
+    std::atomic<uint32_t> bottleneckKbps_{0};
+
+    mutable std::mutex capabilitiesMutex_;
+    std::optional<std::vector<vic::encoder::CodecCapability>> capabilities_;
+};
+
+} // namespace vic::pipeline
@@ -1,18 +1,165 @@
 #include "ViewerSession.h"
 
 #include "Logger.h"
+#include "Metrics.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <sstream>
+#include <utility>
+
+#ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
 #pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
 
 namespace vic::pipeline {
 
 namespace {
 
+// Reintento del pedido de recuperación si el frame de recuperación no llega
+constexpr auto kRecoveryRequestInterval = std::chrono::milliseconds(300);
+
+// Frames en cola antes de descartarla entera: con la cola llena el decoder está
+// muy atrasado y es más rápido pedir recuperación que decodificar todo
+constexpr size_t kMaxDecodeQueue = 16;
+
+/// Reenvía al sink del viewer y anota cuándo empieza commit(): ahí el sink
+/// presenta (el viewer headless renderiza), y eso no es tiempo de decode
+class CommitTimingSink final : public vic::decoder::FrameSink {
+public:
+    explicit CommitTimingSink(vic::decoder::FrameSink& sink) : sink_(sink) {}
+
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        return sink_.acquire(info);
+    }
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        commitStart = std::chrono::steady_clock::now();
+        sink_.commit(info);
+    }
+    void abort() override { sink_.abort(); }
+
+    std::optional<std::chrono::steady_clock::time_point> commitStart;
+
+private:
+    vic::decoder::FrameSink& sink_;
+};
+
+/// Sin sink del renderer: convierte a un DesktopFrame para frameCallback_
+class DesktopFrameSink final : public vic::decoder::FrameSink {
+public:
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        frame.bgraData.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {frame.bgraData.data(), static_cast<size_t>(info.width) * 4};
+    }
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        frame.width = info.width;
+        frame.height = info.height;
+        frame.originalWidth = info.originalWidth;
+        frame.originalHeight = info.originalHeight;
+        frame.timestamp = info.timestamp;
+    }
+
+    vic::capture::DesktopFrame frame{};
+};
+
+// ========== SOCKET DE LA CONEXIÓN LAN ==========
+// WinSock en Windows y sockets BSD en el resto (viewer headless en Linux).
+// Se cierra (y libera WinSock) al destruirse
+class LanSocket {
+public:
+    LanSocket() = default;
+    ~LanSocket() { close(); }
+    LanSocket(const LanSocket&) = delete;
+    LanSocket& operator=(const LanSocket&) = delete;
+
+    /// Socket TCP con timeout de envío y recepción. false si no se pudo crear
+    bool open(std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            return false;
+        }
+        wsaStarted_ = true;
+        socket_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (socket_ == INVALID_SOCKET) {
+            return false;
+        }
+        const DWORD ms = static_cast<DWORD>(timeout.count());
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms));
+        setsockopt(socket_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms));
+#else
+        socket_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (socket_ < 0) {
+            return false;
+        }
+        timeval tv{};
+        tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(socket_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+        return true;
+    }
+
+    bool connect(const std::string& ip, uint16_t port) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, ip.c_str(), &address.sin_addr) != 1) {
+            return false;
+        }
+        return ::connect(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    /// Bytes recibidos; 0 si el otro extremo cerró, < 0 por error o timeout
+    int receive(char* data, size_t size) {
+        return static_cast<int>(::recv(socket_, data, static_cast<int>(size), 0));
+    }
+
+    int send(const char* data, size_t size) {
+#ifdef _WIN32
+        return ::send(socket_, data, static_cast<int>(size), 0);
+#else
+        // Sin SIGPIPE si el host ya cerró: el error vuelve como -1
+        return static_cast<int>(::send(socket_, data, size, MSG_NOSIGNAL));
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (socket_ != INVALID_SOCKET) {
+            closesocket(socket_);
+            socket_ = INVALID_SOCKET;
+        }
+        if (std::exchange(wsaStarted_, false)) {
+            WSACleanup();
+        }
+#else
+        if (socket_ >= 0) {
+            ::close(socket_);
+            socket_ = -1;
+        }
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    SOCKET socket_ = INVALID_SOCKET;
+    bool wsaStarted_ = false;
+#else
+    int socket_ = -1;
+#endif
+};
+
 std::vector<std::string> splitList(const char* value) {
     std::vector<std::string> entries;
     if (!value || *value == '\0') {
@@ -113,6 +260,7 @@ ViewerSession::ViewerSession()
 
 ViewerSession::~ViewerSession() {
     disconnect();
+    stopDecodeThread();
 }
 
 bool ViewerSession::connect(const std::string& code) {
@@ -148,14 +296,7 @@ bool ViewerSession::connect(const std::string& code) {
         }
         logging::global().log(logging::Logger::Level::Info, "[ViewerSession] WebRTC iniciado OK");
 
-        client_->setFrameHandler([this](const vic::encoder::EncodedFrame& frame) {
-            if (decoder_) {
-                auto decoded = decoder_->decode(frame);
-                if (decoded && frameCallback_) {
-                    frameCallback_(*decoded);
-                }
-            }
-        });
+        attachClientHandlers();
 
         if (connectionInfo->offer.sdp.find("a=ice-ufrag:") == std::string::npos) {
             logging::global().log(logging::Logger::Level::Warning,
@@ -201,37 +342,17 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
     logging::global().log(logging::Logger::Level::Info, 
         "[ViewerSession] Iniciando conexión LAN directa a " + hostIp + ":" + std::to_string(port));
     
-    // Inicializar WinSock
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        logging::global().log(logging::Logger::Level::Error, "[ViewerSession] WSAStartup falló");
-        return false;
-    }
-    
-    // Crear socket TCP
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock == INVALID_SOCKET) {
+    // Socket TCP con timeout de conexión (5 segundos)
+    LanSocket sock;
+    if (!sock.open(std::chrono::seconds(5))) {
         logging::global().log(logging::Logger::Level::Error, "[ViewerSession] No se pudo crear socket TCP");
-        WSACleanup();
         return false;
     }
     
-    // Configurar timeout de conexión (5 segundos)
-    DWORD timeout = 5000;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
-    
     // Conectar al host
-    sockaddr_in serverAddr{};
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(port);
-    inet_pton(AF_INET, hostIp.c_str(), &serverAddr.sin_addr);
-    
-    if (::connect(sock, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) == SOCKET_ERROR) {
+    if (!sock.connect(hostIp, port)) {
         logging::global().log(logging::Logger::Level::Error, 
             "[ViewerSession] No se pudo conectar a " + hostIp + ":" + std::to_string(port));
-        closesocket(sock);
-        WSACleanup();
         return false;
     }
     
@@ -240,7 +361,7 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
     try {
         // Recibir tamaño del paquete de conexión (4 bytes)
         uint32_t packetSize = 0;
-        int bytesRead = recv(sock, reinterpret_cast<char*>(&packetSize), sizeof(packetSize), 0);
+        int bytesRead = sock.receive(reinterpret_cast<char*>(&packetSize), sizeof(packetSize));
         if (bytesRead != sizeof(packetSize)) {
             throw std::runtime_error("No se pudo leer tamaño del paquete");
         }
@@ -254,8 +375,7 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
         std::string connectionData(packetSize, '\0');
         size_t totalRead = 0;
         while (totalRead < packetSize) {
-            int chunk = recv(sock, connectionData.data() + totalRead, 
-                static_cast<int>(packetSize - totalRead), 0);
+            int chunk = sock.receive(connectionData.data() + totalRead, packetSize - totalRead);
             if (chunk <= 0) {
                 throw std::runtime_error("Conexión cerrada mientras se recibían datos");
             }
@@ -335,14 +455,7 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
             throw std::runtime_error("No se pudo iniciar WebRTC");
         }
         
-        client_->setFrameHandler([this](const vic::encoder::EncodedFrame& frame) {
-            if (decoder_) {
-                auto decoded = decoder_->decode(frame);
-                if (decoded && frameCallback_) {
-                    frameCallback_(*decoded);
-                }
-            }
-        });
+        attachClientHandlers();
         
         // Generar respuesta
         logging::global().log(logging::Logger::Level::Info, "[ViewerSession] Aceptando oferta y generando respuesta...");
@@ -374,13 +487,12 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
         
         // Enviar respuesta
         uint32_t answerSize = htonl(static_cast<uint32_t>(answer.size()));
-        send(sock, reinterpret_cast<const char*>(&answerSize), sizeof(answerSize), 0);
-        send(sock, answer.c_str(), static_cast<int>(answer.size()), 0);
+        sock.send(reinterpret_cast<const char*>(&answerSize), sizeof(answerSize));
+        sock.send(answer.c_str(), answer.size());
         
         logging::global().log(logging::Logger::Level::Info, "[ViewerSession] Respuesta enviada al host");
         
-        closesocket(sock);
-        WSACleanup();
+        sock.close();
         
         connected_.store(true);
         logging::global().log(logging::Logger::Level::Info, "[ViewerSession] Conexión LAN establecida, esperando frames");
@@ -389,8 +501,7 @@ bool ViewerSession::connectDirect(const std::string& hostIp, uint16_t port) {
     } catch (const std::exception& ex) {
         logging::global().log(logging::Logger::Level::Error,
             std::string("[ViewerSession] connectDirect falló: ") + ex.what());
-        closesocket(sock);
-        WSACleanup();
+        sock.close();
         try { client_->stop(); } catch (...) {}
         connected_.store(false);
         return false;
@@ -401,6 +512,8 @@ void ViewerSession::disconnect() {
     if (!connected_.load()) {
         return;
     }
+    // Primero el hilo de decode: puede estar pidiendo recuperación por el client
+    stopDecodeThread();
     client_->stop();
     connected_.store(false);
     reconnectRunning_.store(false);
@@ -413,6 +526,207 @@ void ViewerSession::setFrameCallback(std::function<void(const vic::capture::Desk
     frameCallback_ = std::move(callback);
 }
 
+void ViewerSession::setFrameSink(std::shared_ptr<vic::decoder::FrameSink> sink) {
+    frameSink_ = std::move(sink);
+}
+
+void ViewerSession::setFrameStatsCallback(std::function<void(const ViewerFrameStats&)> callback) {
+    frameStatsCallback_ = std::move(callback);
+}
+
+void ViewerSession::setCursorCallback(std::function<void(const RemoteCursor&)> callback) {
+    std::lock_guard lock(cursorMutex_);
+    cursorCallback_ = std::move(callback);
+}
+
+RemoteCursor ViewerSession::remoteCursor() const {
+    std::lock_guard lock(cursorMutex_);
+    RemoteCursor cursor{};
+    cursor.state = cursorState_;
+    auto it = cursorShapes_.find(cursorState_.shapeHash);
+    if (it != cursorShapes_.end()) {
+        cursor.shape = it->second;
+    }
+    return cursor;
+}
+
+void ViewerSession::attachClientHandlers() {
+    client_->setLocalCapabilities(vic::decoder::decoderCapabilities());
+    startDecodeThread();
+    client_->setFrameHandler([this](const vic::encoder::EncodedFrame& frame) {
+        enqueueEncodedFrame(frame);
+    });
+    client_->setCursorHandlers(
+        [this](const vic::capture::CursorState& state) { handleCursorPosition(state); },
+        [this](const vic::capture::CursorShape& shape) { handleCursorShape(shape); });
+}
+
+// ========== HILO DE DECODE ==========
+// Corre en el callback de red: solo copia el frame a la cola y vuelve
+void ViewerSession::enqueueEncodedFrame(const vic::encoder::EncodedFrame& frame) {
+    const auto arrival = std::chrono::steady_clock::now();
+    {
+        std::lock_guard lock(decodeMutex_);
+        if (!decodeRunning_) {
+            return;
+        }
+        if (decodeQueue_.size() >= kMaxDecodeQueue) {
+            // Sin los frames descartados el decoder detecta la referencia
+            // faltante en el próximo y pide recuperación al host
+            logging::global().log(logging::Logger::Level::Warning,
+                "[Viewer] Cola de decode llena (" + std::to_string(decodeQueue_.size()) + " frames), descartando");
+            decodeQueue_.clear();
+            vic::metrics::MetricsCollector::instance().recordDecodeQueueOverflow();
+        }
+        decodeQueue_.push_back({frame, arrival});
+    }
+    decodeCv_.notify_one();
+}
+
+void ViewerSession::startDecodeThread() {
+    std::lock_guard lock(decodeMutex_);
+    if (decodeRunning_) {
+        return;
+    }
+    decodeRunning_ = true;
+    decodeQueue_.clear();
+    decodeThread_ = std::thread([this] { decodeLoop(); });
+}
+
+void ViewerSession::stopDecodeThread() {
+    {
+        std::lock_guard lock(decodeMutex_);
+        decodeRunning_ = false;
+        decodeQueue_.clear();
+    }
+    decodeCv_.notify_one();
+    if (decodeThread_.joinable()) {
+        decodeThread_.join();
+    }
+}
+
+void ViewerSession::decodeLoop() {
+    std::deque<QueuedFrame> batch;
+    while (true) {
+        {
+            std::unique_lock lock(decodeMutex_);
+            decodeCv_.wait(lock, [this] { return !decodeRunning_ || !decodeQueue_.empty(); });
+            if (!decodeRunning_) {
+                return;
+            }
+            batch.swap(decodeQueue_);
+        }
+
+        // Todos por referencia, solo el último se convierte y presenta
+        const auto depth = static_cast<uint32_t>(batch.size());
+        vic::metrics::MetricsCollector::instance().recordDecodeQueueDepth(depth);
+        if (depth > 1) {
+            vic::metrics::MetricsCollector::instance().recordFramesNotPresented(depth - 1);
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            handleEncodedFrame(batch[i], i + 1 == batch.size());
+        }
+        batch.clear();
+    }
+}
+
+void ViewerSession::handleEncodedFrame(const QueuedFrame& queued, bool present) {
+    const auto& frame = queued.frame;
+    const auto start = std::chrono::steady_clock::now();
+    std::optional<std::chrono::steady_clock::time_point> decodeEnd;
+    bool decoded = false;
+    bool presented = false;
+    if (decodeEnabled_.load(std::memory_order_relaxed)) {
+        // El codec (y si va por tiles) lo elige el host por stream: cambiar de decoder cuando cambia
+        const bool tiled = !frame.tiles.empty();
+        if (frame.codec != decoderCodec_ || tiled != decoderTiled_) {
+            decoderCodec_ = frame.codec;
+            decoderTiled_ = tiled;
+            decoder_ = tiled ? vic::decoder::createTiledDecoder(frame.codec) : vic::decoder::createDecoder(frame.codec);
+            logging::global().log(decoder_ ? logging::Logger::Level::Info : logging::Logger::Level::Error,
+                std::string("[Viewer] Stream ") + vic::encoder::codecName(frame.codec) +
+                (tiled ? " por tiles (" + std::to_string(frame.tiles.size()) + ")" : std::string()) +
+                (decoder_ ? "" : ": codec sin decoder disponible"));
+        }
+        if (decoder_) {
+            // Sin I420→BGRA salvo el último de la ráfaga: los anteriores solo avanzan las referencias
+            decoded = decoder_->decodeOnly(frame);
+            // Si el último no decodificó, convertLatest() presenta el más nuevo
+            // de la ráfaga que sí (el decoder conserva su imagen pendiente)
+            if (present && frameSink_) {
+                CommitTimingSink sink(*frameSink_);
+                presented = decoder_->convertLatest(sink);
+                decodeEnd = sink.commitStart;
+            } else if (present) {
+                DesktopFrameSink sink;
+                presented = decoder_->convertLatest(sink);
+                decodeEnd = std::chrono::steady_clock::now();
+                if (presented && frameCallback_) {
+                    frameCallback_(sink.frame);
+                }
+            }
+            requestRecoveryIfNeeded();
+        }
+    }
+
+    if (frameStatsCallback_) {
+        const auto end = std::chrono::steady_clock::now();
+        ViewerFrameStats stats{};
+        stats.frameId = frame.frameId;
+        stats.bytes = frame.payload.size();
+        stats.keyFrame = frame.keyFrame;
+        stats.decoded = decoded;
+        stats.presented = presented;
+        stats.arrival = queued.arrival;
+        stats.queueUs = std::chrono::duration<double, std::micro>(start - queued.arrival).count();
+        // Sin el commit del sink ni el callback, que presentan el frame
+        stats.decodeUs = std::chrono::duration<double, std::micro>(decodeEnd.value_or(end) - start).count();
+        frameStatsCallback_(stats);
+    }
+}
+
+void ViewerSession::requestRecoveryIfNeeded() {
+    // ========== RECUPERACIÓN DE PÉRDIDAS ==========
+    // El decoder descarta frames cuyas referencias no tiene; el host responde
+    // con un frame que solo usa un long-term intacto (o keyframe si no hay)
+    const auto state = decoder_->recoveryState();
+    if (!state) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastRecoveryRequest_ < kRecoveryRequestInterval) {
+        return;
+    }
+    lastRecoveryRequest_ = now;
+    logging::global().log(logging::Logger::Level::Info,
+        "[Viewer] Pidiendo recuperación: último=" + std::to_string(state->lastFrameId) +
+        " golden=" + std::to_string(state->goldenFrameId) + " altref=" + std::to_string(state->altRefFrameId));
+    client_->sendRecoveryRequest({state->lastFrameId, state->goldenFrameId, state->altRefFrameId});
+}
+
+void ViewerSession::handleCursorPosition(const vic::capture::CursorState& state) {
+    std::function<void(const RemoteCursor&)> callback;
+    RemoteCursor cursor{};
+    {
+        std::lock_guard lock(cursorMutex_);
+        cursorState_ = state;
+        cursor.state = state;
+        auto it = cursorShapes_.find(state.shapeHash);
+        if (it != cursorShapes_.end()) {
+            cursor.shape = it->second;
+        }
+        callback = cursorCallback_;
+    }
+    if (callback) {
+        callback(cursor);
+    }
+}
+
+void ViewerSession::handleCursorShape(const vic::capture::CursorShape& shape) {
+    std::lock_guard lock(cursorMutex_);
+    cursorShapes_[shape.hash] = std::make_shared<const vic::capture::CursorShape>(shape);
+}
+
 bool ViewerSession::sendMouseEvent(const vic::input::MouseEvent& ev) {
     return client_->sendMouseEvent(ev);
 }
@@ -444,20 +758,16 @@ void ViewerSession::enableAutoReconnect(const std::string& code) {
                 if (!info) {
                     continue;
                 }
+                // Como en disconnect(): el hilo de decode primero, así
+                // attachClientHandlers() lo vuelve a arrancar
+                stopDecodeThread();
                 client_->stop();
                 clientTransportConfig_ = buildViewerConfig(info->iceServers);
                 client_->setConnectionInfo(*info);
                 if (!client_->start(clientTransportConfig_)) {
                     continue;
                 }
-                client_->setFrameHandler([this](const vic::encoder::EncodedFrame& frame) {
-                    if (decoder_) {
-                        auto decoded = decoder_->decode(frame);
-                        if (decoded && frameCallback_) {
-                            frameCallback_(*decoded);
-                        }
-                    }
-                });
+                attachClientHandlers();
                 if (info->offer.sdp.find("a=ice-ufrag:") == std::string::npos) {
                     logging::global().log(logging::Logger::Level::Warning,
                         "Matchmaker devolvió oferta sin credenciales ICE (auto-reconnect):\n" + info->offer.sdp);
@@ -473,6 +783,7 @@ void ViewerSession::enableAutoReconnect(const std::string& code) {
             } catch (const std::exception& ex) {
                 logging::global().log(logging::Logger::Level::Warning,
                     std::string("Auto-reconnect falló: ") + ex.what());
+                stopDecodeThread();
                 try { client_->stop(); } catch (...) {}
                 connected_.store(false);
             }
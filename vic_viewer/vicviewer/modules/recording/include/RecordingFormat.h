@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VideoCodec.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vic::recording {
+
+// ========== GRABACIÓN DE SESIONES ==========
+// Cada segmento son dos archivos:
+//   <nombre>.ivf  IVF estándar (cabecera de 32 bytes + por frame 12 bytes de
+//                 cabecera y el bitstream tal cual salió del encoder). Lo abre
+//                 cualquier reproductor VP8/VP9
+//   <nombre>.idx  Índice: una entrada por keyframe (para buscar sin recorrer
+//                 el IVF) y por frame con copy-rects, que el decoder tiene que
+//                 aplicar antes de decodificar y el IVF no sabe guardar
+// Todo en little-endian
+
+constexpr char kIvfSignature[4] = {'D', 'K', 'I', 'F'};
+constexpr size_t kIvfFileHeaderSize = 32;
+constexpr size_t kIvfFrameHeaderSize = 12;
+constexpr uint32_t kIvfTimebaseDenominator = 1000;   // pts en ms
+constexpr size_t kIvfFrameCountOffset = 24;
+
+constexpr char kIndexSignature[8] = {'V', 'I', 'C', 'I', 'D', 'X', '0', '1'};
+constexpr size_t kIndexHeaderSize = 16;              // Firma + versión + reservado
+constexpr uint32_t kIndexVersion = 1;
+constexpr size_t kIndexEntrySize = 40;
+constexpr size_t kIndexCopyRectSize = 24;            // 6 x u32, siguen a su entrada
+
+/// Bits de IndexEntry::flags
+constexpr uint8_t kIndexKeyFrame = 0x01;
+constexpr uint8_t kIndexCopyRects = 0x02;
+
+/// Entrada del índice (en disco: 40 bytes, seguida de rectCount copy-rects)
+struct IndexEntry {
+    uint32_t frameNumber{};      // Posición del frame en el IVF (0 = primero)
+    uint32_t rectCount{};
+    uint64_t fileOffset{};       // Offset de la cabecera del frame en el IVF
+    uint64_t timestamp{};        // EncodedFrame::timestamp (ms)
+    uint16_t width{};            // Resolución codificada (cambia en un keyframe)
+    uint16_t height{};
+    uint16_t originalWidth{};    // Pantalla original (coordenadas de mouse)
+    uint16_t originalHeight{};
+    uint8_t flags{};
+};
+
+/// FourCC del IVF para un codec. H.264 se graba como Annex B en un IVF "H264"
+/// (no estándar, pero lo leen ffmpeg y nuestro reader)
+[[nodiscard]] constexpr uint32_t ivfFourcc(vic::encoder::VideoCodec codec) {
+    switch (codec) {
+    case vic::encoder::VideoCodec::Vp9:
+        return 0x30395056u;   // "VP90"
+    case vic::encoder::VideoCodec::H264:
+        return 0x34363248u;   // "H264"
+    case vic::encoder::VideoCodec::Vp8:
+    default:
+        return 0x30385056u;   // "VP80"
+    }
+}
+
+} // namespace vic::recording
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "EncodedFrame.h"
+#include "RecordingFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vic::recording {
+
+/// Un frame del IVF, sin copiar: payload apunta al archivo mapeado
+struct RecordedFrame {
+    uint32_t number{};
+    uint64_t offset{};                  // Cabecera del frame en el IVF
+    uint64_t pts{};                     // ms desde el inicio del segmento
+    bool keyFrame{false};
+    uint32_t width{};                   // Resolución codificada vigente
+    uint32_t height{};
+    uint32_t originalWidth{};
+    uint32_t originalHeight{};
+    std::span<const uint8_t> payload;
+    std::span<const vic::capture::CopyRect> copyRects;
+};
+
+/// Lector de un segmento grabado por SessionRecorder (o cualquier IVF).
+/// Mapea el archivo en memoria y arma al abrir la tabla de frames recorriendo
+/// solo las cabeceras; el índice .idx aporta keyframes, resolución y
+/// copy-rects. Sin índice, los keyframes se detectan en el bitstream VP8
+/// (VP9 / H.264: solo el primero). Inmutable tras open(): se puede leer
+/// desde varios hilos
+class RecordingReader {
+public:
+    /// nullptr si el archivo no existe o no es un IVF válido. Un IVF truncado
+    /// (grabación cortada) se abre hasta el último frame completo
+    static std::unique_ptr<RecordingReader> open(const std::string& ivfPath);
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] vic::encoder::VideoCodec codec() const { return codec_; }
+    [[nodiscard]] bool hasIndex() const { return hasIndex_; }
+    [[nodiscard]] uint64_t fileSize() const;
+    [[nodiscard]] uint64_t durationMs() const { return frames_.empty() ? 0 : frames_.back().pts; }
+
+    [[nodiscard]] size_t frameCount() const { return frames_.size(); }
+    [[nodiscard]] const RecordedFrame& frame(size_t index) const { return frames_[index]; }
+    [[nodiscard]] const std::vector<RecordedFrame>& frames() const { return frames_; }
+
+    /// Números de frame de los keyframes, en orden
+    [[nodiscard]] const std::vector<uint32_t>& keyFrames() const { return keyFrames_; }
+    /// Último keyframe con pts <= ptsMs (el primero si no hay ninguno antes)
+    [[nodiscard]] size_t seekKeyframe(uint64_t ptsMs) const;
+
+    /// Armar el EncodedFrame del frame para el decoder. El payload se copia a
+    /// `out` reutilizando su capacidad (sin asignar en un replay sostenido)
+    void toEncodedFrame(size_t index, vic::encoder::EncodedFrame& out) const;
+
+private:
+    struct Mapping;
+
+    RecordingReader() = default;
+    bool parseIvf();
+    bool applyIndex(const std::vector<uint8_t>& index);
+
+    std::string path_;
+    std::unique_ptr<Mapping> mapping_;
+    vic::encoder::VideoCodec codec_{vic::encoder::VideoCodec::Vp8};
+    bool hasIndex_ = false;
+    std::vector<RecordedFrame> frames_;
+    std::vector<uint32_t> keyFrames_;
+    std::vector<vic::capture::CopyRect> copyRects_;
+};
+
+} // namespace vic::recording
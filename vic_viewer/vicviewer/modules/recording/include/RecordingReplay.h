@@ -0,0 +1,67 @@
+#pragma once
+
+#include "OffscreenRenderer.h"
+#include "RecordingReader.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vic::recording {
+
+struct ReplayOptions {
+    bool render = true;                   // Pasar cada frame por el renderer offscreen
+    uint32_t renderWidth = 0;             // 0 = tamaño del frame (sin escalar)
+    uint32_t renderHeight = 0;
+    vic::ui::ScaleFilter filter = vic::ui::ScaleFilter::Bilinear;
+    uint32_t loops = 1;                   // Vueltas completas (cada una desde un decoder nuevo)
+    uint32_t decoderThreads = 0;          // 0 = según cores y resolución
+    /// Grabación de referencia (misma sesión, p. ej. a más bitrate o de otra
+    /// versión del encoder): PSNR frame a frame contra su decode. No cuenta
+    /// en los tiempos
+    const RecordingReader* reference = nullptr;
+};
+
+/// Distribución de tiempos por frame (decode + conversión + render), en µs
+struct FrameTimeSummary {
+    double p50{};
+    double p90{};
+    double p99{};
+    double p999{};
+    double max{};
+};
+
+struct ReplayStats {
+    std::string path;
+    uint64_t frames{};
+    uint64_t failedFrames{};              // El decoder no devolvió imagen
+    uint64_t bytes{};
+    uint64_t pixels{};                    // Pixels convertidos a BGRA
+    uint64_t mediaMs{};                   // Duración grabada (x vueltas)
+    double wallMs{};
+    double decodeMs{};
+    double convertMs{};
+    double renderMs{};
+    std::vector<float> frameTimesUs;
+
+    // Calidad contra la referencia (0 frames comparados = sin referencia o
+    // resolución distinta)
+    uint64_t comparedFrames{};
+    double avgPsnr{};
+    double minPsnr{};
+};
+
+/// Reproducir una grabación por el decoder (decodeOnly + convertLatest, para
+/// separar decode y conversión) y el renderer offscreen, sin esperas: tan
+/// rápido como den la CPU y la memoria
+ReplayStats replayRecording(const RecordingReader& recording, const ReplayOptions& options);
+
+/// Varias grabaciones en paralelo, una por hilo (jobs = 0: un hilo por core).
+/// Resultados en el orden de `recordings`
+std::vector<ReplayStats> replayParallel(std::span<const RecordingReader* const> recordings,
+                                        const ReplayOptions& options, uint32_t jobs);
+
+[[nodiscard]] FrameTimeSummary summarizeFrameTimes(std::span<const float> frameTimesUs);
+
+} // namespace vic::recording
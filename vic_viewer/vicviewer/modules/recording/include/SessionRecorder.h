@@ -0,0 +1,101 @@
+#pragma once
+
+#include "EncodedFrame.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vic::recording {
+
+struct RecorderConfig {
+    std::string directory;                  // Se crea si no existe
+    std::string baseName;                   // Vacío = "session_AAAAMMDD_HHMMSS"
+    size_t maxPendingBytes = 32 * 1024 * 1024;   // Backlog sin escribir antes de descartar
+    std::chrono::milliseconds flushInterval{250};
+};
+
+struct RecorderStats {
+    uint64_t framesWritten{};
+    uint64_t bytesWritten{};
+    uint64_t keyFrames{};
+    uint64_t framesDropped{};   // Backlog lleno, deltas sin keyframe, o con tiles
+    uint32_t segments{};
+};
+
+/// Graba el stream ya codificado (sin re-encodear) a IVF + índice, ver
+/// RecordingFormat.h. El hilo de captura solo encola el mismo frame
+/// compartido que reciben los viewers; un hilo propio arma cada lote en un
+/// buffer propio y lo escribe con un write() y un flush, así el disco nunca
+/// frena el envío. Cada cambio de codec abre un segmento nuevo
+/// (<base>_001.ivf, ...). Tras un error de escritura deja de grabar hasta
+/// stop(); el hilo sigue vivo descartando hasta que se lo detiene
+class SessionRecorder {
+public:
+    explicit SessionRecorder(RecorderConfig config);
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    /// Crear el directorio y arrancar el hilo de escritura. Los archivos se
+    /// abren con el primer keyframe
+    bool start();
+    /// Escribir lo pendiente, completar las cabeceras y cerrar
+    void stop();
+
+    /// Desde el hilo de captura; nunca bloquea (solo un lock corto). Hasta el
+    /// primer keyframe, y tras descartar por backlog, ignora los deltas.
+    /// false = descartado
+    bool enqueue(std::shared_ptr<const vic::encoder::EncodedFrame> frame);
+
+    /// Devuelve true una sola vez cuando el grabador está esperando un
+    /// keyframe (arranque sin caché GOP o backlog descartado): el host lo pide
+    bool takeKeyframeRequest();
+
+    [[nodiscard]] bool isRecording() const { return running_.load() && !failed_.load(); }
+    [[nodiscard]] RecorderStats stats() const;
+    /// Ruta del IVF del segmento actual (vacío hasta el primer keyframe)
+    [[nodiscard]] std::string currentPath() const;
+
+private:
+    struct Segment;
+
+    void writerLoop();
+    bool writeFrame(const vic::encoder::EncodedFrame& frame);
+    bool openSegment(const vic::encoder::EncodedFrame& first);
+    bool flushSegment();
+    void closeSegment();
+    void fail(const std::string& what);
+
+    RecorderConfig config_;
+    std::string baseName_;
+
+    std::thread writerThread_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>> pending_;
+    size_t pendingBytes_ = 0;      // En pending_
+    size_t writingBytes_ = 0;      // Lote que está escribiendo el hilo
+    bool awaitingKeyframe_ = true;
+    bool tilesWarned_ = false;
+    bool stopping_ = false;
+    RecorderStats stats_{};
+    std::string currentPath_;
+
+    std::atomic_bool running_{false};     // Entre start() y stop(): el hilo existe
+    std::atomic_bool failed_{false};      // Error de disco: no se graba más
+    std::atomic_bool keyframeWanted_{true};
+
+    // Solo el hilo de escritura
+    std::unique_ptr<Segment> segment_;
+    uint32_t segmentNumber_ = 0;
+};
+
+} // namespace vic::recording
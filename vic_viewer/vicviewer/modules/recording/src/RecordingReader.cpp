@@ -0,0 +1,313 @@
+#include "RecordingReader.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vic::recording {
+
+namespace {
+
+uint64_t getLe(const uint8_t* data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (i * 8);
+    }
+    return value;
+}
+
+// Keyframe VP8: bit 0 del frame tag en 0 y start code 9d 01 2a; la
+// resolución sigue en 14 bits por lado
+bool parseVp8KeyFrame(std::span<const uint8_t> payload, uint32_t& width, uint32_t& height) {
+    if (payload.size() < 10 || (payload[0] & 0x01) != 0 ||
+        payload[3] != 0x9d || payload[4] != 0x01 || payload[5] != 0x2a) {
+        return false;
+    }
+    width = static_cast<uint32_t>(getLe(payload.data() + 6, 2) & 0x3fff);
+    height = static_cast<uint32_t>(getLe(payload.data() + 8, 2) & 0x3fff);
+    return true;
+}
+
+} // namespace
+
+// ========== ARCHIVO MAPEADO ==========
+// Solo lectura y con aviso de acceso secuencial: el replay recorre el archivo
+// de punta a punta y el SO puede leer por adelantado
+
+struct RecordingReader::Mapping {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+
+    bool open(const std::filesystem::path& path) {
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            return false;
+        }
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            return false;
+        }
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return data != nullptr;
+    }
+
+    ~Mapping() {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+    }
+#else
+    int fd = -1;
+
+    bool open(const std::filesystem::path& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        madvise(mapped, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t*>(mapped);
+        size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    ~Mapping() {
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+};
+
+std::unique_ptr<RecordingReader> RecordingReader::open(const std::string& ivfPath) {
+    std::unique_ptr<RecordingReader> reader(new RecordingReader());
+    reader->path_ = ivfPath;
+    reader->mapping_ = std::make_unique<Mapping>();
+    if (!reader->mapping_->open(ivfPath)) {
+        logging::global().log(logging::Logger::Level::Error, "[Recording] No se pudo mapear " + ivfPath);
+        return nullptr;
+    }
+    if (!reader->parseIvf()) {
+        return nullptr;
+    }
+
+    auto indexPath = std::filesystem::path(ivfPath);
+    indexPath.replace_extension(".idx");
+    std::ifstream indexFile(indexPath, std::ios::binary);
+    if (indexFile) {
+        const std::vector<uint8_t> index{std::istreambuf_iterator<char>(indexFile), std::istreambuf_iterator<char>()};
+        reader->hasIndex_ = reader->applyIndex(index);
+    }
+    return reader;
+}
+
+RecordingReader::~RecordingReader() = default;
+
+uint64_t RecordingReader::fileSize() const {
+    return mapping_ ? mapping_->size : 0;
+}
+
+bool RecordingReader::parseIvf() {
+    const uint8_t* data = mapping_->data;
+    const size_t size = mapping_->size;
+    if (size < kIvfFileHeaderSize || std::memcmp(data, kIvfSignature, sizeof(kIvfSignature)) != 0) {
+        logging::global().log(logging::Logger::Level::Error, "[Recording] " + path_ + " no es un IVF");
+        return false;
+    }
+    const auto fourcc = static_cast<uint32_t>(getLe(data + 8, 4));
+    bool known = false;
+    for (const auto codec : {vic::encoder::VideoCodec::Vp8, vic::encoder::VideoCodec::Vp9, vic::encoder::VideoCodec::H264}) {
+        if (ivfFourcc(codec) == fourcc) {
+            codec_ = codec;
+            known = true;
+        }
+    }
+    if (!known) {
+        logging::global().log(logging::Logger::Level::Error, "[Recording] " + path_ + ": codec no soportado");
+        return false;
+    }
+    uint32_t width = static_cast<uint32_t>(getLe(data + 12, 2));
+    uint32_t height = static_cast<uint32_t>(getLe(data + 14, 2));
+    const size_t headerSize = std::max<size_t>(kIvfFileHeaderSize, getLe(data + 6, 2));
+
+    // La cabecera trae el total, pero una grabación cortada no llegó a escribirlo
+    frames_.reserve(static_cast<size_t>(getLe(data + kIvfFrameCountOffset, 4)));
+    size_t offset = headerSize;
+    while (offset + kIvfFrameHeaderSize <= size) {
+        const size_t payloadSize = static_cast<size_t>(getLe(data + offset, 4));
+        if (payloadSize > size - offset - kIvfFrameHeaderSize) {
+            logging::global().log(logging::Logger::Level::Warning,
+                "[Recording] " + path_ + " truncado tras " + std::to_string(frames_.size()) + " frames");
+            break;
+        }
+        RecordedFrame frame{};
+        frame.number = static_cast<uint32_t>(frames_.size());
+        frame.offset = offset;
+        frame.pts = getLe(data + offset + 4, 8);
+        frame.payload = {data + offset + kIvfFrameHeaderSize, payloadSize};
+        frame.keyFrame = codec_ == vic::encoder::VideoCodec::Vp8
+            ? parseVp8KeyFrame(frame.payload, width, height)
+            : frames_.empty();
+        frame.width = width;
+        frame.height = height;
+        frame.originalWidth = width;
+        frame.originalHeight = height;
+        if (frame.keyFrame) {
+            keyFrames_.push_back(frame.number);
+        }
+        frames_.push_back(frame);
+        offset += kIvfFrameHeaderSize + payloadSize;
+    }
+    return true;
+}
+
+bool RecordingReader::applyIndex(const std::vector<uint8_t>& index) {
+    if (index.size() < kIndexHeaderSize || std::memcmp(index.data(), kIndexSignature, sizeof(kIndexSignature)) != 0 ||
+        getLe(index.data() + 8, 4) != kIndexVersion) {
+        logging::global().log(logging::Logger::Level::Warning,
+            "[Recording] Índice de " + path_ + " inválido, se ignora");
+        return false;
+    }
+
+    struct Entry {
+        IndexEntry entry;
+        size_t firstRect{};
+    };
+    std::vector<Entry> entries;
+    size_t offset = kIndexHeaderSize;
+    while (offset + kIndexEntrySize <= index.size()) {
+        const uint8_t* raw = index.data() + offset;
+        Entry parsed{};
+        parsed.entry.frameNumber = static_cast<uint32_t>(getLe(raw, 4));
+        parsed.entry.rectCount = static_cast<uint32_t>(getLe(raw + 4, 4));
+        parsed.entry.fileOffset = getLe(raw + 8, 8);
+        parsed.entry.timestamp = getLe(raw + 16, 8);
+        parsed.entry.width = static_cast<uint16_t>(getLe(raw + 24, 2));
+        parsed.entry.height = static_cast<uint16_t>(getLe(raw + 26, 2));
+        parsed.entry.originalWidth = static_cast<uint16_t>(getLe(raw + 28, 2));
+        parsed.entry.originalHeight = static_cast<uint16_t>(getLe(raw + 30, 2));
+        parsed.entry.flags = raw[32];
+        const size_t rectBytes = static_cast<size_t>(parsed.entry.rectCount) * kIndexCopyRectSize;
+        if (rectBytes > index.size() - offset - kIndexEntrySize) {
+            break;   // Índice cortado a mitad de una entrada
+        }
+        offset += kIndexEntrySize;
+        parsed.firstRect = copyRects_.size();
+        for (uint32_t i = 0; i < parsed.entry.rectCount; ++i, offset += kIndexCopyRectSize) {
+            const uint8_t* rect = index.data() + offset;
+            copyRects_.push_back({static_cast<uint32_t>(getLe(rect, 4)), static_cast<uint32_t>(getLe(rect + 4, 4)),
+                                  static_cast<uint32_t>(getLe(rect + 8, 4)), static_cast<uint32_t>(getLe(rect + 12, 4)),
+                                  static_cast<uint32_t>(getLe(rect + 16, 4)), static_cast<uint32_t>(getLe(rect + 20, 4))});
+        }
+        // El IVF pudo cortarse antes que el índice
+        if (parsed.entry.frameNumber < frames_.size() &&
+            frames_[parsed.entry.frameNumber].offset == parsed.entry.fileOffset) {
+            entries.push_back(parsed);
+        }
+    }
+
+    // El índice manda: keyframes, resolución vigente y copy-rects
+    keyFrames_.clear();
+    for (auto& frame : frames_) {
+        frame.keyFrame = false;
+    }
+    auto next = entries.begin();
+    uint32_t width = frames_.empty() ? 0 : frames_.front().width;
+    uint32_t height = frames_.empty() ? 0 : frames_.front().height;
+    uint32_t originalWidth = width;
+    uint32_t originalHeight = height;
+    for (auto& frame : frames_) {
+        if (next != entries.end() && next->entry.frameNumber == frame.number) {
+            const auto& entry = next->entry;
+            if (entry.width > 0 && entry.height > 0) {
+                width = entry.width;
+                height = entry.height;
+            }
+            if (entry.originalWidth > 0 && entry.originalHeight > 0) {
+                originalWidth = entry.originalWidth;
+                originalHeight = entry.originalHeight;
+            }
+            frame.keyFrame = (entry.flags & kIndexKeyFrame) != 0;
+            if (entry.flags & kIndexCopyRects) {
+                frame.copyRects = {copyRects_.data() + next->firstRect, entry.rectCount};
+            }
+            if (frame.keyFrame) {
+                keyFrames_.push_back(frame.number);
+            }
+            ++next;
+        }
+        frame.width = width;
+        frame.height = height;
+        frame.originalWidth = originalWidth;
+        frame.originalHeight = originalHeight;
+    }
+    return true;
+}
+
+size_t RecordingReader::seekKeyframe(uint64_t ptsMs) const {
+    if (keyFrames_.empty()) {
+        return 0;
+    }
+    const auto after = std::upper_bound(keyFrames_.begin(), keyFrames_.end(), ptsMs,
+        [this](uint64_t pts, uint32_t number) { return pts < frames_[number].pts; });
+    return after == keyFrames_.begin() ? keyFrames_.front() : *std::prev(after);
+}
+
+void RecordingReader::toEncodedFrame(size_t index, vic::encoder::EncodedFrame& out) const {
+    const RecordedFrame& frame = frames_[index];
+    out.timestamp = frame.pts;
+    out.payload.assign(frame.payload.begin(), frame.payload.end());
+    out.width = frame.width;
+    out.height = frame.height;
+    out.originalWidth = frame.originalWidth;
+    out.originalHeight = frame.originalHeight;
+    out.keyFrame = frame.keyFrame;
+    out.codec = codec_;
+    out.copyRects.assign(frame.copyRects.begin(), frame.copyRects.end());
+    // Sin numerar: el decoder no verifica la cadena de referencias
+    out.frameId = 0;
+    out.referenceFrameId = 0;
+    out.referenceFlags = 0;
+    out.temporalLayer = 0;
+    out.tiles.clear();
+}
+
+} // namespace vic::recording
@@ -0,0 +1,204 @@
+#include "RecordingReplay.h"
+
+#include "Logger.h"
+#include "VideoDecoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace vic::recording {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// PSNR con las dos imágenes idénticas (MSE 0)
+constexpr double kLosslessPsnr = 100.0;
+
+/// Buffer BGRA propio, reutilizado entre frames
+class SurfaceSink final : public vic::decoder::FrameSink {
+public:
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        frame.width = info.width;
+        frame.height = info.height;
+        frame.bgraData.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {frame.bgraData.data(), static_cast<size_t>(info.width) * 4};
+    }
+
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        frame.originalWidth = info.originalWidth;
+        frame.originalHeight = info.originalHeight;
+        frame.timestamp = info.timestamp;
+        committed = true;
+    }
+
+    void abort() override { committed = false; }
+
+    vic::capture::DesktopFrame frame{};
+    bool committed = false;
+};
+
+// Sobre B, G y R (el alfa es constante)
+double psnrBgra(const vic::capture::DesktopFrame& a, const vic::capture::DesktopFrame& b) {
+    uint64_t sum = 0;
+    const size_t bytes = std::min(a.bgraData.size(), b.bgraData.size());
+    for (size_t i = 0; i < bytes; i += 4) {
+        for (size_t c = 0; c < 3; ++c) {
+            const int diff = static_cast<int>(a.bgraData[i + c]) - static_cast<int>(b.bgraData[i + c]);
+            sum += static_cast<uint64_t>(diff * diff);
+        }
+    }
+    if (sum == 0 || bytes == 0) {
+        return kLosslessPsnr;
+    }
+    const double mse = static_cast<double>(sum) / (static_cast<double>(bytes) / 4.0 * 3.0);
+    return std::min(kLosslessPsnr, 10.0 * std::log10(255.0 * 255.0 / mse));
+}
+
+double elapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+ReplayStats replayRecording(const RecordingReader& recording, const ReplayOptions& options) {
+    ReplayStats stats{};
+    stats.path = recording.path();
+    stats.frameTimesUs.reserve(recording.frameCount() * std::max<uint32_t>(1, options.loops));
+    stats.minPsnr = std::numeric_limits<double>::max();
+    double psnrSum = 0;
+
+    std::unique_ptr<vic::ui::OffscreenRenderer> renderer;
+    if (options.render) {
+        vic::ui::OffscreenRendererConfig rendererConfig;
+        rendererConfig.filter = options.filter;
+        renderer = vic::ui::CreateOffscreenRenderer(rendererConfig);
+        renderer->Initialize(nullptr);
+        if (options.renderWidth > 0 && options.renderHeight > 0) {
+            renderer->Resize(options.renderWidth, options.renderHeight);
+        }
+    }
+
+    vic::encoder::EncodedFrame encoded;
+    vic::encoder::EncodedFrame referenceEncoded;
+    SurfaceSink sink;
+    SurfaceSink referenceSink;
+    const auto wallStart = Clock::now();
+    for (uint32_t loop = 0; loop < std::max<uint32_t>(1, options.loops); ++loop) {
+        // Decoder nuevo por vuelta: la grabación arranca en un keyframe
+        auto decoder = vic::decoder::createDecoder(recording.codec());
+        if (!decoder) {
+            logging::global().log(logging::Logger::Level::Error,
+                "[Replay] Sin decoder para " + std::string(vic::encoder::codecName(recording.codec())));
+            break;
+        }
+        decoder->setMaxThreads(options.decoderThreads);
+        std::unique_ptr<vic::decoder::VideoDecoder> referenceDecoder;
+        if (options.reference) {
+            referenceDecoder = vic::decoder::createDecoder(options.reference->codec());
+        }
+
+        for (size_t i = 0; i < recording.frameCount(); ++i) {
+            recording.toEncodedFrame(i, encoded);
+            ++stats.frames;
+            stats.bytes += encoded.payload.size();
+
+            const auto decodeStart = Clock::now();
+            const bool decoded = decoder->decodeOnly(encoded);
+            const auto convertStart = Clock::now();
+            sink.committed = false;
+            const bool converted = decoded && decoder->convertLatest(sink) && sink.committed;
+            const auto renderStart = Clock::now();
+            if (converted && renderer) {
+                renderer->RenderFrame(sink.frame);
+                renderer->Present();
+            }
+            const auto end = Clock::now();
+
+            stats.decodeMs += elapsedMs(decodeStart, convertStart);
+            stats.convertMs += elapsedMs(convertStart, renderStart);
+            stats.renderMs += elapsedMs(renderStart, end);
+            stats.frameTimesUs.push_back(static_cast<float>(elapsedMs(decodeStart, end) * 1000.0));
+            if (converted) {
+                stats.pixels += static_cast<uint64_t>(sink.frame.width) * sink.frame.height;
+            } else {
+                ++stats.failedFrames;
+            }
+
+            // Referencia: el frame con el mismo número, fuera del tiempo medido.
+            // Se decodifica siempre, aunque el principal haya fallado: saltearlo
+            // rompería su cadena de referencias y todas las muestras siguientes
+            if (referenceDecoder && i < options.reference->frameCount()) {
+                options.reference->toEncodedFrame(i, referenceEncoded);
+                referenceSink.committed = false;
+                const bool referenceDecoded = referenceDecoder->decodeInto(referenceEncoded, referenceSink) &&
+                                              referenceSink.committed;
+                if (converted && referenceDecoded &&
+                    referenceSink.frame.width == sink.frame.width && referenceSink.frame.height == sink.frame.height) {
+                    const double psnr = psnrBgra(sink.frame, referenceSink.frame);
+                    psnrSum += psnr;
+                    stats.minPsnr = std::min(stats.minPsnr, psnr);
+                    ++stats.comparedFrames;
+                }
+            }
+        }
+        stats.mediaMs += recording.durationMs();
+    }
+    stats.wallMs = elapsedMs(wallStart, Clock::now());
+    if (stats.comparedFrames > 0) {
+        stats.avgPsnr = psnrSum / static_cast<double>(stats.comparedFrames);
+    } else {
+        stats.minPsnr = 0;
+    }
+    return stats;
+}
+
+std::vector<ReplayStats> replayParallel(std::span<const RecordingReader* const> recordings,
+                                        const ReplayOptions& options, uint32_t jobs) {
+    std::vector<ReplayStats> results(recordings.size());
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    jobs = std::min<uint32_t>(jobs, static_cast<uint32_t>(recordings.size()));
+
+    // Cada hilo toma la próxima grabación libre: las largas no dejan cores ociosos
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (uint32_t i = 0; i < jobs; ++i) {
+        workers.emplace_back([&] {
+            for (size_t index = next++; index < recordings.size(); index = next++) {
+                results[index] = replayRecording(*recordings[index], options);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+FrameTimeSummary summarizeFrameTimes(std::span<const float> frameTimesUs) {
+    FrameTimeSummary summary{};
+    if (frameTimesUs.empty()) {
+        return summary;
+    }
+    std::vector<float> sorted(frameTimesUs.begin(), frameTimesUs.end());
+    std::sort(sorted.begin(), sorted.end());
+    const auto at = [&sorted](double fraction) {
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+    };
+    summary.p50 = at(0.50);
+    summary.p90 = at(0.90);
+    summary.p99 = at(0.99);
+    summary.p999 = at(0.999);
+    summary.max = sorted.back();
+    return summary;
+}
+
+} // namespace vic::recording
@@ -0,0 +1,366 @@
+#include "SessionRecorder.h"
+#include "RecordingFormat.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace vic::recording {
+
+namespace {
+
+// Buffer propio de cada archivo: un lote entero (~250 ms de video) se arma en
+// memoria y sale con un solo write(). No se usa pubsetbuf: en MSVC no tiene
+// efecto antes de open() y el stream se queda con el buffer de 4 KB del CRT
+constexpr size_t kFileBufferSize = 1024 * 1024;
+
+void append(std::vector<uint8_t>& out, const uint8_t* data, size_t size) {
+    out.insert(out.end(), data, data + size);
+}
+
+void putLe(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+std::string defaultBaseName() {
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::ostringstream oss;
+    oss << "session_" << std::put_time(std::localtime(&now), "%Y%m%d_%H%M%S");
+    return oss.str();
+}
+
+} // namespace
+
+struct SessionRecorder::Segment {
+    std::filesystem::path ivfPath;
+    std::ofstream ivf;
+    std::ofstream index;
+    std::vector<uint8_t> ivfBatch;      // Pendiente de write()
+    std::vector<uint8_t> indexBatch;
+    vic::encoder::VideoCodec codec{};
+    uint64_t firstTimestamp{};
+    uint64_t offset{};           // Bytes escritos en el IVF
+    uint32_t frameCount{};
+};
+
+SessionRecorder::SessionRecorder(RecorderConfig config)
+        : config_(std::move(config)) {}
+
+SessionRecorder::~SessionRecorder() {
+    stop();
+}
+
+bool SessionRecorder::start() {
+    if (running_.load()) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec || !std::filesystem::is_directory(config_.directory)) {
+        logging::global().log(logging::Logger::Level::Error,
+            "[Recorder] No se pudo crear el directorio " + config_.directory);
+        return false;
+    }
+    baseName_ = config_.baseName.empty() ? defaultBaseName() : config_.baseName;
+    segmentNumber_ = 0;
+    {
+        std::lock_guard lock(mutex_);
+        pending_.clear();
+        pendingBytes_ = 0;
+        writingBytes_ = 0;
+        awaitingKeyframe_ = true;
+        stopping_ = false;
+        stats_ = {};
+    }
+    failed_.store(false);
+    keyframeWanted_.store(true);
+    running_.store(true);
+    writerThread_ = std::thread([this] { writerLoop(); });
+    logging::global().log(logging::Logger::Level::Info,
+        "[Recorder] Grabando en " + (std::filesystem::path(config_.directory) / baseName_).string() + "_*.ivf");
+    return true;
+}
+
+void SessionRecorder::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (writerThread_.joinable()) {
+        writerThread_.join();
+    }
+    const auto final = stats();
+    logging::global().log(logging::Logger::Level::Info,
+        "[Recorder] Grabación cerrada: " + std::to_string(final.framesWritten) + " frames, " +
+        std::to_string(final.bytesWritten / 1024) + " KB, " + std::to_string(final.segments) +
+        " segmento(s), " + std::to_string(final.framesDropped) + " descartados");
+}
+
+bool SessionRecorder::enqueue(std::shared_ptr<const vic::encoder::EncodedFrame> frame) {
+    if (!running_.load(std::memory_order_relaxed) || failed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    const size_t bytes = frame->payload.size();
+    std::lock_guard lock(mutex_);
+    // Un frame por tiles son varios bitstreams: un IVF no los representa
+    if (!frame->tiles.empty()) {
+        if (!tilesWarned_) {
+            tilesWarned_ = true;
+            logging::global().log(logging::Logger::Level::Warning,
+                "[Recorder] Encoder por tiles: esos frames no se graban");
+        }
+        ++stats_.framesDropped;
+        return false;
+    }
+    if (awaitingKeyframe_) {
+        if (!frame->keyFrame) {
+            ++stats_.framesDropped;
+            return false;
+        }
+        awaitingKeyframe_ = false;
+    }
+    // Disco más lento que el stream: descartar lo encolado y retomar en un
+    // keyframe, sin bloquear al hilo de captura
+    if (pendingBytes_ + writingBytes_ + bytes > config_.maxPendingBytes) {
+        stats_.framesDropped += pending_.size() + 1;
+        pending_.clear();
+        pendingBytes_ = 0;
+        awaitingKeyframe_ = true;
+        keyframeWanted_.store(true);
+        logging::global().log(logging::Logger::Level::Warning,
+            "[Recorder] Backlog de escritura lleno, descartando hasta el próximo keyframe");
+        return false;
+    }
+    pending_.push_back(std::move(frame));
+    pendingBytes_ += bytes;
+    return true;
+}
+
+bool SessionRecorder::takeKeyframeRequest() {
+    return isRecording() && keyframeWanted_.exchange(false);
+}
+
+RecorderStats SessionRecorder::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+std::string SessionRecorder::currentPath() const {
+    std::lock_guard lock(mutex_);
+    return currentPath_;
+}
+
+void SessionRecorder::writerLoop() {
+    std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>> batch;
+    while (true) {
+        bool last = false;
+        {
+            std::unique_lock lock(mutex_);
+            // Un lote por intervalo; antes si el backlog pasa de un cuarto del máximo
+            cv_.wait_for(lock, config_.flushInterval,
+                [this] { return stopping_ || pendingBytes_ * 4 >= config_.maxPendingBytes; });
+            batch.swap(pending_);
+            writingBytes_ = pendingBytes_;
+            pendingBytes_ = 0;
+            last = stopping_;
+        }
+
+        RecorderStats written{};
+        const uint32_t segmentsBefore = segmentNumber_;
+        for (const auto& frame : batch) {
+            if (writeFrame(*frame)) {
+                ++written.framesWritten;
+                written.bytesWritten += frame->payload.size();
+                written.keyFrames += frame->keyFrame ? 1 : 0;
+            } else {
+                ++written.framesDropped;
+            }
+        }
+        // Un write() y un flush por lote. Si el disco falló, el lote se da
+        // por perdido
+        if (segment_) {
+            flushSegment();
+        }
+        if (failed_.load()) {
+            written = {0, 0, 0, written.framesDropped + written.framesWritten};
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            writingBytes_ = 0;
+            stats_.framesWritten += written.framesWritten;
+            stats_.bytesWritten += written.bytesWritten;
+            stats_.keyFrames += written.keyFrames;
+            stats_.framesDropped += written.framesDropped;
+            stats_.segments += segmentNumber_ - segmentsBefore;
+            if (segment_) {
+                currentPath_ = segment_->ivfPath.string();
+            }
+        }
+        batch.clear();
+        if (last) {
+            break;
+        }
+    }
+    closeSegment();
+}
+
+bool SessionRecorder::writeFrame(const vic::encoder::EncodedFrame& frame) {
+    // Tras un error no se reabre nada, aunque lleguen keyframes en el lote
+    if (failed_.load()) {
+        return false;
+    }
+    // Otro codec (renegociado para un viewer nuevo) no entra en el mismo IVF:
+    // segmento nuevo, que arranca en el keyframe del encoder nuevo
+    if (!segment_ || segment_->codec != frame.codec) {
+        if (!frame.keyFrame || !openSegment(frame)) {
+            return false;
+        }
+    }
+    Segment& segment = *segment_;
+    const uint64_t pts = frame.timestamp - std::min(frame.timestamp, segment.firstTimestamp);
+
+    putLe(segment.ivfBatch, frame.payload.size(), 4);
+    putLe(segment.ivfBatch, pts, 8);
+    append(segment.ivfBatch, frame.payload.data(), frame.payload.size());
+
+    // Índice: keyframes (para buscar) y frames con copy-rects (el decoder los
+    // aplica antes de decodificar; un reproductor IVF común los ignora)
+    const uint8_t flags = static_cast<uint8_t>((frame.keyFrame ? kIndexKeyFrame : 0) |
+                                               (frame.copyRects.empty() ? 0 : kIndexCopyRects));
+    if (flags != 0) {
+        auto& entry = segment.indexBatch;
+        putLe(entry, segment.frameCount, 4);
+        putLe(entry, frame.copyRects.size(), 4);
+        putLe(entry, segment.offset, 8);
+        putLe(entry, frame.timestamp, 8);
+        putLe(entry, frame.width, 2);
+        putLe(entry, frame.height, 2);
+        putLe(entry, frame.originalWidth, 2);
+        putLe(entry, frame.originalHeight, 2);
+        putLe(entry, flags, 1);
+        putLe(entry, 0, 7);
+        for (const auto& rect : frame.copyRects) {
+            putLe(entry, rect.srcX, 4);
+            putLe(entry, rect.srcY, 4);
+            putLe(entry, rect.dstX, 4);
+            putLe(entry, rect.dstY, 4);
+            putLe(entry, rect.width, 4);
+            putLe(entry, rect.height, 4);
+        }
+    }
+
+    segment.offset += kIvfFrameHeaderSize + frame.payload.size();
+    ++segment.frameCount;
+    // Un lote más grande que el buffer (keyframes 4K) sale en varios write()
+    if (segment.ivfBatch.size() >= kFileBufferSize) {
+        return flushSegment();
+    }
+    return true;
+}
+
+bool SessionRecorder::flushSegment() {
+    Segment& segment = *segment_;
+    segment.ivf.write(reinterpret_cast<const char*>(segment.ivfBatch.data()),
+                      static_cast<std::streamsize>(segment.ivfBatch.size()));
+    segment.index.write(reinterpret_cast<const char*>(segment.indexBatch.data()),
+                        static_cast<std::streamsize>(segment.indexBatch.size()));
+    segment.ivf.flush();
+    segment.index.flush();
+    segment.ivfBatch.clear();
+    segment.indexBatch.clear();
+    if (!segment.ivf || !segment.index) {
+        fail("Error escribiendo " + segment.ivfPath.string());
+        return false;
+    }
+    return true;
+}
+
+void SessionRecorder::fail(const std::string& what) {
+    // Solo se marca: stop() sigue siendo quien detiene y junta el hilo
+    failed_.store(true);
+    logging::global().log(logging::Logger::Level::Error, "[Recorder] " + what + ", grabación detenida");
+    closeSegment();
+}
+
+bool SessionRecorder::openSegment(const vic::encoder::EncodedFrame& first) {
+    closeSegment();
+
+    std::ostringstream name;
+    name << baseName_ << '_' << std::setw(3) << std::setfill('0') << segmentNumber_;
+    const auto base = std::filesystem::path(config_.directory) / name.str();
+
+    auto segment = std::make_unique<Segment>();
+    segment->ivfPath = base;
+    segment->ivfPath += ".ivf";
+    auto indexPath = base;
+    indexPath += ".idx";
+    segment->ivfBatch.reserve(kFileBufferSize + kIvfFrameHeaderSize);
+    segment->indexBatch.reserve(kFileBufferSize / 16);
+    segment->ivf.open(segment->ivfPath, std::ios::binary | std::ios::trunc);
+    segment->index.open(indexPath, std::ios::binary | std::ios::trunc);
+    if (!segment->ivf || !segment->index) {
+        fail("No se pudo crear " + segment->ivfPath.string());
+        return false;
+    }
+    segment->codec = first.codec;
+    segment->firstTimestamp = first.timestamp;
+
+    auto& header = segment->ivfBatch;
+    header.assign(kIvfSignature, kIvfSignature + sizeof(kIvfSignature));
+    putLe(header, 0, 2);                                   // Versión
+    putLe(header, kIvfFileHeaderSize, 2);
+    putLe(header, ivfFourcc(first.codec), 4);
+    putLe(header, first.width, 2);
+    putLe(header, first.height, 2);
+    putLe(header, kIvfTimebaseDenominator, 4);             // Rate
+    putLe(header, 1, 4);                                   // Scale: pts en ms
+    putLe(header, 0, 4);                                   // Frames: se completa al cerrar
+    putLe(header, 0, 4);
+    segment->offset = kIvfFileHeaderSize;
+
+    auto& indexHeader = segment->indexBatch;
+    indexHeader.assign(kIndexSignature, kIndexSignature + sizeof(kIndexSignature));
+    putLe(indexHeader, kIndexVersion, 4);
+    putLe(indexHeader, 0, 4);
+
+    logging::global().log(logging::Logger::Level::Info,
+        "[Recorder] Segmento " + segment->ivfPath.filename().string() + " (" + vic::encoder::codecName(first.codec) + " " +
+        std::to_string(first.width) + "x" + std::to_string(first.height) + ")");
+    segment_ = std::move(segment);
+    ++segmentNumber_;
+    return true;
+}
+
+void SessionRecorder::closeSegment() {
+    if (!segment_) {
+        return;
+    }
+    // Lo que quede del lote (cambio de codec a mitad de lote); tras un error
+    // solo se cierra
+    if (!failed_.load() && !flushSegment()) {
+        return;
+    }
+    // Los reproductores usan el total de la cabecera para la duración
+    std::vector<uint8_t> count;
+    putLe(count, segment_->frameCount, 4);
+    segment_->ivf.seekp(static_cast<std::streamoff>(kIvfFrameCountOffset));
+    segment_->ivf.write(reinterpret_cast<const char*>(count.data()), static_cast<std::streamsize>(count.size()));
+    segment_->ivf.close();
+    segment_->index.close();
+    segment_.reset();
+}
+
+} // namespace vic::recording
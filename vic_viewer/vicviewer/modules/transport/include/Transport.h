@@ -1,7 +1,9 @@
 #pragma once
 
+#include "CursorShape.h"
 #include "EncodedFrame.h"
 #include "InputEvents.h"
+#include "VideoCodec.h"
 
 #include <cstdint>
 #include <functional>
@@ -70,6 +72,14 @@ struct AnswerBundle {
     std::vector<IceCandidate> iceCandidates;
 };
 
+/// Pedido de frame de recuperación del viewer: el último frame decodificado
+/// y los long-term que conserva intactos (0 = ninguno)
+struct RecoveryRequest {
+    uint32_t lastFrameId{};
+    uint32_t goldenFrameId{};
+    uint32_t altRefFrameId{};
+};
+
 class TransportServer {
 public:
     TransportServer();
@@ -85,6 +95,14 @@ public:
     void setConnectionInfo(const ConnectionInfo& info);
 
     bool sendFrame(const vic::encoder::EncodedFrame& frame);
+
+    /// Bytes encolados en el DataChannel aún sin enviar (congestión del viewer)
+    [[nodiscard]] size_t bufferedAmount() const;
+
+    /// Enviar estado del cursor por el DataChannel. La forma se envía solo la
+    /// primera vez que aparece su hash en la conexión actual y la posición
+    /// solo si cambió desde el último envío
+    bool sendCursorUpdate(const vic::capture::CursorState& state, const vic::capture::CursorShape* shape);
     
     // Devuelve true una sola vez cuando el DataChannel se abre y necesita keyframe
     bool needsInitialKeyframe();
@@ -93,6 +111,12 @@ public:
         std::function<void(const vic::input::MouseEvent&)> mouseHandler,
         std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler);
 
+    /// Llamado (desde el hilo de red) cuando el viewer perdió frames
+    void setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler);
+
+    /// Llamado (desde el hilo de red) cuando el viewer anuncia sus decoders
+    void setCapabilitiesHandler(std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler);
+
     void setConnectionStateCallback(std::function<void(ConnectionState)> callback);
 
 private:
@@ -112,10 +136,18 @@ public:
     void setConnectionInfo(const ConnectionInfo& info);
 
     void setFrameHandler(std::function<void(const vic::encoder::EncodedFrame&)> handler);
+    void setCursorHandlers(
+        std::function<void(const vic::capture::CursorState&)> positionHandler,
+        std::function<void(const vic::capture::CursorShape&)> shapeHandler);
     void setConnectionStateCallback(std::function<void(ConnectionState)> callback);
 
+    /// Decoders de este viewer: se anuncian al host cada vez que se abre el
+    /// DataChannel o el túnel, para que elija el codec del stream
+    void setLocalCapabilities(std::vector<vic::encoder::CodecCapability> capabilities);
+
     bool sendMouseEvent(const vic::input::MouseEvent& ev);
     bool sendKeyboardEvent(const vic::input::KeyboardEvent& ev);
+    bool sendRecoveryRequest(const RecoveryRequest& request);
 
     void stop();
 
@@ -7,7 +7,11 @@ namespace vic::transport::protocol {
 enum class ControlMessageType : uint8_t {
     Mouse = 1,
     Keyboard = 2,
-    VideoFrame = 3
+    VideoFrame = 3,
+    CursorPosition = 4,   // Host -> viewer, en cada movimiento
+    CursorShape = 5,      // Host -> viewer, una vez por forma (cacheada por hash)
+    RecoveryRequest = 6,  // Viewer -> host, al descartar frames por referencias perdidas
+    Capabilities = 7      // Viewer -> host, al abrir el canal: decoders soportados
 };
 
 #pragma pack(push, 1)
@@ -19,6 +23,37 @@ struct VideoFrameHeader {
     uint8_t keyFrame;
     uint32_t originalWidth;   // Ancho ORIGINAL de la pantalla del host
     uint32_t originalHeight;  // Alto ORIGINAL de la pantalla del host
+    uint8_t copyRectCount;    // CopyRectMessage que siguen al header (antes del payload)
+    uint32_t frameId;
+    uint32_t referenceFrameId;
+    uint8_t referenceFlags;   // EncodedFrame::kRefreshGolden | kRefreshAltRef | kRecovery
+    uint8_t codec;            // vic::encoder::VideoCodec del stream
+    uint8_t temporalLayer;    // 0 = base; >0 = descartable por el emisor o un relay
+    uint8_t tileCount;        // TileMessage que siguen a los copy-rects (0 = un solo bitstream)
+};
+
+// Bloque desplazado (scroll / ventana arrastrada) en coordenadas del frame codificado
+struct CopyRectMessage {
+    uint16_t srcX;
+    uint16_t srcY;
+    uint16_t dstX;
+    uint16_t dstY;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Tile codificado por separado (encoder por tiles): su rectángulo en el frame,
+// cuántos bytes del payload le tocan (en orden) y sus propias referencias
+struct TileMessage {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    uint32_t payloadSize;
+    uint8_t keyFrame;
+    uint32_t frameId;
+    uint32_t referenceFrameId;
+    uint8_t referenceFlags;
 };
 #pragma pack(pop)
 
@@ -36,6 +71,41 @@ struct KeyboardMessage {
     uint16_t scan;
     uint8_t action;
 };
+
+struct CursorPositionMessage {
+    int32_t x;                // Hotspot en coordenadas de la pantalla original
+    int32_t y;
+    uint64_t shapeHash;       // Forma enviada previamente con CursorShape
+    uint8_t visible;
+};
+
+// Frames long-term que el viewer conserva intactos (0 = ninguno): el host
+// codifica el siguiente frame referenciando solo uno de ellos
+struct RecoveryRequestMessage {
+    uint32_t lastFrameId;     // Último frame decodificado correctamente
+    uint32_t goldenFrameId;
+    uint32_t altRefFrameId;
+};
+
+// Seguido de codecCount CodecCapabilityMessage, en orden de preferencia del viewer
+struct CapabilitiesHeader {
+    uint8_t codecCount;
+};
+
+struct CodecCapabilityMessage {
+    uint8_t codec;            // vic::encoder::VideoCodec
+    uint8_t profileMask;      // Bit por perfil soportado (ver VideoCodec.h)
+};
+
+// Seguido de width*height*4 bytes BGRA
+struct CursorShapeHeader {
+    uint64_t hash;
+    uint16_t width;
+    uint16_t height;
+    uint16_t hotspotX;
+    uint16_t hotspotY;
+    uint32_t payloadSize;
+};
 #pragma pack(pop)
 
 } // namespace vic::transport::protocol
@@ -4,6 +4,7 @@
 #include "TransportProtocol.h"
 #include "TunnelAgent.h"
 #include "TunnelFallback.h"
+#include "VideoFramePacket.h"
 
 #include <rtc/rtc.hpp>
 
@@ -18,6 +19,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -26,8 +28,11 @@ namespace vic::transport {
 namespace {
 
 using protocol::ControlMessageType;
+using protocol::CursorPositionMessage;
+using protocol::CursorShapeHeader;
 using protocol::KeyboardMessage;
 using protocol::MouseMessage;
+using protocol::RecoveryRequestMessage;
 
 std::atomic_bool g_rtcInitialized{false};
 
@@ -138,6 +143,55 @@ rtc::binary buildKeyboardPayload(const vic::input::KeyboardEvent& ev) {
     return payload;
 }
 
+rtc::binary buildCursorPositionPayload(const vic::capture::CursorState& state) {
+    rtc::binary payload;
+    payload.resize(sizeof(uint8_t) + sizeof(CursorPositionMessage));
+    payload[0] = std::byte{static_cast<uint8_t>(ControlMessageType::CursorPosition)};
+    CursorPositionMessage message{};
+    message.x = state.x;
+    message.y = state.y;
+    message.shapeHash = state.shapeHash;
+    message.visible = state.visible ? 1 : 0;
+    std::memcpy(payload.data() + 1, &message, sizeof(CursorPositionMessage));
+    return payload;
+}
+
+rtc::binary buildCursorShapePayload(const vic::capture::CursorShape& shape) {
+    rtc::binary payload;
+    payload.resize(sizeof(uint8_t) + sizeof(CursorShapeHeader) + shape.bgraData.size());
+    payload[0] = std::byte{static_cast<uint8_t>(ControlMessageType::CursorShape)};
+    CursorShapeHeader header{};
+    header.hash = shape.hash;
+    header.width = static_cast<uint16_t>(shape.width);
+    header.height = static_cast<uint16_t>(shape.height);
+    header.hotspotX = static_cast<uint16_t>(shape.hotspotX);
+    header.hotspotY = static_cast<uint16_t>(shape.hotspotY);
+    header.payloadSize = static_cast<uint32_t>(shape.bgraData.size());
+    std::memcpy(payload.data() + 1, &header, sizeof(CursorShapeHeader));
+    std::memcpy(payload.data() + 1 + sizeof(CursorShapeHeader), shape.bgraData.data(), shape.bgraData.size());
+    return payload;
+}
+
+rtc::binary buildRecoveryRequestPayload(const RecoveryRequest& request) {
+    rtc::binary payload;
+    payload.resize(sizeof(uint8_t) + sizeof(RecoveryRequestMessage));
+    payload[0] = std::byte{static_cast<uint8_t>(ControlMessageType::RecoveryRequest)};
+    RecoveryRequestMessage message{};
+    message.lastFrameId = request.lastFrameId;
+    message.goldenFrameId = request.goldenFrameId;
+    message.altRefFrameId = request.altRefFrameId;
+    std::memcpy(payload.data() + 1, &message, sizeof(RecoveryRequestMessage));
+    return payload;
+}
+
+rtc::binary buildCapabilitiesPayload(const std::vector<vic::encoder::CodecCapability>& capabilities) {
+    rtc::binary payload;
+    payload.resize(sizeof(uint8_t) + protocol::capabilitiesPacketSize(capabilities));
+    payload[0] = std::byte{static_cast<uint8_t>(ControlMessageType::Capabilities)};
+    protocol::writeCapabilitiesPacket(capabilities, reinterpret_cast<uint8_t*>(payload.data() + 1));
+    return payload;
+}
+
 ConnectionState mapState(rtc::PeerConnection::State state) {
     switch (state) {
     case rtc::PeerConnection::State::New:
@@ -228,6 +282,20 @@ public:
         return channel_->send(payload);
     }
 
+    void setCursorHandlers(std::function<void(const vic::capture::CursorState&)> positionHandler,
+                           std::function<void(const vic::capture::CursorShape&)> shapeHandler) {
+        cursorPositionHandler_ = std::move(positionHandler);
+        cursorShapeHandler_ = std::move(shapeHandler);
+    }
+
+    void setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler) {
+        recoveryHandler_ = std::move(handler);
+    }
+
+    void setCapabilitiesHandler(std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler) {
+        capabilitiesHandler_ = std::move(handler);
+    }
+
 private:
     void handleMessage(const rtc::binary& data) {
         if (data.size() <= 1) {
@@ -268,39 +336,78 @@ private:
                 keyboardHandler_(evt);
             }
         } else if (type == static_cast<uint8_t>(ControlMessageType::VideoFrame)) {
-            const size_t headerSize = sizeof(protocol::VideoFrameHeader);
-            if (data.size() < 1 + headerSize) {
-                logging::global().log(logging::Logger::Level::Warning, "[DC] VideoFrame: header too small");
-                return;
-            }
-            protocol::VideoFrameHeader header{};
-            std::memcpy(&header, buffer, headerSize);
-            
-            if (data.size() != 1 + headerSize + header.payloadSize) {
+            vic::encoder::EncodedFrame frame{};
+            if (!protocol::readVideoFramePacket(reinterpret_cast<const uint8_t*>(buffer), data.size() - 1, frame)) {
                 logging::global().log(logging::Logger::Level::Warning, "[DC] VideoFrame: size mismatch");
                 return;
             }
             
             logging::global().log(logging::Logger::Level::Info, 
-                "[DC] VideoFrame RECIBIDO: " + std::to_string(header.width) + "x" + 
-                std::to_string(header.height) + " (orig:" + std::to_string(header.originalWidth) + "x" +
-                std::to_string(header.originalHeight) + ") payload=" + std::to_string(header.payloadSize));
+                "[DC] VideoFrame RECIBIDO: " + std::to_string(frame.width) + "x" + 
+                std::to_string(frame.height) + " (orig:" + std::to_string(frame.originalWidth) + "x" +
+                std::to_string(frame.originalHeight) + ") payload=" + std::to_string(frame.payload.size()));
             
             if (frameHandler_) {
-                vic::encoder::EncodedFrame frame{};
-                frame.width = header.width;
-                frame.height = header.height;
-                frame.originalWidth = header.originalWidth > 0 ? header.originalWidth : header.width;
-                frame.originalHeight = header.originalHeight > 0 ? header.originalHeight : header.height;
-                frame.timestamp = header.timestamp;
-                frame.keyFrame = header.keyFrame != 0;
-                frame.payload.resize(header.payloadSize);
-                std::memcpy(frame.payload.data(), buffer + headerSize, header.payloadSize);
                 logging::global().log(logging::Logger::Level::Info, "[DC] Llamando frameHandler_");
                 frameHandler_(frame);
             } else {
                 logging::global().log(logging::Logger::Level::Warning, "[DC] frameHandler_ es NULL!");
             }
+        } else if (type == static_cast<uint8_t>(ControlMessageType::CursorPosition)) {
+            if (data.size() != 1 + sizeof(CursorPositionMessage)) {
+                return;
+            }
+            CursorPositionMessage msg{};
+            std::memcpy(&msg, buffer, sizeof(CursorPositionMessage));
+            if (cursorPositionHandler_) {
+                vic::capture::CursorState state{};
+                state.x = msg.x;
+                state.y = msg.y;
+                state.visible = msg.visible != 0;
+                state.shapeHash = msg.shapeHash;
+                cursorPositionHandler_(state);
+            }
+        } else if (type == static_cast<uint8_t>(ControlMessageType::CursorShape)) {
+            const size_t headerSize = sizeof(CursorShapeHeader);
+            if (data.size() < 1 + headerSize) {
+                return;
+            }
+            CursorShapeHeader header{};
+            std::memcpy(&header, buffer, headerSize);
+            const size_t expected = static_cast<size_t>(header.width) * header.height * 4;
+            if (header.payloadSize != expected || data.size() != 1 + headerSize + expected) {
+                logging::global().log(logging::Logger::Level::Warning, "[DC] CursorShape: size mismatch");
+                return;
+            }
+            if (cursorShapeHandler_) {
+                vic::capture::CursorShape shape{};
+                shape.hash = header.hash;
+                shape.width = header.width;
+                shape.height = header.height;
+                shape.hotspotX = header.hotspotX;
+                shape.hotspotY = header.hotspotY;
+                shape.bgraData.resize(expected);
+                std::memcpy(shape.bgraData.data(), buffer + headerSize, expected);
+                cursorShapeHandler_(shape);
+            }
+        } else if (type == static_cast<uint8_t>(ControlMessageType::RecoveryRequest)) {
+            if (data.size() != 1 + sizeof(RecoveryRequestMessage)) {
+                return;
+            }
+            RecoveryRequestMessage msg{};
+            std::memcpy(&msg, buffer, sizeof(RecoveryRequestMessage));
+            if (recoveryHandler_) {
+                recoveryHandler_(RecoveryRequest{msg.lastFrameId, msg.goldenFrameId, msg.altRefFrameId});
+            }
+        } else if (type == static_cast<uint8_t>(ControlMessageType::Capabilities)) {
+            std::vector<vic::encoder::CodecCapability> capabilities;
+            if (!protocol::readCapabilitiesPacket(reinterpret_cast<const uint8_t*>(buffer), data.size() - 1, capabilities)) {
+                logging::global().log(logging::Logger::Level::Warning, "[DC] Capabilities: size mismatch");
+                return;
+            }
+            if (capabilitiesHandler_) {
+                capabilitiesHandler_(capabilities);
+            }
         }
     }
 
@@ -310,6 +417,10 @@ private:
     std::function<void(const vic::input::MouseEvent&)> mouseHandler_;
     std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler_;
     std::function<void(const vic::encoder::EncodedFrame&)> frameHandler_;
+    std::function<void(const vic::capture::CursorState&)> cursorPositionHandler_;
+    std::function<void(const vic::capture::CursorShape&)> cursorShapeHandler_;
+    std::function<void(const RecoveryRequest&)> recoveryHandler_;
+    std::function<void(const std::vector<vic::encoder::CodecCapability>&)> capabilitiesHandler_;
 };
 
 } // namespace
@@ -436,8 +547,10 @@ public:
     }
 
     bool sendFrame(const vic::encoder::EncodedFrame& frame) {
+        // Los descartes por congestión (capas temporales de mejora, cola
+        // llena) los decide ViewerPeer: acá se envía todo lo que llega
         bool sent = false;
-        
+
         // NOTA: Usar DataChannel para video para mejor compatibilidad WAN
         // El track RTP tiene problemas con sdpMid mismatch entre host y viewer
         
@@ -446,8 +559,10 @@ public:
             sent = sendFrameViaDataChannel(frame);
         }
         
-        // Fallback: Try RTP track only if DataChannel failed
-        if (!sent && videoTrack_ && videoTrack_->isOpen() && !frame.payload.empty()) {
+        // Fallback: Try RTP track only if DataChannel failed (el track se negoció como VP8,
+        // y un frame por tiles no es un bitstream VP8 válido)
+        if (!sent && frame.codec == vic::encoder::VideoCodec::Vp8 && frame.tiles.empty() &&
+            videoTrack_ && videoTrack_->isOpen() && !frame.payload.empty()) {
             const uint32_t timestamp = normalizeTimestamp(frame.timestamp, config_.clockRate);
             rtc::FrameInfo info(timestamp);
             info.timestampSeconds = std::chrono::duration<double>(frame.timestamp / 1000.0);
@@ -464,42 +579,32 @@ public:
         return sent;
     }
     
+    size_t bufferedAmount() const {
+        const auto channel = controlChannel_;
+        return channel && channel->isOpen() ? channel->bufferedAmount() : 0;
+    }
+
     bool sendFrameViaDataChannel(const vic::encoder::EncodedFrame& frame) {
         if (!controlChannel_ || !controlChannel_->isOpen()) {
-            static int logCount = 0;
-            if (logCount++ % 100 == 0) {
+            if (notReadyLogCount_.fetch_add(1, std::memory_order_relaxed) % 100 == 0) {
                 logging::global().log(logging::Logger::Level::Debug, 
                     "[Server] sendFrameViaDataChannel: channel not ready");
             }
             return false;
         }
         
-        // Build packet: [type:1][header][payload:N]
-        const size_t headerSize = sizeof(protocol::VideoFrameHeader);
+        // Build packet: [type:1][header][copyRects][tiles][payload:N]
         rtc::binary packet;
-        packet.resize(1 + headerSize + frame.payload.size());
+        packet.resize(1 + protocol::videoFramePacketSize(frame));
         
         packet[0] = std::byte{static_cast<uint8_t>(protocol::ControlMessageType::VideoFrame)};
+        protocol::writeVideoFramePacket(frame, reinterpret_cast<uint8_t*>(packet.data() + 1));
         
-        protocol::VideoFrameHeader header{};
-        header.width = frame.width;
-        header.height = frame.height;
-        header.timestamp = frame.timestamp;
-        header.payloadSize = static_cast<uint32_t>(frame.payload.size());
-        header.keyFrame = frame.keyFrame ? 1 : 0;
-        // Resolución original para cálculo correcto de coordenadas de mouse
-        header.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
-        header.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
-        
-        std::memcpy(packet.data() + 1, &header, headerSize);
-        std::memcpy(packet.data() + 1 + headerSize, frame.payload.data(), frame.payload.size());
-        
-        static int frameCount = 0;
-        if (frameCount++ % 30 == 0) {
+        if (sentLogCount_.fetch_add(1, std::memory_order_relaxed) % 30 == 0) {
             logging::global().log(logging::Logger::Level::Info, 
                 "[Server] Enviando frame via DC: " + std::to_string(frame.width) + "x" + 
-                std::to_string(frame.height) + " (orig:" + std::to_string(header.originalWidth) + "x" +
-                std::to_string(header.originalHeight) + ") size=" + std::to_string(frame.payload.size()));
+                std::to_string(frame.height) + " (orig:" + std::to_string(frame.originalWidth) + "x" +
+                std::to_string(frame.originalHeight) + ") size=" + std::to_string(frame.payload.size()));
         }
         
         try {
@@ -510,6 +615,32 @@ public:
         }
     }
 
+    bool sendCursorUpdate(const vic::capture::CursorState& state, const vic::capture::CursorShape* shape) {
+        if (!controlChannel_ || !controlChannel_->isOpen()) {
+            return false;
+        }
+
+        std::lock_guard lock(cursorMutex_);
+        try {
+            // La forma va antes que la posición que la referencia
+            if (shape && shape->hash == state.shapeHash && !sentCursorShapes_.count(shape->hash)) {
+                controlChannel_->send(buildCursorShapePayload(*shape));
+                sentCursorShapes_.insert(shape->hash);
+                logging::global().log(logging::Logger::Level::Debug,
+                    "[Server] Forma de cursor enviada: " + std::to_string(shape->width) + "x" +
+                    std::to_string(shape->height));
+            }
+            if (lastCursorState_ && *lastCursorState_ == state) {
+                return true;
+            }
+            controlChannel_->send(buildCursorPositionPayload(state));
+            lastCursorState_ = state;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
     void setInputHandlers(
         std::function<void(const vic::input::MouseEvent&)> mouseHandler,
         std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler) {
@@ -523,6 +654,22 @@ public:
         }
     }
 
+    void setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler) {
+        recoveryHandler_ = std::move(handler);
+        dataChannelWrapper_.setRecoveryHandler(recoveryHandler_);
+        if (fallbackServer_) {
+            fallbackServer_->setRecoveryHandler(recoveryHandler_);
+        }
+    }
+
+    void setCapabilitiesHandler(std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler) {
+        capabilitiesHandler_ = std::move(handler);
+        dataChannelWrapper_.setCapabilitiesHandler(capabilitiesHandler_);
+        if (fallbackServer_) {
+            fallbackServer_->setCapabilitiesHandler(capabilitiesHandler_);
+        }
+    }
+
     void setConnectionStateCallback(std::function<void(ConnectionState)> callback) {
         stateCallback_ = std::move(callback);
         recomputeState();
@@ -586,6 +733,12 @@ private:
         controlChannel_->onOpen([this]() {
             logging::global().log(logging::Logger::Level::Info, 
                 "[Server] DataChannel ABIERTO - solicitando keyframe");
+            {
+                // Viewer nuevo: no tiene ninguna forma de cursor cacheada
+                std::lock_guard lock(cursorMutex_);
+                sentCursorShapes_.clear();
+                lastCursorState_.reset();
+            }
             needsKeyframe_.store(true, std::memory_order_release);
         });
         controlChannel_->onClosed([this]() {
@@ -607,6 +760,8 @@ private:
     std::function<void(ConnectionState)> stateCallback_;
     std::function<void(const vic::input::MouseEvent&)> mouseHandler_;
     std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler_;
+    std::function<void(const RecoveryRequest&)> recoveryHandler_;
+    std::function<void(const std::vector<vic::encoder::CodecCapability>&)> capabilitiesHandler_;
     DataChannelWrapper dataChannelWrapper_;
     LocalGatheringState gatheringState_;
     std::unique_ptr<fallback::Server> fallbackServer_;
@@ -615,6 +770,12 @@ private:
     std::atomic_bool fallbackConnected_{false};
     std::atomic<ConnectionState> peerState_{ConnectionState::New};
     std::atomic_bool needsKeyframe_{false};
+    // Logs de envío cada N frames; cada viewer manda desde su propio hilo
+    std::atomic<uint32_t> notReadyLogCount_{0};
+    std::atomic<uint32_t> sentLogCount_{0};
+    std::mutex cursorMutex_;
+    std::unordered_set<uint64_t> sentCursorShapes_;
+    std::optional<vic::capture::CursorState> lastCursorState_;
 };
 
     void TransportServer::Impl::ensureFallbackInitialized() {
@@ -625,6 +786,8 @@ private:
         if (!fallbackServer_) {
             fallbackServer_ = std::make_unique<fallback::Server>();
             fallbackServer_->setInputHandlers(mouseHandler_, keyboardHandler_);
+            fallbackServer_->setRecoveryHandler(recoveryHandler_);
+            fallbackServer_->setCapabilitiesHandler(capabilitiesHandler_);
             fallbackServer_->setConnectionCallback([this](bool connected) {
                 fallbackConnected_.store(connected, std::memory_order_release);
                 recomputeState();
@@ -770,6 +933,11 @@ public:
         }
     }
 
+    void setCursorHandlers(std::function<void(const vic::capture::CursorState&)> positionHandler,
+                           std::function<void(const vic::capture::CursorShape&)> shapeHandler) {
+        dataChannelWrapper_.setCursorHandlers(std::move(positionHandler), std::move(shapeHandler));
+    }
+
     void setConnectionStateCallback(std::function<void(ConnectionState)> callback) {
         stateCallback_ = std::move(callback);
         recomputeState();
@@ -815,6 +983,26 @@ public:
         return false;
     }
 
+    void setLocalCapabilities(std::vector<vic::encoder::CodecCapability> capabilities) {
+        {
+            std::lock_guard lock(capabilitiesMutex_);
+            capabilities_ = std::move(capabilities);
+        }
+        // Canal ya abierto: anunciar ahora, si no se anuncia al abrirse
+        sendCapabilities();
+    }
+
+    bool sendRecoveryRequest(const RecoveryRequest& request) {
+        if (dataChannelWrapper_.send(buildRecoveryRequestPayload(request))) {
+            return true;
+        }
+        std::lock_guard lock(fallbackMutex_);
+        if (fallbackClient_ && fallbackClient_->isConnected()) {
+            return fallbackClient_->sendRecoveryRequest(request);
+        }
+        return false;
+    }
+
     void stop() {
         if (pc_) {
             pc_->close();
@@ -899,11 +1087,16 @@ private:
             controlChannel_ = std::move(channel);
             controlChannel_->onOpen([this]() {
                 logging::global().log(logging::Logger::Level::Info, "[TransportClient] DataChannel ABIERTO - listo para enviar");
+                sendCapabilities();
             });
             controlChannel_->onClosed([this]() {
                 logging::global().log(logging::Logger::Level::Warning, "[TransportClient] DataChannel CERRADO");
             });
             attachDataChannel();
+            // Un canal entrante puede llegar ya abierto (sin onOpen)
+            if (controlChannel_->isOpen()) {
+                sendCapabilities();
+            }
         });
 
         pc_->onTrack([this](std::shared_ptr<rtc::Track> track) {
@@ -946,6 +1139,22 @@ private:
         frameHandler_(frame);
     }
 
+    // ========== NEGOCIACIÓN DE CODEC ==========
+    // Sin anuncio (viewer viejo) el host sigue en VP8; un host viejo lo ignora
+    void sendCapabilities() {
+        std::vector<vic::encoder::CodecCapability> capabilities;
+        {
+            std::lock_guard lock(capabilitiesMutex_);
+            capabilities = capabilities_;
+        }
+        if (capabilities.empty()) {
+            return;
+        }
+        if (controlChannel_ && controlChannel_->isOpen()) {
+            dataChannelWrapper_.send(buildCapabilitiesPayload(capabilities));
+        }
+    }
+
     void ensureFallbackMonitor();
     void stopFallback();
     void monitorFallback();
@@ -955,6 +1164,8 @@ private:
     std::shared_ptr<rtc::PeerConnection> pc_;
     std::shared_ptr<rtc::Track> videoTrack_;
     std::shared_ptr<rtc::DataChannel> controlChannel_;
+    std::mutex capabilitiesMutex_;
+    std::vector<vic::encoder::CodecCapability> capabilities_;
     DataChannelWrapper dataChannelWrapper_;
     std::function<void(const vic::encoder::EncodedFrame&)> frameHandler_;
     std::function<void(ConnectionState)> stateCallback_;
@@ -1063,6 +1274,12 @@ private:
                     if (fallbackClient_) {
                         success = fallbackClient_->connect(*tunnel, *code);
                     }
+                    if (success) {
+                        std::lock_guard capabilitiesLock(capabilitiesMutex_);
+                        if (!capabilities_.empty()) {
+                            fallbackClient_->sendCapabilities(capabilities_);
+                        }
+                    }
                 }
                 if (!success) {
                     std::this_thread::sleep_for(2s);
@@ -1114,6 +1331,15 @@ bool TransportServer::sendFrame(const vic::encoder::EncodedFrame& frame) {
     return impl_->sendFrame(frame);
 }
 
+size_t TransportServer::bufferedAmount() const {
+    return impl_->bufferedAmount();
+}
+
+bool TransportServer::sendCursorUpdate(const vic::capture::CursorState& state,
+                                       const vic::capture::CursorShape* shape) {
+    return impl_->sendCursorUpdate(state, shape);
+}
+
 bool TransportServer::needsInitialKeyframe() {
     return impl_->needsInitialKeyframe();
 }
@@ -1124,6 +1350,15 @@ void TransportServer::setInputHandlers(
     impl_->setInputHandlers(std::move(mouseHandler), std::move(keyboardHandler));
 }
 
+void TransportServer::setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler) {
+    impl_->setRecoveryHandler(std::move(handler));
+}
+
+void TransportServer::setCapabilitiesHandler(
+    std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler) {
+    impl_->setCapabilitiesHandler(std::move(handler));
+}
+
 void TransportServer::setConnectionInfo(const ConnectionInfo& info) {
     impl_->setConnectionInfo(info);
 }
@@ -1153,10 +1388,20 @@ void TransportClient::setFrameHandler(std::function<void(const vic::encoder::Enc
     impl_->setFrameHandler(std::move(handler));
 }
 
+void TransportClient::setCursorHandlers(
+    std::function<void(const vic::capture::CursorState&)> positionHandler,
+    std::function<void(const vic::capture::CursorShape&)> shapeHandler) {
+    impl_->setCursorHandlers(std::move(positionHandler), std::move(shapeHandler));
+}
+
 void TransportClient::setConnectionStateCallback(std::function<void(ConnectionState)> callback) {
     impl_->setConnectionStateCallback(std::move(callback));
 }
 
+void TransportClient::setLocalCapabilities(std::vector<vic::encoder::CodecCapability> capabilities) {
+    impl_->setLocalCapabilities(std::move(capabilities));
+}
+
 void TransportClient::setConnectionInfo(const ConnectionInfo& info) {
     impl_->setConnectionInfo(info);
 }
@@ -1169,6 +1414,10 @@ bool TransportClient::sendKeyboardEvent(const vic::input::KeyboardEvent& ev) {
     return impl_->sendKeyboardEvent(ev);
 }
 
+bool TransportClient::sendRecoveryRequest(const RecoveryRequest& request) {
+    return impl_->sendRecoveryRequest(request);
+}
+
 void TransportClient::stop() {
     impl_->stop();
 }
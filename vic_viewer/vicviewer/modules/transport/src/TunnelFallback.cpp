@@ -1,12 +1,14 @@
 #include "TunnelFallback.h"
 
 #include "Logger.h"
+#include "VideoFramePacket.h"
 
 #include <Ws2tcpip.h>
 
 #include <array>
 #include <chrono>
 #include <cstring>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
@@ -19,8 +21,11 @@ namespace {
 
 constexpr uint8_t kFrameMessageType = 0x10;
 constexpr size_t kHeaderSize = 5;
-constexpr size_t kFrameMetaSize = sizeof(uint64_t) + sizeof(uint32_t) * 3 + sizeof(uint8_t);
-constexpr size_t kFrameMinimumSize = sizeof(uint64_t) + sizeof(uint32_t) * 2 + sizeof(uint8_t) + sizeof(uint32_t);
+// Mismo formato de frame que el DataChannel (VideoFramePacket)
+constexpr size_t kFrameMetaSize = sizeof(protocol::VideoFrameHeader) +
+    std::numeric_limits<uint8_t>::max() * sizeof(protocol::CopyRectMessage) +
+    std::numeric_limits<uint8_t>::max() * sizeof(protocol::TileMessage);
+constexpr size_t kFrameMinimumSize = sizeof(protocol::VideoFrameHeader);
 constexpr size_t kMaxPayloadSize = 16 * 1024 * 1024; // 16 MB safety cap
 
 bool ensureWinsockInitialized() {
@@ -50,20 +55,6 @@ uint32_t readUint32(const uint8_t* src) {
         (static_cast<uint32_t>(src[3]) << 24);
 }
 
-void writeUint64(uint8_t* dest, uint64_t value) {
-    for (size_t i = 0; i < 8; ++i) {
-        dest[i] = static_cast<uint8_t>((value >> (i * 8)) & 0xFF);
-    }
-}
-
-uint64_t readUint64(const uint8_t* src) {
-    uint64_t value = 0;
-    for (size_t i = 0; i < 8; ++i) {
-        value |= static_cast<uint64_t>(src[i]) << (i * 8);
-    }
-    return value;
-}
-
 bool sendLine(SOCKET socket, const std::string& line) {
     std::string payload = line;
     payload.push_back('\n');
@@ -195,6 +186,14 @@ void Server::setInputHandlers(
     keyboardHandler_ = std::move(keyboardHandler);
 }
 
+void Server::setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler) {
+    recoveryHandler_ = std::move(handler);
+}
+
+void Server::setCapabilitiesHandler(std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler) {
+    capabilitiesHandler_ = std::move(handler);
+}
+
 void Server::setConnectionCallback(std::function<void(bool)> callback) {
     connectionCallback_ = std::move(callback);
 }
@@ -323,6 +322,23 @@ void Server::handleClientMessage(uint8_t type, const std::vector<uint8_t>& paylo
             ev.action = static_cast<vic::input::KeyAction>(msg.action);
             keyboardHandler_(ev);
         }
+    } else if (type == static_cast<uint8_t>(protocol::ControlMessageType::RecoveryRequest)) {
+        if (payload.size() != sizeof(protocol::RecoveryRequestMessage)) {
+            return;
+        }
+        protocol::RecoveryRequestMessage msg{};
+        std::memcpy(&msg, payload.data(), sizeof(protocol::RecoveryRequestMessage));
+        if (recoveryHandler_) {
+            recoveryHandler_(RecoveryRequest{msg.lastFrameId, msg.goldenFrameId, msg.altRefFrameId});
+        }
+    } else if (type == static_cast<uint8_t>(protocol::ControlMessageType::Capabilities)) {
+        std::vector<vic::encoder::CodecCapability> capabilities;
+        if (!protocol::readCapabilitiesPacket(payload.data(), payload.size(), capabilities)) {
+            return;
+        }
+        if (capabilitiesHandler_) {
+            capabilitiesHandler_(capabilities);
+        }
     }
 }
 
@@ -360,28 +376,13 @@ bool Server::writeHeader(SOCKET socket, uint8_t type, uint32_t size) {
 }
 
 bool Server::sendFrameInternal(SOCKET socket, const vic::encoder::EncodedFrame& frame) {
-    const uint32_t payloadSize = static_cast<uint32_t>(frame.payload.size());
-    const uint32_t messageSize = static_cast<uint32_t>(sizeof(uint64_t) + sizeof(uint32_t) * 3 + sizeof(uint8_t) + payloadSize);
-    if (!writeHeader(socket, kFrameMessageType, messageSize)) {
-        return false;
-    }
+    std::vector<uint8_t> message(protocol::videoFramePacketSize(frame));
+    protocol::writeVideoFramePacket(frame, message.data());
 
-    std::array<uint8_t, sizeof(uint64_t) + sizeof(uint32_t) * 3 + sizeof(uint8_t)> meta{};
-    writeUint64(meta.data(), frame.timestamp);
-    writeUint32(meta.data() + 8, frame.width);
-    writeUint32(meta.data() + 12, frame.height);
-    meta[16] = frame.keyFrame ? 1 : 0;
-    writeUint32(meta.data() + 17, payloadSize);
-
-    if (!sendAll(socket, meta.data(), meta.size())) {
+    if (!writeHeader(socket, kFrameMessageType, static_cast<uint32_t>(message.size()))) {
         return false;
     }
-    if (payloadSize > 0) {
-        if (!sendAll(socket, frame.payload.data(), payloadSize)) {
-            return false;
-        }
-    }
-    return true;
+    return sendAll(socket, message.data(), message.size());
 }
 
 Client::Client() = default;
@@ -541,6 +542,48 @@ bool Client::sendKeyboardEvent(const vic::input::KeyboardEvent& ev) {
     return sendAll(socket, &msg, sizeof(protocol::KeyboardMessage));
 }
 
+bool Client::sendRecoveryRequest(const RecoveryRequest& request) {
+    SOCKET socket = INVALID_SOCKET;
+    {
+        std::lock_guard lock(socketMutex_);
+        socket = socket_;
+    }
+    if (socket == INVALID_SOCKET) {
+        return false;
+    }
+
+    protocol::RecoveryRequestMessage msg{};
+    msg.lastFrameId = request.lastFrameId;
+    msg.goldenFrameId = request.goldenFrameId;
+    msg.altRefFrameId = request.altRefFrameId;
+
+    std::lock_guard sendLock(sendMutex_);
+    if (!writeHeader(socket, static_cast<uint8_t>(protocol::ControlMessageType::RecoveryRequest), sizeof(protocol::RecoveryRequestMessage))) {
+        return false;
+    }
+    return sendAll(socket, &msg, sizeof(protocol::RecoveryRequestMessage));
+}
+
+bool Client::sendCapabilities(const std::vector<vic::encoder::CodecCapability>& capabilities) {
+    SOCKET socket = INVALID_SOCKET;
+    {
+        std::lock_guard lock(socketMutex_);
+        socket = socket_;
+    }
+    if (socket == INVALID_SOCKET) {
+        return false;
+    }
+
+    std::vector<uint8_t> message(protocol::capabilitiesPacketSize(capabilities));
+    protocol::writeCapabilitiesPacket(capabilities, message.data());
+
+    std::lock_guard sendLock(sendMutex_);
+    if (!writeHeader(socket, static_cast<uint8_t>(protocol::ControlMessageType::Capabilities), static_cast<uint32_t>(message.size()))) {
+        return false;
+    }
+    return sendAll(socket, message.data(), message.size());
+}
+
 bool Client::isConnected() const {
     return connected_.load();
 }
@@ -600,39 +643,14 @@ void Client::receiveLoop() {
 }
 
 bool Client::handleFramePayload(const std::vector<uint8_t>& payload) {
-    if (payload.size() < kFrameMinimumSize) {
-        return false;
-    }
-
-    size_t offset = 0;
-    uint64_t timestamp = readUint64(payload.data() + offset);
-    offset += sizeof(uint64_t);
-    uint32_t width = readUint32(payload.data() + offset);
-    offset += sizeof(uint32_t);
-    uint32_t height = readUint32(payload.data() + offset);
-    offset += sizeof(uint32_t);
-    bool keyFrame = payload[offset] != 0;
-    offset += sizeof(uint8_t);
-    uint32_t frameSize = readUint32(payload.data() + offset);
-    offset += sizeof(uint32_t);
-
-    if (offset + frameSize > payload.size()) {
+    vic::encoder::EncodedFrame frame{};
+    if (!protocol::readVideoFramePacket(payload.data(), payload.size(), frame)) {
         return false;
     }
-    if (frameSize > kMaxPayloadSize) {
+    if (frame.payload.size() > kMaxPayloadSize) {
         return false;
     }
 
-    vic::encoder::EncodedFrame frame{};
-    frame.timestamp = timestamp;
-    frame.width = width;
-    frame.height = height;
-    frame.keyFrame = keyFrame;
-    frame.payload.resize(frameSize);
-    if (frameSize > 0) {
-        std::memcpy(frame.payload.data(), payload.data() + offset, frameSize);
-    }
-
     if (frameHandler_) {
         frameHandler_(frame);
     }
@@ -31,6 +31,8 @@ public:
     void setInputHandlers(
         std::function<void(const vic::input::MouseEvent&)> mouseHandler,
         std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler);
+    void setRecoveryHandler(std::function<void(const RecoveryRequest&)> handler);
+    void setCapabilitiesHandler(std::function<void(const std::vector<vic::encoder::CodecCapability>&)> handler);
     void setConnectionCallback(std::function<void(bool)> callback);
 
     bool hasClient() const;
@@ -50,6 +52,8 @@ private:
 
     std::function<void(const vic::input::MouseEvent&)> mouseHandler_{};
     std::function<void(const vic::input::KeyboardEvent&)> keyboardHandler_{};
+    std::function<void(const RecoveryRequest&)> recoveryHandler_{};
+    std::function<void(const std::vector<vic::encoder::CodecCapability>&)> capabilitiesHandler_{};
     std::function<void(bool)> connectionCallback_{};
 
     std::atomic_bool running_{false};
@@ -79,6 +83,8 @@ public:
 
     bool sendMouseEvent(const vic::input::MouseEvent& ev);
     bool sendKeyboardEvent(const vic::input::KeyboardEvent& ev);
+    bool sendRecoveryRequest(const RecoveryRequest& request);
+    bool sendCapabilities(const std::vector<vic::encoder::CodecCapability>& capabilities);
 
     bool isConnected() const;
 
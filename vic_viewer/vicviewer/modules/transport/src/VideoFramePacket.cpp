@@ -0,0 +1,183 @@
+#include "VideoFramePacket.h"
+
+#include "TransportProtocol.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace vic::transport::protocol {
+
+namespace {
+
+// Los contadores del header son de 8 bits y las coordenadas de 16
+constexpr size_t kMaxCopyRects = std::numeric_limits<uint8_t>::max();
+constexpr size_t kMaxTiles = std::numeric_limits<uint8_t>::max();
+constexpr size_t kMaxCapabilities = std::numeric_limits<uint8_t>::max();
+
+size_t copyRectCount(const vic::encoder::EncodedFrame& frame) {
+    return std::min(frame.copyRects.size(), kMaxCopyRects);
+}
+
+size_t tileCount(const vic::encoder::EncodedFrame& frame) {
+    return std::min(frame.tiles.size(), kMaxTiles);
+}
+
+} // namespace
+
+size_t videoFramePacketSize(const vic::encoder::EncodedFrame& frame) {
+    return sizeof(VideoFrameHeader) + copyRectCount(frame) * sizeof(CopyRectMessage) +
+        tileCount(frame) * sizeof(TileMessage) + frame.payload.size();
+}
+
+void writeVideoFramePacket(const vic::encoder::EncodedFrame& frame, uint8_t* dest) {
+    const size_t rectCount = copyRectCount(frame);
+    const size_t tiles = tileCount(frame);
+
+    VideoFrameHeader header{};
+    header.width = frame.width;
+    header.height = frame.height;
+    header.timestamp = frame.timestamp;
+    header.payloadSize = static_cast<uint32_t>(frame.payload.size());
+    header.keyFrame = frame.keyFrame ? 1 : 0;
+    // Resolución original para cálculo correcto de coordenadas de mouse
+    header.originalWidth = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
+    header.originalHeight = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
+    header.copyRectCount = static_cast<uint8_t>(rectCount);
+    header.frameId = frame.frameId;
+    header.referenceFrameId = frame.referenceFrameId;
+    header.referenceFlags = frame.referenceFlags;
+    header.codec = static_cast<uint8_t>(frame.codec);
+    header.temporalLayer = frame.temporalLayer;
+    header.tileCount = static_cast<uint8_t>(tiles);
+    std::memcpy(dest, &header, sizeof(header));
+    dest += sizeof(header);
+
+    for (size_t i = 0; i < rectCount; ++i) {
+        const auto& rect = frame.copyRects[i];
+        CopyRectMessage msg{};
+        msg.srcX = static_cast<uint16_t>(rect.srcX);
+        msg.srcY = static_cast<uint16_t>(rect.srcY);
+        msg.dstX = static_cast<uint16_t>(rect.dstX);
+        msg.dstY = static_cast<uint16_t>(rect.dstY);
+        msg.width = static_cast<uint16_t>(rect.width);
+        msg.height = static_cast<uint16_t>(rect.height);
+        std::memcpy(dest, &msg, sizeof(msg));
+        dest += sizeof(msg);
+    }
+
+    for (size_t i = 0; i < tiles; ++i) {
+        const auto& tile = frame.tiles[i];
+        TileMessage msg{};
+        msg.x = static_cast<uint16_t>(tile.x);
+        msg.y = static_cast<uint16_t>(tile.y);
+        msg.width = static_cast<uint16_t>(tile.width);
+        msg.height = static_cast<uint16_t>(tile.height);
+        msg.payloadSize = tile.payloadSize;
+        msg.keyFrame = tile.keyFrame ? 1 : 0;
+        msg.frameId = tile.frameId;
+        msg.referenceFrameId = tile.referenceFrameId;
+        msg.referenceFlags = tile.referenceFlags;
+        std::memcpy(dest, &msg, sizeof(msg));
+        dest += sizeof(msg);
+    }
+
+    if (!frame.payload.empty()) {
+        std::memcpy(dest, frame.payload.data(), frame.payload.size());
+    }
+}
+
+bool readVideoFramePacket(const uint8_t* data, size_t size, vic::encoder::EncodedFrame& frame) {
+    if (size < sizeof(VideoFrameHeader)) {
+        return false;
+    }
+    VideoFrameHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+
+    const size_t rectBytes = static_cast<size_t>(header.copyRectCount) * sizeof(CopyRectMessage);
+    const size_t tileBytes = static_cast<size_t>(header.tileCount) * sizeof(TileMessage);
+    if (size != sizeof(VideoFrameHeader) + rectBytes + tileBytes + header.payloadSize) {
+        return false;
+    }
+
+    frame.width = header.width;
+    frame.height = header.height;
+    frame.originalWidth = header.originalWidth > 0 ? header.originalWidth : header.width;
+    frame.originalHeight = header.originalHeight > 0 ? header.originalHeight : header.height;
+    frame.timestamp = header.timestamp;
+    frame.keyFrame = header.keyFrame != 0;
+    frame.frameId = header.frameId;
+    frame.referenceFrameId = header.referenceFrameId;
+    frame.referenceFlags = header.referenceFlags;
+    frame.codec = static_cast<vic::encoder::VideoCodec>(header.codec);
+    frame.temporalLayer = header.temporalLayer;
+
+    frame.copyRects.resize(header.copyRectCount);
+    for (auto& rect : frame.copyRects) {
+        CopyRectMessage msg{};
+        std::memcpy(&msg, data, sizeof(msg));
+        data += sizeof(msg);
+        rect = {msg.srcX, msg.srcY, msg.dstX, msg.dstY, msg.width, msg.height};
+    }
+
+    // Los tiles se reparten el payload en orden: tienen que sumar exacto
+    size_t tilePayload = 0;
+    frame.tiles.resize(header.tileCount);
+    for (auto& tile : frame.tiles) {
+        TileMessage msg{};
+        std::memcpy(&msg, data, sizeof(msg));
+        data += sizeof(msg);
+        tile = {msg.x, msg.y, msg.width, msg.height, msg.payloadSize, msg.keyFrame != 0,
+            msg.frameId, msg.referenceFrameId, msg.referenceFlags};
+        tilePayload += msg.payloadSize;
+    }
+    if (!frame.tiles.empty() && tilePayload != header.payloadSize) {
+        return false;
+    }
+
+    frame.payload.assign(data, data + header.payloadSize);
+    return true;
+}
+
+size_t capabilitiesPacketSize(std::span<const vic::encoder::CodecCapability> capabilities) {
+    return sizeof(CapabilitiesHeader) + std::min(capabilities.size(), kMaxCapabilities) * sizeof(CodecCapabilityMessage);
+}
+
+void writeCapabilitiesPacket(std::span<const vic::encoder::CodecCapability> capabilities, uint8_t* dest) {
+    const size_t count = std::min(capabilities.size(), kMaxCapabilities);
+    CapabilitiesHeader header{};
+    header.codecCount = static_cast<uint8_t>(count);
+    std::memcpy(dest, &header, sizeof(header));
+    dest += sizeof(header);
+    for (size_t i = 0; i < count; ++i) {
+        CodecCapabilityMessage msg{};
+        msg.codec = static_cast<uint8_t>(capabilities[i].codec);
+        msg.profileMask = capabilities[i].profileMask;
+        std::memcpy(dest, &msg, sizeof(msg));
+        dest += sizeof(msg);
+    }
+}
+
+bool readCapabilitiesPacket(const uint8_t* data, size_t size, std::vector<vic::encoder::CodecCapability>& capabilities) {
+    if (size < sizeof(CapabilitiesHeader)) {
+        return false;
+    }
+    CapabilitiesHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    if (size != sizeof(CapabilitiesHeader) + static_cast<size_t>(header.codecCount) * sizeof(CodecCapabilityMessage)) {
+        return false;
+    }
+    capabilities.resize(header.codecCount);
+    for (auto& capability : capabilities) {
+        CodecCapabilityMessage msg{};
+        std::memcpy(&msg, data, sizeof(msg));
+        data += sizeof(msg);
+        capability.codec = static_cast<vic::encoder::VideoCodec>(msg.codec);
+        capability.profileMask = msg.profileMask;
+    }
+    return true;
+}
+
+} // namespace vic::transport::protocol
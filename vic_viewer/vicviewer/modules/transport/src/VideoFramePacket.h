@@ -0,0 +1,28 @@
+#pragma once
+
+#include "EncodedFrame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vic::transport::protocol {
+
+/// Serialización de un frame de video compartida por el DataChannel y el túnel
+/// de fallback: [VideoFrameHeader][CopyRectMessage x copyRectCount]
+/// [TileMessage x tileCount][payload]
+size_t videoFramePacketSize(const vic::encoder::EncodedFrame& frame);
+
+/// Escribir el paquete en `dest` (debe tener videoFramePacketSize(frame) bytes)
+void writeVideoFramePacket(const vic::encoder::EncodedFrame& frame, uint8_t* dest);
+
+/// Leer un paquete completo; false si el tamaño no cuadra con el header
+bool readVideoFramePacket(const uint8_t* data, size_t size, vic::encoder::EncodedFrame& frame);
+
+/// Anuncio de capacidades del viewer: [CapabilitiesHeader][CodecCapabilityMessage x codecCount]
+size_t capabilitiesPacketSize(std::span<const vic::encoder::CodecCapability> capabilities);
+void writeCapabilitiesPacket(std::span<const vic::encoder::CodecCapability> capabilities, uint8_t* dest);
+bool readCapabilitiesPacket(const uint8_t* data, size_t size, std::vector<vic::encoder::CodecCapability>& capabilities);
+
+} // namespace vic::transport::protocol
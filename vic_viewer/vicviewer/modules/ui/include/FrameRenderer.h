@@ -2,7 +2,12 @@
 
 #include "DesktopFrame.h"
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+// Sin ventanas nativas (Linux CI, headless): solo existe el renderer offscreen
+using HWND = void*;
+#endif
 #include <cstdint>
 #include <memory>
 
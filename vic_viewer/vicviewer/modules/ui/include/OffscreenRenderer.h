@@ -0,0 +1,51 @@
+#pragma once
+
+#include "FrameRenderer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace vic::ui {
+
+/// Filtro de escalado del renderer offscreen (libyuv, SIMD)
+enum class ScaleFilter {
+    Bilinear,   // Igual que el sampler de D3D11: suave al ampliar
+    Area,       // Promedio por área (box): sin aliasing al reducir
+};
+
+struct OffscreenRendererConfig {
+    ScaleFilter filter = ScaleFilter::Bilinear;
+    bool computeChecksum = false;   // Hash de la superficie en cada Present()
+    std::string dumpDirectory;      // Vacío = sin dump; si no, BMPs frame_NNNNNN.bmp
+    uint32_t dumpEvery = 1;         // Guardar uno de cada N frames presentados
+};
+
+/// Tiempos de RenderFrame() (escalado a la superficie), en microsegundos
+struct OffscreenRenderStats {
+    uint64_t framesRendered = 0;
+    double lastRenderUs = 0;
+    double avgRenderUs = 0;
+    double maxRenderUs = 0;
+};
+
+/// Renderer sin ventana: escala cada frame al tamaño de Resize() sobre una
+/// superficie BGRA en memoria. Portable (sin Windows ni GPU), para load tests,
+/// CI en Linux y como referencia del costo de render.
+/// Initialize() acepta nullptr; hasta el primer Resize() la superficie toma
+/// el tamaño del frame (sin escalar)
+class OffscreenRenderer : public FrameRenderer {
+public:
+    /// Contenido presentado (BGRA, width * 4 bytes por fila)
+    virtual const vic::capture::DesktopFrame& surface() const = 0;
+
+    /// Hash FNV-1a de la superficie del último Present() (0 si computeChecksum = false)
+    virtual uint64_t lastChecksum() const = 0;
+
+    virtual OffscreenRenderStats stats() const = 0;
+};
+
+/// Crear renderer offscreen (siempre disponible)
+std::unique_ptr<OffscreenRenderer> CreateOffscreenRenderer(const OffscreenRendererConfig& config = {});
+
+} // namespace vic::ui
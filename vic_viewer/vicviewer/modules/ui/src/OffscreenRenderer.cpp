@@ -0,0 +1,195 @@
+#include "OffscreenRenderer.h"
+#include "Logger.h"
+
+#include <libyuv.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace vic::ui {
+
+namespace {
+
+constexpr uint64_t kHashSeed = 1469598103934665603ull;
+constexpr uint64_t kHashPrime = 1099511628211ull;
+
+// FNV-1a sobre palabras de 64 bits; la cola (0 o 4 bytes) se mezcla byte a byte
+uint64_t hashSurface(const std::vector<uint8_t>& bgra) {
+    uint64_t hash = kHashSeed;
+    const size_t words = bgra.size() / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bgra.data() + i * sizeof(uint64_t), sizeof(word));
+        hash = (hash ^ word) * kHashPrime;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < bgra.size(); ++i) {
+        hash = (hash ^ bgra[i]) * kHashPrime;
+    }
+    return hash;
+}
+
+void putLe(std::vector<uint8_t>& out, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+// BMP de 32 bits top-down: mismo layout BGRA que la superficie, sin conversión
+bool writeBmp(const std::filesystem::path& path, const vic::capture::DesktopFrame& frame) {
+    constexpr uint32_t kHeaderSize = 14 + 40;
+    const uint32_t pixelBytes = static_cast<uint32_t>(frame.bgraData.size());
+    std::vector<uint8_t> header;
+    header.reserve(kHeaderSize);
+    header.push_back('B');
+    header.push_back('M');
+    putLe(header, kHeaderSize + pixelBytes, 4);
+    putLe(header, 0, 4);
+    putLe(header, kHeaderSize, 4);
+    putLe(header, 40, 4);                                   // BITMAPINFOHEADER
+    putLe(header, frame.width, 4);
+    putLe(header, static_cast<uint32_t>(-static_cast<int32_t>(frame.height)), 4);  // Top-down
+    putLe(header, 1, 2);                                    // Planes
+    putLe(header, 32, 2);                                   // Bits por pixel
+    putLe(header, 0, 4);                                    // BI_RGB
+    putLe(header, pixelBytes, 4);
+    putLe(header, 2835, 4);                                 // 72 dpi
+    putLe(header, 2835, 4);
+    putLe(header, 0, 4);
+    putLe(header, 0, 4);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(frame.bgraData.data()), static_cast<std::streamsize>(pixelBytes));
+    return static_cast<bool>(file);
+}
+
+/// Offscreen renderer - escalado por software (libyuv) a memoria
+class SoftwareOffscreenRenderer final : public OffscreenRenderer {
+public:
+    explicit SoftwareOffscreenRenderer(OffscreenRendererConfig config)
+        : config_(std::move(config)) {
+        config_.dumpEvery = std::max(config_.dumpEvery, 1u);
+    }
+    ~SoftwareOffscreenRenderer() override { Shutdown(); }
+
+    bool Initialize(HWND) override {
+        if (!config_.dumpDirectory.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(config_.dumpDirectory, ec);
+            if (ec) {
+                logging::global().log(logging::Logger::Level::Warning,
+                    "OffscreenRenderer: No se pudo crear " + config_.dumpDirectory + " (dump desactivado)");
+                config_.dumpDirectory.clear();
+            }
+        }
+        initialized_ = true;
+        logging::global().log(logging::Logger::Level::Info,
+            std::string("OffscreenRenderer: Initialized (") +
+            (config_.filter == ScaleFilter::Area ? "area" : "bilinear") + ")");
+        return true;
+    }
+
+    void Resize(uint32_t width, uint32_t height) override {
+        targetWidth_ = width;
+        targetHeight_ = height;
+    }
+
+    void RenderFrame(const vic::capture::DesktopFrame& frame) override {
+        const size_t srcBytes = static_cast<size_t>(frame.width) * frame.height * 4;
+        if (!initialized_ || frame.width == 0 || frame.height == 0 || frame.bgraData.size() < srcBytes) {
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const uint32_t width = targetWidth_ > 0 ? targetWidth_ : frame.width;
+        const uint32_t height = targetHeight_ > 0 ? targetHeight_ : frame.height;
+        surface_.width = width;
+        surface_.height = height;
+        surface_.originalWidth = frame.originalWidth;
+        surface_.originalHeight = frame.originalHeight;
+        surface_.timestamp = frame.timestamp;
+        surface_.bgraData.resize(static_cast<size_t>(width) * height * 4);
+
+        if (width == frame.width && height == frame.height) {
+            std::memcpy(surface_.bgraData.data(), frame.bgraData.data(), srcBytes);
+        } else {
+            // libyuv: ARGB significa BGRA en memoria (little-endian)
+            libyuv::ARGBScale(
+                frame.bgraData.data(), static_cast<int>(frame.width * 4),
+                static_cast<int>(frame.width), static_cast<int>(frame.height),
+                surface_.bgraData.data(), static_cast<int>(width * 4),
+                static_cast<int>(width), static_cast<int>(height),
+                config_.filter == ScaleFilter::Area ? libyuv::kFilterBox : libyuv::kFilterBilinear);
+        }
+
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ++stats_.framesRendered;
+        stats_.lastRenderUs = us;
+        stats_.maxRenderUs = std::max(stats_.maxRenderUs, us);
+        totalRenderUs_ += us;
+        stats_.avgRenderUs = totalRenderUs_ / static_cast<double>(stats_.framesRendered);
+        pending_ = true;
+    }
+
+    void Present() override {
+        if (!pending_) {
+            return;
+        }
+        pending_ = false;
+        ++presented_;
+        if (config_.computeChecksum) {
+            checksum_ = hashSurface(surface_.bgraData);
+        }
+        if (!config_.dumpDirectory.empty() && (presented_ - 1) % config_.dumpEvery == 0) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%06llu.bmp", static_cast<unsigned long long>(presented_));
+            const auto path = std::filesystem::path(config_.dumpDirectory) / name;
+            if (!writeBmp(path, surface_)) {
+                logging::global().log(logging::Logger::Level::Warning,
+                    "OffscreenRenderer: Error escribiendo " + path.string() + " (dump desactivado)");
+                config_.dumpDirectory.clear();
+            }
+        }
+    }
+
+    void Shutdown() override {
+        initialized_ = false;
+    }
+
+    const char* GetName() const override { return "Offscreen"; }
+    bool IsValid() const override { return initialized_; }
+
+    const vic::capture::DesktopFrame& surface() const override { return surface_; }
+    uint64_t lastChecksum() const override { return checksum_; }
+    OffscreenRenderStats stats() const override { return stats_; }
+
+private:
+    OffscreenRendererConfig config_;
+    bool initialized_ = false;
+    uint32_t targetWidth_ = 0;
+    uint32_t targetHeight_ = 0;
+
+    vic::capture::DesktopFrame surface_{};
+    bool pending_ = false;          // RenderFrame() sin Present() todavía
+    uint64_t presented_ = 0;
+    uint64_t checksum_ = 0;
+
+    OffscreenRenderStats stats_{};
+    double totalRenderUs_ = 0;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<OffscreenRenderer> CreateOffscreenRenderer(const OffscreenRendererConfig& config) {
+    return std::make_unique<SoftwareOffscreenRenderer>(config);
+}
+
+} // namespace vic::ui
@@ -4,6 +4,7 @@
 #include "Logger.h"
 #include "MatchmakerClient.h"
 #include "StreamConfig.h"
+#include "TripleBuffer.h"
 #include "ViewerSession.h"
 #include "vic/ui/AntiAbuse.h"
 
@@ -24,7 +25,9 @@
 #pragma comment(lib, "Ws2_32.lib")
 #pragma comment(lib, "Iphlpapi.lib")
 
+#include <atomic>
 #include <cctype>
+#include <cstring>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -33,6 +36,7 @@
 #include <optional>
 #include <algorithm>
 #include <fstream>
+#include <vector>
 
 #pragma comment(lib, "Comctl32.lib")
 #pragma comment(lib, "Dwmapi.lib")
@@ -56,6 +60,7 @@ constexpr COLORREF COLOR_TAB_INACTIVE = RGB(30, 41, 59); // Azul oscuro (slate-8
 constexpr UINT WM_TRAYICON = WM_APP + 1;
 constexpr UINT WM_VIEWER_CONNECTED = WM_APP + 3;
 constexpr UINT WM_VIEWER_TIMEOUT = WM_APP + 4;
+constexpr UINT WM_VIEWER_CURSOR = WM_APP + 5;
 
 // Timer IDs
 constexpr UINT_PTR TIMER_VIEWER_CONNECT_TIMEOUT = 5001;
@@ -131,7 +136,7 @@ struct MainWindowState {
     HWND viewerCodeEdit = nullptr;
     HWND viewerButton = nullptr;
     HWND viewerCanvas = nullptr;
-    bool viewerConnected = false;
+    std::atomic<bool> viewerConnected{false};  // Lo marca el hilo de decode con el primer frame
     
     // Viewer FREE mode (quien paga es el viewer)
     bool viewerFreeMode = false;
@@ -166,8 +171,15 @@ struct MainWindowState {
     // Heartbeat
     UINT_PTR heartbeatTimer = 0;
 
-    std::optional<vic::capture::DesktopFrame> lastFrame;
-    std::mutex frameMutex;
+    // Frames del viewer: el hilo de decode escribe y publica sin locks, la UI
+    // toma el más nuevo al pintar. lastFrame = el último tomado (solo hilo de UI)
+    vic::TripleBuffer<vic::capture::DesktopFrame> frames;
+    const vic::capture::DesktopFrame* lastFrame = nullptr;
+
+    // Cursor remoto (compuesto localmente sobre el frame)
+    HICON remoteCursorIcon = nullptr;
+    uint64_t remoteCursorIconHash = 0;
+    RECT remoteCursorRect{};  // Última posición pintada (solo hilo de UI)
 };
 
 // Utility functions
@@ -1356,6 +1368,113 @@ bool isIPAddress(const std::string& input) {
     return (octets == 4 && dots == 3);
 }
 
+// =========== CURSOR REMOTO ===========
+// Rectángulo del cursor remoto en coordenadas del canvas
+bool remoteCursorCanvasRect(const vic::capture::DesktopFrame& frame, const vic::pipeline::RemoteCursor& cursor,
+                            const RECT& client, RECT& out) {
+    if (!cursor.state.visible || !cursor.shape || client.right <= 0 || client.bottom <= 0) {
+        return false;
+    }
+    // El host envía la posición en coordenadas de la pantalla original
+    const uint32_t targetW = frame.originalWidth > 0 ? frame.originalWidth : frame.width;
+    const uint32_t targetH = frame.originalHeight > 0 ? frame.originalHeight : frame.height;
+    if (targetW == 0 || targetH == 0) {
+        return false;
+    }
+    const float sx = static_cast<float>(client.right) / targetW;
+    const float sy = static_cast<float>(client.bottom) / targetH;
+    out.left = static_cast<LONG>((cursor.state.x - static_cast<int32_t>(cursor.shape->hotspotX)) * sx);
+    out.top = static_cast<LONG>((cursor.state.y - static_cast<int32_t>(cursor.shape->hotspotY)) * sy);
+    out.right = out.left + (std::max)(1L, static_cast<LONG>(cursor.shape->width * sx));
+    out.bottom = out.top + (std::max)(1L, static_cast<LONG>(cursor.shape->height * sy));
+    return true;
+}
+
+// Icono GDI para la forma actual; se recrea solo cuando cambia el hash
+HICON ensureRemoteCursorIcon(MainWindowState* state, const vic::capture::CursorShape& shape) {
+    if (state->remoteCursorIcon && state->remoteCursorIconHash == shape.hash) {
+        return state->remoteCursorIcon;
+    }
+    if (state->remoteCursorIcon) {
+        DestroyIcon(state->remoteCursorIcon);
+        state->remoteCursorIcon = nullptr;
+    }
+
+    BITMAPINFO bmi{};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = static_cast<LONG>(shape.width);
+    bmi.bmiHeader.biHeight = -static_cast<LONG>(shape.height);
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HBITMAP color = CreateDIBSection(nullptr, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!color || !bits) {
+        return nullptr;
+    }
+    std::memcpy(bits, shape.bgraData.data(), shape.bgraData.size());
+
+    // Con color de 32 bits y alpha, la máscara no se usa: basta con ceros
+    std::vector<uint8_t> maskBits(static_cast<size_t>((shape.width + 15) / 16) * 2 * shape.height, 0);
+    HBITMAP mask = CreateBitmap(static_cast<int>(shape.width), static_cast<int>(shape.height), 1, 1, maskBits.data());
+
+    ICONINFO ii{};
+    ii.fIcon = FALSE;
+    ii.xHotspot = shape.hotspotX;
+    ii.yHotspot = shape.hotspotY;
+    ii.hbmMask = mask;
+    ii.hbmColor = color;
+    state->remoteCursorIcon = CreateIconIndirect(&ii);
+    state->remoteCursorIconHash = state->remoteCursorIcon ? shape.hash : 0;
+
+    DeleteObject(mask);
+    DeleteObject(color);
+    return state->remoteCursorIcon;
+}
+
+// =========== FRAMES DEL VIEWER ===========
+// El decoder convierte directo al buffer de escritura del TripleBuffer y
+// commit() lo publica con un exchange atómico: el WM_PAINT nunca espera al
+// decoder ni al revés, y los tres buffers se reciclan sin copias por frame
+class ViewerFrameSink final : public vic::decoder::FrameSink {
+public:
+    explicit ViewerFrameSink(MainWindowState* state) : state_(state) {}
+
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        auto& frame = state_->frames.writeBuffer();
+        frame.bgraData.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {frame.bgraData.data(), static_cast<size_t>(info.width) * 4};
+    }
+
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        vic::logging::global().log(vic::logging::Logger::Level::Info, 
+            "[UI] FRAME RECIBIDO: " + std::to_string(info.width) + "x" + std::to_string(info.height));
+
+        auto& frame = state_->frames.writeBuffer();
+        frame.width = info.width;
+        frame.height = info.height;
+        frame.originalWidth = info.originalWidth;
+        frame.originalHeight = info.originalHeight;
+        frame.timestamp = info.timestamp;
+        state_->frames.publish();
+        
+        if (!state_->viewerConnected.exchange(true)) {
+            // Cancelar timer de timeout - conexión exitosa
+            KillTimer(state_->mainWindow, TIMER_VIEWER_CONNECT_TIMEOUT);
+            vic::logging::global().log(vic::logging::Logger::Level::Info, "[UI] Primer frame! Cancelando timeout y enviando WM_VIEWER_CONNECTED");
+            PostMessage(state_->mainWindow, WM_VIEWER_CONNECTED, 0, 0);
+        }
+        
+        if (state_->viewerCanvas) {
+            InvalidateRect(state_->viewerCanvas, nullptr, FALSE);
+        }
+    }
+
+private:
+    MainWindowState* state_;
+};
+
 // Viewer functions
 void connectViewer(MainWindowState* state) {
     if (!state) return;
@@ -1412,24 +1531,13 @@ void connectViewer(MainWindowState* state) {
         vic::logging::global().log(vic::logging::Logger::Level::Info, "[UI] connectViewer: codigo resuelto OK");
     }
 
-    // Configurar callback de frames (igual para ambos modos)
-    state->viewerSession->setFrameCallback([state](const vic::capture::DesktopFrame& frame) {
-        vic::logging::global().log(vic::logging::Logger::Level::Info, 
-            "[UI] FRAME RECIBIDO: " + std::to_string(frame.width) + "x" + std::to_string(frame.height));
-        
-        std::lock_guard lock(state->frameMutex);
-        state->lastFrame = frame;
-        
-        if (!state->viewerConnected) {
-            state->viewerConnected = true;
-            // Cancelar timer de timeout - conexión exitosa
-            KillTimer(state->mainWindow, TIMER_VIEWER_CONNECT_TIMEOUT);
-            vic::logging::global().log(vic::logging::Logger::Level::Info, "[UI] Primer frame! Cancelando timeout y enviando WM_VIEWER_CONNECTED");
-            PostMessage(state->mainWindow, WM_VIEWER_CONNECTED, 0, 0);
-        }
-        
+    // Destino de los frames (igual para ambos modos): el decoder escribe en el buffer de la UI
+    state->viewerSession->setFrameSink(std::make_shared<ViewerFrameSink>(state));
+
+    // Cursor remoto: la invalidación usa el frame de la UI, así que se hace en su hilo
+    state->viewerSession->setCursorCallback([state](const vic::pipeline::RemoteCursor&) {
         if (state->viewerCanvas) {
-            InvalidateRect(state->viewerCanvas, nullptr, FALSE);
+            PostMessage(state->viewerCanvas, WM_VIEWER_CURSOR, 0, 0);
         }
     });
 
@@ -1704,7 +1812,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -1769,7 +1876,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -1796,7 +1902,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -1823,7 +1928,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -1850,7 +1954,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -1877,7 +1980,6 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             RECT rect;
             GetClientRect(hwnd, &rect);
             
-            std::lock_guard lock(state->frameMutex);
             if (state->lastFrame) {
                 float fx = static_cast<float>(pt.x) / rect.right;
                 float fy = static_cast<float>(pt.y) / rect.bottom;
@@ -2284,6 +2386,10 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 DeleteObject(state->bannerBitmap);
                 state->bannerBitmap = nullptr;
             }
+            if (state->remoteCursorIcon) {
+                DestroyIcon(state->remoteCursorIcon);
+                state->remoteCursorIcon = nullptr;
+            }
         }
         cleanupGdiResources();
         PostQuitMessage(0);
@@ -2309,7 +2415,10 @@ LRESULT CALLBACK ViewerCanvasProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPa
         RECT rect;
         GetClientRect(hwnd, &rect);
         
-        std::lock_guard lock(state->frameMutex);
+        // El frame más nuevo que publicó el decoder (si no hubo uno nuevo, el anterior)
+        if (state->frames.acquireLatest()) {
+            state->lastFrame = &state->frames.readBuffer();
+        }
         if (state->lastFrame) {
             BITMAPINFO bmi{};
             bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
@@ -2322,12 +2431,41 @@ LRESULT CALLBACK ViewerCanvasProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPa
             StretchDIBits(hdc, 0, 0, rect.right, rect.bottom,
                 0, 0, state->lastFrame->width, state->lastFrame->height,
                 state->lastFrame->bgraData.data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+
+            // Componer cursor remoto encima del frame
+            const auto cursor = state->viewerSession->remoteCursor();
+            RECT cursorRect{};
+            if (remoteCursorCanvasRect(*state->lastFrame, cursor, rect, cursorRect)) {
+                if (HICON icon = ensureRemoteCursorIcon(state, *cursor.shape)) {
+                    DrawIconEx(hdc, cursorRect.left, cursorRect.top, icon,
+                        cursorRect.right - cursorRect.left, cursorRect.bottom - cursorRect.top,
+                        0, nullptr, DI_NORMAL);
+                }
+            }
         } else {
             FillRect(hdc, &rect, static_cast<HBRUSH>(GetStockObject(BLACK_BRUSH)));
         }
         EndPaint(hwnd, &ps);
         break;
     }
+    case WM_VIEWER_CURSOR: {
+        // Cursor remoto: solo repintar la zona vieja y la nueva del cursor
+        RECT client;
+        GetClientRect(hwnd, &client);
+        if (!IsRectEmpty(&state->remoteCursorRect)) {
+            InvalidateRect(hwnd, &state->remoteCursorRect, FALSE);
+        }
+        const auto cursor = state->viewerSession->remoteCursor();
+        RECT cursorRect{};
+        if (state->lastFrame && remoteCursorCanvasRect(*state->lastFrame, cursor, client, cursorRect)) {
+            InflateRect(&cursorRect, 1, 1);
+            InvalidateRect(hwnd, &cursorRect, FALSE);
+            state->remoteCursorRect = cursorRect;
+        } else {
+            SetRectEmpty(&state->remoteCursorRect);
+        }
+        break;
+    }
     case WM_MOUSEMOVE:
     case WM_LBUTTONDOWN:
     case WM_LBUTTONUP:
@@ -2346,7 +2484,6 @@ LRESULT CALLBACK ViewerCanvasProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPa
         RECT rect;
         GetClientRect(hwnd, &rect);
         
-        std::lock_guard lock(state->frameMutex);
         if (!state->lastFrame) {
             if (msg == WM_LBUTTONDOWN) {
                 vic::logging::global().log(vic::logging::Logger::Level::Warning, "[UI] Click ignorado: sin frame");
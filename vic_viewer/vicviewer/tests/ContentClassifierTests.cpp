@@ -0,0 +1,202 @@
+// Clasificador de contenido: frames sintéticos de texto, video y pantalla
+// quieta, y la histéresis de 200/500/1000 ms antes de cambiar de perfil
+#include "ContentClassifier.h"
+#include "TestPatterns.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::capture::ContentClassifier;
+using vic::capture::ContentType;
+using vic::capture::contentTypeName;
+using vic::tests::fail;
+using vic::tests::drawGlyph;
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr uint64_t kFrameMs = 20;
+
+/// Documento de texto en el que se escribe un carácter por frame, o video:
+/// un degradé suave que cambia entero en cada frame
+class SyntheticScreen {
+public:
+    SyntheticScreen() {
+        frame_.width = kWidth;
+        frame_.height = kHeight;
+        frame_.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+    }
+
+    const vic::capture::DesktopFrame& typing(uint64_t timestampMs) {
+        if (!document_) {
+            frame_.bgraData.assign(frame_.bgraData.size(), 255);
+            for (uint32_t y = 40; y + 12 < kHeight; y += 18) {
+                for (uint32_t x = 40; x + 8 < kWidth; x += 8) {
+                    drawGlyph(frame_.bgraData, kWidth, x, y, x * 31 + y * 17);
+                }
+            }
+            document_ = true;
+        }
+        drawGlyph(frame_.bgraData, kWidth, 40 + (index_ % 120) * 8, 400, index_ * 7919u + 1);
+        ++index_;
+        frame_.timestamp = timestampMs;
+        return frame_;
+    }
+
+    const vic::capture::DesktopFrame& video(uint64_t timestampMs) {
+        document_ = false;
+        ++index_;
+        for (uint32_t y = 0; y < kHeight; ++y) {
+            uint8_t* px = frame_.bgraData.data() + static_cast<size_t>(y) * kWidth * 4;
+            for (uint32_t x = 0; x < kWidth; ++x, px += 4) {
+                const uint8_t value = static_cast<uint8_t>((x / 4 + y / 3 + index_ * 5) & 0xFF);
+                px[0] = px[1] = px[2] = value;
+            }
+        }
+        frame_.timestamp = timestampMs;
+        return frame_;
+    }
+
+private:
+    vic::capture::DesktopFrame frame_{};
+    bool document_ = false;
+    uint32_t index_ = 0;
+};
+
+bool expect(ContentType got, ContentType expected, uint64_t timestampMs, const char* what) {
+    if (got != expected) {
+        return fail(std::string(what) + " a los " + std::to_string(timestampMs) + " ms: se esperaba " +
+                    contentTypeName(expected) + " y quedó " + contentTypeName(got));
+    }
+    return true;
+}
+
+/// Cada frame clasificado por sí solo, sin esperar la histéresis
+bool measuresSyntheticFrames() {
+    ContentClassifier classifier;
+    SyntheticScreen screen;
+    classifier.classify(screen.typing(0));
+    classifier.classify(screen.typing(kFrameMs));
+    const auto text = classifier.lastStats();
+    if (text.dirtyFraction <= 0.0 || text.dirtyFraction >= 0.03) {
+        return fail("Escribir un carácter debería ensuciar uno o dos tiles: " + std::to_string(text.dirtyFraction));
+    }
+
+    classifier.classify(screen.video(2 * kFrameMs));
+    classifier.classify(screen.video(3 * kFrameMs));
+    const auto video = classifier.lastStats();
+    if (video.dirtyFraction < 0.99 || video.temporalNoise < 0.6 || video.edgeDensity > 0.12) {
+        return fail("El degradé en movimiento no parece video: sucio " + std::to_string(video.dirtyFraction) +
+                    ", ruido " + std::to_string(video.temporalNoise) + ", bordes " +
+                    std::to_string(video.edgeDensity));
+    }
+
+    // Una página de texto nueva cambia casi todo, pero con bordes duros
+    classifier.classify(screen.typing(4 * kFrameMs));
+    const auto page = classifier.lastStats();
+    if (page.dirtyFraction < 0.5 || page.edgeDensity <= 0.12) {
+        return fail("La página de texto no tiene los bordes de texto: " + std::to_string(page.edgeDensity));
+    }
+
+    classifier.classify(screen.video(5 * kFrameMs));
+    classifier.classify(screen.video(5 * kFrameMs + kFrameMs));
+    classifier.classifyUnchanged(7 * kFrameMs);
+    if (classifier.lastStats().dirtyFraction != 0.0) {
+        return fail("Un frame sin cambios tiene tiles sucios");
+    }
+    return true;
+}
+
+/// Un perfil nuevo solo se adopta si se sostiene: video 500 ms, texto
+/// 200 ms, estático 1000 ms. Una interrupción reinicia la espera
+bool appliesHysteresis() {
+    ContentClassifier classifier;
+    SyntheticScreen screen;
+    uint64_t now = 0;
+    if (!expect(classifier.classify(screen.typing(now)), ContentType::Text, now, "Primer frame")) {
+        return false;
+    }
+
+    // Un par de frames de video en medio del texto no cambian nada
+    now += kFrameMs;
+    classifier.classify(screen.video(now));
+    now += kFrameMs;
+    classifier.classify(screen.video(now));
+    for (int i = 0; i < 5; ++i) {
+        now += kFrameMs;
+        if (!expect(classifier.classify(screen.typing(now)), ContentType::Text, now, "Ráfaga de video corta")) {
+            return false;
+        }
+    }
+
+    // Video sostenido: el primer frame ya es video, el cambio llega a los 500 ms
+    uint64_t since = 0;
+    for (bool first = true; now < since + 700; first = false) {
+        now += kFrameMs;
+        const ContentType type = classifier.classify(screen.video(now));
+        if (first) {
+            since = now;
+            continue;
+        }
+        const ContentType expected = now >= since + 500 ? ContentType::Video : ContentType::Text;
+        if (!expect(type, expected, now, "Video sostenido")) {
+            return false;
+        }
+    }
+
+    // Vuelta a texto a los 200 ms (el primer frame de texto es una página nueva)
+    since = now + kFrameMs;
+    while (now < since + 300) {
+        now += kFrameMs;
+        const ContentType expected = now >= since + 200 ? ContentType::Text : ContentType::Video;
+        if (!expect(classifier.classify(screen.typing(now)), expected, now, "Vuelta a texto")) {
+            return false;
+        }
+    }
+
+    // Pantalla quieta: estático recién al segundo, y un carácter en medio
+    // reinicia la espera
+    since = now + kFrameMs;
+    for (int i = 0; i < 20; ++i) {
+        now += kFrameMs;
+        if (!expect(classifier.classifyUnchanged(now), ContentType::Text, now, "Quieta menos de un segundo")) {
+            return false;
+        }
+    }
+    now += kFrameMs;
+    classifier.classify(screen.typing(now));
+    since = now + kFrameMs;
+    while (now < since + 1200) {
+        now += kFrameMs;
+        const ContentType expected = now >= since + 1000 ? ContentType::Static : ContentType::Text;
+        if (!expect(classifier.classifyUnchanged(now), expected, now, "Pantalla quieta")) {
+            return false;
+        }
+    }
+
+    // Desde estático, escribir vuelve a texto a los 200 ms
+    since = now + kFrameMs;
+    while (now < since + 300) {
+        now += kFrameMs;
+        const ContentType expected = now >= since + 200 ? ContentType::Text : ContentType::Static;
+        if (!expect(classifier.classify(screen.typing(now)), expected, now, "Escribir tras estático")) {
+            return false;
+        }
+    }
+
+    classifier.reset();
+    if (classifier.current() != ContentType::Text) {
+        return fail("reset() no volvió al perfil de texto");
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Content classifier", {
+        measuresSyntheticFrames, appliesHysteresis
+    });
+}
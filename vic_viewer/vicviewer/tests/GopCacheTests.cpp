@@ -0,0 +1,88 @@
+// Caché GOP: un keyframe la reinicia, un delta sin keyframe no entra, pasar
+// el presupuesto la invalida hasta el próximo keyframe y clear() la vacía
+#include "GopCache.h"
+#include "TestPatterns.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+using vic::tests::fail;
+
+constexpr size_t kBudget = 10'000;
+
+std::shared_ptr<const vic::encoder::EncodedFrame> makeFrame(bool keyFrame, size_t bytes) {
+    auto frame = std::make_shared<vic::encoder::EncodedFrame>();
+    frame->keyFrame = keyFrame;
+    frame->payload.assign(bytes, 0);
+    return frame;
+}
+
+bool ignoresDeltasWithoutKeyframe() {
+    vic::pipeline::GopCache cache(kBudget);
+    cache.push(makeFrame(false, 100));
+    if (cache.valid() || cache.bytes() != 0) {
+        return fail("Un delta sin keyframe entró en la caché");
+    }
+    return true;
+}
+
+bool keyframeResets() {
+    vic::pipeline::GopCache cache(kBudget);
+    cache.push(makeFrame(true, 3000));
+    cache.push(makeFrame(false, 200));
+    cache.push(makeFrame(false, 300));
+    if (!cache.valid() || cache.frames().size() != 3 || cache.bytes() != 3500) {
+        return fail("La caché no guardó el keyframe y sus deltas");
+    }
+    const auto key = makeFrame(true, 2500);
+    cache.push(key);
+    if (cache.frames().size() != 1 || cache.frames().front() != key || cache.bytes() != 2500) {
+        return fail("Un keyframe nuevo no reinició la caché");
+    }
+    return true;
+}
+
+bool overflowInvalidatesUntilKeyframe() {
+    vic::pipeline::GopCache cache(kBudget);
+    cache.push(makeFrame(true, 6000));
+    cache.push(makeFrame(false, 3000));
+    cache.push(makeFrame(false, 2000));   // 11000 > presupuesto
+    if (cache.valid() || !cache.overflowed() || cache.bytes() != 0) {
+        return fail("Pasar el presupuesto no invalidó la caché");
+    }
+    cache.push(makeFrame(false, 10));
+    if (cache.valid() || !cache.overflowed()) {
+        return fail("Un delta tras el desborde volvió a validar la caché");
+    }
+    // Un keyframe solo, aunque pase el presupuesto, siempre entra
+    cache.push(makeFrame(true, 12000));
+    if (!cache.valid() || cache.overflowed() || cache.frames().size() != 1) {
+        return fail("El keyframe no renovó la caché desbordada");
+    }
+    return true;
+}
+
+bool clearEmpties() {
+    vic::pipeline::GopCache cache(kBudget);
+    cache.push(makeFrame(true, 1000));
+    cache.push(makeFrame(false, 100));
+    cache.clear();
+    if (cache.valid() || cache.overflowed() || cache.bytes() != 0) {
+        return fail("clear() no vació la caché");
+    }
+    cache.push(makeFrame(false, 100));
+    if (cache.valid()) {
+        return fail("Tras clear() se aceptó un delta sin keyframe");
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("GOP cache", {
+        ignoresDeltasWithoutKeyframe, keyframeResets, overflowInvalidatesUntilKeyframe, clearEmpties
+    });
+}
@@ -0,0 +1,187 @@
+// Refinamiento en reposo: tras idleRefineAfterFrames frames sin cambios el
+// cuantizador baja de a un paso por frame (24, 12, 4) y se detiene; cualquier
+// cambio vuelve al rango normal del encoder y reinicia la espera
+#include "IdleRefinement.h"
+#include "TestPatterns.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::pipeline::IdleRefinement;
+using vic::pipeline::QuantizerOverride;
+using vic::tests::fail;
+using Clock = IdleRefinement::Clock;
+
+constexpr auto kFrameInterval = std::chrono::milliseconds(33);
+constexpr uint32_t kAfterFrames = 6;
+
+/// Encoder que solo anota lo que le pide el host sobre el cuantizador
+class QuantizerLog final : public vic::encoder::VideoEncoder {
+public:
+    explicit QuantizerLog(bool supported = true) : supported_(supported) {}
+
+    bool Configure(uint32_t, uint32_t, uint32_t) override { return true; }
+    std::optional<vic::encoder::EncodedFrame> EncodeFrame(const vic::capture::DesktopFrame&) override {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> Flush() override { return {}; }
+
+    bool setQuantizerRange(uint32_t minQuantizer, uint32_t maxQuantizer) override {
+        calls.push_back("range " + std::to_string(minQuantizer) + "-" + std::to_string(maxQuantizer));
+        return supported_;
+    }
+    void resetQuantizerRange() override { calls.push_back("reset"); }
+    void refineNextFrame() override { calls.push_back("refine"); }
+
+    std::vector<std::string> calls;
+
+private:
+    bool supported_;
+};
+
+std::string join(const std::vector<std::string>& calls) {
+    std::string out;
+    for (const auto& call : calls) {
+        out += (out.empty() ? "" : ", ") + call;
+    }
+    return "[" + out + "]";
+}
+
+bool expectCalls(QuantizerLog& encoder, const std::vector<std::string>& expected, const std::string& step) {
+    if (encoder.calls != expected) {
+        return fail(step + ": el encoder recibió " + join(encoder.calls) + ", se esperaba " + join(expected));
+    }
+    encoder.calls.clear();
+    return true;
+}
+
+/// Lo que haría el hilo de captura en `now` sin frames nuevos: codificar el
+/// refinamiento que corresponda (o nada)
+std::optional<uint32_t> idleTick(IdleRefinement& refinement, QuantizerOverride& quantizer, QuantizerLog& encoder,
+                                 Clock::time_point now) {
+    const auto refineQuantizer = refinement.due(now);
+    if (refineQuantizer) {
+        quantizer.apply(encoder, refineQuantizer);
+        refinement.advance();
+    }
+    return refineQuantizer;
+}
+
+/// Un refinamiento por frame de espera, con el cuantizador bajando, y
+/// después la pantalla quieta no genera nada más
+bool refinesProgressivelyThenStops() {
+    const auto start = Clock::now();
+    IdleRefinement refinement(true, kAfterFrames, kFrameInterval, start);
+    QuantizerOverride quantizer;
+    QuantizerLog encoder;
+
+    if (idleTick(refinement, quantizer, encoder, start + kFrameInterval * (kAfterFrames - 1))) {
+        return fail("Refinó antes de " + std::to_string(kAfterFrames) + " frames sin cambios");
+    }
+    uint32_t previous = 63;
+    for (size_t step = 0; step < IdleRefinement::kQuantizers.size(); ++step) {
+        const auto at = start + kFrameInterval * static_cast<int64_t>(kAfterFrames + step);
+        const uint32_t expected = IdleRefinement::kQuantizers[step];
+        const auto got = idleTick(refinement, quantizer, encoder, at);
+        if (got != expected) {
+            return fail("Paso " + std::to_string(step) + ": cuantizador " + (got ? std::to_string(*got) : "ninguno") +
+                        ", se esperaba " + std::to_string(expected));
+        }
+        if (expected >= previous) {
+            return fail("El cuantizador no bajó en el paso " + std::to_string(step));
+        }
+        previous = expected;
+        const std::string q = std::to_string(expected);
+        if (!expectCalls(encoder, {"range " + q + "-" + q, "refine"}, "Paso " + std::to_string(step))) {
+            return false;
+        }
+        // Dentro del mismo intervalo no hay un segundo refinamiento
+        if (idleTick(refinement, quantizer, encoder, at)) {
+            return fail("Dos refinamientos en el mismo intervalo de frame");
+        }
+    }
+    if (idleTick(refinement, quantizer, encoder, start + std::chrono::seconds(60))) {
+        return fail("Siguió refinando después del último paso");
+    }
+    return expectCalls(encoder, {}, "Después del último paso");
+}
+
+/// Un cambio en medio del refinamiento vuelve al rango normal en el próximo
+/// frame (una sola vez) y la espera arranca de nuevo desde el cambio
+bool damageResetsQuantizer() {
+    const auto start = Clock::now();
+    IdleRefinement refinement(true, kAfterFrames, kFrameInterval, start);
+    QuantizerOverride quantizer;
+    QuantizerLog encoder;
+
+    auto now = start + kFrameInterval * kAfterFrames;
+    idleTick(refinement, quantizer, encoder, now);
+    now += kFrameInterval;
+    idleTick(refinement, quantizer, encoder, now);
+    encoder.calls.clear();
+    if (!quantizer.overridden() || refinement.step() != 2) {
+        return fail("Tras dos refinamientos el cuantizador debería estar acotado");
+    }
+
+    // Frame con daño: el host reinicia la espera y codifica sin refinamiento
+    now += kFrameInterval / 2;
+    refinement.restart(now);
+    quantizer.apply(encoder, refinement.due(now));
+    if (!expectCalls(encoder, {"reset"}, "Frame con cambios") || quantizer.overridden()) {
+        return false;
+    }
+    quantizer.apply(encoder, std::nullopt);
+    if (!expectCalls(encoder, {}, "Segundo frame con cambios")) {
+        return false;
+    }
+
+    if (idleTick(refinement, quantizer, encoder, now + kFrameInterval * (kAfterFrames - 1))) {
+        return fail("Tras el cambio refinó sin esperar idleRefineAfterFrames");
+    }
+    const auto first = idleTick(refinement, quantizer, encoder, now + kFrameInterval * kAfterFrames);
+    if (first != IdleRefinement::kQuantizers[0]) {
+        return fail("Tras el cambio el refinamiento no volvió a empezar por el primer paso");
+    }
+    return true;
+}
+
+/// Desactivado no refina nunca; un encoder que no acota el cuantizador
+/// tampoco recibe resetQuantizerRange()
+bool respectsDisabledAndUnsupported() {
+    const auto start = Clock::now();
+    IdleRefinement disabled(false, kAfterFrames, kFrameInterval, start);
+    if (disabled.due(start + std::chrono::seconds(60))) {
+        return fail("Con el refinamiento desactivado no debería haber pasos");
+    }
+
+    IdleRefinement refinement(true, kAfterFrames, kFrameInterval, start);
+    QuantizerOverride quantizer;
+    QuantizerLog encoder(false);
+    idleTick(refinement, quantizer, encoder, start + kFrameInterval * kAfterFrames);
+    encoder.calls.clear();
+    quantizer.apply(encoder, std::nullopt);
+    if (!expectCalls(encoder, {}, "Encoder sin rango de cuantizador")) {
+        return false;
+    }
+
+    // Cambio de codec: el encoder nuevo ya está en el rango normal
+    QuantizerLog supported;
+    quantizer.apply(supported, 24);
+    quantizer.forget();
+    supported.calls.clear();
+    quantizer.apply(supported, std::nullopt);
+    return expectCalls(supported, {}, "Encoder nuevo");
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Idle refinement", {
+        refinesProgressivelyThenStops, damageResetsQuantizer, respectsDisabledAndUnsupported
+    });
+}
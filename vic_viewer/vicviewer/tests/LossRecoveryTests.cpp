@@ -0,0 +1,198 @@
+// Recuperación de pérdidas: tras perder frames, el viewer se recupera con un
+// frame que solo referencia un long-term (golden/altref) en lugar de un keyframe
+#include "VideoDecoder.h"
+#include "VideoEncoder.h"
+#include "DesktopFrame.h"
+#include "TestPatterns.h"
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+namespace {
+
+using vic::tests::fail;
+using vic::tests::drawGlyph;
+using vic::tests::psnr;
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr uint32_t kBitrateKbps = 2000;
+constexpr int kFramesBeforeLoss = 45;    // Pasa al menos un refresco de long-term
+constexpr int kLostFrames = 3;
+constexpr double kMinPsnr = 30.0;
+
+/// Documento de texto en el que se escribe un carácter por frame
+class TypingScreen {
+public:
+    TypingScreen() {
+        frame_.width = kWidth;
+        frame_.height = kHeight;
+        frame_.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+        for (uint32_t y = 40; y + 12 < kHeight; y += 18) {
+            for (uint32_t x = 40; x + 8 < kWidth; x += 8) {
+                drawGlyph(frame_.bgraData, kWidth, x, y, x * 31 + y * 17);
+            }
+        }
+    }
+
+    const vic::capture::DesktopFrame& next() {
+        frame_.timestamp = static_cast<uint64_t>(index_) * 33;
+        drawGlyph(frame_.bgraData, kWidth, 40 + (index_ % 120) * 8, 400, static_cast<uint32_t>(index_) * 7919u + 1);
+        ++index_;
+        return frame_;
+    }
+
+private:
+    vic::capture::DesktopFrame frame_{};
+    int index_ = 0;
+};
+
+/// Perder frames, pedir recuperación con los long-term que conserva el decoder
+/// y comprobar que el viewer vuelve a mostrar el contenido correcto
+bool recoversFromLongTerm() {
+    auto encoder = vic::encoder::createVp8Encoder();
+    auto decoder = vic::decoder::createVp8Decoder();
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    decoder->configure(kWidth, kHeight);
+    TypingScreen screen;
+
+    size_t keyFrameSize = 0;
+    for (int i = 0; i < kFramesBeforeLoss; ++i) {
+        auto encoded = encoder->EncodeFrame(screen.next());
+        if (!encoded || !decoder->decode(*encoded)) {
+            return fail("Frame " + std::to_string(i) + " no se pudo codificar/decodificar");
+        }
+        if (encoded->keyFrame) {
+            keyFrameSize = encoded->payload.size();
+        }
+    }
+
+    // Frames perdidos en la red
+    for (int i = 0; i < kLostFrames; ++i) {
+        if (!encoder->EncodeFrame(screen.next())) {
+            return fail("No se pudo codificar un frame perdido");
+        }
+    }
+
+    // El siguiente depende de los perdidos: no se debe decodificar
+    auto afterLoss = encoder->EncodeFrame(screen.next());
+    if (!afterLoss) {
+        return fail("No se pudo codificar el frame posterior a la pérdida");
+    }
+    if (decoder->decode(*afterLoss)) {
+        return fail("El decoder decodificó un frame con referencias perdidas");
+    }
+    const auto state = decoder->recoveryState();
+    if (!state || (state->goldenFrameId == 0 && state->altRefFrameId == 0)) {
+        return fail("El decoder no reporta long-term intactos");
+    }
+
+    const uint32_t intact[] = {state->goldenFrameId, state->altRefFrameId};
+    encoder->requestRecovery(intact);
+    const auto& source = screen.next();
+    auto recovery = encoder->EncodeFrame(source);
+    if (!recovery || recovery->keyFrame ||
+        (recovery->referenceFlags & vic::encoder::EncodedFrame::kRecovery) == 0) {
+        return fail("El encoder no produjo un frame de recuperación");
+    }
+    auto decoded = decoder->decode(*recovery);
+    if (!decoded) {
+        return fail("El frame de recuperación no se pudo decodificar");
+    }
+    if (decoder->recoveryState()) {
+        return fail("El decoder sigue esperando recuperación");
+    }
+    const double recoveredPsnr = psnr(source.bgraData, decoded->bgraData);
+    if (recoveredPsnr < kMinPsnr) {
+        return fail("PSNR tras la recuperación demasiado bajo: " + std::to_string(recoveredPsnr) + " dB");
+    }
+
+    // La cadena sigue normal después de la recuperación
+    for (int i = 0; i < 5; ++i) {
+        const auto& frame = screen.next();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto next = encoded ? decoder->decode(*encoded) : std::nullopt;
+        if (!next || psnr(frame.bgraData, next->bgraData) < kMinPsnr) {
+            return fail("Frame posterior a la recuperación inválido");
+        }
+    }
+
+    // Tamaño de un keyframe en el mismo punto, para comparar
+    encoder->forceNextKeyframe();
+    auto keyFrame = encoder->EncodeFrame(screen.next());
+    if (!keyFrame || !keyFrame->keyFrame) {
+        return fail("No se pudo forzar un keyframe");
+    }
+
+    std::cout << "Keyframe inicial:    " << keyFrameSize << " bytes" << std::endl;
+    std::cout << "Keyframe forzado:    " << keyFrame->payload.size() << " bytes" << std::endl;
+    std::cout << "Frame recuperación:  " << recovery->payload.size() << " bytes (PSNR "
+              << recoveredPsnr << " dB)" << std::endl;
+
+    if (recovery->payload.size() >= keyFrame->payload.size()) {
+        return fail("El frame de recuperación no es más chico que un keyframe");
+    }
+    return true;
+}
+
+/// Sin long-term en común con el viewer, la recuperación cae en keyframe
+bool fallsBackToKeyframe() {
+    auto encoder = vic::encoder::createVp8Encoder();
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    TypingScreen screen;
+    for (int i = 0; i < 5; ++i) {
+        encoder->EncodeFrame(screen.next());
+    }
+    const uint32_t intact[] = {0, 0};
+    encoder->requestRecovery(intact);
+    auto encoded = encoder->EncodeFrame(screen.next());
+    if (!encoded || !encoded->keyFrame) {
+        return fail("Sin long-term intactos se esperaba un keyframe");
+    }
+    return true;
+}
+
+/// Con 2 capas temporales, descartar todos los frames de la capa de mejora
+/// no corrompe nada ni requiere recuperación: la base sigue decodificándose
+bool dropsEnhancementLayer() {
+    auto encoder = vic::encoder::createVp8Encoder();
+    auto decoder = vic::decoder::createVp8Decoder();
+    encoder->setTemporalLayers(2);
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    decoder->configure(kWidth, kHeight);
+    TypingScreen screen;
+
+    int enhancementFrames = 0;
+    for (int i = 0; i < 40; ++i) {
+        const auto& frame = screen.next();
+        auto encoded = encoder->EncodeFrame(frame);
+        if (!encoded) {
+            return fail("Frame " + std::to_string(i) + " no se pudo codificar");
+        }
+        if (encoded->temporalLayer > 0) {
+            ++enhancementFrames;
+            continue;   // Descartado por congestión
+        }
+        auto decoded = decoder->decode(*encoded);
+        if (!decoded || decoder->recoveryState()) {
+            return fail("Frame base " + std::to_string(i) + " no decodificable sin la capa de mejora");
+        }
+        if (psnr(frame.bgraData, decoded->bgraData) < kMinPsnr) {
+            return fail("PSNR de la capa base demasiado bajo en el frame " + std::to_string(i));
+        }
+    }
+    if (enhancementFrames < 15) {
+        return fail("Muy pocos frames en la capa de mejora: " + std::to_string(enhancementFrames));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Loss recovery", {
+        recoversFromLongTerm, fallsBackToKeyframe, dropsEnhancementLayer
+    });
+}
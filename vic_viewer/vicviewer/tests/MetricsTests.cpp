@@ -0,0 +1,208 @@
+// Métricas: percentiles de los histogramas HDR contra el orden exacto (varios
+// hilos escribiendo), rango de 1 ns a ~137 s, resta entre acumulados y
+// ventanas que abarcan el hueco cuando nadie leyó, y bytes enviados por viewer
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using vic::metrics::LatencyHistogram;
+using vic::metrics::MetricsCollector;
+using vic::metrics::Stage;
+using vic::tests::fail;
+using namespace std::chrono_literals;
+
+constexpr double kMaxErrorPercent = 3.2;   // Medio bucket: < 1/kSubBuckets
+
+/// Latencias tipo encode: cuerpo lognormal en ~4 ms y picos de 20-60 ms
+std::vector<uint64_t> syntheticLatencies(size_t count, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> body(std::log(4'000'000.0), 0.35);
+    std::uniform_real_distribution<double> spike(20'000'000.0, 60'000'000.0);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::vector<uint64_t> values(count);
+    for (auto& value : values) {
+        value = static_cast<uint64_t>(coin(rng) < 0.004 ? spike(rng) : body(rng));
+    }
+    return values;
+}
+
+double errorPercent(double measured, double expected) {
+    return std::abs(measured - expected) * 100.0 / expected;
+}
+
+/// Cuatro hilos registran a la vez; los percentiles fusionados quedan a
+/// menos de medio bucket del orden exacto y no se pierde ninguna muestra
+bool percentilesMatchExactOrder() {
+    constexpr uint32_t kThreads = 4;
+    constexpr size_t kSamplesPerThread = 100000;
+    auto& collector = MetricsCollector::instance();
+    collector.reset();
+
+    std::vector<std::vector<uint64_t>> perThread;
+    std::vector<uint64_t> all;
+    for (uint32_t i = 0; i < kThreads; ++i) {
+        perThread.push_back(syntheticLatencies(kSamplesPerThread, 1234 + i));
+        all.insert(all.end(), perThread.back().begin(), perThread.back().end());
+    }
+    std::vector<std::thread> writers;
+    for (uint32_t i = 0; i < kThreads; ++i) {
+        writers.emplace_back([&, i] {
+            for (const uint64_t ns : perThread[i]) {
+                collector.recordStageTime(Stage::Encode, ns);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    std::sort(all.begin(), all.end());
+    const auto exactUs = [&all](double quantile) {
+        const auto rank = static_cast<size_t>(std::ceil(quantile * static_cast<double>(all.size())));
+        return static_cast<double>(all[std::clamp<size_t>(rank, 1, all.size()) - 1]) / 1000.0;
+    };
+
+    const auto latency = collector.getMetrics().latencyWindows.back().stages[static_cast<size_t>(Stage::Encode)];
+    if (latency.count != all.size()) {
+        return fail("Se perdieron muestras: " + std::to_string(latency.count) + " / " + std::to_string(all.size()));
+    }
+    const std::pair<const char*, std::pair<double, double>> rows[] = {
+        {"p50", {0.50, latency.p50Us}}, {"p90", {0.90, latency.p90Us}},
+        {"p99", {0.99, latency.p99Us}}, {"p99.9", {0.999, latency.p999Us}},
+        {"max", {1.0, latency.maxUs}},
+    };
+    for (const auto& [name, values] : rows) {
+        const double error = errorPercent(values.second, exactUs(values.first));
+        if (error >= kMaxErrorPercent) {
+            return fail(std::string(name) + " con " + std::to_string(error) + " % de error");
+        }
+    }
+    return true;
+}
+
+/// Exacto por debajo de kSubBuckets ns, error acotado hasta 2^kMaxExponent ns
+/// y lo que pasa de ahí queda en el último bucket
+bool coversHistogramRange() {
+    namespace histogram = vic::metrics::histogram;
+    for (uint64_t ns = 1; ns < histogram::kSubBuckets; ++ns) {
+        LatencyHistogram single;
+        single.record(ns);
+        if (single.percentileNs(0.5) != static_cast<double>(ns)) {
+            return fail("Valor chico no exacto: " + std::to_string(ns) + " ns");
+        }
+    }
+    const uint64_t top = (uint64_t{1} << histogram::kMaxExponent) - 1;
+    for (const uint64_t ns : {uint64_t{1000}, uint64_t{999'999}, uint64_t{60'000'000'000}, top}) {
+        LatencyHistogram single;
+        single.record(ns);
+        const double error = errorPercent(single.percentileNs(0.5), static_cast<double>(ns));
+        if (histogram::bucketIndex(ns) >= histogram::kBuckets || error >= kMaxErrorPercent) {
+            return fail("Error de " + std::to_string(error) + " % en " + std::to_string(ns) + " ns");
+        }
+    }
+    if (histogram::bucketIndex(top + 1) != histogram::kBuckets - 1 ||
+        histogram::bucketIndex(UINT64_MAX) != histogram::kBuckets - 1) {
+        return fail("Los valores por encima del rango no caen en el último bucket");
+    }
+    return true;
+}
+
+/// Una ventana es el acumulado actual menos un checkpoint anterior
+bool subtractsCheckpoint() {
+    LatencyHistogram cumulative;
+    for (int i = 0; i < 100; ++i) {
+        cumulative.record(50'000'000);   // 50 ms, antes del checkpoint
+    }
+    const LatencyHistogram checkpoint = cumulative;
+    for (int i = 0; i < 10; ++i) {
+        cumulative.record(2'000'000);    // 2 ms, dentro de la ventana
+    }
+    LatencyHistogram window = cumulative;
+    window.subtract(checkpoint);
+    if (window.count() != 10 || window.sumNs() != 20'000'000 ||
+        errorPercent(window.maxNs(), 2'000'000.0) >= kMaxErrorPercent) {
+        return fail("La resta no dejó solo lo registrado después del checkpoint");
+    }
+    return true;
+}
+
+/// Los checkpoints avanzan al leer: tras un hueco sin lecturas la ventana
+/// abarca todo el hueco (y `covered` lo dice); leyendo seguido vuelve a la
+/// longitud de la ventana
+bool windowCoversGapWithoutReads() {
+    auto& collector = MetricsCollector::instance();
+    collector.setWindows({std::chrono::milliseconds(50)});
+    collector.getMetrics();
+    collector.recordStageTime(Stage::Decode, 1'000'000);
+    std::this_thread::sleep_for(200ms);
+    collector.recordStageTime(Stage::Decode, 1'000'000);
+
+    auto window = collector.getMetrics().latencyWindows.front();
+    if (window.covered < 200ms || window.stages[static_cast<size_t>(Stage::Decode)].count != 2) {
+        return fail("Tras un hueco sin lecturas la ventana no abarcó el hueco (" +
+                    std::to_string(window.covered.count()) + " ms)");
+    }
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(20ms);
+        window = collector.getMetrics().latencyWindows.front();
+    }
+    if (window.covered < 50ms || window.covered > 150ms ||
+        window.stages[static_cast<size_t>(Stage::Decode)].count != 0) {
+        return fail("Leyendo seguido la ventana no volvió a ~50 ms (" + std::to_string(window.covered.count()) +
+                    " ms)");
+    }
+    collector.setWindows({std::chrono::seconds(1), std::chrono::seconds(10), std::chrono::seconds(60)});
+    return true;
+}
+
+/// Bytes enviados: los de cada hilo de envío se suman, no se mezclan con los
+/// codificados y reset() los toma como nueva base
+bool sumsBytesSentAcrossViewers() {
+    constexpr size_t kFrames = 1000;
+    constexpr size_t kFrameBytes = 1500;
+    auto& collector = MetricsCollector::instance();
+    collector.recordBytesSent(kFrameBytes);
+    collector.reset();
+
+    std::vector<std::thread> viewers;
+    for (int i = 0; i < 3; ++i) {
+        viewers.emplace_back([&] {
+            for (size_t frame = 0; frame < kFrames; ++frame) {
+                collector.recordBytesSent(kFrameBytes);
+            }
+        });
+    }
+    for (auto& viewer : viewers) {
+        viewer.join();
+    }
+    collector.recordFrameSize(kFrameBytes);
+
+    const auto metrics = collector.getMetrics();
+    if (metrics.totalBytesSent != 3 * kFrames * kFrameBytes) {
+        return fail("Bytes enviados: " + std::to_string(metrics.totalBytesSent) + " / " +
+                    std::to_string(3 * kFrames * kFrameBytes));
+    }
+    if (metrics.totalBytesTransferred != kFrameBytes) {
+        return fail("Los bytes enviados no deberían contar como codificados");
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Metrics", {
+        percentilesMatchExactOrder, coversHistogramRange, subtractsCheckpoint, windowCoversGapWithoutReads,
+        sumsBytesSentAcrossViewers
+    });
+}
@@ -0,0 +1,162 @@
+// Grabación: lo que escribe SessionRecorder lo lee RecordingReader igual
+// (frames, keyframes, copy-rects), un IVF cortado se abre hasta el último
+// frame completo y un cambio de codec abre un segmento nuevo
+#include "RecordingReader.h"
+#include "SessionRecorder.h"
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::tests::fail;
+
+constexpr uint32_t kFrames = 40;
+constexpr uint32_t kKeyFrameInterval = 15;
+constexpr uint32_t kCopyRectInterval = 7;
+
+namespace fs = std::filesystem;
+
+/// Payload reconocible por frame; el primer keyframe pasa de 1 MB para
+/// cubrir un lote más grande que el buffer de escritura
+std::shared_ptr<vic::encoder::EncodedFrame> makeFrame(uint32_t number, vic::encoder::VideoCodec codec) {
+    auto frame = std::make_shared<vic::encoder::EncodedFrame>();
+    frame->timestamp = 1000 + static_cast<uint64_t>(number) * 33;
+    frame->keyFrame = number % kKeyFrameInterval == 0;
+    frame->codec = codec;
+    frame->width = frame->originalWidth = 1280;
+    frame->height = frame->originalHeight = 720;
+    frame->payload.resize(number == 0 ? 1536 * 1024 : 200 + number * 37);
+    for (size_t i = 0; i < frame->payload.size(); ++i) {
+        frame->payload[i] = static_cast<uint8_t>(number * 131 + i);
+    }
+    if (number % kCopyRectInterval == 3) {
+        frame->copyRects.push_back({0, number, 0, number + 16, 1280, 400});
+        frame->copyRects.push_back({10, 20, 30, 40, 50, 60});
+    }
+    return frame;
+}
+
+bool samePayload(const vic::recording::RecordedFrame& recorded, const vic::encoder::EncodedFrame& frame) {
+    return std::equal(recorded.payload.begin(), recorded.payload.end(),
+                      frame.payload.begin(), frame.payload.end());
+}
+
+bool roundTrip(const fs::path& directory) {
+    vic::recording::SessionRecorder recorder({directory.string(), "roundtrip"});
+    if (!recorder.start()) {
+        return fail("No se pudo iniciar la grabación");
+    }
+    // Deltas antes del primer keyframe: se descartan
+    auto early = makeFrame(1, vic::encoder::VideoCodec::Vp8);
+    if (recorder.enqueue(early)) {
+        return fail("Se encoló un delta antes del primer keyframe");
+    }
+    std::vector<std::shared_ptr<vic::encoder::EncodedFrame>> sent;
+    for (uint32_t i = 0; i < kFrames; ++i) {
+        sent.push_back(makeFrame(i, vic::encoder::VideoCodec::Vp8));
+        if (!recorder.enqueue(sent.back())) {
+            return fail("Frame " + std::to_string(i) + " descartado");
+        }
+    }
+    recorder.stop();
+    const auto stats = recorder.stats();
+    if (stats.framesWritten != kFrames || stats.segments != 1 || stats.framesDropped != 1) {
+        return fail("Estadísticas inesperadas: " + std::to_string(stats.framesWritten) + " escritos, " +
+                    std::to_string(stats.framesDropped) + " descartados");
+    }
+
+    const auto path = directory / "roundtrip_000.ivf";
+    auto reader = vic::recording::RecordingReader::open(path.string());
+    if (!reader || !reader->hasIndex()) {
+        return fail("No se pudo abrir " + path.string() + " con su índice");
+    }
+    if (reader->frameCount() != kFrames) {
+        return fail("Frames leídos: " + std::to_string(reader->frameCount()));
+    }
+    const std::vector<uint32_t> expectedKeys = {0, 15, 30};
+    if (reader->keyFrames() != expectedKeys) {
+        return fail("Índice de keyframes incorrecto");
+    }
+    if (reader->seekKeyframe(sent[20]->timestamp - 1000) != 15) {
+        return fail("seekKeyframe no cae en el keyframe anterior");
+    }
+    for (uint32_t i = 0; i < kFrames; ++i) {
+        const auto& recorded = reader->frame(i);
+        const auto& frame = *sent[i];
+        if (!samePayload(recorded, frame) || recorded.keyFrame != frame.keyFrame ||
+            recorded.pts != frame.timestamp - 1000 || recorded.width != frame.width) {
+            return fail("Frame " + std::to_string(i) + " distinto al grabado");
+        }
+        if (recorded.copyRects.size() != frame.copyRects.size() ||
+            !std::equal(recorded.copyRects.begin(), recorded.copyRects.end(), frame.copyRects.begin(),
+                        [](const auto& a, const auto& b) {
+                            return a.srcX == b.srcX && a.srcY == b.srcY && a.dstX == b.dstX &&
+                                   a.dstY == b.dstY && a.width == b.width && a.height == b.height;
+                        })) {
+            return fail("Copy-rects del frame " + std::to_string(i) + " distintos");
+        }
+    }
+    reader.reset();
+
+    // Grabación cortada a mitad del último frame
+    const auto truncated = directory / "truncated.ivf";
+    fs::copy_file(path, truncated, fs::copy_options::overwrite_existing);
+    fs::resize_file(truncated, fs::file_size(path) - sent.back()->payload.size() / 2);
+    auto partial = vic::recording::RecordingReader::open(truncated.string());
+    if (!partial || partial->frameCount() != kFrames - 1) {
+        return fail("El IVF truncado no se abre hasta el último frame completo");
+    }
+    if (!samePayload(partial->frame(kFrames - 2), *sent[kFrames - 2])) {
+        return fail("Último frame completo del IVF truncado distinto");
+    }
+    return true;
+}
+
+bool codecChangeOpensSegment(const fs::path& directory) {
+    vic::recording::SessionRecorder recorder({directory.string(), "codec"});
+    if (!recorder.start()) {
+        return fail("No se pudo iniciar la grabación");
+    }
+    for (uint32_t i = 0; i < 10; ++i) {
+        recorder.enqueue(makeFrame(i, vic::encoder::VideoCodec::Vp8));
+    }
+    // Un delta del codec nuevo no abre segmento; su keyframe sí
+    auto delta = makeFrame(31, vic::encoder::VideoCodec::Vp9);
+    recorder.enqueue(delta);
+    for (uint32_t i = 0; i < 5; ++i) {
+        recorder.enqueue(makeFrame(i == 0 ? 0 : 40 + i, vic::encoder::VideoCodec::Vp9));
+    }
+    recorder.stop();
+
+    auto first = vic::recording::RecordingReader::open((directory / "codec_000.ivf").string());
+    auto second = vic::recording::RecordingReader::open((directory / "codec_001.ivf").string());
+    if (!first || !second || recorder.stats().segments != 2) {
+        return fail("El cambio de codec no abrió un segmento nuevo");
+    }
+    if (first->frameCount() != 10 || second->frameCount() != 5 ||
+        second->codec() != vic::encoder::VideoCodec::Vp9 || second->keyFrames().front() != 0) {
+        return fail("Segmentos con frames o codec inesperados");
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const auto directory = fs::temp_directory_path() / "vic_recording_tests";
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+
+    const int result = vic::tests::runTests("Recording", {
+        [&] { return roundTrip(directory); },
+        [&] { return codecChangeOpensSegment(directory); },
+    });
+    fs::remove_all(directory, ec);
+    return result;
+}
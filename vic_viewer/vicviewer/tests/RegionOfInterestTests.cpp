@@ -0,0 +1,223 @@
+// Región de interés: zonas editadas del DamageTracker (tiles de 64, unión en
+// rects, recorte en los bordes, vencimiento y cambios globales) y el mapa ROI
+// que arma el host (segmentos, escala al frame codificado y recorte)
+#include "DamageTracker.h"
+#include "RegionOfInterest.h"
+#include "TestPatterns.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::capture::CursorState;
+using vic::capture::DamageRect;
+using vic::capture::DamageTracker;
+using vic::encoder::RoiMap;
+using vic::encoder::RoiRegion;
+using vic::pipeline::buildRoiMap;
+using vic::pipeline::kRoiCursorSegment;
+using vic::pipeline::kRoiEditSegment;
+using vic::tests::drawGlyph;
+using vic::tests::fail;
+
+// Ni el ancho ni el alto son múltiplos de 64: la última fila y columna de
+// tiles quedan recortadas (16x10 tiles)
+constexpr uint32_t kWidth = 1000;
+constexpr uint32_t kHeight = 600;
+constexpr uint64_t kWindowMs = 2000;
+constexpr size_t kMaxRects = 8;
+
+vic::capture::DesktopFrame blankFrame(uint64_t timestampMs) {
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.timestamp = timestampMs;
+    frame.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+    return frame;
+}
+
+std::string describe(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    return std::to_string(x) + "," + std::to_string(y) + " " + std::to_string(width) + "x" + std::to_string(height);
+}
+
+bool expectEdits(const DamageTracker& tracker, const std::vector<DamageRect>& expected, const std::string& step) {
+    const auto edits = tracker.recentEdits(kWindowMs, kMaxRects);
+    if (edits.size() != expected.size()) {
+        return fail(step + ": " + std::to_string(edits.size()) + " rects, se esperaban " +
+                    std::to_string(expected.size()));
+    }
+    for (size_t i = 0; i < edits.size(); ++i) {
+        const auto& got = edits[i];
+        const auto& want = expected[i];
+        if (got.x != want.x || got.y != want.y || got.width != want.width || got.height != want.height) {
+            return fail(step + ": rect " + describe(got.x, got.y, got.width, got.height) + ", se esperaba " +
+                        describe(want.x, want.y, want.width, want.height));
+        }
+    }
+    return true;
+}
+
+bool expectRegion(const RoiRegion& got, const RoiRegion& want, const std::string& step) {
+    if (got.x != want.x || got.y != want.y || got.width != want.width || got.height != want.height ||
+        got.segment != want.segment) {
+        return fail(step + ": región " + describe(got.x, got.y, got.width, got.height) + " segmento " +
+                    std::to_string(got.segment) + ", se esperaba " + describe(want.x, want.y, want.width, want.height) +
+                    " segmento " + std::to_string(want.segment));
+    }
+    return true;
+}
+
+/// Un carácter escrito marca su tile; dos tiles encimados en la misma columna
+/// se unen en un solo rect, y el tile del borde se recorta al frame
+bool tracksEditedTiles() {
+    DamageTracker tracker;
+    auto frame = blankFrame(0);
+    tracker.update(frame);
+    if (!expectEdits(tracker, {}, "Primer frame")) {
+        return false;
+    }
+
+    drawGlyph(frame.bgraData, kWidth, 3 * 64 + 10, 2 * 64 + 10, 1);
+    frame.timestamp = 100;
+    tracker.update(frame);
+    if (!expectEdits(tracker, {{192, 128, 64, 64}}, "Un carácter")) {
+        return false;
+    }
+
+    drawGlyph(frame.bgraData, kWidth, 3 * 64 + 20, 3 * 64 + 10, 2);
+    frame.timestamp = 150;
+    tracker.update(frame);
+    if (!expectEdits(tracker, {{192, 128, 64, 128}}, "Tile de abajo")) {
+        return false;
+    }
+
+    // Tile (15, 9): 40x24 dentro del frame
+    drawGlyph(frame.bgraData, kWidth, 985, 585, 3);
+    frame.timestamp = 200;
+    tracker.update(frame);
+    return expectEdits(tracker, {{192, 128, 64, 128}, {960, 576, 40, 24}}, "Tile del borde");
+}
+
+/// Una edición vale `windowMs` desde el frame en que cambió; un cambio de más
+/// de 1/4 de los tiles (scroll, otra ventana) borra las anteriores
+bool expiresOldEdits() {
+    DamageTracker tracker;
+    auto frame = blankFrame(0);
+    tracker.update(frame);
+    drawGlyph(frame.bgraData, kWidth, 10, 10, 1);
+    frame.timestamp = 100;
+    tracker.update(frame);
+
+    frame.timestamp = 100 + kWindowMs;
+    tracker.update(frame);
+    if (!expectEdits(tracker, {{0, 0, 64, 64}}, "Justo al final de la ventana")) {
+        return false;
+    }
+    frame.timestamp += 1;
+    tracker.update(frame);
+    if (!expectEdits(tracker, {}, "Pasada la ventana")) {
+        return false;
+    }
+
+    drawGlyph(frame.bgraData, kWidth, 10, 10, 2);
+    frame.timestamp += 20;
+    tracker.update(frame);
+    for (auto& value : frame.bgraData) {
+        value = static_cast<uint8_t>(255 - value);
+    }
+    frame.timestamp += 20;
+    tracker.update(frame);
+    if (!expectEdits(tracker, {}, "Cambio global")) {
+        return false;
+    }
+
+    tracker.reset();
+    tracker.update(frame);
+    return expectEdits(tracker, {}, "Tras reset()");
+}
+
+/// Cursor: cuadrado de 2 * roiCursorRadius escalado al frame codificado, y
+/// recortado si el cursor está cerca del borde; nada si está oculto o afuera
+bool mapsCursorRegion() {
+    vic::pipeline::StreamConfig config{};
+    config.roiCursorRadius = 128;
+    CursorState cursor{};
+    cursor.visible = true;
+    cursor.x = 500;
+    cursor.y = 300;
+
+    // Pantalla de 2000x1200 codificada a 1000x600
+    auto map = buildRoiMap(config, cursor, {}, 2000, 1200, kWidth, kHeight);
+    if (map.regions.size() != 1) {
+        return fail("El cursor debería dar una sola región");
+    }
+    if (!expectRegion(map.regions[0], {186, 86, 128, 128, kRoiCursorSegment}, "Cursor")) {
+        return false;
+    }
+    if (map.deltaQ[kRoiCursorSegment] >= 0 || map.deltaQ[0] <= 0 || map.deltaLoopFilter[kRoiCursorSegment] >= 0) {
+        return fail("El cursor debería ganar calidad a costa del fondo");
+    }
+
+    cursor.x = 50;
+    cursor.y = 1150;
+    map = buildRoiMap(config, cursor, {}, 2000, 1200, kWidth, kHeight);
+    if (map.regions.size() != 1) {
+        return fail("El cursor en la esquina debería dar una región recortada");
+    }
+    if (!expectRegion(map.regions[0], {0, 511, 89, 89, kRoiCursorSegment}, "Cursor en la esquina")) {
+        return false;
+    }
+
+    cursor.x = -300;
+    map = buildRoiMap(config, cursor, {}, 2000, 1200, kWidth, kHeight);
+    if (!map.empty() || map.deltaQ != RoiMap{}.deltaQ) {
+        return fail("Un cursor fuera de la pantalla no debería dar regiones ni deltas");
+    }
+    cursor.x = 500;
+    cursor.visible = false;
+    if (!buildRoiMap(config, cursor, {}, 2000, 1200, kWidth, kHeight).empty()) {
+        return fail("Un cursor oculto no debería dar regiones");
+    }
+    return buildRoiMap(config, cursor, {}, 0, 0, kWidth, kHeight).empty() || fail("Sin pantalla no hay mapa");
+}
+
+/// Las ediciones del tracker van al segmento de edición, recortadas al frame,
+/// y el cursor queda último para ganar donde se solapan
+bool mapsEditsBeforeCursor() {
+    DamageTracker tracker;
+    auto frame = blankFrame(0);
+    tracker.update(frame);
+    drawGlyph(frame.bgraData, kWidth, 64 + 10, 64 + 10, 1);
+    drawGlyph(frame.bgraData, kWidth, 985, 585, 2);
+    frame.timestamp = 100;
+    tracker.update(frame);
+    auto edits = tracker.recentEdits(kWindowMs, kMaxRects);
+    // Una edición que se sale del frame (rect de otra resolución)
+    edits.push_back({900, 500, 200, 200});
+
+    vic::pipeline::StreamConfig config{};
+    config.roiCursorRadius = 32;
+    CursorState cursor{};
+    cursor.visible = true;
+    cursor.x = 96;
+    cursor.y = 96;
+    const auto map = buildRoiMap(config, cursor, edits, kWidth, kHeight, kWidth, kHeight);
+    if (map.regions.size() != 4) {
+        return fail("Se esperaban 3 ediciones y el cursor, quedaron " + std::to_string(map.regions.size()));
+    }
+    return expectRegion(map.regions[0], {64, 64, 64, 64, kRoiEditSegment}, "Edición") &&
+           expectRegion(map.regions[1], {960, 576, 40, 24, kRoiEditSegment}, "Edición del borde") &&
+           expectRegion(map.regions[2], {900, 500, 100, 100, kRoiEditSegment}, "Edición recortada") &&
+           expectRegion(map.regions[3], {64, 64, 64, 64, kRoiCursorSegment}, "Cursor sobre la edición") &&
+           (map.deltaQ[kRoiEditSegment] < 0 || fail("La edición debería ganar calidad"));
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Region of interest", {
+        tracksEditedTiles, expiresOldEdits, mapsCursorRegion, mapsEditsBeforeCursor
+    });
+}
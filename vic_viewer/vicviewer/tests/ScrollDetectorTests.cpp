@@ -0,0 +1,155 @@
+// Detector de scroll: un documento que se desplaza bajo una barra fija, una
+// ventana arrastrada sobre un fondo con textura y cambios en el lugar (que no
+// deben producir copy-rects)
+#include "ScrollDetector.h"
+#include "TestPatterns.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::capture::CopyRect;
+using vic::capture::DesktopFrame;
+using vic::capture::ScrollDetector;
+using vic::tests::fail;
+
+// El ancho no es múltiplo de 64: la última franja tiene 10 columnas
+constexpr uint32_t kWidth = 650;
+constexpr uint32_t kHeight = 480;
+constexpr uint32_t kToolbarHeight = 60;
+
+/// Pixel pseudoaleatorio fijo por posición y semilla: cada fila y columna
+/// queda con un hash distinto, como texto o una foto
+uint32_t noise(uint32_t x, uint32_t y, uint32_t seed) {
+    uint32_t h = x * 73856093u ^ y * 19349663u ^ seed * 83492791u;
+    h ^= h >> 15;
+    h *= 2654435761u;
+    h ^= h >> 13;
+    return h | 0xFF000000u;
+}
+
+DesktopFrame blankFrame() {
+    DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 0);
+    return frame;
+}
+
+void setPixel(DesktopFrame& frame, uint32_t x, uint32_t y, uint32_t value) {
+    uint8_t* px = frame.bgraData.data() + (static_cast<size_t>(y) * kWidth + x) * 4;
+    px[0] = static_cast<uint8_t>(value);
+    px[1] = static_cast<uint8_t>(value >> 8);
+    px[2] = static_cast<uint8_t>(value >> 16);
+    px[3] = static_cast<uint8_t>(value >> 24);
+}
+
+/// Barra de herramientas fija arriba y un documento debajo, desplazado
+/// `scroll` filas
+DesktopFrame documentFrame(uint32_t scroll) {
+    auto frame = blankFrame();
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            setPixel(frame, x, y, y < kToolbarHeight ? noise(x, y, 1) : noise(x, y - kToolbarHeight + scroll, 2));
+        }
+    }
+    return frame;
+}
+
+/// Fondo de escritorio con textura y una ventana de 200x128 en (windowX, 128)
+DesktopFrame desktopFrame(uint32_t windowX) {
+    auto frame = blankFrame();
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            const bool window = x >= windowX && x < windowX + 200 && y >= 128 && y < 256;
+            setPixel(frame, x, y, window ? noise(x - windowX, y - 128, 3) : noise(x, y, 4));
+        }
+    }
+    return frame;
+}
+
+std::string describe(const CopyRect& rect) {
+    return std::to_string(rect.srcX) + "," + std::to_string(rect.srcY) + " -> " + std::to_string(rect.dstX) + "," +
+           std::to_string(rect.dstY) + " " + std::to_string(rect.width) + "x" + std::to_string(rect.height);
+}
+
+bool expectRects(const std::vector<CopyRect>& got, const std::vector<CopyRect>& expected, const std::string& step) {
+    if (got.size() != expected.size()) {
+        std::string detail;
+        for (const auto& rect : got) {
+            detail += " [" + describe(rect) + "]";
+        }
+        return fail(step + ": " + std::to_string(got.size()) + " copy-rects, se esperaban " +
+                    std::to_string(expected.size()) + detail);
+    }
+    for (size_t i = 0; i < got.size(); ++i) {
+        const auto& a = got[i];
+        const auto& b = expected[i];
+        if (a.srcX != b.srcX || a.srcY != b.srcY || a.dstX != b.dstX || a.dstY != b.dstY || a.width != b.width ||
+            a.height != b.height) {
+            return fail(step + ": copy-rect " + describe(a) + ", se esperaba " + describe(b));
+        }
+    }
+    return true;
+}
+
+/// Scroll de 40 filas hacia abajo en el documento: lo que estaba en y = 100
+/// pasa a y = 60, en todo el ancho y sin tocar la barra fija
+bool detectsVerticalScroll() {
+    ScrollDetector detector;
+    if (!expectRects(detector.detect(documentFrame(0)), {}, "Primer frame")) {
+        return false;
+    }
+    if (!expectRects(detector.detect(documentFrame(40)), {{0, 100, 0, 60, kWidth, 380}}, "Scroll de 40 filas")) {
+        return false;
+    }
+    // Y de vuelta: hacia arriba el origen queda por encima del destino
+    return expectRects(detector.detect(documentFrame(10)), {{0, 60, 0, 90, kWidth, 390}}, "Scroll de 30 filas arriba");
+}
+
+/// Ventana arrastrada 60 px a la derecha: un solo copy-rect del tamaño de la
+/// ventana (el fondo descubierto no se parece a nada)
+bool detectsWindowMove() {
+    ScrollDetector detector;
+    detector.detect(desktopFrame(100));
+    return expectRects(detector.detect(desktopFrame(160)), {{100, 128, 160, 128, 200, 128}}, "Ventana movida");
+}
+
+/// Sin desplazamiento: frames iguales, un bloque que cambia en el lugar o un
+/// frame tras reset() no producen copy-rects
+bool ignoresChangesInPlace() {
+    ScrollDetector detector;
+    auto frame = documentFrame(0);
+    detector.detect(frame);
+    if (!expectRects(detector.detect(frame), {}, "Frame repetido")) {
+        return false;
+    }
+    for (uint32_t y = 200; y < 300; ++y) {
+        for (uint32_t x = 100; x < 400; ++x) {
+            setPixel(frame, x, y, noise(x, y, 5));
+        }
+    }
+    if (!expectRects(detector.detect(frame), {}, "Bloque reemplazado")) {
+        return false;
+    }
+    detector.reset();
+    if (!expectRects(detector.detect(documentFrame(40)), {}, "Tras reset()")) {
+        return false;
+    }
+    // Otra resolución también olvida el frame anterior
+    DesktopFrame small{};
+    small.width = 320;
+    small.height = 240;
+    small.bgraData.assign(static_cast<size_t>(320) * 240 * 4, 128);
+    return expectRects(detector.detect(small), {}, "Cambio de resolución");
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Scroll detector", {
+        detectsVerticalScroll, detectsWindowMove, ignoresChangesInPlace
+    });
+}
@@ -0,0 +1,208 @@
+// Governor de velocidad del encoder: 30 frames entre ajustes, más hilos antes
+// que un preset más rápido, calidad primero con margen, quitar hilos solo si
+// el uso estimado queda bajo el 70 % y los límites de cpu-used/particiones
+#include "SpeedGovernor.h"
+#include "TestPatterns.h"
+
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using vic::encoder::EncoderSpeedState;
+using vic::encoder::SpeedGovernor;
+using vic::encoder::SpeedGovernorLimits;
+using vic::tests::fail;
+
+constexpr uint32_t kBudgetUs = 33'333;        // 30 fps
+constexpr uint32_t kSettleFrames = 30;
+
+uint32_t encodeUs(double utilisation) {
+    return static_cast<uint32_t>(utilisation * kBudgetUs);
+}
+
+/// Frames con el mismo tiempo de encode hasta el próximo ajuste (0 = ninguno
+/// en cuatro períodos)
+uint32_t framesUntilChange(SpeedGovernor& governor, double utilisation) {
+    for (uint32_t frame = 1; frame <= 4 * kSettleFrames; ++frame) {
+        if (governor.observe(encodeUs(utilisation))) {
+            return frame;
+        }
+    }
+    return 0;
+}
+
+std::string describe(const EncoderSpeedState& state) {
+    return "cpu-used " + std::to_string(state.cpuUsed) + ", " + std::to_string(state.threads) + " hilos, particiones " +
+           std::to_string(state.tokenPartitions);
+}
+
+bool expectState(const SpeedGovernor& governor, int cpuUsed, uint32_t threads, const std::string& step) {
+    const auto& state = governor.state();
+    if (state.cpuUsed != cpuUsed || state.threads != threads) {
+        return fail(step + ": se esperaba cpu-used " + std::to_string(cpuUsed) + " con " + std::to_string(threads) +
+                    " hilos y quedó " + describe(state));
+    }
+    return true;
+}
+
+/// Un período completo hasta el ajuste y el estado que deja
+bool expectPeriod(SpeedGovernor& governor, double utilisation, int cpuUsed, uint32_t threads, const std::string& step) {
+    const uint32_t frames = framesUntilChange(governor, utilisation);
+    if (frames != kSettleFrames) {
+        return fail(step + ": ajustó a los " + std::to_string(frames) + " frames (" + describe(governor.state()) + ")");
+    }
+    return expectState(governor, cpuUsed, threads, step);
+}
+
+SpeedGovernorLimits vp8Limits() {
+    SpeedGovernorLimits limits;
+    limits.minCpuUsed = 4;
+    limits.maxCpuUsed = 16;
+    limits.maxThreads = 4;
+    limits.tokenPartitions = true;
+    limits.minTokenPartitions = 1;
+    return limits;
+}
+
+bool disabledWithoutBudget() {
+    SpeedGovernor governor;
+    governor.configure(0, vp8Limits(), {10, 1, 0, 0.0});
+    for (uint32_t i = 0; i < 3 * kSettleFrames; ++i) {
+        if (governor.observe(encodeUs(3.0))) {
+            return fail("Sin presupuesto el governor no debería ajustar nada");
+        }
+    }
+    return !governor.enabled() || fail("Presupuesto 0 debería desactivarlo");
+}
+
+bool clampsInitialState() {
+    SpeedGovernor governor;
+    governor.configure(kBudgetUs, vp8Limits(), {40, 12, 0, 0.0});
+    if (!expectState(governor, 16, 4, "Estado inicial fuera de los límites")) {
+        return false;
+    }
+    governor.configure(kBudgetUs, vp8Limits(), {1, 0, 0, 0.0});
+    return expectState(governor, 4, 1, "Estado inicial por debajo de los límites");
+}
+
+/// Pasado de presupuesto: hilos primero, luego cpu-used de a 2 (o de a 1
+/// entre el 85 % y el 100 %) hasta el máximo del codec, un paso por período
+bool speedsUpWhenOverBudget() {
+    SpeedGovernor governor;
+    governor.configure(kBudgetUs, vp8Limits(), {10, 2, 0, 0.0});
+    const struct {
+        double utilisation;
+        int cpuUsed;
+        uint32_t threads;
+        const char* step;
+    } steps[] = {
+        {1.2, 10, 3, "Primer ajuste: un hilo más"},
+        {1.2, 10, 4, "Segundo ajuste: otro hilo"},
+        {1.2, 12, 4, "Sin hilos libres: cpu-used de a 2"},
+        {0.9, 13, 4, "Entre el 85 % y el 100 %: de a 1"},
+        {1.2, 15, 4, "Otro paso de a 2"},
+        {1.2, 16, 4, "Tope de cpu-used"},
+    };
+    for (const auto& step : steps) {
+        if (!expectPeriod(governor, step.utilisation, step.cpuUsed, step.threads, step.step)) {
+            return false;
+        }
+    }
+    return framesUntilChange(governor, 1.2) == 0 || fail("Ajustó de nuevo con todo al máximo");
+}
+
+/// Con margen: primero calidad (cpu-used hasta el mínimo); después quita un
+/// hilo solo si el uso estimado con uno menos queda bajo el 70 %
+bool spendsMarginOnQuality() {
+    SpeedGovernor governor;
+    governor.configure(kBudgetUs, vp8Limits(), {6, 4, 0, 0.0});
+    if (framesUntilChange(governor, 0.6) != 0) {
+        return fail("Entre el 50 % y el 85 % no debería tocar nada");
+    }
+    // Tras un período quieto reacciona apenas el promedio móvil cruza el 50 %
+    const uint32_t frames = framesUntilChange(governor, 0.45);
+    if (frames == 0 || frames >= kSettleFrames) {
+        return fail("Con margen tras un período quieto ajustó a los " + std::to_string(frames) + " frames");
+    }
+    if (!expectState(governor, 5, 4, "Margen: mejor calidad")) {
+        return false;
+    }
+    // 0.45 * 4/3 = 0.6 y 0.45 * 3/2 = 0.675 quedan bajo el 70 %; con dos
+    // hilos 0.45 * 2 = 0.9 no
+    if (!expectPeriod(governor, 0.45, 4, 4, "Calidad al mínimo") ||
+        !expectPeriod(governor, 0.45, 4, 3, "Devolver un hilo") ||
+        !expectPeriod(governor, 0.45, 4, 2, "Devolver otro hilo")) {
+        return false;
+    }
+    if (framesUntilChange(governor, 0.45) != 0) {
+        return fail("Quitó un hilo aunque el uso estimado pasaba el 70 %: " + describe(governor.state()));
+    }
+    return true;
+}
+
+/// Un ajuste reinicia el período: el siguiente no llega antes de 30 frames
+bool waitsBetweenChanges() {
+    SpeedGovernor governor;
+    governor.configure(kBudgetUs, vp8Limits(), {10, 4, 0, 0.0});
+    for (uint32_t i = 1; i < kSettleFrames; ++i) {
+        if (governor.observe(encodeUs(2.0))) {
+            return fail("Ajustó en el frame " + std::to_string(i) + ", antes del período");
+        }
+    }
+    if (!governor.observe(encodeUs(2.0)) || framesUntilChange(governor, 2.0) != kSettleFrames) {
+        return fail("No ajustó exactamente al cumplir cada período");
+    }
+    // Un pico aislado apenas mueve el promedio móvil
+    SpeedGovernor smooth;
+    smooth.configure(kBudgetUs, vp8Limits(), {10, 4, 0, 0.0});
+    for (uint32_t i = 1; i < kSettleFrames; ++i) {
+        smooth.observe(encodeUs(0.6));
+    }
+    if (smooth.observe(encodeUs(2.5)) || smooth.state().utilisation > 0.85) {
+        return fail("Un solo frame lento no debería cambiar el preset");
+    }
+    return true;
+}
+
+bool pinnedThreadsStayFixed() {
+    SpeedGovernor governor;
+    governor.configure(kBudgetUs, vp8Limits(), {10, 2, 0, 0.0});
+    governor.pinThreads(2);
+    if (!expectPeriod(governor, 1.2, 12, 2, "Hilos fijos, pasado de presupuesto")) {
+        return false;
+    }
+    governor.configure(kBudgetUs, vp8Limits(), {4, 3, 0, 0.0});
+    governor.pinThreads(3);
+    if (framesUntilChange(governor, 0.2) != 0) {
+        return fail("Quitó un hilo fijado: " + describe(governor.state()));
+    }
+    return true;
+}
+
+/// Una partición por hilo (log2), sin bajar del mínimo por resolución y
+/// nunca en VP9
+bool matchesTokenPartitions() {
+    SpeedGovernor governor;
+    auto limits = vp8Limits();
+    limits.maxThreads = 8;
+    const std::pair<uint32_t, uint32_t> expected[] = {{1, 1}, {2, 1}, {3, 1}, {4, 2}, {7, 2}, {8, 3}};
+    for (const auto& [threads, partitions] : expected) {
+        governor.configure(kBudgetUs, limits, {10, threads, 0, 0.0});
+        if (governor.state().tokenPartitions != partitions) {
+            return fail("Con " + std::to_string(threads) + " hilos: " + describe(governor.state()));
+        }
+    }
+    limits.tokenPartitions = false;
+    governor.configure(kBudgetUs, limits, {8, 8, 0, 0.0});
+    return governor.state().tokenPartitions == 0 || fail("VP9 no particiona tokens");
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Speed governor", {
+        disabledWithoutBudget, clampsInitialState, speedsUpWhenOverBudget, spendsMarginOnQuality,
+        waitsBetweenChanges, pinnedThreadsStayFixed, matchesTokenPartitions
+    });
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Compartido por los tests y benchmarks: contenido sintético (glifos de texto
+// sobre un buffer BGRA, PSNR sobre el canal verde) y el esqueleto de los tests
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace vic::tests {
+
+/// Glifo de 7x12 (tinta 24 sobre fondo 255) en (x, y) de un buffer BGRA de
+/// `width` pixels de ancho. El patrón depende solo de `seed`
+inline void drawGlyph(std::vector<uint8_t>& bgra, uint32_t width, uint32_t x, uint32_t y, uint32_t seed) {
+    for (uint32_t row = 0; row < 12; ++row) {
+        for (uint32_t col = 0; col < 7; ++col) {
+            uint8_t* px = bgra.data() + (static_cast<size_t>(y + row) * width + x + col) * 4;
+            const uint8_t value = (((seed * 2654435761u) >> ((row * 7 + col) % 32)) & 1u) ? 24 : 255;
+            px[0] = px[1] = px[2] = value;
+        }
+    }
+}
+
+/// PSNR del canal verde (aproxima la luma); 99 dB si son idénticos
+inline double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        const double diff = static_cast<double>(a[i + 1]) - static_cast<double>(b[i + 1]);
+        sum += diff * diff;
+    }
+    const double mse = sum / (static_cast<double>(a.size()) / 4.0);
+    return mse <= 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+/// Reportar un chequeo fallido; devuelve false para usarlo como `return fail(...)`
+inline bool fail(const std::string& message) {
+    std::cerr << message << std::endl;
+    return false;
+}
+
+/// main() de un test: corre los casos en orden hasta el primero que falla.
+/// 0 e imprime "<name> test passed" si pasan todos
+inline int runTests(const std::string& name, std::initializer_list<std::function<bool()>> tests) {
+    for (const auto& test : tests) {
+        if (!test()) {
+            return 1;
+        }
+    }
+    std::cout << name << " test passed" << std::endl;
+    return 0;
+}
+
+} // namespace vic::tests
@@ -0,0 +1,130 @@
+// Buzón de tres buffers (decoder -> render): sin publicaciones no hay frame,
+// leer dos veces sin publicar no cambia nada, gana el más nuevo y con los dos
+// hilos en paralelo nunca se lee un buffer a medio escribir ni uno más viejo
+#include "TripleBuffer.h"
+#include "TestPatterns.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace {
+
+using vic::TripleBuffer;
+using vic::tests::fail;
+
+/// Frame con todas sus palabras iguales al id: una lectura rota se nota
+struct Frame {
+    uint64_t id{};
+    std::array<uint64_t, 1024> words{};
+};
+
+void fill(Frame& frame, uint64_t id) {
+    frame.id = id;
+    frame.words.fill(id);
+}
+
+bool intact(const Frame& frame) {
+    for (const uint64_t word : frame.words) {
+        if (word != frame.id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool emptyUntilPublished() {
+    TripleBuffer<Frame> mailbox;
+    if (mailbox.hasFrame() || mailbox.acquireLatest()) {
+        return fail("Sin publicaciones no debería haber frame");
+    }
+    fill(mailbox.writeBuffer(), 1);
+    mailbox.publish();
+    if (!mailbox.acquireLatest() || !mailbox.hasFrame() || mailbox.readBuffer().id != 1) {
+        return fail("El frame publicado no llegó al consumidor");
+    }
+    // Sin publicaciones nuevas: false y el mismo buffer
+    const Frame* read = &mailbox.readBuffer();
+    if (mailbox.acquireLatest() || &mailbox.readBuffer() != read || read->id != 1 || !mailbox.hasFrame()) {
+        return fail("Sin publicaciones nuevas acquireLatest() cambió el buffer de lectura");
+    }
+    return true;
+}
+
+/// Varias publicaciones sin leer: solo se ve la última. El buffer de escritura
+/// nunca es el que está leyendo el consumidor
+bool latestWins() {
+    TripleBuffer<Frame> mailbox;
+    uint64_t id = 0;
+    for (int round = 0; round < 50; ++round) {
+        const int burst = 1 + round % 4;
+        for (int i = 0; i < burst; ++i) {
+            fill(mailbox.writeBuffer(), ++id);
+            mailbox.publish();
+            if (mailbox.hasFrame() && &mailbox.writeBuffer() == &mailbox.readBuffer()) {
+                return fail("El productor recibió el buffer que está leyendo el consumidor");
+            }
+        }
+        if (!mailbox.acquireLatest() || mailbox.readBuffer().id != id || !intact(mailbox.readBuffer())) {
+            return fail("Tras " + std::to_string(burst) + " publicaciones se leyó el frame " +
+                        std::to_string(mailbox.readBuffer().id) + " en lugar del " + std::to_string(id));
+        }
+        if (&mailbox.writeBuffer() == &mailbox.readBuffer()) {
+            return fail("Tras leer, el productor comparte buffer con el consumidor");
+        }
+    }
+    return true;
+}
+
+/// Productor y consumidor en paralelo: cada lectura está entera y los ids
+/// nunca retroceden; el último publicado siempre termina llegando
+bool noTornReadsConcurrently() {
+    constexpr uint64_t kFrames = 100000;
+    TripleBuffer<Frame> mailbox;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint64_t id = 1; id <= kFrames; ++id) {
+            fill(mailbox.writeBuffer(), id);
+            mailbox.publish();
+        }
+        done = true;
+    });
+
+    uint64_t lastId = 0;
+    uint64_t reads = 0;
+    std::string error;
+    while (error.empty()) {
+        const bool finished = done.load();
+        if (mailbox.acquireLatest()) {
+            const Frame& frame = mailbox.readBuffer();
+            ++reads;
+            if (!intact(frame)) {
+                error = "Frame " + std::to_string(frame.id) + " leído a medio escribir";
+            } else if (frame.id <= lastId) {
+                error = "Se leyó el frame " + std::to_string(frame.id) + " después del " + std::to_string(lastId);
+            }
+            lastId = frame.id;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+    if (!error.empty()) {
+        return fail(error);
+    }
+    if (lastId != kFrames || reads == 0) {
+        return fail("El último frame leído fue " + std::to_string(lastId) + " de " + std::to_string(kFrames));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Triple buffer", {
+        emptyUntilPublished, latestWins, noTornReadsConcurrently
+    });
+}
@@ -1,11 +1,48 @@
 #include "VideoDecoder.h"
 #include "VideoEncoder.h"
 #include "DesktopFrame.h"
+#include "OffscreenRenderer.h"
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <limits>
+#include <vector>
+
+namespace {
+
+// Buffer del "renderer" con filas más anchas que el frame (como una textura mapeada)
+class PaddedSink final : public vic::decoder::FrameSink {
+public:
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        stride = static_cast<size_t>(info.width) * 4 + 64;
+        pixels.assign(stride * info.height, 0);
+        return {pixels.data(), stride};
+    }
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        committed = info;
+        ++commits;
+    }
+
+    // Mismos pixels que un frame de decode()
+    bool matches(const vic::capture::DesktopFrame& frame) const {
+        const size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+        for (uint32_t row = 0; row < frame.height; ++row) {
+            if (std::memcmp(pixels.data() + row * stride, frame.bgraData.data() + row * rowBytes, rowBytes) != 0) {
+                return false;
+            }
+        }
+        return committed.width == frame.width && committed.height == frame.height;
+    }
+
+    std::vector<uint8_t> pixels;
+    size_t stride{};
+    vic::decoder::DecodedFrameInfo committed{};
+    int commits{};
+};
+
+} // namespace
 
 int main() {
     vic::capture::DesktopFrame frame{};
@@ -31,7 +68,12 @@ int main() {
         return 1;
     }
 
-    auto decoder = vic::decoder::createVp8Decoder();
+    // El viewer elige el decoder por el codec del stream
+    auto decoder = vic::decoder::createDecoder(encoded->codec);
+    if (!decoder) {
+        std::cerr << "No decoder for codec " << vic::encoder::codecName(encoded->codec) << std::endl;
+        return 1;
+    }
     decoder->configure(frame.width, frame.height);
     auto decoded = decoder->decode(*encoded);
     if (!decoded) {
@@ -59,6 +101,97 @@ int main() {
         std::cerr << "PSNR too low: " << psnr << " dB (continuing for MVP)" << std::endl;
     }
 
+    // Negociación: el host elige el codec más barato que el viewer decodifica
+    const vic::encoder::CodecCapability hostCodecs[] = {
+        {vic::encoder::VideoCodec::H264, vic::encoder::kH264High},
+        {vic::encoder::VideoCodec::Vp8, vic::encoder::kProfile0},
+        {vic::encoder::VideoCodec::Vp9, vic::encoder::kProfile0},
+    };
+    const auto viewerCodecs = vic::decoder::decoderCapabilities();
+    const auto negotiated = vic::encoder::negotiateCodec(hostCodecs, viewerCodecs);
+    if (!negotiated || negotiated->codec != vic::encoder::VideoCodec::Vp8) {
+        std::cerr << "Codec negotiation did not pick VP8" << std::endl;
+        return 1;
+    }
+    const vic::encoder::CodecCapability h264Only[] = {{vic::encoder::VideoCodec::H264, vic::encoder::kH264High}};
+    if (vic::encoder::negotiateCodec(h264Only, viewerCodecs)) {
+        std::cerr << "Codec negotiation accepted a codec the viewer cannot decode" << std::endl;
+        return 1;
+    }
+
+    // Tiles: dos columnas codificadas por separado y unidas en el viewer
+    vic::capture::DesktopFrame wide{};
+    wide.width = 256;
+    wide.height = 64;
+    wide.bgraData.resize(static_cast<size_t>(wide.width) * wide.height * 4);
+    for (size_t i = 0; i < wide.bgraData.size(); ++i) {
+        wide.bgraData[i] = static_cast<uint8_t>((i * 7) & 0xFF);
+    }
+    auto tiledEncoder = vic::encoder::createTiledEncoder(vic::encoder::VideoCodec::Vp8, 2, vic::encoder::TileSplit::Vertical);
+    auto tiled = tiledEncoder->EncodeFrame(wide);
+    if (!tiled || tiled->tiles.size() != 2 || !tiled->keyFrame) {
+        std::cerr << "Tiled encoder did not produce two key tiles" << std::endl;
+        return 1;
+    }
+    auto tiledDecoder = vic::decoder::createTiledDecoder(tiled->codec);
+    auto stitched = tiledDecoder ? tiledDecoder->decode(*tiled) : std::nullopt;
+    if (!stitched || stitched->width != wide.width || stitched->height != wide.height) {
+        std::cerr << "Tiled decoder failed to stitch the frame" << std::endl;
+        return 1;
+    }
+
+    // decodeInto: mismos pixels que decode(), escritos en el buffer del renderer
+    auto directDecoder = vic::decoder::createDecoder(encoded->codec);
+    PaddedSink directSink;
+    if (!directDecoder->decodeInto(*encoded, directSink) || directSink.commits != 1 || !directSink.matches(*decoded)) {
+        std::cerr << "decodeInto did not match decode()" << std::endl;
+        return 1;
+    }
+    // decodeOnly + convertLatest: la imagen se convierte una sola vez
+    auto deferredDecoder = vic::decoder::createDecoder(encoded->codec);
+    PaddedSink deferredSink;
+    if (!deferredDecoder->decodeOnly(*encoded) || !deferredDecoder->convertLatest(deferredSink) ||
+        deferredDecoder->convertLatest(deferredSink) || !deferredSink.matches(*decoded)) {
+        std::cerr << "decodeOnly/convertLatest did not match decode()" << std::endl;
+        return 1;
+    }
+    auto tiledDirectDecoder = vic::decoder::createTiledDecoder(tiled->codec);
+    PaddedSink tiledSink;
+    if (!tiledDirectDecoder->decodeInto(*tiled, tiledSink) || tiledSink.commits != 1 || !tiledSink.matches(*stitched)) {
+        std::cerr << "Tiled decodeInto did not match decode()" << std::endl;
+        return 1;
+    }
+
+    // Renderer offscreen: 1:1 copia el frame; escalado determinista (mismo checksum)
+    auto sameSize = vic::ui::CreateOffscreenRenderer();
+    sameSize->Initialize(nullptr);
+    sameSize->RenderFrame(*decoded);
+    sameSize->Present();
+    if (sameSize->surface().bgraData != decoded->bgraData) {
+        std::cerr << "Offscreen renderer altered an unscaled frame" << std::endl;
+        return 1;
+    }
+    vic::ui::OffscreenRendererConfig checksumConfig{};
+    checksumConfig.filter = vic::ui::ScaleFilter::Area;
+    checksumConfig.computeChecksum = true;
+    uint64_t checksums[2] = {};
+    for (auto& checksum : checksums) {
+        auto scaled = vic::ui::CreateOffscreenRenderer(checksumConfig);
+        scaled->Initialize(nullptr);
+        scaled->Resize(decoded->width / 2, decoded->height / 2);
+        scaled->RenderFrame(*decoded);
+        scaled->Present();
+        if (scaled->surface().width != decoded->width / 2 || scaled->stats().framesRendered != 1) {
+            std::cerr << "Offscreen renderer did not scale to the target size" << std::endl;
+            return 1;
+        }
+        checksum = scaled->lastChecksum();
+    }
+    if (checksums[0] == 0 || checksums[0] != checksums[1]) {
+        std::cerr << "Offscreen renderer checksum is not deterministic" << std::endl;
+        return 1;
+    }
+
     std::cout << "Encode/Decode test passed" << std::endl;
     return 0;
 }
@@ -0,0 +1,225 @@
+// Reparto a varios viewers: el mismo frame compartido en cada cola, cola
+// llena que se vacía sin afectar a los demás, ráfaga GOP y primera imagen,
+// capa temporal bajo congestión, capa de simulcast y recuperación combinada
+// entre viewers
+#include "LayerAdaptation.h"
+#include "SendQueue.h"
+#include "TestPatterns.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vic::pipeline::SendQueue;
+using vic::pipeline::SimulcastLayerPolicy;
+using vic::pipeline::TemporalLayerAdapter;
+using vic::tests::fail;
+using namespace std::chrono_literals;
+
+SendQueue::FramePtr makeFrame(bool keyFrame, uint32_t frameId) {
+    auto frame = std::make_shared<vic::encoder::EncodedFrame>();
+    frame->keyFrame = keyFrame;
+    frame->frameId = frameId;
+    frame->payload.assign(1000, 0);
+    return frame;
+}
+
+/// Un frame codificado una vez llega a cada cola sin copiarse; el viewer que
+/// no consume se vacía solo y los demás no pierden nada
+bool sharesFramesAcrossViewers() {
+    SendQueue fast;
+    SendQueue slow;
+    const auto key = makeFrame(true, 1);
+    fast.push(key);
+    slow.push(key);
+    if (fast.pop()->frame.get() != key.get()) {
+        return fail("El frame encolado no es el compartido");
+    }
+
+    bool overflowed = false;
+    for (uint32_t id = 2; id < 2 + SendQueue::kMaxLive; ++id) {
+        const auto frame = makeFrame(false, id);
+        if (fast.push(frame) != SendQueue::PushResult::Queued) {
+            return fail("El viewer al día descartó el frame " + std::to_string(id));
+        }
+        fast.pop();
+        overflowed = slow.push(frame) == SendQueue::PushResult::Overflowed || overflowed;
+    }
+    if (!overflowed || slow.size() != 1) {
+        return fail("La cola del viewer lento no se vació al llenarse");
+    }
+    // Enviado por uno y descartado por el otro: nadie más lo retiene
+    if (key.use_count() != 1) {
+        return fail("Referencias inesperadas al keyframe: " + std::to_string(key.use_count()));
+    }
+    return true;
+}
+
+bool waitsForKeyframe() {
+    SendQueue queue;
+    if (queue.push(makeFrame(false, 1)) != SendQueue::PushResult::AwaitingKeyframe || !queue.empty()) {
+        return fail("Se encoló un delta antes del keyframe");
+    }
+    queue.awaitKeyframe(true);
+    queue.push(makeFrame(true, 2));
+    queue.push(makeFrame(false, 3));
+    const auto first = queue.pop();
+    if (!first || !first->joined || first->burst || first->liveDepth != 1) {
+        return fail("El keyframe no completó la primera imagen");
+    }
+    if (queue.pop()->joined) {
+        return fail("La primera imagen se contó dos veces");
+    }
+    return true;
+}
+
+/// La ráfaga GOP no cuenta para el límite de la cola y la primera imagen
+/// se completa con su último frame
+bool burstThenLive() {
+    SendQueue queue;
+    std::vector<SendQueue::FramePtr> gop = {makeFrame(true, 1)};
+    for (uint32_t id = 2; id <= 20; ++id) {
+        gop.push_back(makeFrame(false, id));
+    }
+    if (queue.prime({makeFrame(false, 99)}) || !queue.prime(gop)) {
+        return fail("prime() aceptó una caché sin keyframe o rechazó una válida");
+    }
+    for (uint32_t id = 21; id < 21 + SendQueue::kMaxLive + 4; ++id) {
+        if (queue.push(makeFrame(false, id)) != SendQueue::PushResult::Queued) {
+            return fail("El vivo detrás de la ráfaga se descartó con la cola corta");
+        }
+    }
+    for (size_t i = 0; i < gop.size(); ++i) {
+        const auto entry = queue.pop();
+        if (!entry->burst || entry->joined != (i + 1 == gop.size())) {
+            return fail("Frame " + std::to_string(i) + " de la ráfaga mal contado");
+        }
+    }
+    const auto live = queue.pop();
+    if (live->burst || live->frame->frameId != 21) {
+        return fail("El vivo no sigue a la ráfaga en orden");
+    }
+    return true;
+}
+
+bool adaptsTemporalLayer() {
+    TemporalLayerAdapter adapter;
+    const auto t0 = std::chrono::steady_clock::time_point{} + 1h;
+    adapter.reset(3, t0);
+    const size_t congestedBytes = TemporalLayerAdapter::kCongestedBufferedBytes + 1;
+
+    struct Step {
+        std::chrono::milliseconds at;
+        size_t depth;
+        size_t buffered;
+        int expected;       // -1 = sin cambio
+    };
+    const Step steps[] = {
+        {100ms, TemporalLayerAdapter::kCongestedQueueDepth, 0, -1},   // Muy pronto tras el arranque
+        {600ms, TemporalLayerAdapter::kCongestedQueueDepth, 0, 1},
+        {800ms, 0, congestedBytes, -1},                               // Menos de 500 ms desde el cambio
+        {1200ms, 0, congestedBytes, 0},
+        {1500ms, 0, congestedBytes, -1},                              // Ya en la capa base
+        {3000ms, 0, 0, -1},                                           // Menos de 3 s sin congestión
+        {4600ms, 0, 0, 1},
+        {6000ms, 0, 0, -1},
+        {7700ms, 0, 0, 2},
+        {20000ms, 0, 0, -1},                                          // Ya en la capa más alta
+    };
+    for (const auto& step : steps) {
+        const auto layer = adapter.update(step.depth, step.buffered, t0 + step.at);
+        if (layer.has_value() != (step.expected >= 0) || (layer && *layer != step.expected)) {
+            return fail("Capa temporal inesperada a los " + std::to_string(step.at.count()) + " ms");
+        }
+    }
+    adapter.reset(1, t0);
+    if (adapter.update(10, congestedBytes, t0 + 1s) || adapter.maxLayer() != 0) {
+        return fail("Con una sola capa no hay nada que bajar");
+    }
+    return true;
+}
+
+/// Baja con el enlace corto; sube solo de prueba, y una prueba que cae
+/// enseguida duplica la espera de la siguiente
+bool switchesSimulcastLayer() {
+    constexpr double kFullKbps = 4000;
+    constexpr uint8_t kFull = SimulcastLayerPolicy::kFullLayer;
+    constexpr uint8_t kLow = SimulcastLayerPolicy::kLowLayer;
+    const auto t0 = std::chrono::steady_clock::time_point{} + 1h;
+    SimulcastLayerPolicy policy(t0);
+
+    if (policy.evaluate(kFull, 0, kFullKbps, t0 + 1s) || policy.evaluate(kFull, 5000, kFullKbps, t0 + 2s)) {
+        return fail("Bajó de capa con el enlace holgado");
+    }
+    if (policy.evaluate(kFull, 4500, kFullKbps, t0 + 3s) != kLow) {
+        return fail("No bajó con el enlace por debajo de 1.2x la capa completa");
+    }
+    // En la capa reducida un cuello de botella medido no habilita la prueba
+    if (policy.evaluate(kLow, 0, kFullKbps, t0 + 12s) || policy.evaluate(kLow, 300, kFullKbps, t0 + 14s)) {
+        return fail("Subió de capa antes de tiempo o con el enlace limitando");
+    }
+    if (policy.evaluate(kLow, 0, kFullKbps, t0 + 13s + SimulcastLayerPolicy::kProbeAfter) != kFull) {
+        return fail("No probó la capa completa tras la espera");
+    }
+
+    // Dos pruebas que caen enseguida: 10 s -> 20 s -> 40 s
+    auto now = t0 + 23s;
+    for (const auto expected : {std::chrono::seconds(20), std::chrono::seconds(40)}) {
+        if (policy.evaluate(kFull, 3000, kFullKbps, now + 2s) != kLow || policy.probeAfter() != expected) {
+            return fail("La prueba fallida no duplicó la espera");
+        }
+        now += 2s;
+        if (policy.evaluate(kLow, 0, kFullKbps, now + expected - 1s) ||
+            policy.evaluate(kLow, 0, kFullKbps, now + expected) != kFull) {
+            return fail("La prueba no respetó la espera duplicada");
+        }
+        now += expected;
+    }
+
+    // Una prueba que aguanta vuelve a la espera corta para la próxima caída
+    if (policy.evaluate(kFull, 0, kFullKbps, now + SimulcastLayerPolicy::kFailedProbe) ||
+        policy.evaluate(kFull, 3000, kFullKbps, now + 60s) != kLow ||
+        policy.probeAfter() != SimulcastLayerPolicy::kProbeAfter) {
+        return fail("Tras una prueba exitosa la espera no volvió a 10 s");
+    }
+    for (int i = 0; i < 10; ++i) {
+        now += 200s;
+        policy.evaluate(kLow, 0, kFullKbps, now);
+        policy.evaluate(kFull, 3000, kFullKbps, now + 1s);
+    }
+    if (policy.probeAfter() != SimulcastLayerPolicy::kMaxProbeAfter) {
+        return fail("La espera entre pruebas no se limitó a 80 s");
+    }
+    return true;
+}
+
+bool combinesRecoveryRequests() {
+    using vic::transport::RecoveryRequest;
+    if (!vic::pipeline::commonIntactFrames({}).empty()) {
+        return fail("Sin pedidos no hay long-term en común");
+    }
+    const auto single = vic::pipeline::commonIntactFrames({RecoveryRequest{10, 4, 0}});
+    if (single != std::vector<uint32_t>{4}) {
+        return fail("Un pedido: se esperaba solo su golden (altref 0 no cuenta)");
+    }
+    const auto shared = vic::pipeline::commonIntactFrames({{10, 4, 8}, {12, 8, 6}, {11, 9, 8}});
+    if (shared != std::vector<uint32_t>{8}) {
+        return fail("El long-term en común de los tres viewers es el 8");
+    }
+    if (!vic::pipeline::commonIntactFrames({{10, 4, 8}, {12, 5, 6}}).empty()) {
+        return fail("Sin long-term en común se esperaba caer a keyframe");
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    return vic::tests::runTests("Viewer fan-out", {
+        sharesFramesAcrossViewers, waitsForKeyframe, burstThenLive, adaptsTemporalLayer,
+        switchesSimulcastLayer, combinesRecoveryRequests
+    });
+}
@@ -0,0 +1,154 @@
+// Burst benchmark: CPU del viewer cuando los frames llegan en ráfagas (jitter
+// de red, UI ocupada). Compara convertir a BGRA cada frame decodificado contra
+// decodeOnly() para los que ya tienen uno más nuevo detrás y convertir solo el
+// último de cada ráfaga (lo que hace el hilo de decode de ViewerSession)
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+constexpr uint32_t kWidth = 1920;
+constexpr uint32_t kHeight = 1080;
+constexpr uint32_t kBitrateKbps = 6000;
+constexpr int kFrames = 240;
+// Frames que llegan juntos en cada ráfaga (se repite el patrón)
+constexpr size_t kBurstPattern[] = {1, 1, 4, 1, 2, 6, 1, 3, 1, 8};
+
+// Buffer del renderer: el contenido del último frame presentado
+class RenderSink final : public vic::decoder::FrameSink {
+public:
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        pixels.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {pixels.data(), static_cast<size_t>(info.width) * 4};
+    }
+    void commit(const vic::decoder::DecodedFrameInfo&) override {
+        ++presented;
+    }
+
+    std::vector<uint8_t> pixels;
+    int presented{};
+};
+
+struct RunResult {
+    double cpuMs{};
+    double wallMs{};
+    int presented{};
+    std::vector<uint8_t> lastFrame;
+};
+
+// Video que se desplaza: cada frame cambia casi todos los pixels
+std::vector<vic::encoder::EncodedFrame> encodeClip() {
+    std::vector<vic::encoder::EncodedFrame> clip;
+    auto encoder = vic::encoder::createVp8Encoder();
+    if (!encoder || !encoder->Configure(kWidth, kHeight, kBitrateKbps)) {
+        return clip;
+    }
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.resize(static_cast<size_t>(kWidth) * kHeight * 4);
+    for (int i = 0; i < kFrames; ++i) {
+        frame.timestamp = static_cast<uint64_t>(i) * 16;
+        for (uint32_t y = 0; y < kHeight; ++y) {
+            uint8_t* row = frame.bgraData.data() + static_cast<size_t>(y) * kWidth * 4;
+            for (uint32_t x = 0; x < kWidth; ++x) {
+                row[x * 4 + 0] = static_cast<uint8_t>(x + i * 3);
+                row[x * 4 + 1] = static_cast<uint8_t>(y + i * 2);
+                row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) + i);
+                row[x * 4 + 3] = 255;
+            }
+        }
+        auto encoded = encoder->EncodeFrame(frame);
+        if (encoded) {
+            clip.push_back(std::move(*encoded));
+        }
+    }
+    return clip;
+}
+
+RunResult run(const std::vector<vic::encoder::EncodedFrame>& clip, bool convertLatestOnly) {
+    RunResult result{};
+    auto decoder = vic::decoder::createVp8Decoder();
+    RenderSink sink;
+
+    const std::clock_t cpuStart = std::clock();
+    const auto wallStart = Clock::now();
+    size_t next = 0;
+    size_t burst = 0;
+    while (next < clip.size()) {
+        const size_t count = std::min(kBurstPattern[burst++ % std::size(kBurstPattern)], clip.size() - next);
+        for (size_t i = 0; i < count; ++i) {
+            const auto& frame = clip[next + i];
+            if (convertLatestOnly && i + 1 < count) {
+                decoder->decodeOnly(frame);
+            } else {
+                decoder->decodeInto(frame, sink);
+            }
+        }
+        next += count;
+    }
+    result.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+    result.cpuMs = 1000.0 * static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    result.presented = sink.presented;
+    result.lastFrame = std::move(sink.pixels);
+    return result;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=======================================================" << std::endl;
+    std::cout << "  VicViewer Burst Benchmark (decodeOnly + convertLatest)" << std::endl;
+    std::cout << "=======================================================" << std::endl;
+
+    const auto clip = encodeClip();
+    if (clip.size() != static_cast<size_t>(kFrames)) {
+        std::cerr << "Error: no se pudo encodear el clip de prueba" << std::endl;
+        return 1;
+    }
+
+    size_t bursts = 0;
+    for (size_t next = 0; next < clip.size(); ++bursts) {
+        next += kBurstPattern[bursts % std::size(kBurstPattern)];
+    }
+    std::cout << kFrames << " frames " << kWidth << "x" << kHeight << " en " << bursts << " ráfagas" << std::endl;
+
+    const auto every = run(clip, false);
+    const auto latest = run(clip, true);
+
+    std::cout << "\n" << std::string(64, '=') << std::endl;
+    std::cout << std::left << std::setw(24) << "Modo"
+              << std::setw(12) << "CPU (ms)"
+              << std::setw(12) << "Wall (ms)"
+              << std::setw(12) << "Presentados" << std::endl;
+    std::cout << std::string(64, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(24) << "Convertir todos"
+              << std::setw(12) << every.cpuMs << std::setw(12) << every.wallMs << every.presented << std::endl;
+    std::cout << std::left << std::setw(24) << "Solo el más nuevo"
+              << std::setw(12) << latest.cpuMs << std::setw(12) << latest.wallMs << latest.presented << std::endl;
+    std::cout << std::string(64, '=') << std::endl;
+
+    const double saved = every.cpuMs > 0 ? 100.0 * (every.cpuMs - latest.cpuMs) / every.cpuMs : 0.0;
+    std::cout << "CPU ahorrada: " << saved << " % ("
+              << (every.presented - latest.presented) << " conversiones I420->BGRA evitadas)" << std::endl;
+
+    // Mismo decode en ambos modos: el último frame presentado tiene que ser idéntico
+    if (every.lastFrame != latest.lastFrame) {
+        std::cerr << "Error: el último frame presentado difiere entre modos" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+// GOP cache benchmark: tiempo hasta la primera imagen de un viewer que se une
+// con el stream en marcha. Sin caché el host fuerza un keyframe (que además
+// pagan todos los que ya miran); con caché recibe en ráfaga el último keyframe
+// y los deltas desde él, y los decodifica con decodeOnly() hasta el último.
+// Los tiempos de encode/decode son medidos; la transferencia se calcula para
+// varios anchos de banda del viewer
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+#include "GopCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr uint32_t kBitrateKbps = 2000;
+constexpr uint32_t kFramerate = 30;
+constexpr int kFrames = 300;
+constexpr int kJoinEvery = 37;   // Un viewer se une cada tantos frames
+constexpr uint32_t kLinkKbps[] = {2000, 10000, 50000};
+
+class RenderSink final : public vic::decoder::FrameSink {
+public:
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        pixels.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {pixels.data(), static_cast<size_t>(info.width) * 4};
+    }
+    void commit(const vic::decoder::DecodedFrameInfo&) override {}
+
+    std::vector<uint8_t> pixels;
+};
+
+// Escritorio: fondo fijo con "texto", una línea que se escribe y una ventana
+// pequeña con video
+void renderDesktop(vic::capture::DesktopFrame& frame, int index) {
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        uint8_t* row = frame.bgraData.data() + static_cast<size_t>(y) * kWidth * 4;
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            const bool glyph = (y % 18) < 12 && ((x / 7 + y / 18) % 5) != 0 && ((x * 7 + y * 3) % 11) < 6;
+            uint8_t value = glyph ? 40 : 235;
+            // Línea que se escribe: avanza 6 px por frame
+            if (y >= 300 && y < 312 && x < static_cast<uint32_t>(index * 6) % kWidth) {
+                value = ((x * 5 + y) % 9) < 5 ? 20 : 240;
+            }
+            row[x * 4 + 0] = value;
+            row[x * 4 + 1] = value;
+            row[x * 4 + 2] = value;
+            row[x * 4 + 3] = 255;
+        }
+    }
+    for (uint32_t y = 420; y < 600; ++y) {
+        uint8_t* row = frame.bgraData.data() + static_cast<size_t>(y) * kWidth * 4;
+        for (uint32_t x = 800; x < 1120; ++x) {
+            row[x * 4 + 0] = static_cast<uint8_t>(x + index * 3);
+            row[x * 4 + 1] = static_cast<uint8_t>(y + index * 2);
+            row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) + index);
+        }
+    }
+}
+
+struct Join {
+    bool forced{};           // Keyframe forzado (sin caché, o caché inválida)
+    double encodeMs{};
+    double decodeMs{};
+    size_t bytes{};          // Keyframe o ráfaga completa
+    size_t frames{};
+};
+
+struct RunResult {
+    std::vector<Join> joins;
+    size_t streamBytes{};    // Lo que reciben los viewers que ya miraban
+    size_t maxFrameBytes{};
+    size_t keyFrames{};
+};
+
+double decodeBurst(const std::vector<std::shared_ptr<const vic::encoder::EncodedFrame>>& frames) {
+    auto decoder = vic::decoder::createVp8Decoder();
+    RenderSink sink;
+    const auto start = Clock::now();
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (i + 1 < frames.size()) {
+            decoder->decodeOnly(*frames[i]);
+        } else {
+            decoder->decodeInto(*frames[i], sink);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+RunResult run(bool useCache) {
+    RunResult result{};
+    auto encoder = vic::encoder::createVp8Encoder();
+    if (!encoder || !encoder->Configure(kWidth, kHeight, kBitrateKbps)) {
+        return result;
+    }
+    vic::pipeline::GopCache cache;
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.resize(static_cast<size_t>(kWidth) * kHeight * 4);
+
+    for (int i = 0; i < kFrames; ++i) {
+        const bool join = i > 0 && i % kJoinEvery == 0;
+        Join current{};
+        if (join && useCache && cache.valid()) {
+            current.frames = cache.frames().size();
+            current.bytes = cache.bytes();
+            current.decodeMs = decodeBurst(cache.frames());
+            result.joins.push_back(current);
+        } else if (join) {
+            encoder->forceNextKeyframe();
+        }
+
+        frame.timestamp = static_cast<uint64_t>(i) * (1000 / kFramerate);
+        renderDesktop(frame, i);
+        const auto encodeStart = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        const double encodeMs = std::chrono::duration<double, std::milli>(Clock::now() - encodeStart).count();
+        if (!encoded) {
+            continue;
+        }
+        auto shared = std::make_shared<const vic::encoder::EncodedFrame>(std::move(*encoded));
+        result.streamBytes += shared->payload.size();
+        result.maxFrameBytes = std::max(result.maxFrameBytes, shared->payload.size());
+        result.keyFrames += shared->keyFrame ? 1 : 0;
+        cache.push(shared);
+
+        if (join && !(useCache && current.frames > 0)) {
+            current.forced = true;
+            current.encodeMs = encodeMs;
+            current.bytes = shared->payload.size();
+            current.frames = 1;
+            current.decodeMs = decodeBurst({shared});
+            result.joins.push_back(current);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=======================================================" << std::endl;
+    std::cout << "  VicViewer GOP Cache Benchmark (time-to-first-frame)" << std::endl;
+    std::cout << "=======================================================" << std::endl;
+    std::cout << kFrames << " frames " << kWidth << "x" << kHeight << " @ " << kBitrateKbps
+              << " kbps, un viewer nuevo cada " << kJoinEvery << " frames" << std::endl;
+
+    const auto keyframe = run(false);
+    const auto cached = run(true);
+    if (keyframe.joins.empty() || cached.joins.empty()) {
+        std::cerr << "Error: no se pudo encodear el clip de prueba" << std::endl;
+        return 1;
+    }
+
+    // Sin caché hay que esperar además la próxima captura (media vuelta en promedio)
+    const double captureWaitMs = 1000.0 / kFramerate / 2.0;
+
+    std::cout << "\n" << std::string(84, '=') << std::endl;
+    std::cout << std::left << std::setw(18) << "Modo"
+              << std::setw(12) << "Enlace"
+              << std::setw(14) << "Prom. (ms)"
+              << std::setw(14) << "Máx. (ms)"
+              << std::setw(14) << "Bytes (KB)"
+              << std::setw(12) << "Frames" << std::endl;
+    std::cout << std::string(84, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const uint32_t link : kLinkKbps) {
+        for (const auto* result : {&keyframe, &cached}) {
+            const bool isCache = result == &cached;
+            double total = 0;
+            double worst = 0;
+            double bytes = 0;
+            double frames = 0;
+            for (const auto& join : result->joins) {
+                const double transferMs = join.bytes * 8.0 / link;
+                const double ttff = (join.forced ? captureWaitMs + join.encodeMs : 0.0) + transferMs + join.decodeMs;
+                total += ttff;
+                worst = std::max(worst, ttff);
+                bytes += join.bytes;
+                frames += join.frames;
+            }
+            const double count = static_cast<double>(result->joins.size());
+            std::cout << std::left << std::setw(18) << (isCache ? "Caché GOP" : "Keyframe forzado")
+                      << std::setw(12) << (std::to_string(link / 1000) + " Mbps")
+                      << std::setw(14) << total / count
+                      << std::setw(14) << worst
+                      << std::setw(14) << bytes / count / 1024.0
+                      << std::setw(12) << frames / count << std::endl;
+        }
+    }
+    std::cout << std::string(84, '=') << std::endl;
+
+    // Lo que pagan los viewers que ya estaban mirando
+    std::cout << "Stream para los demás: keyframe forzado " << keyframe.streamBytes / 1024 << " KB ("
+              << keyframe.keyFrames << " keyframes, pico " << keyframe.maxFrameBytes / 1024 << " KB), caché GOP "
+              << cached.streamBytes / 1024 << " KB (" << cached.keyFrames << " keyframes, pico "
+              << cached.maxFrameBytes / 1024 << " KB)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Intra refresh benchmark: relación pico/promedio del tamaño de frame con
+// keyframes (viewers que se conectan) frente al modo intra refresh
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+using vic::tests::drawGlyph;
+using vic::tests::psnr;
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr uint32_t kBitrateKbps = 2000;
+constexpr int kFrames = 300;
+constexpr int kJoinInterval = 90;          // Un viewer nuevo cada 3 s (keyframe forzado)
+constexpr uint32_t kRefreshFrames = 30;
+
+void runSequence(bool intraRefresh) {
+    auto encoder = vic::encoder::createVp8Encoder();
+    auto decoder = vic::decoder::createVp8Decoder();
+    encoder->setIntraRefresh(intraRefresh ? kRefreshFrames : 0);
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    decoder->configure(kWidth, kHeight);
+
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+    for (uint32_t y = 40; y + 12 < kHeight; y += 18) {
+        for (uint32_t x = 40; x + 8 < kWidth; x += 8) {
+            drawGlyph(frame.bgraData, kWidth, x, y, x * 31 + y * 17);
+        }
+    }
+
+    std::vector<size_t> sizes;
+    double encodeMs = 0.0;
+    double joinPsnr = 0.0;
+    double convergedPsnr = 0.0;
+    int joins = 0;
+
+    for (int i = 0; i < kFrames; ++i) {
+        frame.timestamp = static_cast<uint64_t>(i) * 33;
+        drawGlyph(frame.bgraData, kWidth, 40 + (i % 140) * 8, 400, static_cast<uint32_t>(i) * 7919u + 1);
+
+        const int sinceJoin = i % kJoinInterval;
+        if (i > 0 && sinceJoin == 0) {
+            encoder->forceNextKeyframe();
+        }
+
+        auto start = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto end = Clock::now();
+        if (!encoded) {
+            continue;
+        }
+        encodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+        sizes.push_back(encoded->payload.size());
+
+        auto decoded = decoder->decode(*encoded);
+        if (!decoded || i < kJoinInterval) {
+            continue;
+        }
+        // Calidad que ve el viewer recién conectado: al llegar y tras converger
+        if (sinceJoin == 0) {
+            joinPsnr += psnr(frame.bgraData, decoded->bgraData);
+            ++joins;
+        } else if (sinceJoin == static_cast<int>(kRefreshFrames)) {
+            convergedPsnr += psnr(frame.bgraData, decoded->bgraData);
+        }
+    }
+
+    // El primer keyframe (arranque) no cuenta: ambos modos lo tienen
+    const std::vector<size_t> steady(sizes.begin() + 1, sizes.end());
+    double average = 0.0;
+    for (size_t size : steady) {
+        average += static_cast<double>(size);
+    }
+    average /= static_cast<double>(steady.size());
+    const size_t peak = *std::max_element(steady.begin(), steady.end());
+
+    std::cout << (intraRefresh ? "  Intra refresh:" : "  Keyframes:") << std::endl;
+    std::cout << "    Frame promedio:   " << (average / 1000.0) << " KB" << std::endl;
+    std::cout << "    Frame pico:       " << (static_cast<double>(peak) / 1000.0) << " KB" << std::endl;
+    std::cout << "    Pico/promedio:    " << (static_cast<double>(peak) / average) << "x" << std::endl;
+    std::cout << "    Encode:           " << (encodeMs / static_cast<double>(sizes.size())) << " ms/frame" << std::endl;
+    if (joins > 0) {
+        std::cout << "    PSNR al conectar: " << (joinPsnr / joins) << " dB" << std::endl;
+        std::cout << "    PSNR +" << kRefreshFrames << " frames: " << (convergedPsnr / joins) << " dB" << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Intra Refresh Benchmark (" << kWidth << "x" << kHeight << ", " << kBitrateKbps
+              << " kbps, viewer nuevo cada " << kJoinInterval << " frames) ===" << std::endl;
+    runSequence(false);
+    runSequence(true);
+    return 0;
+}
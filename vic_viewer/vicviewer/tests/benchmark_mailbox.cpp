@@ -0,0 +1,218 @@
+// Mailbox benchmark: contención entre el hilo de decode (productor) y el de
+// render (consumidor) con frames BGRA 1080p. Compara el esquema anterior
+// (copia del frame bajo un mutex), mutex + swap de buffers y TripleBuffer
+// (un exchange atómico por frame, sin locks). Verifica además que el
+// consumidor nunca vea un frame a medio escribir ni un frame más viejo
+#include "TripleBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t kFrameBytes = 1920u * 1080u * 4u;
+constexpr auto kDuration = std::chrono::seconds(2);
+
+struct Frame {
+    uint64_t id{};
+    std::vector<uint8_t> bgra;
+};
+
+// El "decoder" marca el frame al principio y al final: si el consumidor ve
+// marcas distintas, leyó un buffer que el productor estaba escribiendo
+void writeFrame(Frame& frame, uint64_t id) {
+    frame.bgra.resize(kFrameBytes);
+    frame.id = id;
+    std::memcpy(frame.bgra.data(), &id, sizeof(id));
+    std::memcpy(frame.bgra.data() + kFrameBytes - sizeof(id), &id, sizeof(id));
+}
+
+bool frameIntact(const Frame& frame) {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    std::memcpy(&head, frame.bgra.data(), sizeof(head));
+    std::memcpy(&tail, frame.bgra.data() + kFrameBytes - sizeof(tail), sizeof(tail));
+    return head == frame.id && tail == frame.id;
+}
+
+struct Result {
+    std::string name;
+    uint64_t published{};
+    uint64_t presented{};
+    double publishAvgUs{};
+    double publishMaxUs{};
+    double readAvgUs{};
+    double readMaxUs{};
+    bool consistent{true};
+};
+
+struct Timing {
+    double totalUs{};
+    double maxUs{};
+    uint64_t count{};
+
+    void add(Clock::duration elapsed) {
+        const double us = std::chrono::duration<double, std::micro>(elapsed).count();
+        totalUs += us;
+        maxUs = std::max(maxUs, us);
+        ++count;
+    }
+    double avg() const { return count > 0 ? totalUs / count : 0.0; }
+};
+
+// Productor y consumidor en paralelo durante kDuration. publish(id) y
+// present(lastId) devuelven false si detectan un frame roto o viejo
+template <typename Publish, typename Present>
+Result run(const std::string& name, Publish publish, Present present) {
+    Result result{};
+    result.name = name;
+    std::atomic<bool> running{true};
+    std::atomic<bool> consistent{true};
+    Timing publishTiming;
+    Timing readTiming;
+
+    std::thread producer([&] {
+        uint64_t id = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            const auto start = Clock::now();
+            publish(++id);
+            publishTiming.add(Clock::now() - start);
+        }
+        result.published = id;
+    });
+    std::thread consumer([&] {
+        uint64_t lastId = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            const auto start = Clock::now();
+            const uint64_t id = present(lastId);
+            readTiming.add(Clock::now() - start);
+            if (id == UINT64_MAX) {
+                consistent = false;
+            } else if (id != lastId) {
+                lastId = id;
+                ++result.presented;
+            }
+            // Un render a ~1 kHz: el consumidor no es el cuello de botella
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    });
+
+    std::this_thread::sleep_for(kDuration);
+    running = false;
+    producer.join();
+    consumer.join();
+
+    result.publishAvgUs = publishTiming.avg();
+    result.publishMaxUs = publishTiming.maxUs;
+    result.readAvgUs = readTiming.avg();
+    result.readMaxUs = readTiming.maxUs;
+    result.consistent = consistent;
+    return result;
+}
+
+// Frame presentado: id si está intacto y no es más viejo que el anterior
+uint64_t check(const Frame& frame, uint64_t lastId) {
+    if (frame.id == 0) {
+        return lastId;
+    }
+    return frameIntact(frame) && frame.id >= lastId ? frame.id : UINT64_MAX;
+}
+
+Result runMutexCopy() {
+    std::mutex mutex;
+    Frame shared;
+    Frame decoded;
+    return run("mutex + copia",
+        [&](uint64_t id) {
+            writeFrame(decoded, id);
+            std::lock_guard lock(mutex);
+            shared = decoded;
+        },
+        [&](uint64_t lastId) {
+            std::lock_guard lock(mutex);
+            return check(shared, lastId);
+        });
+}
+
+Result runMutexSwap() {
+    std::mutex mutex;
+    Frame shared;
+    Frame back;
+    return run("mutex + swap",
+        [&](uint64_t id) {
+            writeFrame(back, id);
+            std::lock_guard lock(mutex);
+            std::swap(shared, back);
+        },
+        [&](uint64_t lastId) {
+            // El render lee bajo el lock (como el WM_PAINT con StretchDIBits)
+            std::lock_guard lock(mutex);
+            return check(shared, lastId);
+        });
+}
+
+Result runTripleBuffer() {
+    vic::TripleBuffer<Frame> mailbox;
+    return run("TripleBuffer",
+        [&](uint64_t id) {
+            writeFrame(mailbox.writeBuffer(), id);
+            mailbox.publish();
+        },
+        [&](uint64_t lastId) {
+            mailbox.acquireLatest();
+            return mailbox.hasFrame() ? check(mailbox.readBuffer(), lastId) : lastId;
+        });
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=======================================================" << std::endl;
+    std::cout << "  VicViewer Mailbox Benchmark (decoder -> render, 1080p)" << std::endl;
+    std::cout << "=======================================================" << std::endl;
+
+    const Result results[] = {runMutexCopy(), runMutexSwap(), runTripleBuffer()};
+
+    std::cout << "\n" << std::string(96, '=') << std::endl;
+    std::cout << std::left << std::setw(18) << "Esquema"
+              << std::setw(14) << "Publicados"
+              << std::setw(14) << "Presentados"
+              << std::setw(14) << "Pub avg (us)"
+              << std::setw(14) << "Pub max (us)"
+              << std::setw(14) << "Read max (us)"
+              << "OK" << std::endl;
+    std::cout << std::string(96, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    bool ok = true;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(18) << r.name
+                  << std::setw(14) << r.published
+                  << std::setw(14) << r.presented
+                  << std::setw(14) << r.publishAvgUs
+                  << std::setw(14) << r.publishMaxUs
+                  << std::setw(14) << r.readMaxUs
+                  << (r.consistent ? "si" : "NO") << std::endl;
+        ok = ok && r.consistent;
+    }
+    std::cout << std::string(96, '=') << std::endl;
+    std::cout << "Pub = escribir + publicar un frame (incluye esperar el lock);"
+              << " Read = tomar el frame para pintar" << std::endl;
+
+    if (!ok) {
+        std::cerr << "Error: el consumidor vio un frame roto o fuera de orden" << std::endl;
+        return 1;
+    }
+    return 0;
+}
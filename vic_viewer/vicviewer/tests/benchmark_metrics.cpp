@@ -0,0 +1,106 @@
+// Metrics benchmark: costo de medir una etapa (VIC_METRICS_*) desde 1 a 8
+// hilos con el esquema anterior (mutex global + deque de 60 muestras y
+// promedios recalculados en cada marca) y con los histogramas HDR por hilo.
+// La precisión de los percentiles la verifica MetricsTests
+#include "Metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int kMarksPerThread = 200000;
+constexpr uint32_t kThreadCounts[] = {1, 2, 4, 8};
+
+// Réplica del MetricsCollector anterior (solo lo que pasa en cada marca)
+class LegacyCollector {
+public:
+    void markStart() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        start_ = Clock::now();
+    }
+
+    void markEnd() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_).count();
+        times_.push_back(static_cast<double>(us));
+        if (times_.size() > kWindowSize) {
+            times_.pop_front();
+        }
+        average_ = std::accumulate(times_.begin(), times_.end(), 0.0) / static_cast<double>(times_.size());
+    }
+
+private:
+    static constexpr size_t kWindowSize = 60;
+    std::mutex mutex_;
+    Clock::time_point start_;
+    std::deque<double> times_;
+    double average_ = 0;
+};
+
+template <typename Mark>
+double nsPerMark(uint32_t threads, Mark mark) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int n = 0; n < kMarksPerThread; ++n) {
+                mark();
+            }
+        });
+    }
+    const auto start = Clock::now();
+    go.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // Costo por marca en cada core: con más hilos que cores el tiempo de
+    // pared solo mide el reparto, no el costo
+    const uint32_t cores = std::clamp(std::thread::hardware_concurrency(), 1u, threads);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() * cores /
+           (static_cast<double>(kMarksPerThread) * threads);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=======================================================" << std::endl;
+    std::cout << "  VicViewer Metrics Benchmark (costo por marca)" << std::endl;
+    std::cout << "=======================================================" << std::endl;
+
+    // ========== Costo por marca ==========
+    LegacyCollector legacy;
+    std::cout << "\n" << std::string(52, '=') << std::endl;
+    std::cout << std::left << std::setw(10) << "Hilos" << std::right << std::setw(21) << "Mutex + deque (ns)"
+              << std::setw(21) << "HDR por hilo (ns)" << std::endl;
+    std::cout << std::string(52, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const uint32_t threads : kThreadCounts) {
+        const double legacyNs = nsPerMark(threads, [&legacy] {
+            legacy.markStart();
+            legacy.markEnd();
+        });
+        const double hdrNs = nsPerMark(threads, [] {
+            VIC_METRICS_ENCODE();
+        });
+        std::cout << std::left << std::setw(10) << threads << std::right << std::setw(21) << legacyNs
+                  << std::setw(21) << hdrNs << std::endl;
+    }
+    std::cout << std::string(52, '=') << std::endl;
+    return 0;
+}
@@ -3,14 +3,21 @@
 #include "VideoDecoder.h"
 #include "ColorConvert.h"
 #include "DesktopFrame.h"
+#include "TestPatterns.h"
 
 #include <chrono>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <numeric>
 
 using Clock = std::chrono::high_resolution_clock;
 
+constexpr uint32_t kCodecBitrateKbps = 2500;
+constexpr int kCodecFrames = 60;
+constexpr double kFrameRate = 30.0;
+
 struct Resolution {
     uint32_t width;
     uint32_t height;
@@ -111,6 +118,74 @@ void benchmarkResolution(const Resolution& res, int iterations = 20) {
     std::cout << std::endl;
 }
 
+// ========== VP8 vs VP9 con contenido de pantalla ==========
+
+using vic::tests::drawGlyph;
+using vic::tests::psnr;
+
+/// Documento de texto en el que se escribe un carácter por frame: bitrate
+/// real (incluido el keyframe inicial), PSNR y tiempos de encode/decode
+void benchmarkCodec(const Resolution& res, const char* name,
+                    const std::function<std::unique_ptr<vic::encoder::VideoEncoder>()>& createEncoder,
+                    const std::function<std::unique_ptr<vic::decoder::VideoDecoder>()>& createDecoder) {
+    auto encoder = createEncoder();
+    auto decoder = createDecoder();
+    encoder->Configure(res.width, res.height, kCodecBitrateKbps);
+    decoder->configure(res.width, res.height);
+
+    vic::capture::DesktopFrame frame{};
+    frame.width = res.width;
+    frame.height = res.height;
+    frame.bgraData.assign(static_cast<size_t>(res.width) * res.height * 4, 255);
+    for (uint32_t y = 20; y + 12 < res.height; y += 18) {
+        for (uint32_t x = 20; x + 8 < res.width; x += 8) {
+            drawGlyph(frame.bgraData, res.width, x, y, x * 31 + y * 17);
+        }
+    }
+    const uint32_t typingColumns = (res.width - 40) / 8;
+
+    double encodeMs = 0.0;
+    double decodeMs = 0.0;
+    double psnrSum = 0.0;
+    size_t totalBytes = 0;
+    int encodedFrames = 0;
+    int decodedFrames = 0;
+    for (int i = 0; i < kCodecFrames; ++i) {
+        frame.timestamp = static_cast<uint64_t>(i) * 33;
+        drawGlyph(frame.bgraData, res.width, 20 + (i % typingColumns) * 8, res.height / 2,
+                  static_cast<uint32_t>(i) * 7919u + 1);
+
+        auto start = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto encodedAt = Clock::now();
+        if (!encoded) {
+            continue;
+        }
+        encodeMs += std::chrono::duration<double, std::milli>(encodedAt - start).count();
+        totalBytes += encoded->payload.size();
+        ++encodedFrames;
+
+        start = Clock::now();
+        auto decoded = decoder->decode(*encoded);
+        auto end = Clock::now();
+        if (!decoded) {
+            continue;
+        }
+        decodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+        psnrSum += psnr(frame.bgraData, decoded->bgraData);
+        ++decodedFrames;
+    }
+
+    if (decodedFrames == 0) {
+        std::cout << "  " << name << ": sin frames decodificados" << std::endl;
+        return;
+    }
+    const double kbps = static_cast<double>(totalBytes) * 8.0 / 1000.0 * kFrameRate / kCodecFrames;
+    std::cout << "  " << name << ": " << kbps << " kbps, PSNR " << (psnrSum / decodedFrames)
+              << " dB, encode " << (encodeMs / encodedFrames) << " ms, decode "
+              << (decodeMs / decodedFrames) << " ms" << std::endl;
+}
+
 int main() {
     std::cout << "=== Multi-Resolution Benchmark ===" << std::endl;
     std::cout << std::endl;
@@ -126,6 +201,14 @@ int main() {
         benchmarkResolution(res);
     }
 
+    std::cout << "=== VP8 vs VP9 (texto, " << kCodecBitrateKbps << " kbps objetivo) ===" << std::endl;
+    for (const auto& res : resolutions) {
+        std::cout << "--- " << res.name << " ---" << std::endl;
+        benchmarkCodec(res, "VP8", vic::encoder::createVp8Encoder, vic::decoder::createVp8Decoder);
+        benchmarkCodec(res, "VP9", vic::encoder::createVp9Encoder, vic::decoder::createVp9Decoder);
+    }
+    std::cout << std::endl;
+
     std::cout << "=== Recommendation ===" << std::endl;
     std::cout << "For 60 FPS with VP8 software encoding:" << std::endl;
     std::cout << "  - Use 720p or lower resolution" << std::endl;
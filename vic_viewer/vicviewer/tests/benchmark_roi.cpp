@@ -0,0 +1,166 @@
+// ROI benchmark: calidad dentro y fuera de la región de interés a bitrate fijo.
+// Simula escritura junto al cursor mientras otra zona de la pantalla se actualiza
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+#include "DamageTracker.h"
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+using vic::tests::drawGlyph;
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr int kFrames = 150;
+constexpr int kWarmupFrames = 30;        // Se descarta el arranque (keyframe + convergencia del RC)
+constexpr uint32_t kBitrateKbps = 1000;
+constexpr uint32_t kCursorRadius = 128;
+
+// Zona de actividad ajena al usuario (p.ej. un log que se actualiza)
+constexpr uint32_t kBusyX = 800;
+constexpr uint32_t kBusyY = 360;
+constexpr uint32_t kBusyWidth = 400;
+constexpr uint32_t kBusyHeight = 300;
+
+struct Rect {
+    uint32_t x, y, width, height;
+    bool contains(uint32_t px, uint32_t py) const {
+        return px >= x && px < x + width && py >= y && py < y + height;
+    }
+};
+
+struct Quality {
+    double inside = 0.0;
+    double outside = 0.0;
+};
+
+/// PSNR (luma aproximada) dentro y fuera de `roi`
+Quality measure(const std::vector<uint8_t>& ref, const std::vector<uint8_t>& dec, const Rect& roi) {
+    double sumIn = 0.0, sumOut = 0.0;
+    size_t countIn = 0, countOut = 0;
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            const size_t i = (static_cast<size_t>(y) * kWidth + x) * 4;
+            const double diff = static_cast<double>(ref[i + 1]) - static_cast<double>(dec[i + 1]);
+            if (roi.contains(x, y)) {
+                sumIn += diff * diff;
+                ++countIn;
+            } else {
+                sumOut += diff * diff;
+                ++countOut;
+            }
+        }
+    }
+    auto toPsnr = [](double sum, size_t count) {
+        const double mse = count ? sum / static_cast<double>(count) : 0.0;
+        return mse <= 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+    };
+    return {toPsnr(sumIn, countIn), toPsnr(sumOut, countOut)};
+}
+
+void runSequence(bool useRoi) {
+    auto encoder = vic::encoder::createVp8Encoder();
+    auto decoder = vic::decoder::createVp8Decoder();
+    vic::capture::DamageTracker damage;
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    decoder->configure(kWidth, kHeight);
+
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+
+    // Página de texto de fondo
+    for (uint32_t y = 40; y + 12 < kHeight; y += 18) {
+        for (uint32_t x = 40; x + 8 < kWidth; x += 8) {
+            if ((x / 8 + y) % 11 != 0) {
+                drawGlyph(frame.bgraData, kWidth, x, y, x * 31 + y * 17);
+            }
+        }
+    }
+
+    Quality sum{};
+    size_t bytes = 0;
+    double encodeMs = 0.0;
+    uint32_t caretX = 200;
+    const uint32_t caretY = 200;
+
+    for (int i = 0; i < kFrames; ++i) {
+        frame.timestamp = static_cast<uint64_t>(i) * 33;
+
+        // Escritura: un carácter nuevo por frame en la línea del cursor
+        for (uint32_t row = 0; row < 12; ++row) {
+            std::fill_n(frame.bgraData.begin() + (static_cast<size_t>(caretY + row) * kWidth + caretX) * 4, 8 * 4, 255);
+        }
+        drawGlyph(frame.bgraData, kWidth, caretX, caretY, static_cast<uint32_t>(i) * 7919u + 1);
+        caretX = caretX + 8 < 440 ? caretX + 8 : 200;
+
+        // Actividad de fondo: la zona "busy" se redibuja entera cada frame
+        for (uint32_t y = kBusyY; y + 12 < kBusyY + kBusyHeight; y += 18) {
+            for (uint32_t x = kBusyX; x + 8 < kBusyX + kBusyWidth; x += 8) {
+                for (uint32_t row = 0; row < 12; ++row) {
+                    std::fill_n(frame.bgraData.begin() + (static_cast<size_t>(y + row) * kWidth + x) * 4, 8 * 4, 255);
+                }
+                drawGlyph(frame.bgraData, kWidth, x, y, x + y * 13 + static_cast<uint32_t>(i) * 104729u);
+            }
+        }
+
+        const Rect cursorRect{caretX > kCursorRadius ? caretX - kCursorRadius : 0,
+                              caretY - std::min(caretY, kCursorRadius), 2 * kCursorRadius, 2 * kCursorRadius};
+        if (useRoi) {
+            damage.update(frame);
+            vic::encoder::RoiMap map;
+            for (const auto& edit : damage.recentEdits(2000, 8)) {
+                map.regions.push_back({edit.x, edit.y, edit.width, edit.height, 2});
+            }
+            map.regions.push_back({cursorRect.x, cursorRect.y, cursorRect.width, cursorRect.height, 1});
+            map.deltaQ = {4, -16, -10, 0};
+            map.deltaLoopFilter = {0, -10, -6, 0};
+            encoder->setRoiMap(map);
+        }
+
+        auto start = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto end = Clock::now();
+        if (!encoded) {
+            continue;
+        }
+        auto decoded = decoder->decode(*encoded);
+        if (!decoded || i < kWarmupFrames) {
+            continue;
+        }
+
+        encodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+        bytes += encoded->payload.size();
+        const Quality q = measure(frame.bgraData, decoded->bgraData, cursorRect);
+        sum.inside += q.inside;
+        sum.outside += q.outside;
+    }
+
+    const double measured = kFrames - kWarmupFrames;
+    std::cout << (useRoi ? "  Con ROI:" : "  Sin ROI:") << std::endl;
+    std::cout << "    Bitrate real:  " << (bytes * 8.0 / measured * 30.0 / 1000.0) << " kbps @30fps" << std::endl;
+    std::cout << "    Encode:        " << (encodeMs / measured) << " ms/frame" << std::endl;
+    std::cout << "    PSNR cursor:   " << (sum.inside / measured) << " dB" << std::endl;
+    std::cout << "    PSNR resto:    " << (sum.outside / measured) << " dB" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== ROI Benchmark (" << kWidth << "x" << kHeight << ", " << kBitrateKbps
+              << " kbps) ===" << std::endl;
+    runSequence(false);
+    runSequence(true);
+    return 0;
+}
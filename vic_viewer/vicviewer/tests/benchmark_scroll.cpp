@@ -0,0 +1,143 @@
+// Scroll benchmark: bits por frame y tiempo de encode sobre texto sintético
+// desplazándose, con y sin copy-rects (ScrollDetector)
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+#include "ScrollDetector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr uint32_t kToolbarHeight = 48;   // Zona fija arriba (barra de herramientas)
+constexpr uint32_t kScrollStep = 12;      // Píxeles por frame (rueda del mouse)
+constexpr int kFrames = 120;
+constexpr uint32_t kBitrateKbps = 2000;
+
+/// Documento alto con "texto": glifos pseudoaleatorios de 7x12 en líneas de 18px
+std::vector<uint8_t> buildDocument(uint32_t width, uint32_t height) {
+    std::vector<uint8_t> doc(static_cast<size_t>(width) * height * 4, 255);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint32_t line = y / 18;
+        const uint32_t row = y % 18;
+        if (row < 3 || row >= 15) {
+            continue; // interlineado
+        }
+        for (uint32_t x = 16; x + 16 < width; ++x) {
+            const uint32_t glyph = x / 8;
+            const uint32_t seed = (line * 7919u + glyph * 104729u) * 2654435761u;
+            if ((seed >> 28) == 0) {
+                continue; // espacio entre palabras
+            }
+            const uint32_t bit = ((x % 8) * 12 + (row - 3)) % 32;
+            if ((seed >> bit) & 1u) {
+                uint8_t* px = doc.data() + (static_cast<size_t>(y) * width + x) * 4;
+                px[0] = px[1] = px[2] = 32;
+            }
+        }
+    }
+    return doc;
+}
+
+vic::capture::DesktopFrame viewport(const std::vector<uint8_t>& doc, uint32_t offset, uint64_t timestamp) {
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.timestamp = timestamp;
+    frame.bgraData.resize(static_cast<size_t>(kWidth) * kHeight * 4);
+    const size_t rowBytes = static_cast<size_t>(kWidth) * 4;
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        uint8_t* dst = frame.bgraData.data() + y * rowBytes;
+        if (y < kToolbarHeight) {
+            std::fill(dst, dst + rowBytes, static_cast<uint8_t>(200));
+        } else {
+            std::copy_n(doc.data() + (static_cast<size_t>(y) + offset) * rowBytes, rowBytes, dst);
+        }
+    }
+    return frame;
+}
+
+double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        for (size_t c = 0; c < 3; ++c) {
+            const double diff = static_cast<double>(a[i + c]) - static_cast<double>(b[i + c]);
+            sum += diff * diff;
+        }
+    }
+    const double mse = sum / (static_cast<double>(a.size()) / 4.0 * 3.0);
+    return mse <= 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+void runSequence(const std::vector<uint8_t>& doc, bool useHints) {
+    auto encoder = vic::encoder::createVp8Encoder();
+    auto decoder = vic::decoder::createVp8Decoder();
+    vic::capture::ScrollDetector detector;
+    encoder->Configure(kWidth, kHeight, kBitrateKbps);
+    decoder->configure(kWidth, kHeight);
+
+    double encodeMs = 0.0;
+    double detectMs = 0.0;
+    double psnrSum = 0.0;
+    size_t deltaBytes = 0;
+    size_t hintedFrames = 0;
+
+    for (int i = 0; i < kFrames; ++i) {
+        auto frame = viewport(doc, static_cast<uint32_t>(i) * kScrollStep, static_cast<uint64_t>(i) * 33);
+
+        auto detectStart = Clock::now();
+        if (useHints) {
+            auto rects = detector.detect(frame);
+            hintedFrames += rects.empty() ? 0 : 1;
+            encoder->setCopyRects(std::move(rects));
+        }
+        auto encodeStart = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto encodeEnd = Clock::now();
+        if (!encoded) {
+            continue;
+        }
+
+        if (i > 0) {
+            detectMs += std::chrono::duration<double, std::milli>(encodeStart - detectStart).count();
+            encodeMs += std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count();
+            deltaBytes += encoded->payload.size();
+        }
+
+        // Decodificar para comprobar que host y viewer no divergen
+        if (auto decoded = decoder->decode(*encoded)) {
+            psnrSum += psnr(frame.bgraData, decoded->bgraData);
+        }
+    }
+
+    const double deltas = kFrames - 1;
+    std::cout << (useHints ? "  Con copy-rects: " : "  Sin copy-rects: ") << std::endl;
+    std::cout << "    Bits/frame:   " << (deltaBytes * 8.0 / deltas / 1000.0) << " kbit" << std::endl;
+    std::cout << "    Encode:       " << (encodeMs / deltas) << " ms/frame" << std::endl;
+    if (useHints) {
+        std::cout << "    Deteccion:    " << (detectMs / deltas) << " ms/frame" << std::endl;
+        std::cout << "    Frames con hint: " << hintedFrames << "/" << (kFrames - 1) << std::endl;
+    }
+    std::cout << "    PSNR medio:   " << (psnrSum / kFrames) << " dB" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Scroll Benchmark (" << kWidth << "x" << kHeight << ", " << kScrollStep
+              << " px/frame, " << kBitrateKbps << " kbps) ===" << std::endl;
+
+    const auto doc = buildDocument(kWidth, kHeight + kFrames * kScrollStep);
+    runSequence(doc, false);
+    runSequence(doc, true);
+    return 0;
+}
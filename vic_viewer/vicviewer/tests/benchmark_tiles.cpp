@@ -0,0 +1,111 @@
+// Tiles benchmark: escalado del encode/decode 4K con 1, 2, 4 y 8 tiles, cada
+// uno con su propio encoder VP8 en su propio hilo
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "DesktopFrame.h"
+#include "TestPatterns.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+using vic::tests::drawGlyph;
+using vic::tests::psnr;
+
+constexpr uint32_t kWidth = 3840;
+constexpr uint32_t kHeight = 2160;
+constexpr uint32_t kBitrateKbps = 12000;
+constexpr int kFrames = 60;
+constexpr uint32_t kTileCounts[] = {1, 2, 4, 8};
+
+void runTiles(uint32_t tiles, double& baselineEncodeMs) {
+    auto encoder = tiles > 1
+        ? vic::encoder::createTiledEncoder(vic::encoder::VideoCodec::Vp8, tiles)
+        : vic::encoder::createVp8Encoder();
+    auto decoder = tiles > 1
+        ? vic::decoder::createTiledDecoder(vic::encoder::VideoCodec::Vp8)
+        : vic::decoder::createVp8Decoder();
+    if (!encoder || !decoder || !encoder->Configure(kWidth, kHeight, kBitrateKbps)) {
+        std::cout << "  " << tiles << " tiles: no disponible" << std::endl;
+        return;
+    }
+
+    // Pantalla de texto con una línea que se sigue escribiendo
+    vic::capture::DesktopFrame frame{};
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgraData.assign(static_cast<size_t>(kWidth) * kHeight * 4, 255);
+    for (uint32_t y = 40; y + 12 < kHeight; y += 18) {
+        for (uint32_t x = 40; x + 8 < kWidth; x += 8) {
+            drawGlyph(frame.bgraData, kWidth, x, y, x * 31 + y * 17);
+        }
+    }
+
+    double encodeMs = 0.0;
+    double decodeMs = 0.0;
+    double quality = 0.0;
+    size_t bytes = 0;
+    int encodedFrames = 0;
+    int decodedFrames = 0;
+
+    for (int i = 0; i < kFrames; ++i) {
+        frame.timestamp = static_cast<uint64_t>(i) * 33;
+        drawGlyph(frame.bgraData, kWidth, 40 + (i % 460) * 8, 1000, static_cast<uint32_t>(i) * 7919u + 1);
+
+        auto start = Clock::now();
+        auto encoded = encoder->EncodeFrame(frame);
+        auto end = Clock::now();
+        if (!encoded) {
+            continue;
+        }
+        encodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+        bytes += encoded->payload.size();
+        ++encodedFrames;
+
+        start = Clock::now();
+        auto decoded = decoder->decode(*encoded);
+        end = Clock::now();
+        if (!decoded) {
+            continue;
+        }
+        decodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+        quality += psnr(frame.bgraData, decoded->bgraData);
+        ++decodedFrames;
+    }
+    if (encodedFrames == 0 || decodedFrames == 0) {
+        std::cout << "  " << tiles << " tiles: sin frames" << std::endl;
+        return;
+    }
+
+    const double avgEncode = encodeMs / encodedFrames;
+    if (tiles == 1) {
+        baselineEncodeMs = avgEncode;
+    }
+    std::cout << "  " << tiles << " tiles:" << std::endl;
+    std::cout << "    Encode:   " << avgEncode << " ms/frame (" << (1000.0 / avgEncode) << " fps)";
+    if (baselineEncodeMs > 0.0) {
+        std::cout << " x" << (baselineEncodeMs / avgEncode);
+    }
+    std::cout << std::endl;
+    std::cout << "    Decode:   " << (decodeMs / decodedFrames) << " ms/frame" << std::endl;
+    std::cout << "    Frame:    " << (static_cast<double>(bytes) / encodedFrames / 1000.0) << " KB promedio" << std::endl;
+    std::cout << "    PSNR:     " << (quality / decodedFrames) << " dB" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Tiles Benchmark (" << kWidth << "x" << kHeight << ", " << kBitrateKbps << " kbps, "
+              << std::thread::hardware_concurrency() << " cores) ===" << std::endl;
+    double baselineEncodeMs = 0.0;
+    for (uint32_t tiles : kTileCounts) {
+        runTiles(tiles, baselineEncodeMs);
+    }
+    return 0;
+}
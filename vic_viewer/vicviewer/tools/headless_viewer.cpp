@@ -0,0 +1,343 @@
+// Viewer headless: N ViewerSession concurrentes en un proceso, sin ventanas,
+// para poner carga sobre un host o un relay (fan-out, escalado del relay).
+// Cada sesión decodifica directo a un buffer propio y lo pasa por el renderer
+// offscreen; por cada frame se loguea llegada, tamaño, decode y render (CSV)
+#include "ViewerSession.h"
+#include "OffscreenRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) {
+    g_stop = true;
+}
+
+struct Options {
+    std::string code;
+    std::string host;
+    uint16_t port = 9999;
+    uint32_t sessions = 1;
+    uint32_t durationSec = 0;       // 0 = hasta Ctrl+C
+    uint32_t connectStaggerMs = 0;  // Espera entre conexiones (0 = todas juntas)
+    bool countOnly = false;
+    uint32_t width = 0;             // 0 = tamaño del frame (sin escalar)
+    uint32_t height = 0;
+    vic::ui::ScaleFilter filter = vic::ui::ScaleFilter::Bilinear;
+    bool checksum = false;
+    std::string dumpDirectory;
+    uint32_t dumpEvery = 60;
+    std::string csvPath;            // Vacío = stdout
+};
+
+void printUsage() {
+    std::cout <<
+        "Uso: VicViewerHeadless (--code=CODIGO | --host=IP[:PUERTO]) [opciones]\n"
+        "  --sessions=N        Sesiones concurrentes (default 1)\n"
+        "  --duration=SEG      Terminar después de SEG segundos (default: Ctrl+C)\n"
+        "  --stagger=MS        Espera entre conexiones (default 0: todas juntas)\n"
+        "  --count-only        Solo contar frames, sin decodificar\n"
+        "  --size=WxH          Tamaño de la \"ventana\" offscreen (default: el del frame)\n"
+        "  --filter=bilinear|area\n"
+        "  --checksum          Checksum de cada frame presentado (columna checksum)\n"
+        "  --dump=DIR          Guardar BMPs por sesión en DIR/sNN\n"
+        "  --dump-every=N      Uno de cada N frames presentados (default 60)\n"
+        "  --csv=ARCHIVO       Log por frame a ARCHIVO (default stdout)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (key == "--code") {
+            options.code = value;
+        } else if (key == "--host") {
+            const auto colon = value.rfind(':');
+            options.host = value.substr(0, colon);
+            if (colon != std::string::npos) {
+                options.port = static_cast<uint16_t>(std::strtoul(value.c_str() + colon + 1, nullptr, 10));
+            }
+        } else if (key == "--sessions") {
+            options.sessions = std::max<uint32_t>(1, static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)));
+        } else if (key == "--duration") {
+            options.durationSec = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--stagger") {
+            options.connectStaggerMs = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--count-only") {
+            options.countOnly = true;
+        } else if (key == "--size") {
+            if (std::sscanf(value.c_str(), "%ux%u", &options.width, &options.height) != 2) {
+                return false;
+            }
+        } else if (key == "--filter") {
+            if (value != "bilinear" && value != "area") {
+                return false;
+            }
+            options.filter = value == "area" ? vic::ui::ScaleFilter::Area : vic::ui::ScaleFilter::Bilinear;
+        } else if (key == "--checksum") {
+            options.checksum = true;
+        } else if (key == "--dump") {
+            options.dumpDirectory = value;
+        } else if (key == "--dump-every") {
+            options.dumpEvery = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--csv") {
+            options.csvPath = value;
+        } else {
+            return false;
+        }
+    }
+    return options.code.empty() != options.host.empty();
+}
+
+/// Log por frame compartido por todas las sesiones (cada una escribe desde su hilo de decode)
+class FrameLog {
+public:
+    explicit FrameLog(std::ostream& out) : out_(out) {
+        out_ << "session,frame_id,arrival_ms,bytes,key,decoded,presented,queue_us,decode_us,render_us,checksum\n";
+    }
+
+    void write(uint32_t session, const vic::pipeline::ViewerFrameStats& stats,
+               Clock::time_point start, double renderUs, uint64_t checksum) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%u,%u,%.3f,%zu,%d,%d,%d,%.1f,%.1f,%.1f,%016llx\n",
+            session, stats.frameId,
+            std::chrono::duration<double, std::milli>(stats.arrival - start).count(),
+            stats.bytes, stats.keyFrame ? 1 : 0, stats.decoded ? 1 : 0, stats.presented ? 1 : 0,
+            stats.queueUs, stats.decodeUs, renderUs, static_cast<unsigned long long>(checksum));
+        std::lock_guard lock(mutex_);
+        out_ << line;
+    }
+
+    void flush() {
+        std::lock_guard lock(mutex_);
+        out_.flush();
+    }
+
+private:
+    std::ostream& out_;
+    std::mutex mutex_;
+};
+
+/// Buffer de decode propio de la sesión; al confirmar un frame lo pasa por el renderer
+class RenderSink final : public vic::decoder::FrameSink {
+public:
+    explicit RenderSink(vic::ui::OffscreenRenderer& renderer) : renderer_(renderer) {}
+
+    vic::decoder::FrameBuffer acquire(const vic::decoder::DecodedFrameInfo& info) override {
+        frame_.width = info.width;
+        frame_.height = info.height;
+        frame_.bgraData.resize(static_cast<size_t>(info.width) * info.height * 4);
+        return {frame_.bgraData.data(), static_cast<size_t>(info.width) * 4};
+    }
+
+    void commit(const vic::decoder::DecodedFrameInfo& info) override {
+        frame_.originalWidth = info.originalWidth;
+        frame_.originalHeight = info.originalHeight;
+        frame_.timestamp = info.timestamp;
+        renderer_.RenderFrame(frame_);
+        renderer_.Present();
+    }
+
+private:
+    vic::ui::OffscreenRenderer& renderer_;
+    vic::capture::DesktopFrame frame_{};
+};
+
+/// Contadores de una sesión (escritos por su hilo de decode, leídos por el resumen)
+struct SessionCounters {
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> decoded{0};
+    std::atomic<uint64_t> presented{0};
+    std::atomic<uint64_t> keyFrames{0};
+    std::atomic<uint64_t> decodeUsTotal{0};
+    std::atomic<uint64_t> renderUsTotal{0};
+    std::atomic<int64_t> firstFrameMs{-1};
+    std::atomic<int64_t> firstPresentedMs{-1};   // Primera imagen (tras la ráfaga GOP, si la hubo)
+};
+
+// La sesión se declara última: se destruye primero y detiene su hilo de
+// decode antes que el renderer y los contadores que usa
+struct HeadlessSession {
+    uint32_t index{};
+    Clock::time_point connectStart{};
+    SessionCounters counters;
+    std::unique_ptr<vic::ui::OffscreenRenderer> renderer;
+    std::shared_ptr<RenderSink> sink;
+    vic::pipeline::ViewerSession session;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::ofstream csvFile;
+    if (!options.csvPath.empty()) {
+        csvFile.open(options.csvPath);
+        if (!csvFile) {
+            std::cerr << "Error: no se pudo abrir " << options.csvPath << std::endl;
+            return 1;
+        }
+    }
+    FrameLog frameLog(options.csvPath.empty() ? std::cout : csvFile);
+    const auto start = Clock::now();
+
+    std::vector<std::unique_ptr<HeadlessSession>> sessions;
+    sessions.reserve(options.sessions);
+    for (uint32_t i = 0; i < options.sessions; ++i) {
+        auto headless = std::make_unique<HeadlessSession>();
+        headless->index = i;
+
+        vic::ui::OffscreenRendererConfig config{};
+        config.filter = options.filter;
+        config.computeChecksum = options.checksum;
+        config.dumpEvery = options.dumpEvery;
+        if (!options.dumpDirectory.empty()) {
+            char dir[16];
+            std::snprintf(dir, sizeof(dir), "s%02u", i);
+            config.dumpDirectory = options.dumpDirectory + "/" + dir;
+        }
+        headless->renderer = vic::ui::CreateOffscreenRenderer(config);
+        headless->renderer->Initialize(nullptr);
+        if (options.width > 0 && options.height > 0) {
+            headless->renderer->Resize(options.width, options.height);
+        }
+        headless->sink = std::make_shared<RenderSink>(*headless->renderer);
+
+        auto* h = headless.get();
+        h->session.setDecodeEnabled(!options.countOnly);
+        h->session.setFrameSink(h->sink);
+        h->session.setFrameStatsCallback([h, &frameLog, start](const vic::pipeline::ViewerFrameStats& stats) {
+            auto& c = h->counters;
+            if (c.frames.fetch_add(1) == 0) {
+                c.firstFrameMs = std::chrono::duration_cast<std::chrono::milliseconds>(stats.arrival - h->connectStart).count();
+            }
+            c.bytes += stats.bytes;
+            c.keyFrames += stats.keyFrame ? 1 : 0;
+            c.decoded += stats.decoded ? 1 : 0;
+            c.decodeUsTotal += static_cast<uint64_t>(stats.decodeUs);
+            double renderUs = 0;
+            uint64_t checksum = 0;
+            if (stats.presented) {
+                if (c.presented.fetch_add(1) == 0) {
+                    c.firstPresentedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - h->connectStart).count();
+                }
+                renderUs = h->renderer->stats().lastRenderUs;
+                checksum = h->renderer->lastChecksum();
+                c.renderUsTotal += static_cast<uint64_t>(renderUs);
+            }
+            frameLog.write(h->index, stats, start, renderUs, checksum);
+        });
+        sessions.push_back(std::move(headless));
+    }
+
+    // Conexiones en paralelo (con --stagger escalonadas): un join masivo también es un caso de carga
+    std::vector<std::thread> connectThreads;
+    std::atomic<uint32_t> connected{0};
+    for (auto& headless : sessions) {
+        auto* h = headless.get();
+        connectThreads.emplace_back([h, &options, &connected] {
+            h->connectStart = Clock::now();
+            const bool ok = options.host.empty()
+                ? h->session.connect(options.code)
+                : h->session.connectDirect(options.host, options.port);
+            if (ok) {
+                ++connected;
+            } else {
+                std::cerr << "[s" << h->index << "] No se pudo conectar" << std::endl;
+            }
+        });
+        if (options.connectStaggerMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.connectStaggerMs));
+        }
+    }
+    for (auto& thread : connectThreads) {
+        thread.join();
+    }
+    std::cerr << connected.load() << "/" << options.sessions << " sesiones conectadas" << std::endl;
+    if (connected.load() == 0) {
+        return 1;
+    }
+
+    // Resumen por segundo en stderr (stdout queda para el CSV)
+    uint64_t lastFrames = 0;
+    uint64_t lastBytes = 0;
+    auto lastReport = Clock::now();
+    while (!g_stop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = Clock::now();
+        if (options.durationSec > 0 && now - start >= std::chrono::seconds(options.durationSec)) {
+            break;
+        }
+        if (now - lastReport < std::chrono::seconds(1)) {
+            continue;
+        }
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        uint32_t alive = 0;
+        for (const auto& headless : sessions) {
+            frames += headless->counters.frames.load();
+            bytes += headless->counters.bytes.load();
+            alive += headless->session.isConnected() ? 1 : 0;
+        }
+        const double seconds = std::chrono::duration<double>(now - lastReport).count();
+        std::fprintf(stderr, "[%6.1fs] %u/%u conectadas | %.1f fps total | %.0f kbps total\n",
+            std::chrono::duration<double>(now - start).count(), alive, options.sessions,
+            (frames - lastFrames) / seconds, (bytes - lastBytes) * 8.0 / 1000.0 / seconds);
+        lastFrames = frames;
+        lastBytes = bytes;
+        lastReport = now;
+    }
+
+    for (auto& headless : sessions) {
+        headless->session.disconnect();
+    }
+    frameLog.flush();
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::fprintf(stderr, "\n%-8s %-10s %-10s %-10s %-8s %-10s %-12s %-12s %-10s %-10s\n",
+        "Sesión", "Frames", "Decod.", "Present.", "Keys", "kbps", "Decode (us)", "Render (us)", "1er (ms)", "Imagen (ms)");
+    for (const auto& headless : sessions) {
+        const auto& c = headless->counters;
+        const uint64_t frames = c.frames.load();
+        const uint64_t presented = c.presented.load();
+        std::fprintf(stderr, "s%-7u %-10llu %-10llu %-10llu %-8llu %-10.0f %-12.1f %-12.1f %-10lld %-10lld\n",
+            headless->index,
+            static_cast<unsigned long long>(frames),
+            static_cast<unsigned long long>(c.decoded.load()),
+            static_cast<unsigned long long>(presented),
+            static_cast<unsigned long long>(c.keyFrames.load()),
+            c.bytes.load() * 8.0 / 1000.0 / elapsed,
+            frames > 0 ? static_cast<double>(c.decodeUsTotal.load()) / frames : 0.0,
+            presented > 0 ? static_cast<double>(c.renderUsTotal.load()) / presented : 0.0,
+            static_cast<long long>(c.firstFrameMs.load()),
+            static_cast<long long>(c.firstPresentedMs.load()));
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+// Replay de grabaciones (SessionRecorder) más rápido que tiempo real, para
+// medir el decoder y el renderer con contenido real: mapea cada IVF y lo pasa
+// por el decoder (decode y conversión a BGRA por separado) y el renderer
+// offscreen sin esperas. Con varios archivos (o --copies) los reproduce en
+// paralelo, uno por hilo, para cargar todos los cores
+#include "RecordingReader.h"
+#include "RecordingReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> files;
+    std::string referencePath;
+    uint32_t jobs = 0;              // 0 = un hilo por core
+    uint32_t copies = 1;            // Cada archivo se reproduce N veces en paralelo
+    uint32_t loops = 1;
+    uint32_t decoderThreads = 0;    // 0 = auto (1 si hay más de un job)
+    bool render = true;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    vic::ui::ScaleFilter filter = vic::ui::ScaleFilter::Bilinear;
+    std::string csvPath;            // Tiempos por frame
+};
+
+void printUsage() {
+    std::cout <<
+        "Uso: VicRecordingReplay [opciones] GRABACION.ivf [...]\n"
+        "  --jobs=N            Grabaciones en paralelo (default: un hilo por core)\n"
+        "  --copies=N          Reproducir cada archivo N veces en paralelo\n"
+        "  --loops=N           Vueltas por grabación (default 1)\n"
+        "  --decoder-threads=N Hilos de cada decoder (default: auto; 1 con varios jobs)\n"
+        "  --no-render         Solo decode + conversión, sin renderer\n"
+        "  --size=WxH          Tamaño de la \"ventana\" offscreen (default: el del frame)\n"
+        "  --filter=bilinear|area\n"
+        "  --reference=ARCHIVO PSNR contra otra grabación de la misma sesión\n"
+        "  --csv=ARCHIVO       Tiempo por frame (archivo,frame,us)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            options.files.push_back(arg);
+            continue;
+        }
+        const auto eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (key == "--jobs") {
+            options.jobs = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--copies") {
+            options.copies = std::max<uint32_t>(1, static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)));
+        } else if (key == "--loops") {
+            options.loops = std::max<uint32_t>(1, static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)));
+        } else if (key == "--decoder-threads") {
+            options.decoderThreads = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--no-render") {
+            options.render = false;
+        } else if (key == "--size") {
+            if (std::sscanf(value.c_str(), "%ux%u", &options.width, &options.height) != 2) {
+                return false;
+            }
+        } else if (key == "--filter") {
+            if (value != "bilinear" && value != "area") {
+                return false;
+            }
+            options.filter = value == "area" ? vic::ui::ScaleFilter::Area : vic::ui::ScaleFilter::Bilinear;
+        } else if (key == "--reference") {
+            options.referencePath = value;
+        } else if (key == "--csv") {
+            options.csvPath = value;
+        } else {
+            return false;
+        }
+    }
+    return !options.files.empty();
+}
+
+void printRow(const std::string& name, const vic::recording::ReplayStats& stats) {
+    const auto times = vic::recording::summarizeFrameTimes(stats.frameTimesUs);
+    const double frames = static_cast<double>(std::max<uint64_t>(1, stats.frames));
+    const double seconds = std::max(stats.wallMs, 1e-3) / 1000.0;
+    std::cout << std::left << std::setw(28) << name.substr(0, 27)
+              << std::right << std::setw(8) << stats.frames
+              << std::setw(9) << stats.frames / seconds
+              << std::setw(8) << (stats.wallMs > 0 ? static_cast<double>(stats.mediaMs) / stats.wallMs : 0.0)
+              << std::setw(9) << static_cast<double>(stats.pixels) / 1e6 / seconds
+              << std::setw(8) << stats.decodeMs / frames
+              << std::setw(8) << stats.convertMs / frames
+              << std::setw(8) << stats.renderMs / frames
+              << std::setw(8) << times.p50 / 1000.0
+              << std::setw(8) << times.p90 / 1000.0
+              << std::setw(8) << times.p99 / 1000.0
+              << std::setw(8) << times.p999 / 1000.0
+              << std::setw(8) << times.max / 1000.0;
+    if (stats.comparedFrames > 0) {
+        std::cout << std::setw(8) << stats.avgPsnr << std::setw(8) << stats.minPsnr;
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    // Mapeados una sola vez y compartidos por los hilos (el lector es inmutable)
+    std::vector<std::unique_ptr<vic::recording::RecordingReader>> readers;
+    for (const auto& file : options.files) {
+        auto reader = vic::recording::RecordingReader::open(file);
+        if (!reader) {
+            std::cerr << "Error: no se pudo abrir " << file << std::endl;
+            return 1;
+        }
+        std::cout << file << ": " << vic::encoder::codecName(reader->codec()) << ", "
+                  << reader->frameCount() << " frames, " << reader->keyFrames().size() << " keyframes, "
+                  << reader->durationMs() / 1000.0 << " s, " << reader->fileSize() / 1024 << " KB"
+                  << (reader->hasIndex() ? "" : " (sin índice)") << std::endl;
+        readers.push_back(std::move(reader));
+    }
+    std::unique_ptr<vic::recording::RecordingReader> reference;
+    if (!options.referencePath.empty()) {
+        reference = vic::recording::RecordingReader::open(options.referencePath);
+        if (!reference) {
+            std::cerr << "Error: no se pudo abrir la referencia " << options.referencePath << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<const vic::recording::RecordingReader*> jobs;
+    for (uint32_t copy = 0; copy < options.copies; ++copy) {
+        for (const auto& reader : readers) {
+            jobs.push_back(reader.get());
+        }
+    }
+    const uint32_t threads = options.jobs > 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t parallel = std::min<uint32_t>(threads, static_cast<uint32_t>(jobs.size()));
+
+    vic::recording::ReplayOptions replayOptions;
+    replayOptions.render = options.render;
+    replayOptions.renderWidth = options.width;
+    replayOptions.renderHeight = options.height;
+    replayOptions.filter = options.filter;
+    replayOptions.loops = options.loops;
+    // Con varios jobs los cores ya están repartidos entre grabaciones
+    replayOptions.decoderThreads = options.decoderThreads > 0 ? options.decoderThreads : (parallel > 1 ? 1 : 0);
+    replayOptions.reference = reference.get();
+
+    std::cout << jobs.size() << " replay(s) en " << parallel << " hilo(s), " << options.loops << " vuelta(s)"
+              << (options.render ? "" : ", sin render") << std::endl;
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = vic::recording::replayParallel(jobs, replayOptions, parallel);
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n" << std::string(130, '=') << std::endl;
+    std::cout << std::left << std::setw(28) << "Grabación"
+              << std::right << std::setw(8) << "Frames"
+              << std::setw(9) << "fps"
+              << std::setw(8) << "x RT"
+              << std::setw(9) << "Mpix/s"
+              << std::setw(8) << "Dec ms"
+              << std::setw(8) << "Cnv ms"
+              << std::setw(8) << "Rnd ms"
+              << std::setw(8) << "p50"
+              << std::setw(8) << "p90"
+              << std::setw(8) << "p99"
+              << std::setw(8) << "p99.9"
+              << std::setw(8) << "Máx"
+              << (reference ? "    PSNR     Mín" : "") << std::endl;
+    std::cout << std::string(130, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    vic::recording::ReplayStats total{};
+    total.path = "TOTAL";
+    double psnrSum = 0;
+    total.minPsnr = 0;
+    for (const auto& stats : results) {
+        printRow(std::filesystem::path(stats.path).filename().string(), stats);
+        total.frames += stats.frames;
+        total.failedFrames += stats.failedFrames;
+        total.bytes += stats.bytes;
+        total.pixels += stats.pixels;
+        total.mediaMs += stats.mediaMs;
+        total.decodeMs += stats.decodeMs;
+        total.convertMs += stats.convertMs;
+        total.renderMs += stats.renderMs;
+        total.frameTimesUs.insert(total.frameTimesUs.end(), stats.frameTimesUs.begin(), stats.frameTimesUs.end());
+        if (stats.comparedFrames > 0) {
+            psnrSum += stats.avgPsnr * static_cast<double>(stats.comparedFrames);
+            total.minPsnr = total.comparedFrames == 0 ? stats.minPsnr : std::min(total.minPsnr, stats.minPsnr);
+            total.comparedFrames += stats.comparedFrames;
+        }
+    }
+    if (total.comparedFrames > 0) {
+        total.avgPsnr = psnrSum / static_cast<double>(total.comparedFrames);
+    }
+    // Throughput agregado: frames de todos los hilos sobre el tiempo de pared
+    total.wallMs = wallMs;
+    if (results.size() > 1) {
+        std::cout << std::string(130, '-') << std::endl;
+        printRow("TOTAL", total);
+    }
+    std::cout << std::string(130, '=') << std::endl;
+    std::cout << "Tiempos por frame (decode + conversión + render) en ms; x RT = veces más rápido que tiempo real" << std::endl;
+    if (total.failedFrames > 0) {
+        std::cout << "Frames sin imagen: " << total.failedFrames << std::endl;
+    }
+
+    if (!options.csvPath.empty()) {
+        std::ofstream csv(options.csvPath);
+        csv << "recording,frame,us\n";
+        for (const auto& stats : results) {
+            for (size_t i = 0; i < stats.frameTimesUs.size(); ++i) {
+                csv << stats.path << ',' << i << ',' << stats.frameTimesUs[i] << '\n';
+            }
+        }
+    }
+    return total.failedFrames == total.frames ? 1 : 0;
+}